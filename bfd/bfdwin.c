@@ -142,8 +142,19 @@ bfd_get_file_window (bfd *abfd,
       file_ptr file_offset, offset2;
       size_t real_size;
       int fd;
+      bfd *file_bfd = abfd;
 
       /* Find the real file and the real offset into it.  */
+      while (file_bfd->my_archive != NULL
+	     && !bfd_is_thin_archive (file_bfd->my_archive))
+	file_bfd = file_bfd->my_archive;
+
+      /* Only a file opened through the cache has a descriptor to map.
+	 Others, such as those opened with bfd_openr_iovec, are read
+	 into a buffer below.  */
+      if (!bfd_cache_file_p (file_bfd))
+	goto no_map;
+
       while (abfd->my_archive != NULL
 	     && !bfd_is_thin_archive (abfd->my_archive))
 	{
@@ -209,6 +220,7 @@ bfd_get_file_window (bfd *abfd,
       else
 	fprintf (stderr, _("not mapping: env var not set\n"));
     }
+ no_map:
 #else
   ok_to_map = 0;
 #endif
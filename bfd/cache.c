@@ -535,6 +535,24 @@ bfd_cache_close (bfd *abfd)
   return bfd_cache_delete (abfd);
 }
 
+/*
+INTERNAL_FUNCTION
+	bfd_cache_file_p
+
+SYNOPSIS
+	bfd_boolean bfd_cache_file_p (bfd *abfd);
+
+DESCRIPTION
+	Return TRUE if @var{abfd} is read through the file cache, so
+	that its iostream, once open, is a <<FILE *>>.
+*/
+
+bfd_boolean
+bfd_cache_file_p (bfd *abfd)
+{
+  return abfd->iovec == &cache_iovec;
+}
+
 /*
 FUNCTION
 	bfd_cache_close_all
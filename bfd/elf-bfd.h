@@ -691,6 +691,27 @@ struct elf_link_hash_table
   asection *irelplt;
   asection *irelifunc;
   asection *dynsym;
+
+  /* The DT_RELR section and the relative relocations packed into it,
+     sorted by input section id and offset.  */
+  asection *srelrdyn;
+  struct elf_relr_entry *relr;
+  bfd_size_type relr_count;
+  bfd_size_type relr_alloc;
+
+  /* Set while the input files are relocated by several threads.  */
+  struct elf_link_threads *link_threads;
+};
+
+/* A relative relocation packed into DT_RELR.  It applies at OFFSET
+   in input section SEC.  USED is set when relocate_section finds
+   it.  */
+
+struct elf_relr_entry
+{
+  asection *sec;
+  bfd_vma offset;
+  bfd_boolean used;
 };
 
 /* Look up an entry in an ELF linker hash table.  */
@@ -1664,6 +1685,12 @@ struct elf_backend_data
   /* True if the 64-bit Linux PRPSINFO structure's `pr_uid' and `pr_gid'
      members use a 16-bit data type.  */
   unsigned linux_prpsinfo64_ugid16 : 1;
+
+  /* True if elf_backend_relocate_section may be called for different
+     input files at the same time.  It must then call _bfd_elf_link_lock
+     around changes to global symbols and linker created sections, and
+     around calls to the einfo callback, and must not return 2.  */
+  unsigned threaded_relocate_section : 1;
 };
 
 /* Information about reloc sections associated with a bfd_elf_section_data
@@ -2030,6 +2057,13 @@ struct elf_obj_tdata
      symbols.  */
   unsigned int bad_symtab : 1;
 
+  /* Set if _bfd_elf_file_view could not map this file.  */
+  unsigned int file_view_failed : 1;
+
+  /* A read-only mapping of the whole file, made by _bfd_elf_file_view
+     when bfd is configured with --with-mmap.  */
+  bfd_window file_view;
+
   /* Information grabbed from an elf core file.  */
   struct core_elf_obj_tdata *core;
 
@@ -2580,6 +2614,14 @@ extern int bfd_elf_link_record_local_dynamic_symbol
 
 extern bfd_boolean _bfd_elf_close_and_cleanup
   (bfd *);
+extern bfd_boolean _bfd_elf_free_cached_info
+  (bfd *);
+extern bfd_boolean _bfd_elf_get_section_contents
+  (bfd *, sec_ptr, void *, file_ptr, bfd_size_type);
+extern const bfd_byte *_bfd_elf_file_view
+  (bfd *, file_ptr, bfd_size_type);
+extern void _bfd_elf_free_file_view
+  (bfd *);
 
 extern bfd_boolean _bfd_elf_common_definition
   (Elf_Internal_Sym *);
@@ -2917,6 +2959,22 @@ extern bfd_boolean _bfd_elf_maybe_set_textrel
 extern bfd_boolean _bfd_elf_add_dynamic_tags
   (bfd *, struct bfd_link_info *, bfd_boolean);
 
+extern bfd_boolean _bfd_elf_create_relr_section
+  (bfd *, struct bfd_link_info *);
+extern bfd_boolean _bfd_elf_relr_scan
+  (bfd *, struct bfd_link_info *,
+   bfd_boolean (*) (struct bfd_link_info *, const Elf_Internal_Rela *,
+		    struct elf_link_hash_entry *));
+extern bfd_boolean _bfd_elf_relr_use
+  (struct bfd_link_info *, asection *, bfd_vma);
+extern bfd_boolean _bfd_elf_size_relative_relocs
+  (struct bfd_link_info *, bfd_boolean *);
+
+extern void _bfd_elf_link_lock
+  (struct bfd_link_info *);
+extern void _bfd_elf_link_unlock
+  (struct bfd_link_info *);
+
 /* Large common section.  */
 extern asection _bfd_elf_large_com_section;
 
@@ -369,6 +369,96 @@ bfd_elf_string_from_elf_section (bfd *abfd,
   return ((char *) hdr->contents) + strindex;
 }
 
+/* Return a pointer to SIZE bytes at offset POS in ABFD, or NULL if
+   they are not available that way.  When bfd is configured with
+   --with-mmap, the whole of an input file is mapped the first time
+   this is called for it and the mapping is kept until the bfd is
+   closed or its cached info freed, so symbols, relocs and section
+   contents are read without a seek and read per request, and without
+   needing the file to be open in the cache.  Files not opened through
+   the cache, such as those from bfd_openr_iovec, are never mapped.  */
+
+const bfd_byte *
+_bfd_elf_file_view (bfd *abfd ATTRIBUTE_UNUSED,
+		    file_ptr pos ATTRIBUTE_UNUSED,
+		    bfd_size_type size ATTRIBUTE_UNUSED)
+{
+#ifdef USE_MMAP
+  struct elf_obj_tdata *tdata = elf_tdata (abfd);
+  bfd *file_bfd;
+
+  if (tdata == NULL || tdata->file_view_failed)
+    return NULL;
+
+  if (tdata->file_view.data == NULL)
+    {
+      ufile_ptr filesize, origin;
+
+      tdata->file_view_failed = 1;
+      if (abfd->direction != read_direction
+	  || bfd_get_format (abfd) != bfd_object
+	  || (abfd->flags & BFD_IN_MEMORY) != 0)
+	return NULL;
+      file_bfd = abfd;
+      origin = abfd->origin;
+      while (file_bfd->my_archive != NULL
+	     && !bfd_is_thin_archive (file_bfd->my_archive))
+	{
+	  file_bfd = file_bfd->my_archive;
+	  origin += file_bfd->origin;
+	}
+      if ((file_bfd->flags & BFD_IN_MEMORY) != 0
+	  || !bfd_cache_file_p (file_bfd))
+	return NULL;
+      /* Touching a mapping past the end of the file faults, so don't
+	 map a truncated archive member.  */
+      filesize = bfd_get_file_size (abfd);
+      if (filesize == 0
+	  || origin + filesize > bfd_get_size (file_bfd)
+	  || !bfd_get_file_window (abfd, 0, filesize, &tdata->file_view,
+				   FALSE))
+	return NULL;
+      if (tdata->file_view.i == NULL || !tdata->file_view.i->mapped)
+	{
+	  /* Don't hold a malloced copy of the whole file.  */
+	  bfd_free_window (&tdata->file_view);
+	  bfd_init_window (&tdata->file_view);
+	  return NULL;
+	}
+      tdata->file_view_failed = 0;
+    }
+
+  if (pos < 0
+      || (bfd_size_type) pos > tdata->file_view.size
+      || size > tdata->file_view.size - pos)
+    return NULL;
+  return (const bfd_byte *) tdata->file_view.data + pos;
+#else
+  return NULL;
+#endif
+}
+
+/* Release the view made by _bfd_elf_file_view, if any.  This is also
+   the bfd_check_format cleanup for ELF objects, so that a view made
+   while trying a target that is then rejected is not leaked.  */
+
+void
+_bfd_elf_free_file_view (bfd *abfd ATTRIBUTE_UNUSED)
+{
+#ifdef USE_MMAP
+  struct elf_obj_tdata *tdata = elf_tdata (abfd);
+
+  if (tdata == NULL)
+    return;
+  if (tdata->file_view.data != NULL)
+    {
+      bfd_free_window (&tdata->file_view);
+      bfd_init_window (&tdata->file_view);
+    }
+  tdata->file_view_failed = 0;
+#endif
+}
+
 /* Read and convert symbols to internal format.
    SYMCOUNT specifies the number of symbols to read, starting from
    symbol SYMOFFSET.  If any of INTSYM_BUF, EXTSYM_BUF or EXTSHNDX_BUF
@@ -398,6 +488,7 @@ bfd_elf_get_elf_syms (bfd *ibfd,
   size_t extsym_size;
   size_t amt;
   file_ptr pos;
+  const bfd_byte *view;
 
   if (bfd_get_flavour (ibfd) != bfd_target_elf_flavour)
     abort ();
@@ -449,17 +540,25 @@ bfd_elf_get_elf_syms (bfd *ibfd,
       goto out;
     }
   pos = symtab_hdr->sh_offset + symoffset * extsym_size;
-  if (extsym_buf == NULL)
-    {
-      alloc_ext = bfd_malloc (amt);
-      extsym_buf = alloc_ext;
-    }
-  if (extsym_buf == NULL
-      || bfd_seek (ibfd, pos, SEEK_SET) != 0
-      || bfd_bread (extsym_buf, amt, ibfd) != amt)
+  /* Swap the symbols in straight from a view of the file, if there
+     is one, rather than reading them into a buffer first.  */
+  view = _bfd_elf_file_view (ibfd, pos, amt);
+  if (view != NULL)
+    extsym_buf = (void *) view;
+  else
     {
-      intsym_buf = NULL;
-      goto out;
+      if (extsym_buf == NULL)
+	{
+	  alloc_ext = bfd_malloc (amt);
+	  extsym_buf = alloc_ext;
+	}
+      if (extsym_buf == NULL
+	  || bfd_seek (ibfd, pos, SEEK_SET) != 0
+	  || bfd_bread (extsym_buf, amt, ibfd) != amt)
+	{
+	  intsym_buf = NULL;
+	  goto out;
+	}
     }
 
   if (shndx_hdr == NULL || shndx_hdr->sh_size == 0)
@@ -473,17 +572,23 @@ bfd_elf_get_elf_syms (bfd *ibfd,
 	  goto out;
 	}
       pos = shndx_hdr->sh_offset + symoffset * sizeof (Elf_External_Sym_Shndx);
-      if (extshndx_buf == NULL)
-	{
-	  alloc_extshndx = (Elf_External_Sym_Shndx *) bfd_malloc (amt);
-	  extshndx_buf = alloc_extshndx;
-	}
-      if (extshndx_buf == NULL
-	  || bfd_seek (ibfd, pos, SEEK_SET) != 0
-	  || bfd_bread (extshndx_buf, amt, ibfd) != amt)
+      view = _bfd_elf_file_view (ibfd, pos, amt);
+      if (view != NULL)
+	extshndx_buf = (Elf_External_Sym_Shndx *) view;
+      else
 	{
-	  intsym_buf = NULL;
-	  goto out;
+	  if (extshndx_buf == NULL)
+	    {
+	      alloc_extshndx = (Elf_External_Sym_Shndx *) bfd_malloc (amt);
+	      extshndx_buf = alloc_extshndx;
+	    }
+	  if (extshndx_buf == NULL
+	      || bfd_seek (ibfd, pos, SEEK_SET) != 0
+	      || bfd_bread (extshndx_buf, amt, ibfd) != amt)
+	    {
+	      intsym_buf = NULL;
+	      goto out;
+	    }
 	}
     }
 
@@ -2106,6 +2211,7 @@ bfd_section_from_shdr (bfd *abfd, unsigned int shindex)
     case SHT_INIT_ARRAY:	/* .init_array section.  */
     case SHT_FINI_ARRAY:	/* .fini_array section.  */
     case SHT_PREINIT_ARRAY:	/* .preinit_array section.  */
+    case SHT_RELR:		/* .relr.dyn section.  */
     case SHT_GNU_LIBLIST:	/* .gnu.liblist section.  */
     case SHT_GNU_HASH:		/* .gnu.hash section.  */
       ret = _bfd_elf_make_section_from_shdr (abfd, hdr, name, shindex);
@@ -2750,6 +2856,7 @@ static const struct bfd_elf_special_section special_sections_r[] =
 {
   { STRING_COMMA_LEN (".rodata"), -2, SHT_PROGBITS, SHF_ALLOC },
   { STRING_COMMA_LEN (".rodata1"), 0, SHT_PROGBITS, SHF_ALLOC },
+  { STRING_COMMA_LEN (".relr.dyn"), 0, SHT_RELR,	    SHF_ALLOC },
   { STRING_COMMA_LEN (".rela"),	  -1, SHT_RELA,	    0 },
   { STRING_COMMA_LEN (".rel"),	  -1, SHT_REL,	    0 },
   { NULL,		    0,	   0, 0,	    0 }
@@ -3356,6 +3463,7 @@ elf_fake_sections (bfd *abfd, asection *asect, void *fsarg)
     case SHT_INIT_ARRAY:
     case SHT_FINI_ARRAY:
     case SHT_PREINIT_ARRAY:
+    case SHT_RELR:
       this_hdr->sh_entsize = bed->s->arch_size / 8;
       break;
 
@@ -9445,11 +9553,58 @@ _bfd_elf_close_and_cleanup (bfd *abfd)
       if (elf_tdata (abfd)->o != NULL && elf_shstrtab (abfd) != NULL)
 	_bfd_elf_strtab_free (elf_shstrtab (abfd));
       _bfd_dwarf2_cleanup_debug_info (abfd, &tdata->dwarf2_find_line_info);
+      _bfd_elf_free_file_view (abfd);
     }
 
   return _bfd_generic_close_and_cleanup (abfd);
 }
 
+bfd_boolean
+_bfd_elf_free_cached_info (bfd *abfd)
+{
+  if (elf_tdata (abfd) != NULL
+      && (bfd_get_format (abfd) == bfd_object
+	  || bfd_get_format (abfd) == bfd_core))
+    _bfd_elf_free_file_view (abfd);
+
+  return _bfd_free_cached_info (abfd);
+}
+
+/* Read section contents, from the view of the file made by
+   _bfd_elf_file_view if there is one.  */
+
+bfd_boolean
+_bfd_elf_get_section_contents (bfd *abfd,
+			       sec_ptr section,
+			       void *location,
+			       file_ptr offset,
+			       bfd_size_type count)
+{
+  bfd_size_type sz;
+  const bfd_byte *view;
+
+  if (count == 0
+      || section->compress_status != COMPRESS_SECTION_NONE
+      || abfd->direction != read_direction)
+    return _bfd_generic_get_section_contents (abfd, section, location,
+					      offset, count);
+
+  sz = section->rawsize != 0 ? section->rawsize : section->size;
+  if (offset < 0
+      || offset + count < count
+      || offset + count > sz)
+    return _bfd_generic_get_section_contents (abfd, section, location,
+					      offset, count);
+
+  view = _bfd_elf_file_view (abfd, section->filepos + offset, count);
+  if (view == NULL)
+    return _bfd_generic_get_section_contents (abfd, section, location,
+					      offset, count);
+
+  memcpy (location, view, count);
+  return TRUE;
+}
+
 /* For Rel targets, we encode meaningful data for BFD_RELOC_VTABLE_ENTRY
    in the relocation's offset.  Thus we cannot allow any sort of sanity
    range-checking to interfere.  There is nothing else to do in processing
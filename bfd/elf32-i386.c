@@ -4326,6 +4326,7 @@ elf_i386_link_setup_gnu_properties (struct bfd_link_info *info)
 
   init_table.r_info = elf32_r_info;
   init_table.r_sym = elf32_r_sym;
+  init_table.relr_p = NULL;
 
   return _bfd_x86_elf_link_setup_gnu_properties (info, &init_table);
 }
@@ -3253,8 +3253,13 @@ elf_x86_64_relocate_section (bfd *output_bfd,
 		     When relocation overflow check is disabled, we
 		     convert R_X86_64_32 to dynamic R_X86_64_RELATIVE.  */
 		  if (r_type == htab->pointer_r_type
-		      || (r_type == R_X86_64_32
-			  && htab->params->no_reloc_overflow_check))
+		      && _bfd_elf_relr_use (info, input_section,
+					    rel->r_offset))
+		    /* Packed into DT_RELR, which has no addend.  */
+		    break;
+		  else if (r_type == htab->pointer_r_type
+			   || (r_type == R_X86_64_32
+			       && htab->params->no_reloc_overflow_check))
 		    {
 		      relocate = TRUE;
 		      outrel.r_info = htab->r_info (0, R_X86_64_RELATIVE);
@@ -5107,6 +5112,23 @@ elf_x86_64_relocs_compatible (const bfd_target *input,
 	  && _bfd_elf_relocs_compatible (input, output));
 }
 
+/* Return TRUE if elf_x86_64_relocate_section turns REL against H, or
+   a local symbol if H is NULL, into an R_X86_64_RELATIVE dynamic
+   reloc.  */
+
+static bfd_boolean
+elf_x86_64_relr_p (struct bfd_link_info *info, const Elf_Internal_Rela *rel,
+		   struct elf_link_hash_entry *h)
+{
+  struct elf_x86_link_hash_table *htab
+    = elf_x86_hash_table (info, X86_64_ELF_DATA);
+  unsigned int r_type = ELF32_R_TYPE (rel->r_info);
+
+  return (r_type == htab->pointer_r_type
+	  && bfd_link_pic (info)
+	  && !COPY_INPUT_RELOC_P (info, h, r_type));
+}
+
 /* Set up x86-64 GNU properties.  Return the first relocatable ELF input
    with GNU properties if found.  Otherwise, return NULL.  */
 
@@ -5165,6 +5187,8 @@ elf_x86_64_link_setup_gnu_properties (struct bfd_link_info *info)
       init_table.r_sym = elf32_r_sym;
     }
 
+  init_table.relr_p = elf_x86_64_relr_p;
+
   return _bfd_x86_elf_link_setup_gnu_properties (info, &init_table);
 }
 
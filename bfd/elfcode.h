@@ -853,7 +853,7 @@ elf_object_p (bfd *abfd)
 	    s->flags |= SEC_DEBUGGING;
 	}
     }
-  return _bfd_no_cleanup;
+  return _bfd_elf_free_file_view;
 
  got_wrong_format_error:
   bfd_set_error (bfd_error_wrong_format);
@@ -31,6 +31,9 @@
 #include "plugin-api.h"
 #include "plugin.h"
 #endif
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 
 /* This struct is used to pass information to routines called via
    elf_link_hash_traverse which must return failure.  */
@@ -2226,6 +2229,54 @@ _bfd_elf_link_find_version_dependencies (struct elf_link_hash_entry *h,
   return TRUE;
 }
 
+/* glibc refuses to load an object with DT_RELR unless it depends on
+   the GLIBC_ABI_DT_RELR version of libc.so.  Add that dependency if
+   we are linking against glibc.  */
+
+static bfd_boolean
+elf_link_add_dt_relr_dependency (struct elf_find_verdep_info *rinfo)
+{
+  static const char relr[] = "GLIBC_ABI_DT_RELR";
+  Elf_Internal_Verneed *t;
+  Elf_Internal_Vernaux *a;
+  bfd_boolean is_glibc;
+
+  for (t = elf_tdata (rinfo->info->output_bfd)->verref;
+       t != NULL;
+       t = t->vn_nextref)
+    {
+      const char *soname = bfd_elf_get_dt_soname (t->vn_bfd);
+
+      if (soname != NULL && CONST_STRNEQ (soname, "libc.so."))
+	break;
+    }
+  if (t == NULL)
+    return TRUE;
+
+  is_glibc = FALSE;
+  for (a = t->vn_auxptr; a != NULL; a = a->vna_nextptr)
+    {
+      if (strcmp (a->vna_nodename, relr) == 0)
+	return TRUE;
+      if (CONST_STRNEQ (a->vna_nodename, "GLIBC_2."))
+	is_glibc = TRUE;
+    }
+  if (!is_glibc)
+    return TRUE;
+
+  a = (Elf_Internal_Vernaux *) bfd_zalloc (rinfo->info->output_bfd,
+					   sizeof *a);
+  if (a == NULL)
+    return FALSE;
+
+  a->vna_nodename = relr;
+  a->vna_flags = 0;
+  a->vna_nextptr = t->vn_auxptr;
+  a->vna_other = ++rinfo->vers;
+  t->vn_auxptr = a;
+  return TRUE;
+}
+
 /* Return TRUE and set *HIDE to TRUE if the versioned symbol is
    hidden.  Set *T_P to NULL if there is no match.  */
 
@@ -2492,14 +2543,23 @@ elf_link_read_relocs_from_section (bfd *abfd,
   Elf_Internal_Rela *irela;
   Elf_Internal_Shdr *symtab_hdr;
   size_t nsyms;
+  const bfd_byte *view;
 
-  /* Position ourselves at the start of the section.  */
-  if (bfd_seek (abfd, shdr->sh_offset, SEEK_SET) != 0)
-    return FALSE;
+  /* Swap the relocations in straight from a view of the file, if
+     there is one.  */
+  view = _bfd_elf_file_view (abfd, shdr->sh_offset, shdr->sh_size);
+  if (view != NULL)
+    external_relocs = (void *) view;
+  else
+    {
+      /* Position ourselves at the start of the section.  */
+      if (bfd_seek (abfd, shdr->sh_offset, SEEK_SET) != 0)
+	return FALSE;
 
-  /* Read the relocations.  */
-  if (bfd_bread (external_relocs, shdr->sh_size, abfd) != shdr->sh_size)
-    return FALSE;
+      /* Read the relocations.  */
+      if (bfd_bread (external_relocs, shdr->sh_size, abfd) != shdr->sh_size)
+	return FALSE;
+    }
 
   symtab_hdr = &elf_tdata (abfd)->symtab_hdr;
   nsyms = NUM_SHDR_ENTRIES (symtab_hdr);
@@ -6798,6 +6858,12 @@ bfd_elf_size_dynamic_sections (bfd *output_bfd,
       if (sinfo.failed)
 	return FALSE;
 
+      /* The relocations are only packed later, in the backend
+	 size_dynamic_sections, so go by .relr.dyn being created.  */
+      if (elf_hash_table (info)->srelrdyn != NULL
+	  && !elf_link_add_dt_relr_dependency (&sinfo))
+	return FALSE;
+
       if (elf_tdata (output_bfd)->verref == NULL)
 	s->flags |= SEC_EXCLUDE;
       else
@@ -7852,6 +7918,7 @@ _bfd_elf_link_hash_table_free (bfd *obfd)
   if (htab->dynstr != NULL)
     _bfd_elf_strtab_free (htab->dynstr);
   _bfd_merge_sections_free (htab->merge_info);
+  free (htab->relr);
   _bfd_generic_link_hash_table_free (obfd);
 }
 
@@ -8364,6 +8431,25 @@ _bfd_elf_match_sections_by_type (bfd *abfd, const asection *asec,
 
 /* Final phase of ELF linker.  */
 
+/* A local symbol of an input file, held back when input files are
+   relocated in parallel so that it can be output in link order.  */
+
+struct elf_deferred_sym
+{
+  const char *name;
+  Elf_Internal_Sym sym;
+  asection *isec;
+};
+
+/* The local symbols held back for one input file.  */
+
+struct elf_deferred_syms
+{
+  struct elf_deferred_sym *syms;
+  size_t count;
+  size_t alloc;
+};
+
 /* A structure we use to avoid passing large numbers of arguments.  */
 
 struct elf_final_link_info
@@ -8402,6 +8488,9 @@ struct elf_final_link_info
   Elf_External_Sym_Shndx *symshndxbuf;
   /* Number of STT_FILE syms seen.  */
   size_t filesym_count;
+  /* Where to hold back the local symbols of the input file being
+     linked, if input files are relocated in parallel.  */
+  struct elf_deferred_syms *deferred_syms;
 };
 
 /* This struct is used to pass information to elf_link_output_extsym.  */
@@ -9291,6 +9380,123 @@ elf_link_sort_cmp2 (const void *A, const void *B)
   return 0;
 }
 
+/* Sort keys for elf_link_sort_radix.  KEY[0] is the most significant
+   word.  INDEX is the position of the element in the unsorted
+   array.  */
+
+struct elf_link_sort_key
+{
+  bfd_vma key[3];
+  size_t index;
+};
+
+/* Sort the COUNT elements of SORT_ELT bytes at BASE into the order
+   given by elf_link_sort_cmp1 if SYM_MASK is non-zero, or by
+   elf_link_sort_cmp2 otherwise.  SYM_SHIFT is the shift of the symbol
+   index in r_info.  Dynamic reloc sections can hold millions of
+   entries, so rather than calling qsort with a comparison function
+   that chases pointers into the large sort elements, build compact
+   integer keys, sort those with a stable LSD radix sort that skips
+   byte positions where all keys agree, and then permute the
+   elements.  Being stable, this orders equal elements as the
+   merge sort used by most qsort implementations does.  */
+
+static void
+elf_link_sort_radix (bfd_byte *base, size_t count, size_t sort_elt,
+		     bfd_vma sym_mask, int sym_shift)
+{
+  struct elf_link_sort_key *keys, *tmp, *t;
+  bfd_byte *sorted, *p;
+  size_t (*hist)[256];
+  unsigned int nkeys, k, b;
+  size_t i, amt;
+
+  if (count < 2)
+    return;
+
+  amt = count * sizeof (*keys);
+  keys = (struct elf_link_sort_key *) bfd_malloc (2 * amt);
+  sorted = (bfd_byte *) bfd_malloc (count * sort_elt);
+  hist = (size_t (*)[256]) bfd_malloc (sizeof (bfd_vma) * sizeof (*hist));
+  if (keys == NULL || sorted == NULL || hist == NULL)
+    {
+      free (keys);
+      free (sorted);
+      free (hist);
+      qsort (base, count, sort_elt,
+	     sym_mask != 0 ? elf_link_sort_cmp1 : elf_link_sort_cmp2);
+      return;
+    }
+  tmp = keys + count;
+
+  nkeys = sym_mask != 0 ? 2 : 3;
+  for (i = 0, p = base; i < count; i++, p += sort_elt)
+    {
+      struct elf_link_sort_rela *s = (struct elf_link_sort_rela *) p;
+
+      if (sym_mask != 0)
+	{
+	  /* Relative relocs first, then by symbol and offset.  The
+	     symbol index is at most 32 bits, so the relative flag
+	     fits above it.  */
+	  bfd_vma sym = (s->rela->r_info & sym_mask) >> sym_shift;
+
+	  keys[i].key[0] = ((bfd_vma) (s->type != reloc_class_relative)
+			    << (sym_shift == 8 ? 24 : 32)) | sym;
+	  keys[i].key[1] = s->rela->r_offset;
+	}
+      else
+	{
+	  keys[i].key[0] = s->type;
+	  keys[i].key[1] = s->u.offset;
+	  keys[i].key[2] = s->rela->r_offset;
+	}
+      keys[i].index = i;
+    }
+
+  for (k = nkeys; k-- > 0; )
+    {
+      memset (hist, 0, sizeof (bfd_vma) * sizeof (*hist));
+      for (i = 0; i < count; i++)
+	{
+	  bfd_vma v = keys[i].key[k];
+
+	  for (b = 0; b < sizeof (bfd_vma); b++, v >>= 8)
+	    hist[b][v & 0xff]++;
+	}
+
+      for (b = 0; b < sizeof (bfd_vma); b++)
+	{
+	  size_t sum, n;
+	  unsigned int d;
+
+	  /* Nothing to do if every key has the same byte here.  */
+	  if (hist[b][(keys[0].key[k] >> (b * 8)) & 0xff] == count)
+	    continue;
+
+	  for (sum = 0, d = 0; d < 256; d++)
+	    {
+	      n = hist[b][d];
+	      hist[b][d] = sum;
+	      sum += n;
+	    }
+	  for (i = 0; i < count; i++)
+	    tmp[hist[b][(keys[i].key[k] >> (b * 8)) & 0xff]++] = keys[i];
+	  t = keys;
+	  keys = tmp;
+	  tmp = t;
+	}
+    }
+
+  for (i = 0, p = sorted; i < count; i++, p += sort_elt)
+    memcpy (p, base + keys[i].index * sort_elt, sort_elt);
+  memcpy (base, sorted, count * sort_elt);
+
+  free (keys < tmp ? keys : tmp);
+  free (sorted);
+  free (hist);
+}
+
 static size_t
 elf_link_sort_relocs (bfd *abfd, struct bfd_link_info *info, asection **psec)
 {
@@ -9308,6 +9514,7 @@ elf_link_sort_relocs (bfd *abfd, struct bfd_link_info *info, asection **psec)
   void (*swap_out) (bfd *, const Elf_Internal_Rela *, bfd_byte *);
   struct bfd_link_order *lo;
   bfd_vma r_sym_mask;
+  int r_sym_shift;
   bfd_boolean use_rela;
 
   /* Find a dynamic reloc section.  */
@@ -9488,9 +9695,15 @@ elf_link_sort_relocs (bfd *abfd, struct bfd_link_info *info, asection **psec)
     }
 
   if (bed->s->arch_size == 32)
-    r_sym_mask = ~(bfd_vma) 0xff;
+    {
+      r_sym_mask = ~(bfd_vma) 0xff;
+      r_sym_shift = 8;
+    }
   else
-    r_sym_mask = ~(bfd_vma) 0xffffffff;
+    {
+      r_sym_mask = ~(bfd_vma) 0xffffffff;
+      r_sym_shift = 32;
+    }
 
   for (lo = dynamic_relocs->map_head.link_order; lo != NULL; lo = lo->next)
     if (lo->type == bfd_indirect_link_order)
@@ -9522,7 +9735,7 @@ elf_link_sort_relocs (bfd *abfd, struct bfd_link_info *info, asection **psec)
 	  }
       }
 
-  qsort (sort, count, sort_elt, elf_link_sort_cmp1);
+  elf_link_sort_radix (sort, count, sort_elt, r_sym_mask, r_sym_shift);
 
   for (i = 0, p = sort; i < count; i++, p += sort_elt)
     {
@@ -9542,7 +9755,7 @@ elf_link_sort_relocs (bfd *abfd, struct bfd_link_info *info, asection **psec)
       sp->u.offset = sq->rela->r_offset;
     }
 
-  qsort (s_non_relative, count - ret, sort_elt, elf_link_sort_cmp2);
+  elf_link_sort_radix (s_non_relative, count - ret, sort_elt, 0, 0);
 
   struct elf_link_hash_table *htab = elf_hash_table (info);
   if (htab->srelplt && htab->srelplt->output_section == dynamic_relocs)
@@ -9668,6 +9881,41 @@ elf_link_output_symstrtab (struct elf_final_link_info *flinfo,
   return 1;
 }
 
+/* Add local symbol ELFSYM of an input file to the output symbol
+   string table, or hold it back if input files are relocated in
+   parallel.  */
+
+static int
+elf_link_output_local_sym (struct elf_final_link_info *flinfo,
+			   const char *name,
+			   Elf_Internal_Sym *elfsym,
+			   asection *input_sec)
+{
+  struct elf_deferred_syms *deferred = flinfo->deferred_syms;
+  struct elf_deferred_sym *ent;
+
+  if (deferred == NULL)
+    return elf_link_output_symstrtab (flinfo, name, elfsym, input_sec,
+				      NULL);
+
+  if (deferred->count >= deferred->alloc)
+    {
+      size_t alloc = deferred->alloc != 0 ? deferred->alloc * 2 : 64;
+
+      ent = (struct elf_deferred_sym *)
+	bfd_realloc (deferred->syms, alloc * sizeof (*ent));
+      if (ent == NULL)
+	return 0;
+      deferred->syms = ent;
+      deferred->alloc = alloc;
+    }
+  ent = deferred->syms + deferred->count++;
+  ent->name = name;
+  ent->sym = *elfsym;
+  ent->isec = input_sec;
+  return 1;
+}
+
 /* Swap symbols out to the symbol table and flush the output symbols to
    the file.  */
 
@@ -10550,6 +10798,97 @@ _bfd_elf_check_kept_section (asection *sec, struct bfd_link_info *info)
   return kept;
 }
 
+/* Write out the contents of input section O, relocated in CONTENTS,
+   to the output file.  */
+
+static bfd_boolean
+elf_link_write_section (struct elf_final_link_info *flinfo, asection *o,
+			bfd_byte *contents, bfd_size_type address_size)
+{
+  bfd *output_bfd = flinfo->output_bfd;
+  const struct elf_backend_data *bed = get_elf_backend_data (output_bfd);
+
+  if (bed->elf_backend_write_section
+      && (*bed->elf_backend_write_section) (output_bfd, flinfo->info, o,
+					    contents))
+    {
+      /* Section written out.  */
+    }
+  else switch (o->sec_info_type)
+    {
+    case SEC_INFO_TYPE_STABS:
+      if (! (_bfd_write_section_stabs
+	     (output_bfd,
+	      &elf_hash_table (flinfo->info)->stab_info,
+	      o, &elf_section_data (o)->sec_info, contents)))
+	return FALSE;
+      break;
+    case SEC_INFO_TYPE_MERGE:
+      if (! _bfd_write_merged_section (output_bfd, o,
+				       elf_section_data (o)->sec_info))
+	return FALSE;
+      break;
+    case SEC_INFO_TYPE_EH_FRAME:
+      {
+	if (! _bfd_elf_write_section_eh_frame (output_bfd, flinfo->info,
+					       o, contents))
+	  return FALSE;
+      }
+      break;
+    case SEC_INFO_TYPE_EH_FRAME_ENTRY:
+      {
+	if (! _bfd_elf_write_section_eh_frame_entry (output_bfd,
+						     flinfo->info,
+						     o, contents))
+	  return FALSE;
+      }
+      break;
+    default:
+      {
+	if (! (o->flags & SEC_EXCLUDE))
+	  {
+	    file_ptr offset = (file_ptr) o->output_offset;
+	    bfd_size_type todo = o->size;
+
+	    offset *= bfd_octets_per_byte (output_bfd, o);
+
+	    if ((o->flags & SEC_ELF_REVERSE_COPY))
+	      {
+		/* Reverse-copy input section to output.  Build the
+		   reversed image in the scratch buffer so that it
+		   can be written out with a single call rather than
+		   one call per address.  */
+		bfd_byte *lo, *hi;
+
+		if (contents != flinfo->contents)
+		  {
+		    memcpy (flinfo->contents, contents, todo);
+		    contents = flinfo->contents;
+		  }
+		for (lo = contents, hi = contents + todo - address_size;
+		     lo < hi;
+		     lo += address_size, hi -= address_size)
+		  {
+		    bfd_byte tmp[8];
+
+		    memcpy (tmp, lo, address_size);
+		    memcpy (lo, hi, address_size);
+		    memcpy (hi, tmp, address_size);
+		  }
+	      }
+	    if (! bfd_set_section_contents (output_bfd,
+					    o->output_section,
+					    contents,
+					    offset, todo))
+	      return FALSE;
+	  }
+      }
+      break;
+    }
+
+  return TRUE;
+}
+
 /* Link an input file into the linker output file.  This function
    handles all the sections and relocations of the input file at once.
    This is so that we only have to read the local symbols once, and
@@ -10600,14 +10939,22 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
       extsymoff = symtab_hdr->sh_info;
     }
 
-  /* Read the local symbols.  */
+  /* Read the local symbols, and their names so that looking them up
+     below doesn't read the input file.  */
   isymbuf = (Elf_Internal_Sym *) symtab_hdr->contents;
-  if (isymbuf == NULL && locsymcount != 0)
+  if (locsymcount != 0)
     {
-      isymbuf = bfd_elf_get_elf_syms (input_bfd, symtab_hdr, locsymcount, 0,
-				      flinfo->internal_syms,
-				      flinfo->external_syms,
-				      flinfo->locsym_shndx);
+      _bfd_elf_link_lock (flinfo->info);
+      if (isymbuf == NULL)
+	isymbuf = bfd_elf_get_elf_syms (input_bfd, symtab_hdr, locsymcount,
+					0, flinfo->internal_syms,
+					flinfo->external_syms,
+					flinfo->locsym_shndx);
+      if (isymbuf != NULL
+	  && flinfo->deferred_syms != NULL
+	  && bfd_elf_get_str_section (input_bfd, symtab_hdr->sh_link) == NULL)
+	isymbuf = NULL;
+      _bfd_elf_link_unlock (flinfo->info);
       if (isymbuf == NULL)
 	return FALSE;
     }
@@ -10747,11 +11094,10 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	  memset (&osym, 0, sizeof (osym));
 	  osym.st_info = ELF_ST_INFO (STB_LOCAL, STT_FILE);
 	  osym.st_shndx = SHN_ABS;
-	  if (!elf_link_output_symstrtab (flinfo,
+	  if (!elf_link_output_local_sym (flinfo,
 					  (input_bfd->lto_output ? NULL
 					   : bfd_get_filename (input_bfd)),
-					  &osym, bfd_abs_section_ptr,
-					  NULL))
+					  &osym, bfd_abs_section_ptr))
 	    return FALSE;
 	}
 
@@ -10786,7 +11132,7 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	}
 
       indx = bfd_get_symcount (output_bfd);
-      ret = elf_link_output_symstrtab (flinfo, name, &osym, isec, NULL);
+      ret = elf_link_output_local_sym (flinfo, name, &osym, isec);
       if (ret == 0)
 	return FALSE;
       else if (ret == 1)
@@ -10811,6 +11157,7 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
   for (o = input_bfd->sections; o != NULL; o = o->next)
     {
       bfd_byte *contents;
+      bfd_boolean ok;
 
       if (! o->linker_mark)
 	{
@@ -10913,7 +11260,10 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
       else
 	{
 	  contents = flinfo->contents;
-	  if (! bfd_get_full_section_contents (input_bfd, o, &contents))
+	  _bfd_elf_link_lock (flinfo->info);
+	  ok = bfd_get_full_section_contents (input_bfd, o, &contents);
+	  _bfd_elf_link_unlock (flinfo->info);
+	  if (!ok)
 	    return FALSE;
 	}
 
@@ -10925,9 +11275,11 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	  int ret;
 
 	  /* Get the swapped relocs.  */
+	  _bfd_elf_link_lock (flinfo->info);
 	  internal_relocs
 	    = _bfd_elf_link_read_relocs (input_bfd, o, flinfo->external_relocs,
 					 flinfo->internal_relocs, FALSE);
+	  _bfd_elf_link_unlock (flinfo->info);
 	  if (internal_relocs == NULL
 	      && o->reloc_count > 0)
 	    return FALSE;
@@ -11038,8 +11390,10 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 
 		  s_type = ELF_ST_TYPE (sym->st_info);
 		  ps = &flinfo->sections[r_symndx];
-		  sym_name = bfd_elf_sym_name (input_bfd, symtab_hdr,
-					       sym, *ps);
+		  /* Looking up a local symbol name is comparatively
+		     expensive and the name is only needed for complex
+		     relocs and diagnostics, so defer it until then.  */
+		  sym_name = NULL;
 		}
 
 	      if ((s_type == STT_RELC || s_type == STT_SRELC)
@@ -11048,6 +11402,10 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 		  bfd_vma val;
 		  bfd_vma dot = (rel->r_offset
 				 + o->output_offset + o->output_section->vma);
+
+		  if (sym_name == NULL)
+		    sym_name = bfd_elf_sym_name (input_bfd, symtab_hdr,
+						 isymbuf + r_symndx, *ps);
 #ifdef DEBUG
 		  printf ("Encountered a complex symbol!");
 		  printf (" (input_bfd %s, section %s, reloc %ld\n",
@@ -11075,7 +11433,13 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 		     discarded section.  */
 		  if ((sec = *ps) != NULL && discarded_section (sec))
 		    {
+		      asection *kept = NULL;
+
 		      BFD_ASSERT (r_symndx != STN_UNDEF);
+		      if (sym_name == NULL)
+			sym_name = bfd_elf_sym_name (input_bfd, symtab_hdr,
+						     isymbuf + r_symndx, sec);
+		      _bfd_elf_link_lock (flinfo->info);
 		      if (action_discarded & COMPLAIN)
 			(*flinfo->info->callbacks->einfo)
 			  /* xgettext:c-format */
@@ -11090,17 +11454,12 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 			 symbol here means we will be changing all later
 			 uses of the symbol, not just in this section.  */
 		      if (action_discarded & PRETEND)
-			{
-			  asection *kept;
-
-			  kept = _bfd_elf_check_kept_section (sec,
-							      flinfo->info);
-			  if (kept != NULL)
-			    {
-			      *ps = kept;
-			      continue;
-			    }
-			}
+			kept = _bfd_elf_check_kept_section (sec, flinfo->info);
+		      if (kept != NULL)
+			*ps = kept;
+		      _bfd_elf_link_unlock (flinfo->info);
+		      if (kept != NULL)
+			continue;
 		    }
 		}
 	    }
@@ -11397,77 +11756,11 @@ elf_link_input_bfd (struct elf_final_link_info *flinfo, bfd *input_bfd)
 	}
 
       /* Write out the modified section contents.  */
-      if (bed->elf_backend_write_section
-	  && (*bed->elf_backend_write_section) (output_bfd, flinfo->info, o,
-						contents))
-	{
-	  /* Section written out.  */
-	}
-      else switch (o->sec_info_type)
-	{
-	case SEC_INFO_TYPE_STABS:
-	  if (! (_bfd_write_section_stabs
-		 (output_bfd,
-		  &elf_hash_table (flinfo->info)->stab_info,
-		  o, &elf_section_data (o)->sec_info, contents)))
-	    return FALSE;
-	  break;
-	case SEC_INFO_TYPE_MERGE:
-	  if (! _bfd_write_merged_section (output_bfd, o,
-					   elf_section_data (o)->sec_info))
-	    return FALSE;
-	  break;
-	case SEC_INFO_TYPE_EH_FRAME:
-	  {
-	    if (! _bfd_elf_write_section_eh_frame (output_bfd, flinfo->info,
-						   o, contents))
-	      return FALSE;
-	  }
-	  break;
-	case SEC_INFO_TYPE_EH_FRAME_ENTRY:
-	  {
-	    if (! _bfd_elf_write_section_eh_frame_entry (output_bfd,
-							 flinfo->info,
-							 o, contents))
-	      return FALSE;
-	  }
-	  break;
-	default:
-	  {
-	    if (! (o->flags & SEC_EXCLUDE))
-	      {
-		file_ptr offset = (file_ptr) o->output_offset;
-		bfd_size_type todo = o->size;
-
-		offset *= bfd_octets_per_byte (output_bfd, o);
-
-		if ((o->flags & SEC_ELF_REVERSE_COPY))
-		  {
-		    /* Reverse-copy input section to output.  */
-		    do
-		      {
-			todo -= address_size;
-			if (! bfd_set_section_contents (output_bfd,
-							o->output_section,
-							contents + todo,
-							offset,
-							address_size))
-			  return FALSE;
-			if (todo == 0)
-			  break;
-			offset += address_size;
-		      }
-		    while (1);
-		  }
-		else if (! bfd_set_section_contents (output_bfd,
-						     o->output_section,
-						     contents,
-						     offset, todo))
-		  return FALSE;
-	      }
-	  }
-	  break;
-	}
+      _bfd_elf_link_lock (flinfo->info);
+      ok = elf_link_write_section (flinfo, o, contents, address_size);
+      _bfd_elf_link_unlock (flinfo->info);
+      if (!ok)
+	return FALSE;
     }
 
   return TRUE;
@@ -11890,13 +12183,82 @@ elf_output_implib (bfd *abfd, struct bfd_link_info *info)
   return ret;
 }
 
-static void
-elf_final_link_free (bfd *obfd, struct elf_final_link_info *flinfo)
+/* Allocate the buffers FLINFO uses to read in input files, given the
+   largest sizes needed.  */
+
+static bfd_boolean
+elf_final_link_alloc_buffers (struct elf_final_link_info *flinfo,
+			      bfd_size_type max_contents_size,
+			      bfd_size_type max_external_reloc_size,
+			      bfd_size_type max_internal_reloc_count,
+			      bfd_size_type max_sym_count,
+			      bfd_size_type max_sym_shndx_count)
 {
-  asection *o;
+  const struct elf_backend_data *bed
+    = get_elf_backend_data (flinfo->output_bfd);
+  bfd_size_type amt;
 
-  if (flinfo->symstrtab != NULL)
-    _bfd_elf_strtab_free (flinfo->symstrtab);
+  if (max_contents_size != 0)
+    {
+      flinfo->contents = (bfd_byte *) bfd_malloc (max_contents_size);
+      if (flinfo->contents == NULL)
+	return FALSE;
+    }
+
+  if (max_external_reloc_size != 0)
+    {
+      flinfo->external_relocs = bfd_malloc (max_external_reloc_size);
+      if (flinfo->external_relocs == NULL)
+	return FALSE;
+    }
+
+  if (max_internal_reloc_count != 0)
+    {
+      amt = max_internal_reloc_count * sizeof (Elf_Internal_Rela);
+      flinfo->internal_relocs = (Elf_Internal_Rela *) bfd_malloc (amt);
+      if (flinfo->internal_relocs == NULL)
+	return FALSE;
+    }
+
+  if (max_sym_count != 0)
+    {
+      amt = max_sym_count * bed->s->sizeof_sym;
+      flinfo->external_syms = (bfd_byte *) bfd_malloc (amt);
+      if (flinfo->external_syms == NULL)
+	return FALSE;
+
+      amt = max_sym_count * sizeof (Elf_Internal_Sym);
+      flinfo->internal_syms = (Elf_Internal_Sym *) bfd_malloc (amt);
+      if (flinfo->internal_syms == NULL)
+	return FALSE;
+
+      amt = max_sym_count * sizeof (long);
+      flinfo->indices = (long int *) bfd_malloc (amt);
+      if (flinfo->indices == NULL)
+	return FALSE;
+
+      amt = max_sym_count * sizeof (asection *);
+      flinfo->sections = (asection **) bfd_malloc (amt);
+      if (flinfo->sections == NULL)
+	return FALSE;
+    }
+
+  if (max_sym_shndx_count != 0)
+    {
+      amt = max_sym_shndx_count * sizeof (Elf_External_Sym_Shndx);
+      flinfo->locsym_shndx = (Elf_External_Sym_Shndx *) bfd_malloc (amt);
+      if (flinfo->locsym_shndx == NULL)
+	return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Free the buffers allocated by elf_final_link_alloc_buffers.  */
+
+static void
+elf_final_link_free_buffers (struct elf_final_link_info *flinfo)
+{
   free (flinfo->contents);
   free (flinfo->external_relocs);
   free (flinfo->internal_relocs);
@@ -11905,16 +12267,366 @@ elf_final_link_free (bfd *obfd, struct elf_final_link_info *flinfo)
   free (flinfo->internal_syms);
   free (flinfo->indices);
   free (flinfo->sections);
-  if (flinfo->symshndxbuf != (Elf_External_Sym_Shndx *) -1)
-    free (flinfo->symshndxbuf);
-  for (o = obfd->sections; o != NULL; o = o->next)
-    {
-      struct bfd_elf_section_data *esdo = elf_section_data (o);
-      free (esdo->rel.hashes);
+}
+
+static void
+elf_final_link_free (bfd *obfd, struct elf_final_link_info *flinfo)
+{
+  asection *o;
+
+  if (flinfo->symstrtab != NULL)
+    _bfd_elf_strtab_free (flinfo->symstrtab);
+  elf_final_link_free_buffers (flinfo);
+  if (flinfo->symshndxbuf != (Elf_External_Sym_Shndx *) -1)
+    free (flinfo->symshndxbuf);
+  for (o = obfd->sections; o != NULL; o = o->next)
+    {
+      struct bfd_elf_section_data *esdo = elf_section_data (o);
+      free (esdo->rel.hashes);
       free (esdo->rela.hashes);
     }
 }
 
+#ifdef HAVE_PTHREAD
+
+/* State shared by the threads relocating input files in parallel.  */
+
+struct elf_link_threads
+{
+  /* Serializes everything not private to one input file.  It is
+     recursive since the linker callbacks take it too.  */
+  pthread_mutex_t lock;
+  /* The input files, in link order, and their local symbols.  */
+  bfd **bfds;
+  struct elf_deferred_syms *deferred_syms;
+  size_t count;
+  /* Index in BFDS of the next input file to link.  */
+  size_t next;
+  /* Set if linking an input file failed, along with the error.  */
+  bfd_boolean failed;
+  bfd_error_type error;
+  /* The linker callbacks, and a copy of them calling the ones made
+     while relocating with LOCK held.  */
+  const struct bfd_link_callbacks *callbacks;
+  struct bfd_link_callbacks locked_callbacks;
+};
+
+/* One of those threads.  */
+
+struct elf_link_thread
+{
+  struct elf_final_link_info flinfo;
+  struct elf_link_threads *threads;
+  pthread_t id;
+};
+
+/* The bfd error handler of the link, and the lock held around it.  */
+
+static bfd_error_handler_type elf_link_error_handler;
+static pthread_mutex_t *elf_link_error_lock;
+
+static void
+elf_link_locked_error_handler (const char *fmt, va_list ap)
+{
+  pthread_mutex_lock (elf_link_error_lock);
+  (*elf_link_error_handler) (fmt, ap);
+  pthread_mutex_unlock (elf_link_error_lock);
+}
+
+static void
+elf_link_locked_warning (struct bfd_link_info *info, const char *warning,
+			 const char *symbol, bfd *abfd, asection *section,
+			 bfd_vma address)
+{
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  pthread_mutex_lock (&threads->lock);
+  threads->callbacks->warning (info, warning, symbol, abfd, section,
+			       address);
+  pthread_mutex_unlock (&threads->lock);
+}
+
+static void
+elf_link_locked_undefined_symbol (struct bfd_link_info *info,
+				  const char *name, bfd *abfd,
+				  asection *section, bfd_vma address,
+				  bfd_boolean is_fatal)
+{
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  pthread_mutex_lock (&threads->lock);
+  threads->callbacks->undefined_symbol (info, name, abfd, section, address,
+					is_fatal);
+  pthread_mutex_unlock (&threads->lock);
+}
+
+static void
+elf_link_locked_reloc_overflow (struct bfd_link_info *info,
+				struct bfd_link_hash_entry *entry,
+				const char *name, const char *reloc_name,
+				bfd_vma addend, bfd *abfd, asection *section,
+				bfd_vma address)
+{
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  pthread_mutex_lock (&threads->lock);
+  threads->callbacks->reloc_overflow (info, entry, name, reloc_name, addend,
+				      abfd, section, address);
+  pthread_mutex_unlock (&threads->lock);
+}
+
+static void
+elf_link_locked_reloc_dangerous (struct bfd_link_info *info,
+				 const char *message, bfd *abfd,
+				 asection *section, bfd_vma address)
+{
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  pthread_mutex_lock (&threads->lock);
+  threads->callbacks->reloc_dangerous (info, message, abfd, section,
+				       address);
+  pthread_mutex_unlock (&threads->lock);
+}
+
+static void
+elf_link_locked_unattached_reloc (struct bfd_link_info *info,
+				  const char *name, bfd *abfd,
+				  asection *section, bfd_vma address)
+{
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  pthread_mutex_lock (&threads->lock);
+  threads->callbacks->unattached_reloc (info, name, abfd, section, address);
+  pthread_mutex_unlock (&threads->lock);
+}
+
+/* Link input files until none are left or one fails.  */
+
+static void *
+elf_link_input_thread (void *arg)
+{
+  struct elf_link_thread *thread = (struct elf_link_thread *) arg;
+  struct elf_link_threads *threads = thread->threads;
+
+  for (;;)
+    {
+      size_t i;
+
+      pthread_mutex_lock (&threads->lock);
+      if (threads->failed || threads->next >= threads->count)
+	{
+	  pthread_mutex_unlock (&threads->lock);
+	  break;
+	}
+      i = threads->next++;
+      pthread_mutex_unlock (&threads->lock);
+
+      thread->flinfo.deferred_syms = &threads->deferred_syms[i];
+      if (!elf_link_input_bfd (&thread->flinfo, threads->bfds[i]))
+	{
+	  pthread_mutex_lock (&threads->lock);
+	  if (!threads->failed)
+	    {
+	      threads->failed = TRUE;
+	      threads->error = bfd_get_error ();
+	    }
+	  pthread_mutex_unlock (&threads->lock);
+	  break;
+	}
+    }
+  return NULL;
+}
+
+/* Link the COUNT input files BFDS with NTHREADS threads, each with
+   its own buffers of the given sizes, then output their local symbols
+   in link order as elf_link_input_bfd does when linking serially.  */
+
+static bfd_boolean
+elf_link_input_bfds_threaded (struct elf_final_link_info *flinfo,
+			      bfd **bfds, size_t count,
+			      unsigned int nthreads,
+			      bfd_size_type max_contents_size,
+			      bfd_size_type max_external_reloc_size,
+			      bfd_size_type max_internal_reloc_count,
+			      bfd_size_type max_sym_count,
+			      bfd_size_type max_sym_shndx_count)
+{
+  struct bfd_link_info *info = flinfo->info;
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  struct elf_link_threads threads;
+  struct elf_link_thread *thread;
+  pthread_mutexattr_t attr;
+  unsigned int i, started;
+  size_t j, k;
+  bfd_boolean ret = FALSE;
+  int err;
+
+  memset (&threads, 0, sizeof (threads));
+  threads.bfds = bfds;
+  threads.count = count;
+  threads.deferred_syms = (struct elf_deferred_syms *)
+    bfd_zmalloc (count * sizeof (*threads.deferred_syms));
+  thread = (struct elf_link_thread *) bfd_zmalloc (nthreads
+						    * sizeof (*thread));
+  if (threads.deferred_syms == NULL || thread == NULL)
+    goto out;
+
+  for (i = 0; i < nthreads; i++)
+    {
+      thread[i].threads = &threads;
+      thread[i].flinfo.info = info;
+      thread[i].flinfo.output_bfd = flinfo->output_bfd;
+      thread[i].flinfo.symstrtab = flinfo->symstrtab;
+      thread[i].flinfo.symshndxbuf = flinfo->symshndxbuf;
+      if (!elf_final_link_alloc_buffers (&thread[i].flinfo,
+					 max_contents_size,
+					 max_external_reloc_size,
+					 max_internal_reloc_count,
+					 max_sym_count, max_sym_shndx_count))
+	goto out;
+    }
+
+  if (pthread_mutexattr_init (&attr) != 0)
+    goto out;
+  err = pthread_mutexattr_settype (&attr, PTHREAD_MUTEX_RECURSIVE);
+  if (err == 0)
+    err = pthread_mutex_init (&threads.lock, &attr);
+  pthread_mutexattr_destroy (&attr);
+  if (err != 0)
+    goto out;
+
+  threads.callbacks = info->callbacks;
+  threads.locked_callbacks = *info->callbacks;
+  threads.locked_callbacks.warning = elf_link_locked_warning;
+  threads.locked_callbacks.undefined_symbol
+    = elf_link_locked_undefined_symbol;
+  threads.locked_callbacks.reloc_overflow = elf_link_locked_reloc_overflow;
+  threads.locked_callbacks.reloc_dangerous = elf_link_locked_reloc_dangerous;
+  threads.locked_callbacks.unattached_reloc
+    = elf_link_locked_unattached_reloc;
+  info->callbacks = &threads.locked_callbacks;
+  elf_link_error_lock = &threads.lock;
+  elf_link_error_handler
+    = bfd_set_error_handler (elf_link_locked_error_handler);
+  htab->link_threads = &threads;
+
+  /* This thread links input files too.  If starting another thread
+     fails, make do with those already started.  */
+  for (started = 1; started < nthreads; started++)
+    if (pthread_create (&thread[started].id, NULL, elf_link_input_thread,
+			&thread[started]) != 0)
+      break;
+  elf_link_input_thread (&thread[0]);
+  for (i = 1; i < started; i++)
+    pthread_join (thread[i].id, NULL);
+
+  htab->link_threads = NULL;
+  bfd_set_error_handler (elf_link_error_handler);
+  info->callbacks = threads.callbacks;
+  pthread_mutex_destroy (&threads.lock);
+
+  if (threads.failed)
+    {
+      bfd_set_error (threads.error);
+      goto out;
+    }
+
+  for (j = 0; j < count; j++)
+    for (k = 0; k < threads.deferred_syms[j].count; k++)
+      {
+	struct elf_deferred_sym *ent = threads.deferred_syms[j].syms + k;
+
+	if (!elf_link_output_symstrtab (flinfo, ent->name, &ent->sym,
+					ent->isec, NULL))
+	  goto out;
+      }
+  for (i = 0; i < nthreads; i++)
+    flinfo->filesym_count += thread[i].flinfo.filesym_count;
+  ret = TRUE;
+
+ out:
+  if (threads.deferred_syms != NULL)
+    for (j = 0; j < count; j++)
+      free (threads.deferred_syms[j].syms);
+  free (threads.deferred_syms);
+  if (thread != NULL)
+    for (i = 0; i < nthreads; i++)
+      elf_final_link_free_buffers (&thread[i].flinfo);
+  free (thread);
+  return ret;
+}
+
+#endif /* HAVE_PTHREAD */
+
+/* Return the number of threads to relocate the input files of the
+   final link described by INFO with, or one if it has to be done
+   serially.  */
+
+static unsigned int
+elf_link_thread_count (bfd *abfd ATTRIBUTE_UNUSED,
+		       struct bfd_link_info *info ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_PTHREAD
+  const struct elf_backend_data *bed = get_elf_backend_data (abfd);
+  long count = info->thread_count;
+
+  /* Relocatable links and --emit-relocs output the input relocs along
+     with each input file, --wrap and LTO plugins change symbols while
+     relocating, and dynamic relocs are added in whatever order input
+     files are relocated so they need sorting for the output to be
+     reproducible.  */
+  if (count == 0
+      || count == 1
+      || !bed->threaded_relocate_section
+      || bfd_link_relocatable (info)
+      || info->emitrelocations
+      || info->wrap_hash != NULL
+      || info->lto_plugin_active
+      || (elf_hash_table (info)->dynamic_sections_created
+	  && !info->combreloc))
+    return 1;
+
+  if (count < 0)
+    {
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+      count = sysconf (_SC_NPROCESSORS_ONLN);
+#else
+      count = 1;
+#endif
+    }
+  return count > 1 ? count : 1;
+#else
+  return 1;
+#endif
+}
+
+/* Serialize access to link state shared between input files while
+   they are relocated in parallel.  */
+
+void
+_bfd_elf_link_lock (struct bfd_link_info *info ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_PTHREAD
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  if (threads != NULL)
+    pthread_mutex_lock (&threads->lock);
+#endif
+}
+
+void
+_bfd_elf_link_unlock (struct bfd_link_info *info ATTRIBUTE_UNUSED)
+{
+#ifdef HAVE_PTHREAD
+  struct elf_link_threads *threads = elf_hash_table (info)->link_threads;
+
+  if (threads != NULL)
+    pthread_mutex_unlock (&threads->lock);
+#endif
+}
+
+static bfd_boolean elf_relr_finish (bfd *, struct bfd_link_info *);
+
 /* Do the final step of an ELF link.  */
 
 bfd_boolean
@@ -11947,6 +12659,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
   const char *std_attrs_section;
   struct elf_link_hash_table *htab = elf_hash_table (info);
   bfd_boolean sections_removed;
+  unsigned int nthreads;
+  size_t input_count;
+  bfd **input_bfds = NULL;
 
   if (!is_elf_hash_table (htab))
     return FALSE;
@@ -11989,6 +12704,7 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
   flinfo.sections = NULL;
   flinfo.symshndxbuf = NULL;
   flinfo.filesym_count = 0;
+  flinfo.deferred_syms = NULL;
 
   /* The object attributes have been merged.  Remove the input
      sections from the link, and set the contents of the output
@@ -12317,58 +13033,11 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
 
   /* Allocate some memory to hold information read in from the input
      files.  */
-  if (max_contents_size != 0)
-    {
-      flinfo.contents = (bfd_byte *) bfd_malloc (max_contents_size);
-      if (flinfo.contents == NULL)
-	goto error_return;
-    }
-
-  if (max_external_reloc_size != 0)
-    {
-      flinfo.external_relocs = bfd_malloc (max_external_reloc_size);
-      if (flinfo.external_relocs == NULL)
-	goto error_return;
-    }
-
-  if (max_internal_reloc_count != 0)
-    {
-      amt = max_internal_reloc_count * sizeof (Elf_Internal_Rela);
-      flinfo.internal_relocs = (Elf_Internal_Rela *) bfd_malloc (amt);
-      if (flinfo.internal_relocs == NULL)
-	goto error_return;
-    }
-
-  if (max_sym_count != 0)
-    {
-      amt = max_sym_count * bed->s->sizeof_sym;
-      flinfo.external_syms = (bfd_byte *) bfd_malloc (amt);
-      if (flinfo.external_syms == NULL)
-	goto error_return;
-
-      amt = max_sym_count * sizeof (Elf_Internal_Sym);
-      flinfo.internal_syms = (Elf_Internal_Sym *) bfd_malloc (amt);
-      if (flinfo.internal_syms == NULL)
-	goto error_return;
-
-      amt = max_sym_count * sizeof (long);
-      flinfo.indices = (long int *) bfd_malloc (amt);
-      if (flinfo.indices == NULL)
-	goto error_return;
-
-      amt = max_sym_count * sizeof (asection *);
-      flinfo.sections = (asection **) bfd_malloc (amt);
-      if (flinfo.sections == NULL)
-	goto error_return;
-    }
-
-  if (max_sym_shndx_count != 0)
-    {
-      amt = max_sym_shndx_count * sizeof (Elf_External_Sym_Shndx);
-      flinfo.locsym_shndx = (Elf_External_Sym_Shndx *) bfd_malloc (amt);
-      if (flinfo.locsym_shndx == NULL)
-	goto error_return;
-    }
+  if (!elf_final_link_alloc_buffers (&flinfo, max_contents_size,
+				     max_external_reloc_size,
+				     max_internal_reloc_count,
+				     max_sym_count, max_sym_shndx_count))
+    goto error_return;
 
   if (htab->tls_sec)
     {
@@ -12430,8 +13099,22 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
      we could write the relocs out and then read them again; I don't
      know how bad the memory loss will be.  */
 
+  /* When relocating input files in parallel, just collect them here
+     in link order.  */
+  nthreads = elf_link_thread_count (abfd, info);
+  input_count = 0;
   for (sub = info->input_bfds; sub != NULL; sub = sub->link.next)
-    sub->output_has_begun = FALSE;
+    {
+      sub->output_has_begun = FALSE;
+      input_count++;
+    }
+  if (nthreads > 1)
+    {
+      input_bfds = (bfd **) bfd_malloc (input_count * sizeof (bfd *));
+      if (input_bfds == NULL)
+	goto error_return;
+    }
+  input_count = 0;
   for (o = abfd->sections; o != NULL; o = o->next)
     {
       for (p = o->map_head.link_order; p != NULL; p = p->next)
@@ -12443,7 +13126,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
 	    {
 	      if (! sub->output_has_begun)
 		{
-		  if (! elf_link_input_bfd (&flinfo, sub))
+		  if (input_bfds != NULL)
+		    input_bfds[input_count++] = sub;
+		  else if (! elf_link_input_bfd (&flinfo, sub))
 		    goto error_return;
 		  sub->output_has_begun = TRUE;
 		}
@@ -12495,6 +13180,24 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
 	}
     }
 
+#ifdef HAVE_PTHREAD
+  if (input_bfds != NULL)
+    {
+      if (nthreads > input_count)
+	nthreads = input_count;
+      if (input_count != 0
+	  && !elf_link_input_bfds_threaded (&flinfo, input_bfds, input_count,
+					    nthreads, max_contents_size,
+					    max_external_reloc_size,
+					    max_internal_reloc_count,
+					    max_sym_count,
+					    max_sym_shndx_count))
+	goto error_return;
+      free (input_bfds);
+      input_bfds = NULL;
+    }
+#endif
+
   /* Free symbol buffer if needed.  */
   if (!info->reduce_memory_overheads)
     {
@@ -12731,6 +13434,9 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
   if (dynamic && info->combreloc && dynobj != NULL)
     relativecount = elf_link_sort_relocs (abfd, info, &reldyn);
 
+  if (htab->relr_count != 0 && !elf_relr_finish (abfd, info))
+    goto error_return;
+
   /* If we are linking against a dynamic object, or generating a
      shared library, finish up the dynamic linking information.  */
   if (dynamic)
@@ -12875,6 +13581,14 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
 	      dyn.d_un.d_ptr = o->output_section->vma + o->output_offset;
 	      break;
 
+	    case DT_RELR:
+	      o = htab->srelrdyn;
+	      name = ".relr.dyn";
+	      goto do_vma;
+	    case DT_RELRSZ:
+	      dyn.d_un.d_val = htab->srelrdyn->size;
+	      break;
+
 	    case DT_REL:
 	    case DT_RELA:
 	    case DT_RELSZ:
@@ -13049,6 +13763,7 @@ bfd_elf_final_link (bfd *abfd, struct bfd_link_info *info)
   return TRUE;
 
  error_return:
+  free (input_bfds);
   elf_final_link_free (abfd, &flinfo);
   return FALSE;
 }
@@ -14948,6 +15663,14 @@ _bfd_elf_add_dynamic_tags (bfd *output_bfd, struct bfd_link_info *info,
 	      || !add_dynamic_entry (DT_TLSDESC_GOT, 0)))
 	return FALSE;
 
+      if (htab->srelrdyn != NULL && htab->relr_count != 0)
+	{
+	  if (!add_dynamic_entry (DT_RELR, 0)
+	      || !add_dynamic_entry (DT_RELRSZ, 0)
+	      || !add_dynamic_entry (DT_RELRENT, bed->s->arch_size / 8))
+	    return FALSE;
+	}
+
       if (need_dynamic_reloc)
 	{
 	  if (bed->rela_plts_and_copies_p)
@@ -14990,3 +15713,453 @@ _bfd_elf_add_dynamic_tags (bfd *output_bfd, struct bfd_link_info *info,
 
   return TRUE;
 }
+
+/* Create the .relr.dyn section in DYNOBJ, which holds the relative
+   relocations packed for DT_RELR when -z pack-relative-relocs is
+   used.  */
+
+bfd_boolean
+_bfd_elf_create_relr_section (bfd *dynobj, struct bfd_link_info *info)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  const struct elf_backend_data *bed = get_elf_backend_data (dynobj);
+  asection *s;
+
+  /* Only position independent output has relative relocations.  */
+  if (!info->enable_dt_relr
+      || !bfd_link_pic (info)
+      || htab->srelrdyn != NULL)
+    return TRUE;
+
+  s = bfd_make_section_anyway_with_flags (dynobj, ".relr.dyn",
+					  (bed->dynamic_sec_flags
+					   | SEC_READONLY));
+  if (s == NULL
+      || !bfd_set_section_alignment (s, bed->s->log_file_align))
+    return FALSE;
+  elf_section_type (s) = SHT_RELR;
+  htab->srelrdyn = s;
+  return TRUE;
+}
+
+/* Sort packed relative relocations by input section and offset.  */
+
+static int
+elf_relr_entry_cmp (const void *a, const void *b)
+{
+  const struct elf_relr_entry *ea = (const struct elf_relr_entry *) a;
+  const struct elf_relr_entry *eb = (const struct elf_relr_entry *) b;
+
+  if (ea->sec->id != eb->sec->id)
+    return ea->sec->id < eb->sec->id ? -1 : 1;
+  if (ea->offset != eb->offset)
+    return ea->offset < eb->offset ? -1 : 1;
+  return 0;
+}
+
+/* Scan the relocations of the input files for word sized relocations
+   which relocate_section will turn into relative dynamic relocations,
+   and move them from the dynamic reloc sections they were counted in
+   to .relr.dyn.  RELATIVE_P is called for each candidate, with H the
+   symbol or NULL for a local symbol, and returns TRUE if the backend
+   will emit a relative relocation for it.  Only relocations in
+   aligned writable data sections against symbols defined in the
+   output are considered; the backend must call _bfd_elf_relr_use for
+   each of them in relocate_section.  This is called from
+   size_dynamic_sections before the dynamic sections are sized.  */
+
+bfd_boolean
+_bfd_elf_relr_scan (bfd *output_bfd, struct bfd_link_info *info,
+		    bfd_boolean (*relative_p) (struct bfd_link_info *,
+					       const Elf_Internal_Rela *,
+					       struct elf_link_hash_entry *))
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  const struct elf_backend_data *bed = get_elf_backend_data (output_bfd);
+  unsigned int wordsize = bed->s->arch_size / 8;
+  unsigned int r_sym_shift = bed->s->arch_size == 32 ? 8 : 32;
+  bfd_size_type relsize = (bed->default_use_rela_p
+			   ? bed->s->sizeof_rela : bed->s->sizeof_rel);
+  bfd *ibfd;
+
+  if (htab->srelrdyn == NULL)
+    return TRUE;
+
+  for (ibfd = info->input_bfds; ibfd != NULL; ibfd = ibfd->link.next)
+    {
+      Elf_Internal_Shdr *symtab_hdr;
+      Elf_Internal_Sym *isymbuf = NULL;
+      struct elf_link_hash_entry **sym_hashes;
+      asection *sec;
+
+      if ((ibfd->flags & DYNAMIC) != 0
+	  || bfd_get_flavour (ibfd) != bfd_target_elf_flavour
+	  || elf_object_id (ibfd) != htab->hash_table_id)
+	continue;
+
+      symtab_hdr = &elf_symtab_hdr (ibfd);
+      sym_hashes = elf_sym_hashes (ibfd);
+
+      for (sec = ibfd->sections; sec != NULL; sec = sec->next)
+	{
+	  Elf_Internal_Rela *relocs, *rel, *relend;
+	  asection *sreloc = elf_section_data (sec)->sreloc;
+
+	  if ((sec->flags & (SEC_ALLOC | SEC_RELOC | SEC_READONLY
+			     | SEC_CODE | SEC_EXCLUDE))
+	      != (SEC_ALLOC | SEC_RELOC)
+	      || sec->reloc_count == 0
+	      || sreloc == NULL
+	      || sec->sec_info_type != SEC_INFO_TYPE_NONE
+	      || discarded_section (sec)
+	      || (1u << sec->alignment_power) < wordsize)
+	    continue;
+
+	  relocs = _bfd_elf_link_read_relocs (ibfd, sec, NULL, NULL,
+					      info->keep_memory);
+	  if (relocs == NULL)
+	    goto error_return;
+
+	  relend = relocs + sec->reloc_count;
+	  for (rel = relocs; rel < relend; rel++)
+	    {
+	      unsigned long r_symndx = rel->r_info >> r_sym_shift;
+	      struct elf_link_hash_entry *h = NULL;
+	      struct elf_relr_entry *ent;
+
+	      /* Some targets combine relocations at the same offset.  */
+	      if (rel->r_offset % wordsize != 0
+		  || (rel + 1 < relend && rel[1].r_offset == rel->r_offset)
+		  || (rel > relocs && rel[-1].r_offset == rel->r_offset))
+		continue;
+
+	      if (r_symndx < symtab_hdr->sh_info)
+		{
+		  Elf_Internal_Sym *isym;
+		  asection *sym_sec;
+
+		  if (isymbuf == NULL)
+		    {
+		      isymbuf = (Elf_Internal_Sym *) symtab_hdr->contents;
+		      if (isymbuf == NULL)
+			isymbuf = bfd_elf_get_elf_syms (ibfd, symtab_hdr,
+							symtab_hdr->sh_info,
+							0, NULL, NULL, NULL);
+		      if (isymbuf == NULL)
+			goto error_free_relocs;
+		    }
+		  isym = isymbuf + r_symndx;
+		  if (ELF_ST_TYPE (isym->st_info) == STT_GNU_IFUNC)
+		    continue;
+		  sym_sec = bfd_section_from_elf_index (ibfd, isym->st_shndx);
+		  if (sym_sec == NULL || discarded_section (sym_sec))
+		    continue;
+		}
+	      else
+		{
+		  h = sym_hashes[r_symndx - symtab_hdr->sh_info];
+		  if (h == NULL)
+		    continue;
+		  while (h->root.type == bfd_link_hash_indirect
+			 || h->root.type == bfd_link_hash_warning)
+		    h = (struct elf_link_hash_entry *) h->root.u.i.link;
+		  if ((h->root.type != bfd_link_hash_defined
+		       && h->root.type != bfd_link_hash_defweak)
+		      || h->type == STT_GNU_IFUNC
+		      || bfd_is_abs_section (h->root.u.def.section)
+		      || discarded_section (h->root.u.def.section))
+		    continue;
+		}
+
+	      if (!relative_p (info, rel, h))
+		continue;
+
+	      if (sreloc->size < relsize)
+		{
+		  _bfd_error_handler
+		    /* xgettext:c-format */
+		    (_("%pB(%pA+%#" PRIx64 "): packed relative relocation "
+		       "was not counted as a dynamic relocation"),
+		     ibfd, sec, (uint64_t) rel->r_offset);
+		  bfd_set_error (bfd_error_bad_value);
+		  goto error_free_relocs;
+		}
+	      sreloc->size -= relsize;
+
+	      if (htab->relr_count == htab->relr_alloc)
+		{
+		  bfd_size_type alloc = htab->relr_alloc * 2 + 64;
+		  ent = (struct elf_relr_entry *)
+		    bfd_realloc (htab->relr, alloc * sizeof (*ent));
+		  if (ent == NULL)
+		    goto error_free_relocs;
+		  htab->relr = ent;
+		  htab->relr_alloc = alloc;
+		}
+	      ent = htab->relr + htab->relr_count++;
+	      ent->sec = sec;
+	      ent->offset = rel->r_offset;
+	      ent->used = FALSE;
+	    }
+
+	  if (elf_section_data (sec)->relocs != relocs)
+	    free (relocs);
+	  continue;
+
+	error_free_relocs:
+	  if (elf_section_data (sec)->relocs != relocs)
+	    free (relocs);
+	  goto error_return;
+	}
+
+      if (isymbuf != NULL && symtab_hdr->contents != (unsigned char *) isymbuf)
+	{
+	  if (info->keep_memory)
+	    symtab_hdr->contents = (unsigned char *) isymbuf;
+	  else
+	    free (isymbuf);
+	}
+      continue;
+
+    error_return:
+      if (isymbuf != NULL
+	  && symtab_hdr->contents != (unsigned char *) isymbuf)
+	free (isymbuf);
+      return FALSE;
+    }
+
+  if (htab->relr_count == 0)
+    {
+      htab->srelrdyn->flags |= SEC_EXCLUDE;
+      return TRUE;
+    }
+
+  qsort (htab->relr, htab->relr_count, sizeof (*htab->relr),
+	 elf_relr_entry_cmp);
+  return TRUE;
+}
+
+/* Return TRUE if the relative relocation at OFFSET in input section
+   SEC was packed into DT_RELR, in which case relocate_section should
+   write the relocated value but not emit a dynamic relocation.  */
+
+bfd_boolean
+_bfd_elf_relr_use (struct bfd_link_info *info, asection *sec,
+		   bfd_vma offset)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  struct elf_relr_entry key;
+  bfd_size_type lo, hi;
+
+  if (htab->relr_count == 0)
+    return FALSE;
+
+  key.sec = sec;
+  key.offset = offset;
+  lo = 0;
+  hi = htab->relr_count;
+  while (lo < hi)
+    {
+      bfd_size_type mid = lo + (hi - lo) / 2;
+
+      if (elf_relr_entry_cmp (htab->relr + mid, &key) < 0)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+  /* Two relocations at the same offset have an entry each.  */
+  for (; lo < htab->relr_count; lo++)
+    {
+      struct elf_relr_entry *ent = htab->relr + lo;
+
+      if (ent->sec != sec || ent->offset != offset)
+	return FALSE;
+      if (!ent->used)
+	{
+	  ent->used = TRUE;
+	  return TRUE;
+	}
+    }
+  return FALSE;
+}
+
+static int
+elf_relr_vma_cmp (const void *a, const void *b)
+{
+  bfd_vma va = *(const bfd_vma *) a;
+  bfd_vma vb = *(const bfd_vma *) b;
+
+  return va < vb ? -1 : va > vb;
+}
+
+/* Return the sorted, distinct output addresses of the packed relative
+   relocations in a malloc'd array, storing their number in *COUNT.  */
+
+static bfd_vma *
+elf_relr_addresses (struct bfd_link_info *info, unsigned int wordsize,
+		    bfd_size_type *count)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  bfd_vma *addr;
+  bfd_size_type i, n;
+
+  addr = (bfd_vma *) bfd_malloc (htab->relr_count * sizeof (*addr));
+  if (addr == NULL)
+    return NULL;
+
+  for (i = 0; i < htab->relr_count; i++)
+    {
+      struct elf_relr_entry *ent = htab->relr + i;
+
+      addr[i] = (ent->sec->output_section->vma + ent->sec->output_offset
+		 + ent->offset);
+      if (addr[i] % wordsize != 0)
+	{
+	  _bfd_error_handler
+	    /* xgettext:c-format */
+	    (_("%pB(%pA+%#" PRIx64 "): packed relative relocation is not "
+	       "aligned"), ent->sec->owner, ent->sec, (uint64_t) ent->offset);
+	  bfd_set_error (bfd_error_bad_value);
+	  free (addr);
+	  return NULL;
+	}
+    }
+
+  qsort (addr, htab->relr_count, sizeof (*addr), elf_relr_vma_cmp);
+  n = 0;
+  for (i = 0; i < htab->relr_count; i++)
+    if (n == 0 || addr[i] != addr[n - 1])
+      addr[n++] = addr[i];
+  *count = n;
+  return addr;
+}
+
+/* Encode the COUNT sorted addresses ADDR as DT_RELR entries of
+   WORDSIZE bytes into BUF, or just count them if BUF is NULL.  An
+   address entry is followed by bitmap entries with the low bit set,
+   each covering the next WORDSIZE * 8 - 1 words.  Return the number
+   of entries.  */
+
+static bfd_size_type
+elf_relr_encode (bfd *abfd, const bfd_vma *addr, bfd_size_type count,
+		 unsigned int wordsize, bfd_byte *buf)
+{
+  bfd_vma nbits = wordsize * 8 - 1;
+  bfd_size_type i = 0, n = 0;
+
+  while (i < count)
+    {
+      bfd_vma base = addr[i];
+
+      if (buf != NULL)
+	bfd_put (wordsize * 8, abfd, base, buf + n * wordsize);
+      n++;
+      i++;
+      base += wordsize;
+
+      for (;;)
+	{
+	  bfd_vma bitmap = 0;
+	  bfd_size_type j;
+
+	  for (j = i; j < count && addr[j] - base < nbits * wordsize; j++)
+	    bitmap |= (bfd_vma) 1 << ((addr[j] - base) / wordsize);
+	  if (j == i)
+	    break;
+	  if (buf != NULL)
+	    bfd_put (wordsize * 8, abfd, (bitmap << 1) | 1,
+		     buf + n * wordsize);
+	  n++;
+	  i = j;
+	  base += nbits * wordsize;
+	}
+    }
+  return n;
+}
+
+/* Size .relr.dyn for the current layout.  The section only grows, so
+   that the layout loop converges; set *NEED_LAYOUT if it did.  */
+
+bfd_boolean
+_bfd_elf_size_relative_relocs (struct bfd_link_info *info,
+			       bfd_boolean *need_layout)
+{
+  struct elf_link_hash_table *htab;
+  unsigned int wordsize;
+  bfd_size_type count, size;
+  bfd_vma *addr;
+
+  if (!is_elf_hash_table (info->hash))
+    return TRUE;
+  htab = elf_hash_table (info);
+  if (htab->srelrdyn == NULL || htab->relr_count == 0)
+    return TRUE;
+
+  wordsize = get_elf_backend_data (info->output_bfd)->s->arch_size / 8;
+  addr = elf_relr_addresses (info, wordsize, &count);
+  if (addr == NULL)
+    return FALSE;
+  size = elf_relr_encode (info->output_bfd, addr, count, wordsize, NULL);
+  free (addr);
+
+  size *= wordsize;
+  if (size > htab->srelrdyn->size)
+    {
+      htab->srelrdyn->size = size;
+      *need_layout = TRUE;
+    }
+  return TRUE;
+}
+
+/* Write the contents of .relr.dyn, padding unused space with empty
+   bitmap entries.  */
+
+static bfd_boolean
+elf_relr_finish (bfd *abfd, struct bfd_link_info *info)
+{
+  struct elf_link_hash_table *htab = elf_hash_table (info);
+  asection *s = htab->srelrdyn;
+  unsigned int wordsize = get_elf_backend_data (abfd)->s->arch_size / 8;
+  bfd_size_type i, count, n;
+  bfd_vma *addr;
+
+  for (i = 0; i < htab->relr_count; i++)
+    if (!htab->relr[i].used)
+      {
+	struct elf_relr_entry *ent = htab->relr + i;
+
+	_bfd_error_handler
+	  /* xgettext:c-format */
+	  (_("%pB(%pA+%#" PRIx64 "): packed relative relocation was not "
+	     "applied"), ent->sec->owner, ent->sec, (uint64_t) ent->offset);
+	bfd_set_error (bfd_error_bad_value);
+	return FALSE;
+      }
+
+  addr = elf_relr_addresses (info, wordsize, &count);
+  if (addr == NULL)
+    return FALSE;
+
+  n = elf_relr_encode (abfd, addr, count, wordsize, NULL);
+  if (n * wordsize > s->size)
+    {
+      _bfd_error_handler (_("%pB: .relr.dyn section is too small"), abfd);
+      bfd_set_error (bfd_error_bad_value);
+      free (addr);
+      return FALSE;
+    }
+
+  s->contents = (bfd_byte *) bfd_zalloc (s->owner, s->size);
+  if (s->contents == NULL)
+    {
+      free (addr);
+      return FALSE;
+    }
+
+  elf_relr_encode (abfd, addr, count, wordsize, s->contents);
+  free (addr);
+  for (; n * wordsize < s->size; n++)
+    bfd_put (wordsize * 8, abfd, 1, s->contents + n * wordsize);
+  return TRUE;
+}
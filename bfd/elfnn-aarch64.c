@@ -5765,6 +5765,12 @@ elfNN_aarch64_final_link_relocate (reloc_howto_type *howto,
 		       || !(bfd_link_pie (info) || SYMBOLIC_BIND (info, h))
 		       || !h->def_regular))
 	    outrel.r_info = ELFNN_R_INFO (h->dynindx, r_type);
+	  else if (_bfd_elf_relr_use (info, input_section, rel->r_offset))
+	    /* A relocation packed into DT_RELR has no addend, so it is
+	       always applied to the section contents.  */
+	    return _bfd_final_link_relocate (howto, input_bfd, input_section,
+					     contents, rel->r_offset, value,
+					     signed_addend);
 	  else
 	    {
 	      int symbol;
@@ -8462,7 +8468,7 @@ elfNN_aarch64_bfd_free_cached_info (bfd *abfd)
     bfd_map_over_sections (abfd,
 			   unrecord_section_via_map_over_sections, NULL);
 
-  return _bfd_free_cached_info (abfd);
+  return _bfd_elf_free_cached_info (abfd);
 }
 
 /* Create dynamic sections. This is different from the ARM backend in that
@@ -8477,9 +8483,33 @@ elfNN_aarch64_create_dynamic_sections (bfd *dynobj,
   if (!aarch64_elf_create_got_section (dynobj, info))
     return FALSE;
 
+  if (!_bfd_elf_create_relr_section (dynobj, info))
+    return FALSE;
+
   return _bfd_elf_create_dynamic_sections (dynobj, info);
 }
 
+/* Return TRUE if elfNN_aarch64_final_link_relocate turns REL against H,
+   or a local symbol if H is NULL, into an R_AARCH64_RELATIVE dynamic
+   reloc.  */
+
+static bfd_boolean
+elfNN_aarch64_relr_p (struct bfd_link_info *info,
+		      const Elf_Internal_Rela *rel,
+		      struct elf_link_hash_entry *h)
+{
+  if (elfNN_aarch64_bfd_reloc_from_type (info->output_bfd,
+					 ELFNN_R_TYPE (rel->r_info))
+      != BFD_RELOC_AARCH64_NN)
+    return FALSE;
+
+  return (bfd_link_pic (info)
+	  && (h == NULL
+	      || h->dynindx == -1
+	      || ((bfd_link_pie (info) || SYMBOLIC_BIND (info, h))
+		  && h->def_regular)));
+}
+
 
 /* Allocate space in .plt, .got and associated reloc sections for
    dynamic relocs.  */
@@ -9028,6 +9058,11 @@ elfNN_aarch64_size_dynamic_sections (bfd *output_bfd ATTRIBUTE_UNUSED,
 	bfd_elfNN_aarch64_init_maps (ibfd);
       }
 
+  /* Move the relative relocs which can be packed into DT_RELR out of
+     the dynamic reloc sections.  */
+  if (!_bfd_elf_relr_scan (output_bfd, info, elfNN_aarch64_relr_p))
+    return FALSE;
+
   /* We now have determined the sizes of the various dynamic sections.
      Allocate memory for them.  */
   relocs = FALSE;
@@ -396,6 +396,9 @@ riscv_elf_create_dynamic_sections (bfd *dynobj,
 					     | SEC_LINKER_CREATED));
     }
 
+  if (!_bfd_elf_create_relr_section (dynobj, info))
+    return FALSE;
+
   if (!htab->elf.splt || !htab->elf.srelplt || !htab->elf.sdynbss
       || (!bfd_link_pic (info) && (!htab->elf.srelbss || !htab->sdyntdata)))
     abort ();
@@ -1088,6 +1091,23 @@ allocate_dynrelocs (struct elf_link_hash_entry *h, void *inf)
   return TRUE;
 }
 
+/* Return TRUE if relocate_section turns REL against H, or a local
+   symbol if H is NULL, into an R_RISCV_RELATIVE dynamic reloc.  */
+
+static bfd_boolean
+riscv_elf_relr_p (struct bfd_link_info *info, const Elf_Internal_Rela *rel,
+		  struct elf_link_hash_entry *h)
+{
+  if (ELFNN_R_TYPE (rel->r_info) != (ARCH_SIZE == 64
+				     ? R_RISCV_64 : R_RISCV_32))
+    return FALSE;
+
+  return (bfd_link_pic (info)
+	  && (h == NULL
+	      || h->dynindx == -1
+	      || (SYMBOLIC_BIND (info, h) && h->def_regular)));
+}
+
 static bfd_boolean
 riscv_elf_size_dynamic_sections (bfd *output_bfd, struct bfd_link_info *info)
 {
@@ -1202,6 +1222,11 @@ riscv_elf_size_dynamic_sections (bfd *output_bfd, struct bfd_link_info *info)
 	htab->elf.sgotplt->size = 0;
     }
 
+  /* Move the relative relocs which can be packed into DT_RELR out of
+     the dynamic reloc sections.  */
+  if (!_bfd_elf_relr_scan (output_bfd, info, riscv_elf_relr_p))
+    return FALSE;
+
   /* The check_relocs and adjust_dynamic_symbol entry points have
      determined the sizes of the various dynamic sections.  Allocate
      memory for them.  */
@@ -1757,6 +1782,7 @@ riscv_elf_relocate_section (bfd *output_bfd,
 	  break;
 
 	case R_RISCV_GOT_HI20:
+	  _bfd_elf_link_lock (info);
 	  if (h != NULL)
 	    {
 	      bfd_boolean dyn, pic;
@@ -1830,6 +1856,7 @@ riscv_elf_relocate_section (bfd *output_bfd,
 		  local_got_offsets[r_symndx] |= 1;
 		}
 	    }
+	  _bfd_elf_link_unlock (info);
 	  relocation = sec_addr (htab->elf.sgot) + off;
 	  absolute = riscv_zero_pcrel_hi_reloc (rel,
 						info,
@@ -2038,11 +2065,18 @@ riscv_elf_relocate_section (bfd *output_bfd,
 		}
 	      else
 		{
+		  /* A relocation packed into DT_RELR has no addend, so
+		     apply it to the section contents instead.  */
+		  if (_bfd_elf_relr_use (info, input_section,
+					 rel->r_offset))
+		    break;
 		  outrel.r_info = ELFNN_R_INFO (0, R_RISCV_RELATIVE);
 		  outrel.r_addend = relocation + rel->r_addend;
 		}
 
+	      _bfd_elf_link_lock (info);
 	      riscv_elf_append_rela (output_bfd, sreloc, &outrel);
+	      _bfd_elf_link_unlock (info);
 	      if (skip_static_relocation)
 		continue;
 	    }
@@ -2053,6 +2087,7 @@ riscv_elf_relocate_section (bfd *output_bfd,
 	  /* Fall through.  */
 
 	case R_RISCV_TLS_GD_HI20:
+	  _bfd_elf_link_lock (info);
 	  if (h != NULL)
 	    {
 	      off = h->got.offset;
@@ -2167,6 +2202,7 @@ riscv_elf_relocate_section (bfd *output_bfd,
 		    }
 		}
 	    }
+	  _bfd_elf_link_unlock (info);
 
 	  BFD_ASSERT (off < (bfd_vma) -2);
 	  relocation = sec_addr (htab->elf.sgot) + off + (is_ie ? ie_off : 0);
@@ -2267,7 +2303,11 @@ riscv_elf_relocate_section (bfd *output_bfd,
 
       /* Do not report error message for the dangerous relocation again.  */
       if (msg && r != bfd_reloc_dangerous)
-	info->callbacks->einfo (msg);
+	{
+	  _bfd_elf_link_lock (info);
+	  info->callbacks->einfo (msg);
+	  _bfd_elf_link_unlock (info);
+	}
 
       /* Free the unused `msg_buf`.  */
       free (msg_buf);
@@ -4324,6 +4364,7 @@ riscv_elf_obj_attrs_arg_type (int tag)
 #define elf_backend_want_dynrelro	1
 #define elf_backend_rela_normal		1
 #define elf_backend_default_execstack	0
+#define elf_backend_threaded_relocate_section 1
 
 #undef  elf_backend_obj_attrs_vendor
 #define elf_backend_obj_attrs_vendor            "riscv"
@@ -31,10 +31,10 @@
 #define	bfd_elfNN_close_and_cleanup _bfd_elf_close_and_cleanup
 #endif
 #ifndef bfd_elfNN_bfd_free_cached_info
-#define bfd_elfNN_bfd_free_cached_info _bfd_free_cached_info
+#define bfd_elfNN_bfd_free_cached_info _bfd_elf_free_cached_info
 #endif
 #ifndef bfd_elfNN_get_section_contents
-#define bfd_elfNN_get_section_contents _bfd_generic_get_section_contents
+#define bfd_elfNN_get_section_contents _bfd_elf_get_section_contents
 #endif
 
 #define bfd_elfNN_canonicalize_dynamic_symtab \
@@ -138,6 +138,9 @@
 #ifndef elf_backend_linux_prpsinfo64_ugid16
 #define elf_backend_linux_prpsinfo64_ugid16 FALSE
 #endif
+#ifndef elf_backend_threaded_relocate_section
+#define elf_backend_threaded_relocate_section 0
+#endif
 #ifndef elf_backend_stack_align
 #define elf_backend_stack_align 16
 #endif
@@ -953,7 +956,8 @@ static struct elf_backend_data elfNN_bed =
   elf_backend_extern_protected_data,
   elf_backend_always_renumber_dynsyms,
   elf_backend_linux_prpsinfo32_ugid16,
-  elf_backend_linux_prpsinfo64_ugid16
+  elf_backend_linux_prpsinfo64_ugid16,
+  elf_backend_threaded_relocate_section
 };
 
 /* Forward declaration for use when initialising alternative_target field.  */
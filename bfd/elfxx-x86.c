@@ -1235,6 +1235,12 @@ _bfd_x86_elf_size_dynamic_sections (bfd *output_bfd,
 	  = htab->non_lazy_plt->eh_frame_plt_size;
     }
 
+  /* Move the relative relocs which can be packed into DT_RELR out of
+     the dynamic reloc sections.  */
+  if (htab->relr_p != NULL
+      && !_bfd_elf_relr_scan (output_bfd, info, htab->relr_p))
+    return FALSE;
+
   /* We now have determined the sizes of the various dynamic sections.
      Allocate memory for them.  */
   relocs = FALSE;
@@ -2616,6 +2622,7 @@ _bfd_x86_elf_link_setup_gnu_properties
 
   htab->r_info = init_table->r_info;
   htab->r_sym = init_table->r_sym;
+  htab->relr_p = init_table->relr_p;
 
   if (bfd_link_relocatable (info))
     return pbfd;
@@ -2779,6 +2786,10 @@ _bfd_x86_elf_link_setup_gnu_properties
   if (!_bfd_elf_create_ifunc_sections (dynobj, info))
     info->callbacks->einfo (_("%F%P: failed to create ifunc sections\n"));
 
+  if (htab->relr_p != NULL
+      && !_bfd_elf_create_relr_section (dynobj, info))
+    info->callbacks->einfo (_("%F%P: failed to create .relr.dyn section\n"));
+
   plt_alignment = bfd_log2 (htab->plt.plt_entry_size);
 
   if (pltsec != NULL)
@@ -509,6 +509,8 @@ struct elf_x86_link_hash_table
   bfd_vma (*r_info) (bfd_vma, bfd_vma);
   bfd_vma (*r_sym) (bfd_vma);
   bfd_boolean (*is_reloc_section) (const char *);
+  bfd_boolean (*relr_p) (struct bfd_link_info *, const Elf_Internal_Rela *,
+			 struct elf_link_hash_entry *);
   unsigned int sizeof_reloc;
   unsigned int got_entry_size;
   unsigned int pointer_r_type;
@@ -538,6 +540,12 @@ struct elf_x86_init_table
 
   bfd_vma (*r_info) (bfd_vma, bfd_vma);
   bfd_vma (*r_sym) (bfd_vma);
+
+  /* Return TRUE if a relocation becomes a relative dynamic relocation
+     which can be packed into DT_RELR.  NULL if DT_RELR isn't
+     supported.  */
+  bfd_boolean (*relr_p) (struct bfd_link_info *, const Elf_Internal_Rela *,
+			 struct elf_link_hash_entry *);
 };
 
 struct elf_x86_obj_tdata
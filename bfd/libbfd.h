@@ -1011,6 +1011,8 @@ bfd_boolean bfd_cache_init (bfd *abfd);
 
 bfd_boolean bfd_cache_close (bfd *abfd);
 
+bfd_boolean bfd_cache_file_p (bfd *abfd);
+
 FILE* bfd_open_file (bfd *abfd);
 
 /* Extracted from reloc.c.  */
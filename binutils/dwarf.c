@@ -342,6 +342,19 @@ read_leb128 (unsigned char *data,
   unsigned int shift = 0;
   int status = 1;
 
+  /* Handle the common single-byte case without entering the loop.  */
+  if (data < end && (*data & 0x80) == 0)
+    {
+      result = *data;
+      if (sign && (result & 0x40))
+	result |= -(dwarf_vma) 0x80;
+      if (length_return != NULL)
+	*length_return = 1;
+      if (status_return != NULL)
+	*status_return = 0;
+      return result;
+    }
+
   while (data < end)
     {
       unsigned char byte = *data++;
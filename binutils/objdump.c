@@ -71,6 +71,10 @@
 #include <sys/mman.h>
 #endif
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 /* Internal headers for the ELF .stab-dump code - sorry.  */
 #define	BYTES_IN_WORD	32
 #include "aout/aout64.h"
@@ -107,6 +111,7 @@ static int do_demangle;			/* -C, --demangle */
 static bfd_boolean disassemble;		/* -d */
 static bfd_boolean disassemble_all;	/* -D */
 static int disassemble_zeroes;		/* --disassemble-zeroes */
+static int disassemble_threads;		/* --threads */
 static bfd_boolean formats_info;	/* -i */
 static int wide_output;			/* -w */
 static int insn_width;			/* --insn-width */
@@ -281,6 +286,7 @@ usage (FILE *stream, int status)
       --prefix-addresses         Print complete address alongside disassembly\n\
       --[no-]show-raw-insn       Display hex alongside symbolic disassembly\n\
       --insn-width=WIDTH         Display WIDTH bytes on a single line for -d\n\
+      --threads[=COUNT]          Disassemble with COUNT threads, or one per CPU\n\
       --adjust-vma=OFFSET        Add OFFSET to all displayed section addresses\n\
       --special-syms             Include special symbols in symbol dumps\n\
       --inlines                  Print all inlines for source line (with -l)\n\
@@ -337,6 +343,7 @@ enum option_values
     OPTION_NO_RECURSE_LIMIT,
     OPTION_INLINES,
     OPTION_SOURCE_COMMENT,
+    OPTION_THREADS,
 #ifdef ENABLE_LIBCTF
     OPTION_CTF,
     OPTION_CTF_PARENT,
@@ -400,6 +407,7 @@ static struct option long_options[]=
   {"prefix", required_argument, NULL, OPTION_PREFIX},
   {"prefix-strip", required_argument, NULL, OPTION_PREFIX_STRIP},
   {"insn-width", required_argument, NULL, OPTION_INSN_WIDTH},
+  {"threads", optional_argument, NULL, OPTION_THREADS},
   {"dwarf-depth", required_argument, 0, OPTION_DWARF_DEPTH},
   {"dwarf-start", required_argument, 0, OPTION_DWARF_START},
   {"dwarf-check", no_argument, 0, OPTION_DWARF_CHECK},
@@ -1884,6 +1892,30 @@ objdump_sprintf (SFILE *f, const char *format, ...)
   size_t n;
   va_list args;
 
+  /* Most disassembler output is plain strings passed through "%s";
+     append those without going through vsnprintf.  */
+  if (format[0] == '%' && format[1] == 's' && format[2] == '\0')
+    {
+      const char *arg;
+
+      va_start (args, format);
+      arg = va_arg (args, const char *);
+      va_end (args);
+
+      /* Print a NULL string the way vsnprintf does.  */
+      if (arg == NULL)
+	arg = "(null)";
+      n = strlen (arg);
+      if (f->alloc - f->pos <= n)
+	{
+	  f->alloc = (f->alloc + n) * 2;
+	  f->buffer = (char *) xrealloc (f->buffer, f->alloc);
+	}
+      memcpy (f->buffer + f->pos, arg, n + 1);
+      f->pos += n;
+      return n;
+    }
+
   while (1)
     {
       size_t space = f->alloc - f->pos;
@@ -2325,6 +2357,7 @@ disassemble_jumps (struct disassemble_info * inf,
   unsigned int opb = inf->octets_per_byte;
   int octets = opb;
   SFILE sfile;
+  void *stream = inf->stream;
 
   aux = (struct objdump_disasm_info *) inf->application_data;
   section = inf->section;
@@ -2418,7 +2451,7 @@ disassemble_jumps (struct disassemble_info * inf,
     }
 
   inf->fprintf_func = (fprintf_ftype) fprintf;
-  inf->stream = stdout;
+  inf->stream = stream;
 
   free (sfile.buffer);
 
@@ -2515,8 +2548,8 @@ null_print (const void * stream ATTRIBUTE_UNUSED, const char * format ATTRIBUTE_
 /* Print out jump visualization.  */
 
 static void
-print_jump_visualisation (bfd_vma addr, int max_level, char *line_buffer,
-			  uint8_t *color_buffer)
+print_jump_visualisation (FILE *out, bfd_vma addr, int max_level,
+			  char *line_buffer, uint8_t *color_buffer)
 {
   if (!line_buffer)
     return;
@@ -2539,18 +2572,48 @@ print_jump_visualisation (bfd_vma addr, int max_level, char *line_buffer,
 		if (extended_color_output)
 		  /* Use extended 8bit color, but
 		     do not choose dark colors.  */
-		  printf ("\033[38;5;%dm", 124 + (color % 108));
+		  fprintf (out, "\033[38;5;%dm", 124 + (color % 108));
 		else
 		  /* Use simple terminal colors.  */
-		  printf ("\033[%dm", 31 + (color % 7));
+		  fprintf (out, "\033[%dm", 31 + (color % 7));
 	      else
 		/* Clear color.  */
-		printf ("\033[0m");
+		fprintf (out, "\033[0m");
 	      last_color = color;
 	    }
 	}
-      putchar ((i < line_buffer_size) ? line_buffer[i]: ' ');
+      putc ((i < line_buffer_size) ? line_buffer[i]: ' ', out);
+    }
+}
+
+/* Print the BPC octets at DATA in hex, most significant octet first
+   for little endian displays.  This is called for every chunk of every
+   instruction, so avoid going through printf.  */
+
+static void
+print_raw_octets (FILE *out, const bfd_byte *data, unsigned int bpc,
+		  enum bfd_endian display_endian)
+{
+  static const char hex[] = "0123456789abcdef";
+  char buf[2 * 16 + 1];
+  unsigned int k, n;
+
+  n = 0;
+  for (k = 0; k < bpc; k++)
+    {
+      bfd_byte b = data[display_endian == BFD_ENDIAN_LITTLE ? bpc - 1 - k : k];
+
+      if (n == sizeof (buf) - 1)
+	{
+	  buf[n] = '\0';
+	  fputs (buf, out);
+	  n = 0;
+	}
+      buf[n++] = hex[b >> 4];
+      buf[n++] = hex[b & 0xf];
     }
+  buf[n] = '\0';
+  fputs (buf, out);
 }
 
 /* Disassemble some data in memory between given values.  */
@@ -2568,6 +2631,7 @@ disassemble_bytes (struct disassemble_info * inf,
 {
   struct objdump_disasm_info *aux;
   asection *section;
+  FILE *out = (FILE *) inf->stream;
   unsigned int octets_per_line;
   unsigned int skip_addr_chars;
   bfd_vma addr_offset;
@@ -2675,13 +2739,13 @@ disassemble_bytes (struct disassemble_info * inf,
 	     and the file offset from where we resume dumping.  */
 	  if (display_file_offsets
 	      && addr_offset + octets / opb < stop_offset)
-	    printf (_("\t... (skipping %lu zeroes, "
-		      "resuming at file offset: 0x%lx)\n"),
-		    (unsigned long) (octets / opb),
-		    (unsigned long) (section->filepos
-				     + addr_offset + octets / opb));
+	    fprintf (out, _("\t... (skipping %lu zeroes, "
+			    "resuming at file offset: 0x%lx)\n"),
+		     (unsigned long) (octets / opb),
+		     (unsigned long) (section->filepos
+				      + addr_offset + octets / opb));
 	  else
-	    printf ("\t...\n");
+	    fprintf (out, "\t...\n");
 	}
       else
 	{
@@ -2693,7 +2757,7 @@ disassemble_bytes (struct disassemble_info * inf,
 	    show_line (aux->abfd, section, addr_offset);
 
 	  if (no_addresses)
-	    printf ("\t");
+	    fprintf (out, "\t");
 	  else if (!prefix_addresses)
 	    {
 	      char *s;
@@ -2703,17 +2767,17 @@ disassemble_bytes (struct disassemble_info * inf,
 		*s = ' ';
 	      if (*s == '\0')
 		*--s = '0';
-	      printf ("%s:\t", buf + skip_addr_chars);
+	      fprintf (out, "%s:\t", buf + skip_addr_chars);
 	    }
 	  else
 	    {
 	      aux->require_sec = TRUE;
 	      objdump_print_address (section->vma + addr_offset, inf);
 	      aux->require_sec = FALSE;
-	      putchar (' ');
+	      putc (' ', out);
 	    }
 
-	  print_jump_visualisation (section->vma + addr_offset,
+	  print_jump_visualisation (out, section->vma + addr_offset,
 				    max_level, line_buffer,
 				    color_buffer);
 
@@ -2798,13 +2862,13 @@ disassemble_bytes (struct disassemble_info * inf,
 
 	      inf->stop_vma = 0;
 	      inf->fprintf_func = (fprintf_ftype) fprintf;
-	      inf->stream = stdout;
+	      inf->stream = out;
 	      if (insn_width == 0 && inf->bytes_per_line != 0)
 		octets_per_line = inf->bytes_per_line;
 	      if (insn_size < (int) opb)
 		{
 		  if (sfile.pos)
-		    printf ("%s\n", sfile.buffer);
+		    fprintf (out, "%s\n", sfile.buffer);
 		  if (insn_size >= 0)
 		    {
 		      non_fatal (_("disassemble_fn returned length %d"),
@@ -2853,21 +2917,8 @@ disassemble_bytes (struct disassemble_info * inf,
 		{
 		  /* PR 21580: Check for a buffer ending early.  */
 		  if (j + bpc <= stop_offset * opb)
-		    {
-		      unsigned int k;
-
-		      if (inf->display_endian == BFD_ENDIAN_LITTLE)
-			{
-			  for (k = bpc; k-- != 0; )
-			    printf ("%02x", (unsigned) data[j + k]);
-			}
-		      else
-			{
-			  for (k = 0; k < bpc; k++)
-			    printf ("%02x", (unsigned) data[j + k]);
-			}
-		    }
-		  putchar (' ');
+		    print_raw_octets (out, data + j, bpc, inf->display_endian);
+		  putc (' ', out);
 		}
 
 	      for (; pb < octets_per_line; pb += bpc)
@@ -2875,21 +2926,21 @@ disassemble_bytes (struct disassemble_info * inf,
 		  unsigned int k;
 
 		  for (k = 0; k < bpc; k++)
-		    printf ("  ");
-		  putchar (' ');
+		    fputs ("  ", out);
+		  putc (' ', out);
 		}
 
 	      /* Separate raw data from instruction by extra space.  */
 	      if (insns)
-		putchar ('\t');
+		putc ('\t', out);
 	      else
-		printf ("    ");
+		fprintf (out, "    ");
 	    }
 
 	  if (! insns)
-	    printf ("%s", buf);
+	    fprintf (out, "%s", buf);
 	  else if (sfile.pos)
-	    printf ("%s", sfile.buffer);
+	    fprintf (out, "%s", sfile.buffer);
 
 	  if (prefix_addresses
 	      ? show_raw_insn > 0
@@ -2900,11 +2951,11 @@ disassemble_bytes (struct disassemble_info * inf,
 		  bfd_vma j;
 		  char *s;
 
-		  putchar ('\n');
+		  putc ('\n', out);
 		  j = addr_offset * opb + pb;
 
 		  if (no_addresses)
-		    printf ("\t");
+		    fprintf (out, "\t");
 		  else
 		    {
 		      bfd_sprintf_vma (aux->abfd, buf, section->vma + j / opb);
@@ -2912,10 +2963,10 @@ disassemble_bytes (struct disassemble_info * inf,
 			*s = ' ';
 		      if (*s == '\0')
 			*--s = '0';
-		      printf ("%s:\t", buf + skip_addr_chars);
+		      fprintf (out, "%s:\t", buf + skip_addr_chars);
 		    }
 
-		  print_jump_visualisation (section->vma + j / opb,
+		  print_jump_visualisation (out, section->vma + j / opb,
 					    max_level, line_buffer,
 					    color_buffer);
 
@@ -2926,27 +2977,14 @@ disassemble_bytes (struct disassemble_info * inf,
 		    {
 		      /* PR 21619: Check for a buffer ending early.  */
 		      if (j + bpc <= stop_offset * opb)
-			{
-			  unsigned int k;
-
-			  if (inf->display_endian == BFD_ENDIAN_LITTLE)
-			    {
-			      for (k = bpc; k-- != 0; )
-				printf ("%02x", (unsigned) data[j + k]);
-			    }
-			  else
-			    {
-			      for (k = 0; k < bpc; k++)
-				printf ("%02x", (unsigned) data[j + k]);
-			    }
-			}
-		      putchar (' ');
+			print_raw_octets (out, data + j, bpc, inf->display_endian);
+		      putc (' ', out);
 		    }
 		}
 	    }
 
 	  if (!wide_output)
-	    putchar ('\n');
+	    putc ('\n', out);
 	  else
 	    need_nl = TRUE;
 	}
@@ -2961,26 +2999,26 @@ disassemble_bytes (struct disassemble_info * inf,
 	      q = **relppp;
 
 	      if (wide_output)
-		putchar ('\t');
+		putc ('\t', out);
 	      else
-		printf ("\t\t\t");
+		fprintf (out, "\t\t\t");
 
 	      if (!no_addresses)
 		{
 		  objdump_print_value (section->vma - rel_offset + q->address,
 				       inf, TRUE);
-		  printf (": ");
+		  fprintf (out, ": ");
 		}
 
 	      if (q->howto == NULL)
-		printf ("*unknown*\t");
+		fprintf (out, "*unknown*\t");
 	      else if (q->howto->name)
-		printf ("%s\t", q->howto->name);
+		fprintf (out, "%s\t", q->howto->name);
 	      else
-		printf ("%d\t", q->howto->type);
+		fprintf (out, "%d\t", q->howto->type);
 
 	      if (q->sym_ptr_ptr == NULL || *q->sym_ptr_ptr == NULL)
-		printf ("*unknown*");
+		fprintf (out, "*unknown*");
 	      else
 		{
 		  const char *sym_name;
@@ -2996,7 +3034,7 @@ disassemble_bytes (struct disassemble_info * inf,
 		      sym_name = bfd_section_name (sym_sec);
 		      if (sym_name == NULL || *sym_name == '\0')
 			sym_name = "*unknown*";
-		      printf ("%s", sanitize_string (sym_name));
+		      fprintf (out, "%s", sanitize_string (sym_name));
 		    }
 		}
 
@@ -3005,22 +3043,22 @@ disassemble_bytes (struct disassemble_info * inf,
 		  bfd_signed_vma addend = q->addend;
 		  if (addend < 0)
 		    {
-		      printf ("-0x");
+		      fprintf (out, "-0x");
 		      addend = -addend;
 		    }
 		  else
-		    printf ("+0x");
+		    fprintf (out, "+0x");
 		  objdump_print_value (addend, inf, TRUE);
 		}
 
-	      printf ("\n");
+	      fprintf (out, "\n");
 	      need_nl = FALSE;
 	    }
 	  ++(*relppp);
 	}
 
       if (need_nl)
-	printf ("\n");
+	fprintf (out, "\n");
 
       addr_offset += octets / opb;
     }
@@ -3030,6 +3068,397 @@ disassemble_bytes (struct disassemble_info * inf,
   free (color_buffer);
 }
 
+/* A block of a section disassembled in one call to disassemble_bytes,
+   as found by disassemble_section.  */
+
+struct disassemble_segment
+{
+  /* The symbol printed before the block, and the address printed
+     with it.  */
+  asymbol *sym;
+  bfd_vma addr;
+
+  /* The offsets of the block within the section.  */
+  bfd_vma start_offset;
+  bfd_vma stop_offset;
+
+  /* The symbols at ADDR, for the disassembler.  */
+  asymbol **symbols;
+  int num_symbols;
+  int symtab_pos;
+
+  /* Whether the block is disassembled or just dumped.  */
+  bfd_boolean insns;
+};
+
+/* Print the blocks SEGS[0] to SEGS[COUNT - 1] of SECTION, each
+   preceded by its symbol.  *RELPPP is the first reloc not yet
+   printed, and is updated to the first one after the blocks.  */
+
+static void
+disassemble_segments (bfd *abfd,
+		      asection *section,
+		      struct disassemble_info *pinfo,
+		      bfd_byte *data,
+		      const struct disassemble_segment *segs,
+		      size_t count,
+		      bfd_vma rel_offset,
+		      arelent ***relppp,
+		      arelent **rel_ppend)
+{
+  struct objdump_disasm_info *paux;
+  size_t i;
+
+  paux = (struct objdump_disasm_info *) pinfo->application_data;
+  for (i = 0; i < count; i++)
+    {
+      const struct disassemble_segment *seg = &segs[i];
+
+      pinfo->symbols = seg->symbols;
+      pinfo->num_symbols = seg->num_symbols;
+      pinfo->symtab_pos = seg->symtab_pos;
+
+      if (! prefix_addresses)
+	{
+	  pinfo->fprintf_func (pinfo->stream, "\n");
+	  objdump_print_addr_with_sym (abfd, section, seg->sym, seg->addr,
+				       pinfo, FALSE);
+	  pinfo->fprintf_func (pinfo->stream, ":\n");
+	}
+
+      /* Resolve symbol name.  */
+      if (visualize_jumps && abfd && seg->sym && seg->sym->name)
+	{
+	  struct disassemble_info di;
+	  SFILE sf;
+
+	  sf.alloc = strlen (seg->sym->name) + 40;
+	  sf.buffer = (char*) xmalloc (sf.alloc);
+	  sf.pos = 0;
+	  di.fprintf_func = (fprintf_ftype) objdump_sprintf;
+	  di.stream = &sf;
+
+	  objdump_print_symname (abfd, &di, seg->sym);
+
+	  /* Fetch jump information.  */
+	  detected_jumps = disassemble_jumps
+	    (pinfo, paux->disassemble_fn,
+	     seg->start_offset, seg->stop_offset,
+	     rel_offset, relppp, rel_ppend);
+
+	  /* Free symbol name.  */
+	  free (sf.buffer);
+	}
+
+      /* Add jumps to output.  */
+      disassemble_bytes (pinfo, paux->disassemble_fn, seg->insns, data,
+			 seg->start_offset, seg->stop_offset,
+			 rel_offset, relppp, rel_ppend);
+
+      /* Free jumps.  */
+      while (detected_jumps)
+	{
+	  detected_jumps = jump_info_free (detected_jumps);
+	}
+    }
+}
+
+#ifdef HAVE_PTHREAD
+
+/* With --threads, a section is split into shards at symbols, and the
+   shards are disassembled at once into temporary files, which are
+   then copied to stdout in order.  */
+
+struct disassemble_shard
+{
+  /* The blocks in the shard.  */
+  const struct disassemble_segment *segs;
+  size_t count;
+
+  /* The first reloc for the shard, and the first one after it.  */
+  arelent **rel_start;
+  arelent **rel_end;
+
+  /* The disassembly, or NULL if it couldn't be written.  */
+  FILE *out;
+};
+
+struct disassemble_shards
+{
+  pthread_mutex_t lock;
+  struct disassemble_shard *shards;
+  size_t count;
+  size_t next;
+
+  bfd *abfd;
+  asection *section;
+  struct disassemble_info *pinfo;
+  bfd_byte *data;
+  bfd_vma rel_offset;
+  arelent **rel_ppend;
+};
+
+/* Disassemble SHARD to OUT, using copies of the disassemble_info and
+   objdump_disasm_info of SH.  */
+
+static void
+disassemble_shard (struct disassemble_shards *sh,
+		   struct disassemble_shard *shard,
+		   FILE *out)
+{
+  struct disassemble_info inf = *sh->pinfo;
+  struct objdump_disasm_info aux;
+  arelent **rel_pp = shard->rel_start;
+
+  aux = *(struct objdump_disasm_info *) inf.application_data;
+  inf.application_data = &aux;
+  inf.stream = out;
+  inf.private_data = NULL;
+  /* The options were parsed when the disassembler was primed.  */
+  inf.disassembler_options = NULL;
+  disassemble_segments (sh->abfd, sh->section, &inf, sh->data,
+			shard->segs, shard->count,
+			sh->rel_offset, &rel_pp, sh->rel_ppend);
+  shard->rel_end = rel_pp;
+  free (inf.private_data);
+}
+
+static void *
+disassemble_shard_thread (void *arg)
+{
+  struct disassemble_shards *sh = (struct disassemble_shards *) arg;
+
+  while (1)
+    {
+      struct disassemble_shard *shard;
+
+      pthread_mutex_lock (&sh->lock);
+      shard = sh->next < sh->count ? &sh->shards[sh->next++] : NULL;
+      pthread_mutex_unlock (&sh->lock);
+      if (shard == NULL)
+	break;
+
+      shard->out = tmpfile ();
+      if (shard->out != NULL)
+	disassemble_shard (sh, shard, shard->out);
+    }
+  return NULL;
+}
+
+/* Return TRUE if the disassembler for INF can be run in several
+   threads at once.  It must set up any static state on its first
+   call, keep all other state in INF->private_data, allocated with
+   malloc, and not carry that state past a symbol or into another
+   section.  */
+
+static bfd_boolean
+disassembler_thread_safe (struct disassemble_info *inf)
+{
+  switch (inf->arch)
+    {
+    case bfd_arch_riscv:
+      return TRUE;
+    default:
+      return FALSE;
+    }
+}
+
+/* Return TRUE if any symbol or section name would be changed by
+   sanitize_string, whose buffer can't be shared between threads.  */
+
+static bfd_boolean
+names_need_sanitizing (bfd *abfd)
+{
+  asection *sec;
+  long i;
+
+  for (i = 0; i < sorted_symcount; i++)
+    if (sanitize_string (bfd_asymbol_name (sorted_syms[i]))
+	!= bfd_asymbol_name (sorted_syms[i]))
+      return TRUE;
+  for (sec = abfd->sections; sec != NULL; sec = sec->next)
+    if (sanitize_string (sec->name) != sec->name)
+      return TRUE;
+  return FALSE;
+}
+
+/* Print the blocks SEGS[0] to SEGS[COUNT - 1] of SECTION like
+   disassemble_segments, but using the threads given by --threads.
+   Return FALSE, having printed nothing, if the section can't be
+   disassembled in threads.  */
+
+static bfd_boolean
+disassemble_segments_threaded (bfd *abfd,
+			       asection *section,
+			       struct disassemble_info *pinfo,
+			       bfd_byte *data,
+			       const struct disassemble_segment *segs,
+			       size_t count,
+			       bfd_vma rel_offset,
+			       arelent **rel_pp,
+			       arelent **rel_ppend)
+{
+  struct objdump_disasm_info *paux;
+  struct disassemble_shards sh;
+  struct disassemble_info prime;
+  pthread_t *threads;
+  long nthreads;
+  size_t nshards, i, started;
+  bfd_vma total, done;
+  SFILE sfile;
+
+  nthreads = disassemble_threads;
+  if (nthreads < 0)
+    {
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+      nthreads = sysconf (_SC_NPROCESSORS_ONLN);
+#else
+      nthreads = 1;
+#endif
+    }
+
+  /* Source lines, jump visualisation and --disassemble=SYMBOL all
+     depend on the blocks printed before.  */
+  paux = (struct objdump_disasm_info *) pinfo->application_data;
+  if (nthreads <= 1
+      || count < 2
+      || with_line_numbers
+      || with_source_code
+      || visualize_jumps
+      || paux->symbol != NULL
+      || !disassembler_thread_safe (pinfo)
+      || names_need_sanitizing (abfd))
+    return FALSE;
+
+  /* Let the disassembler set up its static state before the threads
+     start, with a copy of the disassemble_info whose private_data
+     can be freed.  */
+  sfile.alloc = 120;
+  sfile.buffer = (char *) xmalloc (sfile.alloc);
+  sfile.pos = 0;
+  prime = *pinfo;
+  prime.fprintf_func = (fprintf_ftype) objdump_sprintf;
+  prime.stream = &sfile;
+  prime.private_data = NULL;
+  prime.symbols = segs[0].symbols;
+  prime.num_symbols = segs[0].num_symbols;
+  prime.symtab_pos = segs[0].symtab_pos;
+  (*paux->disassemble_fn) (section->vma + segs[0].start_offset, &prime);
+  free (prime.private_data);
+  free (sfile.buffer);
+
+  /* Split the blocks into shards of about the same size, several per
+     thread, starting each shard at a symbol.  */
+  nshards = nthreads * 4;
+  if (nshards > count)
+    nshards = count;
+  sh.shards = (struct disassemble_shard *) xmalloc (nshards
+						     * sizeof (*sh.shards));
+  total = segs[count - 1].stop_offset - segs[0].start_offset;
+  done = 0;
+  sh.count = 0;
+  for (i = 0; i < count; i++)
+    {
+      const struct disassemble_segment *seg = &segs[i];
+
+      if (i == 0
+	  || (seg->num_symbols > 0
+	      && bfd_asymbol_value (seg->symbols[0]) == seg->addr
+	      && done >= total / nshards * sh.count
+	      && sh.count < nshards))
+	{
+	  struct disassemble_shard *shard = &sh.shards[sh.count++];
+
+	  shard->segs = seg;
+	  shard->count = 0;
+	  shard->out = NULL;
+	  while (rel_pp < rel_ppend
+		 && (*rel_pp)->address < rel_offset + seg->start_offset)
+	    ++rel_pp;
+	  shard->rel_start = rel_pp;
+	  shard->rel_end = rel_pp;
+	}
+      sh.shards[sh.count - 1].count++;
+      done += seg->stop_offset - seg->start_offset;
+    }
+  if (sh.count < 2)
+    {
+      free (sh.shards);
+      return FALSE;
+    }
+
+  sh.next = 0;
+  sh.abfd = abfd;
+  sh.section = section;
+  sh.pinfo = pinfo;
+  sh.data = data;
+  sh.rel_offset = rel_offset;
+  sh.rel_ppend = rel_ppend;
+  pthread_mutex_init (&sh.lock, NULL);
+
+  if ((size_t) nthreads > sh.count)
+    nthreads = sh.count;
+  threads = (pthread_t *) xmalloc ((nthreads - 1) * sizeof (*threads));
+  for (started = 0; started < (size_t) nthreads - 1; started++)
+    if (pthread_create (&threads[started], NULL, disassemble_shard_thread,
+			&sh) != 0)
+      break;
+  disassemble_shard_thread (&sh);
+  while (started != 0)
+    pthread_join (threads[--started], NULL);
+  free (threads);
+  pthread_mutex_destroy (&sh.lock);
+
+  /* Copy out the shards.  A shard which couldn't be written, or which
+     started at a different reloc from where the one before it ended,
+     is done again here.  */
+  rel_pp = sh.shards[0].rel_start;
+  for (i = 0; i < sh.count; i++)
+    {
+      struct disassemble_shard *shard = &sh.shards[i];
+
+      if (shard->out != NULL && shard->rel_start == rel_pp)
+	{
+	  char buf[BUFSIZ];
+	  size_t n;
+
+	  rewind (shard->out);
+	  while ((n = fread (buf, 1, sizeof (buf), shard->out)) != 0)
+	    fwrite (buf, 1, n, stdout);
+	}
+      else
+	{
+	  shard->rel_start = rel_pp;
+	  disassemble_shard (&sh, shard, stdout);
+	}
+      if (shard->out != NULL)
+	fclose (shard->out);
+      rel_pp = shard->rel_end;
+    }
+
+  free (sh.shards);
+  return TRUE;
+}
+
+#else
+
+static bfd_boolean
+disassemble_segments_threaded (bfd *abfd ATTRIBUTE_UNUSED,
+			       asection *section ATTRIBUTE_UNUSED,
+			       struct disassemble_info *pinfo ATTRIBUTE_UNUSED,
+			       bfd_byte *data ATTRIBUTE_UNUSED,
+			       const struct disassemble_segment *segs
+			         ATTRIBUTE_UNUSED,
+			       size_t count ATTRIBUTE_UNUSED,
+			       bfd_vma rel_offset ATTRIBUTE_UNUSED,
+			       arelent **rel_pp ATTRIBUTE_UNUSED,
+			       arelent **rel_ppend ATTRIBUTE_UNUSED)
+{
+  return FALSE;
+}
+
+#endif /* HAVE_PTHREAD */
+
 static void
 disassemble_section (bfd *abfd, asection *section, void *inf)
 {
@@ -3050,6 +3479,9 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
   bfd_vma                      rel_offset;
   unsigned long                addr_offset;
   bfd_boolean                  do_print;
+  struct disassemble_segment * segs = NULL;
+  size_t                       nsegs = 0;
+  size_t                       segs_alloc = 0;
   enum loop_control
   {
    stop_offset_reached,
@@ -3173,10 +3605,11 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
       && bed->sign_extend_vma)
     sign_adjust = (bfd_vma) 1 << (bed->s->arch_size - 1);
 
-  /* Disassemble a block of instructions up to the address associated with
-     the symbol we have just found.  Then print the symbol and find the
-     next symbol on.  Repeat until we have disassembled the entire section
-     or we have reached the end of the address range we are interested in.  */
+  /* Find the blocks of instructions up to the address associated with
+     the symbol we have just found.  Then find the next symbol on.
+     Repeat until we have covered the entire section or we have reached
+     the end of the address range we are interested in.  The blocks are
+     disassembled afterwards, by disassemble_segments.  */
   do_print = paux->symbol == NULL;
   loop_until = stop_offset_reached;
 
@@ -3287,14 +3720,6 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	    }
 	}
 
-      if (! prefix_addresses && do_print)
-	{
-	  pinfo->fprintf_func (pinfo->stream, "\n");
-	  objdump_print_addr_with_sym (abfd, section, sym, addr,
-				       pinfo, FALSE);
-	  pinfo->fprintf_func (pinfo->stream, ":\n");
-	}
-
       if (sym != NULL && bfd_asymbol_value (sym) > addr)
 	nextsym = sym;
       else if (sym == NULL)
@@ -3350,46 +3775,35 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 
       if (do_print)
 	{
-	  /* Resolve symbol name.  */
-	  if (visualize_jumps && abfd && sym && sym->name)
-	    {
-	      struct disassemble_info di;
-	      SFILE sf;
+	  struct disassemble_segment *seg;
 
-	      sf.alloc = strlen (sym->name) + 40;
-	      sf.buffer = (char*) xmalloc (sf.alloc);
-	      sf.pos = 0;
-	      di.fprintf_func = (fprintf_ftype) objdump_sprintf;
-	      di.stream = &sf;
-
-	      objdump_print_symname (abfd, &di, sym);
-
-	      /* Fetch jump information.  */
-	      detected_jumps = disassemble_jumps
-		(pinfo, paux->disassemble_fn,
-		 addr_offset, nextstop_offset,
-		 rel_offset, &rel_pp, rel_ppend);
-
-	      /* Free symbol name.  */
-	      free (sf.buffer);
-	    }
-
-	  /* Add jumps to output.  */
-	  disassemble_bytes (pinfo, paux->disassemble_fn, insns, data,
-			     addr_offset, nextstop_offset,
-			     rel_offset, &rel_pp, rel_ppend);
-
-	  /* Free jumps.  */
-	  while (detected_jumps)
+	  if (nsegs == segs_alloc)
 	    {
-	      detected_jumps = jump_info_free (detected_jumps);
+	      segs_alloc = segs_alloc * 2 + 16;
+	      segs = (struct disassemble_segment *)
+		xrealloc (segs, segs_alloc * sizeof (*segs));
 	    }
+	  seg = &segs[nsegs++];
+	  seg->sym = sym;
+	  seg->addr = addr;
+	  seg->start_offset = addr_offset;
+	  seg->stop_offset = nextstop_offset;
+	  seg->symbols = pinfo->symbols;
+	  seg->num_symbols = pinfo->num_symbols;
+	  seg->symtab_pos = pinfo->symtab_pos;
+	  seg->insns = insns;
 	}
 
       addr_offset = nextstop_offset;
       sym = nextsym;
     }
 
+  if (!disassemble_segments_threaded (abfd, section, pinfo, data, segs, nsegs,
+				      rel_offset, rel_pp, rel_ppend))
+    disassemble_segments (abfd, section, pinfo, data, segs, nsegs,
+			  rel_offset, &rel_pp, rel_ppend);
+  free (segs);
+
   free (data);
 
   if (rel_ppstart != NULL)
@@ -5219,6 +5633,16 @@ main (int argc, char **argv)
 	case OPTION_INLINES:
 	  unwind_inlines = TRUE;
 	  break;
+	case OPTION_THREADS:
+	  if (optarg == NULL)
+	    disassemble_threads = -1;
+	  else
+	    {
+	      disassemble_threads = strtoul (optarg, NULL, 0);
+	      if (disassemble_threads <= 0)
+		fatal (_("error: thread count must be positive"));
+	    }
+	  break;
 	case OPTION_VISUALIZE_JUMPS:
 	  visualize_jumps = TRUE;
 	  color_output = FALSE;
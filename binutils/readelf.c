@@ -1850,6 +1850,53 @@ dump_relocations (Filedata *          filedata,
   return res;
 }
 
+/* Display the addresses relocated by the DT_RELR entries found at the
+   specified offset.  */
+
+static bfd_boolean
+dump_relr_relocations (Filedata *          filedata,
+		       unsigned long       relr_offset,
+		       unsigned long       relr_size)
+{
+  unsigned int wordsize = is_32bit_elf ? 4 : 8;
+  unsigned char * data;
+  unsigned long i;
+  bfd_vma base = 0;
+
+  data = (unsigned char *) get_data (NULL, filedata, relr_offset, 1,
+				     relr_size, _("relr relocation data"));
+  if (data == NULL)
+    return FALSE;
+
+  printf (_(" Offset\n"));
+  for (i = 0; i + wordsize <= relr_size; i += wordsize)
+    {
+      bfd_vma entry = byte_get (data + i, wordsize);
+
+      if ((entry & 1) == 0)
+	{
+	  print_vma (entry, LONG_HEX);
+	  putchar ('\n');
+	  base = entry + wordsize;
+	}
+      else
+	{
+	  unsigned int bit;
+
+	  for (bit = 1; bit < wordsize * 8; bit++)
+	    if ((entry >> bit) & 1)
+	      {
+		print_vma (base + (bit - 1) * wordsize, LONG_HEX);
+		putchar ('\n');
+	      }
+	  base += (wordsize * 8 - 1) * wordsize;
+	}
+    }
+
+  free (data);
+  return TRUE;
+}
+
 static const char *
 get_aarch64_dynamic_type (unsigned long type)
 {
@@ -2189,6 +2236,9 @@ get_dynamic_type (Filedata * filedata, unsigned long type)
     case DT_PREINIT_ARRAY: return "PREINIT_ARRAY";
     case DT_PREINIT_ARRAYSZ: return "PREINIT_ARRAYSZ";
     case DT_SYMTAB_SHNDX: return "SYMTAB_SHNDX";
+    case DT_RELRSZ:	return "RELRSZ";
+    case DT_RELR:	return "RELR";
+    case DT_RELRENT:	return "RELRENT";
 
     case DT_CHECKSUM:	return "CHECKSUM";
     case DT_PLTPADSZ:	return "PLTPADSZ";
@@ -4345,6 +4395,7 @@ get_section_type_name (Filedata * filedata, unsigned int sh_type)
     case SHT_GNU_HASH:		return "GNU_HASH";
     case SHT_GROUP:		return "GROUP";
     case SHT_SYMTAB_SHNDX:	return "SYMTAB SECTION INDICES";
+    case SHT_RELR:		return "RELR";
     case SHT_GNU_verdef:	return "VERDEF";
     case SHT_GNU_verneed:	return "VERNEED";
     case SHT_GNU_versym:	return "VERSYM";
@@ -7486,7 +7537,8 @@ process_relocs (Filedata * filedata)
 	   i++, section++)
 	{
 	  if (   section->sh_type != SHT_RELA
-	      && section->sh_type != SHT_REL)
+	      && section->sh_type != SHT_REL
+	      && section->sh_type != SHT_RELR)
 	    continue;
 
 	  rel_offset = section->sh_offset;
@@ -7512,8 +7564,10 @@ process_relocs (Filedata * filedata)
 
 	      is_rela = section->sh_type == SHT_RELA;
 
-	      if (section->sh_link != 0
-		  && section->sh_link < filedata->file_header.e_shnum)
+	      if (section->sh_type == SHT_RELR)
+		dump_relr_relocations (filedata, rel_offset, rel_size);
+	      else if (section->sh_link != 0
+		       && section->sh_link < filedata->file_header.e_shnum)
 		{
 		  Elf_Internal_Shdr * symsec;
 		  Elf_Internal_Sym *  symtab;
@@ -10859,6 +10913,8 @@ the .dynstr section doesn't match the DT_STRTAB and DT_STRSZ tags\n"));
 	  filedata->dynamic_info[entry->d_tag] = entry->d_un.d_val;
 	  /* Fall through.  */
 	case DT_PLTPADSZ:
+	case DT_RELRSZ	:
+	case DT_RELRENT	:
 	case DT_MOVEENT	:
 	case DT_MOVESZ	:
 	case DT_INIT_ARRAYSZ:
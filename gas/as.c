@@ -1099,9 +1099,10 @@ This program has absolutely no warranty.\n"));
 	  break;
 
 	case OPTION_REDUCE_MEMORY_OVERHEADS:
-	  /* The only change we make at the moment is to reduce
-	     the size of the hash tables that we use.  */
-	  set_gas_hash_table_size (4051);
+	  /* The only change we make at the moment is to start the
+	     hash tables that we use small, and let them grow as
+	     entries are added.  */
+	  set_gas_hash_table_size (31);
 	  break;
 
 	case OPTION_HASH_TABLE_SIZE:
@@ -786,15 +786,12 @@ reg_csr_lookup_internal (const char *s)
   return riscv_csr_address (s, r);
 }
 
+/* Return the number of register R, as found in reg_names_hash, if it
+   is of class CLASS, or -1 otherwise.  */
+
 static unsigned int
-reg_lookup_internal (const char *s, enum reg_class class)
+reg_class_num (void *r, enum reg_class class)
 {
-  void *r;
-
-  if (class == RCLASS_CSR)
-    return reg_csr_lookup_internal (s);
-
-  r = hash_find (reg_names_hash, s);
   if (r == NULL || DECODE_REG_CLASS (r) != class)
     return -1;
 
@@ -804,8 +801,97 @@ reg_lookup_internal (const char *s, enum reg_class class)
   return DECODE_REG_NUM (r);
 }
 
+static unsigned int
+reg_lookup_internal (const char *s, enum reg_class class)
+{
+  if (class == RCLASS_CSR)
+    return reg_csr_lookup_internal (s);
+
+  return reg_class_num (hash_find (reg_names_hash, s), class);
+}
+
+/* The names in the operands of an instruction, with their
+   reg_names_hash entries.  riscv_ip splits the operands into names
+   once, and shares the lookups between all the variants of the
+   mnemonic it tries.  */
+
+#define MAX_REG_TOKENS 8
+
+struct riscv_reg_tokens
+{
+  unsigned int count;
+  struct
+  {
+    /* Start of the name in the operand string.  */
+    const char *name;
+    /* Its reg_names_hash entry, or NULL if it is not a register.  */
+    void *reg;
+  } token[MAX_REG_TOKENS];
+};
+
+/* Split the operand string S into the names that reg_lookup may be
+   asked about, and look each of them up in reg_names_hash.  Names
+   past MAX_REG_TOKENS are looked up by reg_lookup itself.  */
+
+static void
+riscv_tokenize_reg_names (char *s, struct riscv_reg_tokens *tokens)
+{
+  tokens->count = 0;
+  while (*s != '\0' && tokens->count < MAX_REG_TOKENS)
+    {
+      char *e;
+      char save_c;
+
+      if (!is_part_of_name (*s) && !is_name_beginner (*s))
+	{
+	  ++s;
+	  continue;
+	}
+
+      /* Skip numbers, such as the "1" of "1f".  */
+      e = s;
+      if (is_name_beginner (*e))
+	++e;
+      while (is_part_of_name (*e))
+	++e;
+      if (!is_name_beginner (*s))
+	{
+	  s = e;
+	  continue;
+	}
+
+      save_c = *e;
+      *e = '\0';
+      tokens->token[tokens->count].name = s;
+      tokens->token[tokens->count].reg = hash_find (reg_names_hash, s);
+      tokens->count++;
+      *e = save_c;
+      s = e;
+    }
+}
+
+/* Return the reg_names_hash entry for the name S, which ends at a
+   NUL, using TOKENS if it is one of them.  */
+
+static void *
+riscv_reg_token_find (const char *s, const struct riscv_reg_tokens *tokens)
+{
+  unsigned int i;
+
+  if (tokens != NULL)
+    for (i = 0; i < tokens->count; i++)
+      if (tokens->token[i].name == s)
+	return tokens->token[i].reg;
+
+  return hash_find (reg_names_hash, s);
+}
+
+/* Look up the register named at *S, of class CLASS.  TOKENS, if not
+   NULL, holds the names of the current instruction.  */
+
 static bfd_boolean
-reg_lookup (char **s, enum reg_class class, unsigned int *regnop)
+reg_lookup (char **s, enum reg_class class,
+	    const struct riscv_reg_tokens *tokens, unsigned int *regnop)
 {
   char *e;
   char save_c;
@@ -823,7 +909,11 @@ reg_lookup (char **s, enum reg_class class, unsigned int *regnop)
   *e = '\0';
 
   /* Look for the register.  Advance to next token if one was recognized.  */
-  if ((reg = reg_lookup_internal (*s, class)) >= 0)
+  if (class == RCLASS_CSR)
+    reg = reg_csr_lookup_internal (*s);
+  else
+    reg = reg_class_num (riscv_reg_token_find (*s, tokens), class);
+  if (reg >= 0)
     *s = e;
 
   *e = save_c;
@@ -1619,7 +1709,8 @@ my_getExpression (expressionS *ep, char *str)
 
 static size_t
 my_getSmallExpression (expressionS *ep, bfd_reloc_code_real_type *reloc,
-		       char *str, const struct percent_op_match *percent_op)
+		       char *str, const struct percent_op_match *percent_op,
+		       const struct riscv_reg_tokens *tokens)
 {
   size_t reloc_index;
   unsigned crux_depth, str_depth, regno;
@@ -1629,7 +1720,7 @@ my_getSmallExpression (expressionS *ep, bfd_reloc_code_real_type *reloc,
      we need to avoid accidentally creating a useless undefined symbol below,
      if this is an instruction pattern that can't match.  A glibc build fails
      if this is removed.  */
-  if (reg_lookup (&str, RCLASS_GPR, &regno))
+  if (reg_lookup (&str, RCLASS_GPR, tokens, &regno))
     {
       ep->X_op = O_register;
       ep->X_add_number = regno;
@@ -1678,7 +1769,8 @@ my_getSmallExpression (expressionS *ep, bfd_reloc_code_real_type *reloc,
 /* Parse opcode name, could be an mnemonics or number.  */
 static size_t
 my_getOpcodeExpression (expressionS *ep, bfd_reloc_code_real_type *reloc,
-			char *str, const struct percent_op_match *percent_op)
+			char *str, const struct percent_op_match *percent_op,
+			const struct riscv_reg_tokens *tokens)
 {
   const struct opcode_name_t *o = opcode_name_lookup (&str);
 
@@ -1689,7 +1781,7 @@ my_getOpcodeExpression (expressionS *ep, bfd_reloc_code_real_type *reloc,
       return 0;
     }
 
-  return my_getSmallExpression (ep, reloc, str, percent_op);
+  return my_getSmallExpression (ep, reloc, str, percent_op, tokens);
 }
 
 /* Detect and handle implicitly zero load-store offsets.  For example,
@@ -1810,6 +1902,7 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
   const char *error = "unrecognized opcode";
   /* Indicate we are assembling instruction with CSR.  */
   bfd_boolean insn_with_csr = FALSE;
+  struct riscv_reg_tokens reg_tokens;
 
   /* Parse the name of the instruction.  Terminate the string if whitespace
      is found so that hash_find only sees the name part of the string.  */
@@ -1824,6 +1917,7 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
   insn = (struct riscv_opcode *) hash_find (hash, str);
 
   argsStart = s;
+  riscv_tokenize_reg_names (argsStart, &reg_tokens);
   for ( ; insn && insn->name && strcmp (insn->name, str) == 0; insn++)
     {
       if ((insn->xlen_requirement != 0) && (xlen != insn->xlen_requirement))
@@ -1885,49 +1979,50 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	      switch (*++args)
 		{
 		case 's': /* RS1 x8-x15 */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || !(regno >= 8 && regno <= 15))
 		    break;
 		  INSERT_OPERAND (CRS1S, *ip, regno % 8);
 		  continue;
 		case 'w': /* RS1 x8-x15, constrained to equal RD x8-x15.  */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || EXTRACT_OPERAND (CRS1S, ip->insn_opcode) + 8 != regno)
 		    break;
 		  continue;
 		case 't': /* RS2 x8-x15 */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || !(regno >= 8 && regno <= 15))
 		    break;
 		  INSERT_OPERAND (CRS2S, *ip, regno % 8);
 		  continue;
 		case 'x': /* RS2 x8-x15, constrained to equal RD x8-x15.  */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || EXTRACT_OPERAND (CRS2S, ip->insn_opcode) + 8 != regno)
 		    break;
 		  continue;
 		case 'U': /* RS1, constrained to equal RD.  */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || EXTRACT_OPERAND (RD, ip->insn_opcode) != regno)
 		    break;
 		  continue;
 		case 'V': /* RS2 */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno))
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno))
 		    break;
 		  INSERT_OPERAND (CRS2, *ip, regno);
 		  continue;
 		case 'c': /* RS1, constrained to equal sp.  */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || regno != X_SP)
 		    break;
 		  continue;
 		case 'z': /* RS2, contrained to equal x0.  */
-		  if (!reg_lookup (&s, RCLASS_GPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno)
 		      || regno != 0)
 		    break;
 		  continue;
 		case '>':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number <= 0
 		      || imm_expr->X_add_number >= 64)
@@ -1938,7 +2033,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  imm_expr->X_op = O_absent;
 		  continue;
 		case '<':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_IMM (imm_expr->X_add_number)
 		      || imm_expr->X_add_number <= 0
@@ -1947,7 +2043,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  ip->insn_opcode |= ENCODE_RVC_IMM (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case '8':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_UIMM8 (imm_expr->X_add_number)
 		      || imm_expr->X_add_number < 0
@@ -1956,7 +2053,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  ip->insn_opcode |= ENCODE_RVC_UIMM8 (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case 'i':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number == 0
 		      || !VALID_RVC_SIMM3 (imm_expr->X_add_number))
@@ -1964,7 +2062,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  ip->insn_opcode |= ENCODE_RVC_SIMM3 (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case 'j':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number == 0
 		      || !VALID_RVC_IMM (imm_expr->X_add_number))
@@ -1974,7 +2073,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'k':
 		  if (riscv_handle_implicit_zero_offset (imm_expr, s))
 		    continue;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_LW_IMM (imm_expr->X_add_number))
 		    break;
@@ -1983,7 +2083,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'l':
 		  if (riscv_handle_implicit_zero_offset (imm_expr, s))
 		    continue;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_LD_IMM (imm_expr->X_add_number))
 		    break;
@@ -1992,7 +2093,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'm':
 		  if (riscv_handle_implicit_zero_offset (imm_expr, s))
 		    continue;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_LWSP_IMM (imm_expr->X_add_number))
 		    break;
@@ -2002,7 +2104,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'n':
 		  if (riscv_handle_implicit_zero_offset (imm_expr, s))
 		    continue;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_LDSP_IMM (imm_expr->X_add_number))
 		    break;
@@ -2010,7 +2113,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		    ENCODE_RVC_LDSP_IMM (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case 'o':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      /* C.addiw, c.li, and c.andi allow zero immediate.
 			 C.addi allows zero immediate as hint.  Otherwise this
@@ -2020,7 +2124,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  ip->insn_opcode |= ENCODE_RVC_IMM (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case 'K':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_ADDI4SPN_IMM (imm_expr->X_add_number)
 		      || imm_expr->X_add_number == 0)
@@ -2029,7 +2134,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		    ENCODE_RVC_ADDI4SPN_IMM (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case 'L':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_ADDI16SP_IMM (imm_expr->X_add_number)
 		      || imm_expr->X_add_number == 0)
@@ -2040,7 +2146,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'M':
 		  if (riscv_handle_implicit_zero_offset (imm_expr, s))
 		    continue;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_SWSP_IMM (imm_expr->X_add_number))
 		    break;
@@ -2050,7 +2157,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'N':
 		  if (riscv_handle_implicit_zero_offset (imm_expr, s))
 		    continue;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || !VALID_RVC_SDSP_IMM (imm_expr->X_add_number))
 		    break;
@@ -2059,7 +2167,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  goto rvc_imm_done;
 		case 'u':
 		  p = percent_op_utype;
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p))
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens))
 		    break;
 		rvc_lui:
 		  if (imm_expr->X_op != O_constant
@@ -2072,7 +2181,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  ip->insn_opcode |= ENCODE_RVC_IMM (imm_expr->X_add_number);
 		  goto rvc_imm_done;
 		case 'v':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || (imm_expr->X_add_number & (RISCV_IMM_REACH - 1))
 		      || ((int32_t)imm_expr->X_add_number
 			  != imm_expr->X_add_number))
@@ -2085,19 +2195,19 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		case 'a':
 		  goto jump;
 		case 'S': /* Floating-point RS1 x8-x15.  */
-		  if (!reg_lookup (&s, RCLASS_FPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_FPR, &reg_tokens, &regno)
 		      || !(regno >= 8 && regno <= 15))
 		    break;
 		  INSERT_OPERAND (CRS1S, *ip, regno % 8);
 		  continue;
 		case 'D': /* Floating-point RS2 x8-x15.  */
-		  if (!reg_lookup (&s, RCLASS_FPR, &regno)
+		  if (!reg_lookup (&s, RCLASS_FPR, &reg_tokens, &regno)
 		      || !(regno >= 8 && regno <= 15))
 		    break;
 		  INSERT_OPERAND (CRS2S, *ip, regno % 8);
 		  continue;
 		case 'T': /* Floating-point RS2.  */
-		  if (!reg_lookup (&s, RCLASS_FPR, &regno))
+		  if (!reg_lookup (&s, RCLASS_FPR, &reg_tokens, &regno))
 		    break;
 		  INSERT_OPERAND (CRS2, *ip, regno);
 		  continue;
@@ -2105,7 +2215,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  switch (*++args)
 		    {
 		      case '6':
-		        if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+			if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+						   &reg_tokens)
 			    || imm_expr->X_op != O_constant
 			    || imm_expr->X_add_number < 0
 			    || imm_expr->X_add_number >= 64)
@@ -2120,7 +2231,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 			s = expr_end;
 			continue;
 		      case '4':
-		        if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+			if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+						   &reg_tokens)
 			    || imm_expr->X_op != O_constant
 			    || imm_expr->X_add_number < 0
 			    || imm_expr->X_add_number >= 16)
@@ -2135,7 +2247,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 			s = expr_end;
 			continue;
 		      case '3':
-			if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+			if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+						   &reg_tokens)
 			    || imm_expr->X_op != O_constant
 			    || imm_expr->X_add_number < 0
 			    || imm_expr->X_add_number >= 8)
@@ -2149,7 +2262,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 			s = expr_end;
 			continue;
 		      case '2':
-			if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+			if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+						   &reg_tokens)
 			    || imm_expr->X_op != O_constant
 			    || imm_expr->X_add_number < 0
 			    || imm_expr->X_add_number >= 4)
@@ -2225,7 +2339,7 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	    case 'E':		/* Control register.  */
 	      insn_with_csr = TRUE;
 	      explicit_priv_attr = TRUE;
-	      if (reg_lookup (&s, RCLASS_CSR, &regno))
+	      if (reg_lookup (&s, RCLASS_CSR, &reg_tokens, &regno))
 		INSERT_OPERAND (CSR, *ip, regno);
 	      else
 		{
@@ -2265,7 +2379,7 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	    case 's':		/* Source register.  */
 	    case 't':		/* Target register.  */
 	    case 'r':		/* rs3.  */
-	      if (reg_lookup (&s, RCLASS_GPR, &regno))
+	      if (reg_lookup (&s, RCLASS_GPR, &reg_tokens, &regno))
 		{
 		  c = *args;
 		  if (*s == ' ')
@@ -2297,7 +2411,7 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	    case 'T':		/* Floating point rs2.  */
 	    case 'U':		/* Floating point rs1 and rs2.  */
 	    case 'R':		/* Floating point rs3.  */
-	      if (reg_lookup (&s, RCLASS_FPR, &regno))
+	      if (reg_lookup (&s, RCLASS_FPR, &reg_tokens, &regno))
 		{
 		  c = *args;
 		  if (*s == ' ')
@@ -2379,7 +2493,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	      /* If this value won't fit into a 16 bit offset, then go
 		 find a macro that will generate the 32 bit offset
 		 code pattern.  */
-	      if (!my_getSmallExpression (imm_expr, imm_reloc, s, p))
+	      if (!my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					  &reg_tokens))
 		{
 		  normalize_constant_expr (imm_expr);
 		  if (imm_expr->X_op != O_constant
@@ -2402,7 +2517,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 
 	    case 'u':		/* Upper 20 bits.  */
 	      p = percent_op_utype;
-	      if (!my_getSmallExpression (imm_expr, imm_reloc, s, p))
+	      if (!my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					  &reg_tokens))
 		{
 		  if (imm_expr->X_op != O_constant)
 		    break;
@@ -2439,7 +2555,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	      switch (*++args)
 		{
 		case '4':
-		  if (my_getOpcodeExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getOpcodeExpression (imm_expr, imm_reloc, s, p,
+					      &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number < 0
 		      || imm_expr->X_add_number >= 128
@@ -2456,7 +2573,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  s = expr_end;
 		  continue;
 		case '2':
-		  if (my_getOpcodeExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getOpcodeExpression (imm_expr, imm_reloc, s, p,
+					      &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number < 0
 		      || imm_expr->X_add_number >= 3)
@@ -2479,7 +2597,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	      switch (*++args)
 		{
 		case '7':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number < 0
 		      || imm_expr->X_add_number >= 128)
@@ -2494,7 +2613,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  s = expr_end;
 		  continue;
 		case '3':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number < 0
 		      || imm_expr->X_add_number >= 8)
@@ -2509,7 +2629,8 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 		  s = expr_end;
 		  continue;
 		case '2':
-		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+		  if (my_getSmallExpression (imm_expr, imm_reloc, s, p,
+					     &reg_tokens)
 		      || imm_expr->X_op != O_constant
 		      || imm_expr->X_add_number < 0
 		      || imm_expr->X_add_number >= 4)
@@ -2530,7 +2651,7 @@ riscv_ip (char *str, struct riscv_cl_insn *ip, expressionS *imm_expr,
 	      break;
 
 	    case 'z':
-	      if (my_getSmallExpression (imm_expr, imm_reloc, s, p)
+	      if (my_getSmallExpression (imm_expr, imm_reloc, s, p, &reg_tokens)
 		  || imm_expr->X_op != O_constant
 		  || imm_expr->X_add_number != 0)
 		break;
@@ -18,42 +18,58 @@
    Software Foundation, 51 Franklin Street - Fifth Floor, Boston, MA
    02110-1301, USA.  */
 
-/* This version of the hash table code is a wholescale replacement of
-   the old hash table code, which was fairly bad.  This is based on
-   the hash table code in BFD, but optimized slightly for the
-   assembler.  The assembler does not need to derive structures that
-   are stored in the hash table.  Instead, it always stores a pointer.
-   The assembler uses the hash table mostly to store symbols, and we
-   don't need to confuse the symbol structure with a hash table
-   structure.  */
+/* This is an open addressing hash table.  Entries are kept in an
+   array in insertion order, and an array of slots, probed linearly,
+   maps a key's hash code to its entry.  Each slot caches the hash code,
+   so a probe only looks at the entry and its string when the hash codes
+   agree.  The slot array is a power of two in size and is doubled
+   whenever it becomes half full, so lookups stay cheap however many
+   symbols are defined.
+
+   The assembler does not need to derive structures that are stored in
+   the hash table.  Instead, it always stores a pointer.  The assembler
+   uses the hash table mostly to store symbols, and we don't need to
+   confuse the symbol structure with a hash table structure.  */
 
 #include "as.h"
 #include "safe-ctype.h"
-#include "obstack.h"
 
-/* An entry in a hash table.  */
+/* An entry in a hash table.  Deleted entries have a NULL string.  */
 
 struct hash_entry {
-  /* Next entry for this hash code.  */
-  struct hash_entry *next;
   /* String being hashed.  */
   const char *string;
-  /* Hash code.  This is the full hash code, not the index into the
-     table.  */
-  unsigned long hash;
   /* Pointer being stored in the hash table.  */
   void *data;
 };
 
+/* A slot in a hash table.  */
+
+struct hash_slot {
+  /* Hash code of the entry.  */
+  unsigned int hash;
+  /* One more than the index of the entry, HASH_SLOT_EMPTY if the slot
+     has never been used, or HASH_SLOT_DELETED if its entry has been
+     deleted.  */
+  unsigned int index;
+};
+
+#define HASH_SLOT_EMPTY 0
+#define HASH_SLOT_DELETED (~0U)
+
 /* A hash table.  */
 
 struct hash_control {
-  /* The hash array.  */
-  struct hash_entry **table;
-  /* The number of slots in the hash table.  */
+  /* The slot array.  */
+  struct hash_slot *slots;
+  /* The number of slots.  This is a power of two.  */
   unsigned int size;
-  /* An obstack for this hash table.  */
-  struct obstack memory;
+  /* The entries, in insertion order.  There is room for SIZE / 2.  */
+  struct hash_entry *entries;
+  /* The number of entries used, including deleted ones.  */
+  unsigned int count;
+  /* The number of deleted entries.  */
+  unsigned int deleted;
 
 #ifdef HASH_STATISTICS
   /* Statistics.  */
@@ -63,15 +79,16 @@ struct hash_control {
   unsigned long insertions;
   unsigned long replacements;
   unsigned long deletions;
+  unsigned long resizes;
 #endif /* HASH_STATISTICS */
 };
 
-/* The default number of entries to use when creating a hash table.
-   Note this value can be reduced to 4051 by using the command line
-   switch --reduce-memory-overheads, or set to other values by using
-   the --hash-size=<NUMBER> switch.  */
+/* The default number of entries to make room for when creating a hash
+   table.  Tables grow as needed, so this only saves the cost of growing
+   them.  It can be set to other values by using the --hash-size=<NUMBER>
+   switch.  */
 
-static unsigned long gas_hash_table_size = 65537;
+static unsigned long gas_hash_table_size = 4051;
 
 void
 set_gas_hash_table_size (unsigned long size)
@@ -79,20 +96,122 @@ set_gas_hash_table_size (unsigned long size)
   gas_hash_table_size = bfd_hash_set_default_size (size);
 }
 
-/* Create a hash table.  This return a control block.  */
+/* Compute the hash code of the LEN characters of KEY.  The low bits
+   select the slot, so finish by mixing the high bits into them.  */
+
+static unsigned int
+hash_string (const char *key, size_t len)
+{
+  unsigned long hash;
+  unsigned int h;
+  size_t n;
+  unsigned int c;
+
+  hash = 0;
+  for (n = 0; n < len; n++)
+    {
+      c = key[n];
+      hash += c + (c << 17);
+      hash ^= hash >> 2;
+    }
+  hash += len + (len << 17);
+  hash ^= hash >> 2;
+
+  h = (unsigned int) (hash ^ (hash >> 31 >> 1));
+  h ^= h >> 16;
+  h *= 0x85ebca6b;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35;
+  h ^= h >> 16;
+  return h;
+}
+
+/* Give TABLE an empty slot array of SIZE slots, and room for SIZE / 2
+   entries.  */
+
+static void
+hash_alloc (struct hash_control *table, unsigned int size)
+{
+  table->slots = XCNEWVEC (struct hash_slot, size);
+  table->entries = XNEWVEC (struct hash_entry, size / 2);
+  table->size = size;
+  table->count = 0;
+  table->deleted = 0;
+}
+
+/* Make room in TABLE for another entry, dropping deleted entries and
+   doubling the number of slots if the table would otherwise be more
+   than half full.  The entries keep their order.  */
+
+static void
+hash_grow (struct hash_control *table)
+{
+  struct hash_slot *old_slots = table->slots;
+  struct hash_entry *old_entries = table->entries;
+  unsigned int old_size = table->size;
+  unsigned int old_count = table->count;
+  unsigned int live = old_count - table->deleted;
+  unsigned int *hashes;
+  unsigned int size, mask, i;
+
+  size = old_size;
+  while (live >= size / 4)
+    size *= 2;
+
+#ifdef HASH_STATISTICS
+  ++table->resizes;
+#endif
+
+  /* The hash codes are only kept in the slots.  Collect them in entry
+     order so that the entries keep their order in the new table.  */
+  hashes = XNEWVEC (unsigned int, old_count + 1);
+  for (i = 0; i < old_size; i++)
+    {
+      unsigned int index = old_slots[i].index;
+
+      if (index != HASH_SLOT_EMPTY && index != HASH_SLOT_DELETED)
+	hashes[index - 1] = old_slots[i].hash;
+    }
+
+  hash_alloc (table, size);
+  mask = size - 1;
+
+  for (i = 0; i < old_count; i++)
+    {
+      unsigned int j;
+
+      if (old_entries[i].string == NULL)
+	continue;
+
+      j = hashes[i] & mask;
+      while (table->slots[j].index != HASH_SLOT_EMPTY)
+	j = (j + 1) & mask;
+
+      table->slots[j].hash = hashes[i];
+      table->slots[j].index = table->count + 1;
+      table->entries[table->count] = old_entries[i];
+      table->count++;
+    }
+
+  free (hashes);
+  free (old_slots);
+  free (old_entries);
+}
+
+/* Create a hash table with room for SIZE entries.  This return a
+   control block.  */
 
 struct hash_control *
 hash_new_sized (unsigned long size)
 {
-  unsigned long alloc;
   struct hash_control *ret;
+  unsigned int slots;
 
   ret = XNEW (struct hash_control);
-  obstack_begin (&ret->memory, chunksize);
-  alloc = size * sizeof (struct hash_entry *);
-  ret->table = (struct hash_entry **) obstack_alloc (&ret->memory, alloc);
-  memset (ret->table, 0, alloc);
-  ret->size = size;
+  slots = 16;
+  while (slots / 2 <= size && slots < (1U << 30))
+    slots *= 2;
+  hash_alloc (ret, slots);
 
 #ifdef HASH_STATISTICS
   ret->lookups = 0;
@@ -101,6 +220,7 @@ hash_new_sized (unsigned long size)
   ret->insertions = 0;
   ret->replacements = 0;
   ret->deletions = 0;
+  ret->resizes = 0;
 #endif
 
   return ret;
@@ -117,84 +237,94 @@ hash_new (void)
 void
 hash_die (struct hash_control *table)
 {
-  obstack_free (&table->memory, 0);
+  free (table->slots);
+  free (table->entries);
   free (table);
 }
 
 /* Look up a string in a hash table.  This returns a pointer to the
-   hash_entry, or NULL if the string is not in the table.  If PLIST is
-   not NULL, this sets *PLIST to point to the start of the list which
-   would hold this hash entry.  If PHASH is not NULL, this sets *PHASH
-   to the hash code for KEY.
+   slot holding the string, or NULL if the string is not in the table.
+   If PFREE is not NULL, this sets *PFREE to the slot where the string
+   should be entered if it is not found.  If PHASH is not NULL, this
+   sets *PHASH to the hash code for KEY.  */
 
-   Each time we look up a string, we move it to the start of the list
-   for its hash code, to take advantage of referential locality.  */
-
-static struct hash_entry *
+static struct hash_slot *
 hash_lookup (struct hash_control *table, const char *key, size_t len,
-	     struct hash_entry ***plist, unsigned long *phash)
+	     struct hash_slot **pfree, unsigned int *phash)
 {
-  unsigned long hash;
-  size_t n;
-  unsigned int c;
-  unsigned int hindex;
-  struct hash_entry **list;
-  struct hash_entry *p;
-  struct hash_entry *prev;
+  unsigned int hash;
+  unsigned int mask;
+  unsigned int i;
+  struct hash_slot *deleted;
 
 #ifdef HASH_STATISTICS
   ++table->lookups;
 #endif
 
-  hash = 0;
-  for (n = 0; n < len; n++)
-    {
-      c = key[n];
-      hash += c + (c << 17);
-      hash ^= hash >> 2;
-    }
-  hash += len + (len << 17);
-  hash ^= hash >> 2;
-
+  hash = hash_string (key, len);
   if (phash != NULL)
     *phash = hash;
 
-  hindex = hash % table->size;
-  list = table->table + hindex;
+  mask = table->size - 1;
+  deleted = NULL;
+  for (i = hash & mask; ; i = (i + 1) & mask)
+    {
+      struct hash_slot *slot = table->slots + i;
 
-  if (plist != NULL)
-    *plist = list;
+      if (slot->index == HASH_SLOT_EMPTY)
+	{
+	  if (pfree != NULL)
+	    *pfree = deleted != NULL ? deleted : slot;
+	  return NULL;
+	}
+
+      if (slot->index == HASH_SLOT_DELETED)
+	{
+	  if (deleted == NULL)
+	    deleted = slot;
+	  continue;
+	}
 
-  prev = NULL;
-  for (p = *list; p != NULL; p = p->next)
-    {
 #ifdef HASH_STATISTICS
       ++table->hash_compares;
 #endif
 
-      if (p->hash == hash)
+      if (slot->hash == hash)
 	{
+	  const char *string = table->entries[slot->index - 1].string;
+
 #ifdef HASH_STATISTICS
 	  ++table->string_compares;
 #endif
 
-	  if (strncmp (p->string, key, len) == 0 && p->string[len] == '\0')
-	    {
-	      if (prev != NULL)
-		{
-		  prev->next = p->next;
-		  p->next = *list;
-		  *list = p;
-		}
-
-	      return p;
-	    }
+	  if (strncmp (string, key, len) == 0 && string[len] == '\0')
+	    return slot;
 	}
+    }
+}
+
+/* Enter KEY with value VAL in TABLE, whose lookup of KEY gave a hash
+   code of HASH and a free slot of SLOT.  */
+
+static void
+hash_add (struct hash_control *table, const char *key, void *val,
+	  struct hash_slot *slot, unsigned int hash)
+{
+#ifdef HASH_STATISTICS
+  ++table->insertions;
+#endif
 
-      prev = p;
+  if (table->count + 1 >= table->size / 2)
+    {
+      hash_grow (table);
+      hash_lookup (table, key, strlen (key), &slot, NULL);
     }
 
-  return NULL;
+  slot->hash = hash;
+  slot->index = table->count + 1;
+  table->entries[table->count].string = key;
+  table->entries[table->count].data = val;
+  table->count++;
 }
 
 /* Insert an entry into a hash table.  This returns NULL on success.
@@ -205,26 +335,15 @@ hash_lookup (struct hash_control *table, const char *key, size_t len,
 const char *
 hash_insert (struct hash_control *table, const char *key, void *val)
 {
-  struct hash_entry *p;
-  struct hash_entry **list;
-  unsigned long hash;
+  struct hash_slot *slot;
+  struct hash_slot *free_slot;
+  unsigned int hash;
 
-  p = hash_lookup (table, key, strlen (key), &list, &hash);
-  if (p != NULL)
+  slot = hash_lookup (table, key, strlen (key), &free_slot, &hash);
+  if (slot != NULL)
     return "exists";
 
-#ifdef HASH_STATISTICS
-  ++table->insertions;
-#endif
-
-  p = (struct hash_entry *) obstack_alloc (&table->memory, sizeof (*p));
-  p->string = key;
-  p->hash = hash;
-  p->data = val;
-
-  p->next = *list;
-  *list = p;
-
+  hash_add (table, key, val, free_slot, hash);
   return NULL;
 }
 
@@ -235,33 +354,21 @@ hash_insert (struct hash_control *table, const char *key, void *val)
 const char *
 hash_jam (struct hash_control *table, const char *key, void *val)
 {
-  struct hash_entry *p;
-  struct hash_entry **list;
-  unsigned long hash;
+  struct hash_slot *slot;
+  struct hash_slot *free_slot;
+  unsigned int hash;
 
-  p = hash_lookup (table, key, strlen (key), &list, &hash);
-  if (p != NULL)
+  slot = hash_lookup (table, key, strlen (key), &free_slot, &hash);
+  if (slot != NULL)
     {
 #ifdef HASH_STATISTICS
       ++table->replacements;
 #endif
 
-      p->data = val;
+      table->entries[slot->index - 1].data = val;
     }
   else
-    {
-#ifdef HASH_STATISTICS
-      ++table->insertions;
-#endif
-
-      p = (struct hash_entry *) obstack_alloc (&table->memory, sizeof (*p));
-      p->string = key;
-      p->hash = hash;
-      p->data = val;
-
-      p->next = *list;
-      *list = p;
-    }
+    hash_add (table, key, val, free_slot, hash);
 
   return NULL;
 }
@@ -273,17 +380,19 @@ hash_jam (struct hash_control *table, const char *key, void *val)
 void *
 hash_replace (struct hash_control *table, const char *key, void *value)
 {
+  struct hash_slot *slot;
   struct hash_entry *p;
   void *ret;
 
-  p = hash_lookup (table, key, strlen (key), NULL, NULL);
-  if (p == NULL)
+  slot = hash_lookup (table, key, strlen (key), NULL, NULL);
+  if (slot == NULL)
     return NULL;
 
 #ifdef HASH_STATISTICS
   ++table->replacements;
 #endif
 
+  p = table->entries + slot->index - 1;
   ret = p->data;
 
   p->data = value;
@@ -297,13 +406,13 @@ hash_replace (struct hash_control *table, const char *key, void *value)
 void *
 hash_find (struct hash_control *table, const char *key)
 {
-  struct hash_entry *p;
+  struct hash_slot *slot;
 
-  p = hash_lookup (table, key, strlen (key), NULL, NULL);
-  if (p == NULL)
+  slot = hash_lookup (table, key, strlen (key), NULL, NULL);
+  if (slot == NULL)
     return NULL;
 
-  return p->data;
+  return table->entries[slot->index - 1].data;
 }
 
 /* As hash_find, but KEY is of length LEN and is not guaranteed to be
@@ -312,45 +421,45 @@ hash_find (struct hash_control *table, const char *key)
 void *
 hash_find_n (struct hash_control *table, const char *key, size_t len)
 {
-  struct hash_entry *p;
+  struct hash_slot *slot;
 
-  p = hash_lookup (table, key, len, NULL, NULL);
-  if (p == NULL)
+  slot = hash_lookup (table, key, len, NULL, NULL);
+  if (slot == NULL)
     return NULL;
 
-  return p->data;
+  return table->entries[slot->index - 1].data;
 }
 
 /* Delete an entry from a hash table.  This returns the value stored
-   for that entry, or NULL if there is no such entry.  */
+   for that entry, or NULL if there is no such entry.  Entries are not
+   allocated separately, so FREEME is ignored.  */
 
 void *
-hash_delete (struct hash_control *table, const char *key, int freeme)
+hash_delete (struct hash_control *table, const char *key,
+	     int freeme ATTRIBUTE_UNUSED)
 {
+  struct hash_slot *slot;
   struct hash_entry *p;
-  struct hash_entry **list;
 
-  p = hash_lookup (table, key, strlen (key), &list, NULL);
-  if (p == NULL)
+  slot = hash_lookup (table, key, strlen (key), NULL, NULL);
+  if (slot == NULL)
     return NULL;
 
-  if (p != *list)
-    abort ();
-
 #ifdef HASH_STATISTICS
   ++table->deletions;
 #endif
 
-  *list = p->next;
-
-  if (freeme)
-    obstack_free (&table->memory, p);
+  p = table->entries + slot->index - 1;
+  slot->index = HASH_SLOT_DELETED;
+  p->string = NULL;
+  table->deleted++;
 
   return p->data;
 }
 
 /* Traverse a hash table.  Call the function on every entry in the
-   hash table.  */
+   hash table, in the order the entries were added.  The function may
+   delete entries, but must not add any.  */
 
 void
 hash_traverse (struct hash_control *table,
@@ -358,11 +467,11 @@ hash_traverse (struct hash_control *table,
 {
   unsigned int i;
 
-  for (i = 0; i < table->size; ++i)
+  for (i = 0; i < table->count; ++i)
     {
-      struct hash_entry *p;
+      struct hash_entry *p = table->entries + i;
 
-      for (p = table->table[i]; p != NULL; p = p->next)
+      if (p->string != NULL)
 	(*pfn) (p->string, p->data);
     }
 }
@@ -376,10 +485,6 @@ hash_print_statistics (FILE *f ATTRIBUTE_UNUSED,
 		       struct hash_control *table ATTRIBUTE_UNUSED)
 {
 #ifdef HASH_STATISTICS
-  unsigned int i;
-  unsigned long total;
-  unsigned long empty;
-
   fprintf (f, "%s hash statistics:\n", name);
   fprintf (f, "\t%lu lookups\n", table->lookups);
   fprintf (f, "\t%lu hash comparisons\n", table->hash_compares);
@@ -387,27 +492,12 @@ hash_print_statistics (FILE *f ATTRIBUTE_UNUSED,
   fprintf (f, "\t%lu insertions\n", table->insertions);
   fprintf (f, "\t%lu replacements\n", table->replacements);
   fprintf (f, "\t%lu deletions\n", table->deletions);
-
-  total = 0;
-  empty = 0;
-  for (i = 0; i < table->size; ++i)
-    {
-      struct hash_entry *p;
-
-      if (table->table[i] == NULL)
-	++empty;
-      else
-	{
-	  for (p = table->table[i]; p != NULL; p = p->next)
-	    ++total;
-	}
-    }
-
-  fprintf (f, "\t%g average chain length\n", (double) total / table->size);
-  fprintf (f, "\t%lu empty slots\n", empty);
+  fprintf (f, "\t%lu resizes\n", table->resizes);
+  fprintf (f, "\t%u entries in %u slots\n",
+	   table->count - table->deleted, table->size);
 #endif
 }
-
+
 #ifdef TEST
 
 /* This test program is left over from the old hash table code.  */
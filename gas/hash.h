@@ -23,11 +23,13 @@
 
 struct hash_control;
 
-/* Set the size of the hash table used.  */
+/* Set the number of entries hash tables initially have room for.  */
 
 void set_gas_hash_table_size (unsigned long);
 
-/* Create a hash table.  This return a control block.  */
+/* Create a hash table.  This return a control block.  hash_new_sized
+   makes room for the given number of entries; tables grow as needed
+   either way.  */
 
 extern struct hash_control *hash_new (void);
 extern struct hash_control *hash_new_sized (unsigned long);
@@ -69,12 +71,14 @@ extern void *hash_find (struct hash_control *, const char *key);
 extern void *hash_find_n (struct hash_control *, const char *key, size_t len);
 
 /* Delete an entry from a hash table.  This returns the value stored
-   for that entry, or NULL if there is no such entry.  */
+   for that entry, or NULL if there is no such entry.  The last
+   argument is ignored.  */
 
 extern void *hash_delete (struct hash_control *, const char *key, int);
 
 /* Traverse a hash table.  Call the function on every entry in the
-   hash table.  */
+   hash table, in the order the entries were added.  The function may
+   delete entries, but must not add any.  */
 
 extern void hash_traverse (struct hash_control *,
 			   void (*pfn) (const char *key, void *value));
@@ -51,6 +51,43 @@ eq_abbrev (const void *lhs, const void *rhs)
   return l_info->number == r_info->number;
 }
 
+/* Return the size of an attribute of form FORM when it is known
+   without looking at the DIE or the CU header, or -1 otherwise.  */
+
+static int
+constant_form_size (unsigned int form)
+{
+  switch (form)
+    {
+    case DW_FORM_flag_present:
+    case DW_FORM_implicit_const:
+      return 0;
+    case DW_FORM_data1:
+    case DW_FORM_ref1:
+    case DW_FORM_flag:
+    case DW_FORM_strx1:
+      return 1;
+    case DW_FORM_data2:
+    case DW_FORM_ref2:
+    case DW_FORM_strx2:
+      return 2;
+    case DW_FORM_strx3:
+      return 3;
+    case DW_FORM_data4:
+    case DW_FORM_ref4:
+    case DW_FORM_strx4:
+      return 4;
+    case DW_FORM_data8:
+    case DW_FORM_ref8:
+    case DW_FORM_ref_sig8:
+      return 8;
+    case DW_FORM_data16:
+      return 16;
+    default:
+      return -1;
+    }
+}
+
 /* Abbreviation tables.
 
    In DWARF version 2, the description of the debugging information is
@@ -101,6 +138,8 @@ abbrev_table::read (struct objfile *objfile,
   unsigned int abbrev_number, bytes_read, abbrev_name;
   unsigned int abbrev_form;
   std::vector<struct attr_abbrev> cur_attrs;
+  bool size_is_constant;
+  unsigned int size;
 
   abbrev_table_up abbrev_table (new struct abbrev_table (sect_off));
 
@@ -122,6 +161,9 @@ abbrev_table::read (struct objfile *objfile,
       abbrev_ptr += bytes_read;
       cur_abbrev->has_children = read_1_byte (abfd, abbrev_ptr);
       abbrev_ptr += 1;
+      cur_abbrev->sibling_offset = (unsigned short) -1;
+      size_is_constant = true;
+      size = 0;
 
       /* now read in declarations */
       for (;;)
@@ -147,6 +189,22 @@ abbrev_table::read (struct objfile *objfile,
 	  if (abbrev_name == 0)
 	    break;
 
+	  if (size_is_constant)
+	    {
+	      int form_size = constant_form_size (abbrev_form);
+
+	      if (abbrev_name == DW_AT_sibling
+		  && abbrev_form == DW_FORM_ref4
+		  && cur_abbrev->sibling_offset == (unsigned short) -1
+		  && size < (unsigned short) -1)
+		cur_abbrev->sibling_offset = size;
+
+	      if (form_size < 0)
+		size_is_constant = false;
+	      else
+		size += form_size;
+	    }
+
 	  cur_attrs.emplace_back ();
 	  struct attr_abbrev &cur_attr = cur_attrs.back ();
 	  cur_attr.name = (enum dwarf_attribute) abbrev_name;
@@ -154,6 +212,11 @@ abbrev_table::read (struct objfile *objfile,
 	  cur_attr.implicit_const = implicit_const;
 	}
 
+      /* A DIE without attributes has nothing to skip, so zero is safe
+	 as the "not constant" marker.  */
+      if (size_is_constant && size < (unsigned short) -1)
+	cur_abbrev->size_if_constant = size;
+
       cur_abbrev->num_attrs = cur_attrs.size ();
       cur_abbrev->attrs =
 	XOBNEWVEC (&abbrev_table->m_abbrev_obstack, struct attr_abbrev,
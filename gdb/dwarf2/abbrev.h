@@ -37,6 +37,18 @@ struct abbrev_info
     unsigned short has_children;		/* boolean */
     unsigned short num_attrs;	/* number of attributes */
     struct attr_abbrev *attrs;	/* an array of attribute descriptions */
+
+    /* If non-zero, the total size in bytes of this DIE's attributes,
+       which is known when every attribute has a form whose size does
+       not depend on the DIE or the CU header.  Such DIEs can be
+       skipped without decoding any attribute.  */
+    unsigned short size_if_constant;
+
+    /* If this abbrev has a DW_AT_sibling attribute of form
+       DW_FORM_ref4, and all attributes preceding it have constant
+       size, the offset of its value from the start of the DIE's
+       attributes.  Otherwise -1.  */
+    unsigned short sibling_offset;
   };
 
 struct attr_abbrev
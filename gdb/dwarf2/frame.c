@@ -131,6 +131,33 @@ struct dwarf2_fde
 
 typedef std::vector<dwarf2_fde *> dwarf2_fde_table;
 
+/* One row of a compiled FDE: the register rules that apply from START
+   up to the START of the next row.  */
+
+struct dwarf2_cfa_row
+{
+  /* The first address at which these rules apply, relative to the
+     text section offset of the objfile.  */
+  CORE_ADDR start;
+
+  /* The rules.  PREV is always NULL.  */
+  dwarf2_frame_state_reg_info regs;
+};
+
+/* The CIE and FDE programs of an FDE, run once over the whole address
+   range of the FDE.  Unwinding a frame then only needs a lookup in ROWS
+   instead of running the programs up to the frame's pc again.  */
+
+struct dwarf2_cfa_table
+{
+  /* The architecture the programs were run for.  */
+  struct gdbarch *gdbarch;
+
+  /* The rows, sorted by START.  Empty if the programs could not be
+     compiled, in which case they must be run for each frame.  */
+  std::vector<dwarf2_cfa_row> rows;
+};
+
 /* A minimal decoding of DWARF2 compilation units.  We only decode
    what's needed to get to the call frame information.  */
 
@@ -162,6 +189,10 @@ struct comp_unit
   /* The FDE table.  */
   dwarf2_fde_table fde_table;
 
+  /* The FDEs compiled so far.  */
+  std::unordered_map<const dwarf2_fde *, std::unique_ptr<dwarf2_cfa_table>>
+    cfa_tables;
+
   /* Hold data used by this module.  */
   auto_obstack obstack;
 };
@@ -350,13 +381,18 @@ Not implemented: computing unwound register using explicit value operator"));
 
 /* Execute FDE program from INSN_PTR possibly up to INSN_END or up to inferior
    PC.  Modify FS state accordingly.  Return current INSN_PTR where the
-   execution has stopped, one can resume it on the next call.  */
+   execution has stopped, one can resume it on the next call.
+
+   PER_ROW is true when the caller runs the FDE program one row at a
+   time.  The remembered states are then left for the caller to drop
+   once the whole program has run, and unknown instructions are
+   reported with error so that the caller can give up on the rows.  */
 
 static const gdb_byte *
 execute_cfa_program (struct dwarf2_fde *fde, const gdb_byte *insn_ptr,
 		     const gdb_byte *insn_end, struct gdbarch *gdbarch,
 		     CORE_ADDR pc, struct dwarf2_frame_state *fs,
-		     CORE_ADDR text_offset)
+		     CORE_ADDR text_offset, bool per_row = false)
 {
   int eh_frame_p = fde->eh_frame_p;
   unsigned int bytes_read;
@@ -605,6 +641,8 @@ bad CFI data; mismatched DW_CFA_restore_state at %s"),
 			     "space is not handled on this architecture."),
 			   insn);
 		}
+	      else if (per_row)
+		error (_("Unknown CFI encountered."));
 	      else
 		internal_error (__FILE__, __LINE__,
 				_("Unknown CFI encountered."));
@@ -612,7 +650,7 @@ bad CFI data; mismatched DW_CFA_restore_state at %s"),
 	}
     }
 
-  if (fs->initial.reg.empty ())
+  if (fs->initial.reg.empty () && !per_row)
     {
       /* Don't allow remember/restore between CIE and FDE programs.  */
       delete fs->regs.prev;
@@ -622,6 +660,71 @@ bad CFI data; mismatched DW_CFA_restore_state at %s"),
   return insn_ptr;
 }
 
+/* Run the CIE and FDE programs of FDE over the whole address range of
+   the FDE, for an objfile whose text section is at TEXT_OFFSET, and
+   store the resulting rows in TABLE.  FS must have been initialized for
+   the start of the FDE, with the producer quirks applied.  */
+
+static void
+compile_cfa_program (struct dwarf2_fde *fde, struct gdbarch *gdbarch,
+		     struct dwarf2_frame_state *fs, CORE_ADDR text_offset,
+		     struct dwarf2_cfa_table *table)
+{
+  const CORE_ADDR start = fs->pc;
+
+  table->gdbarch = gdbarch;
+
+  execute_cfa_program (fde, fde->cie->initial_instructions, fde->cie->end,
+		       gdbarch, (CORE_ADDR) -1, fs, text_offset);
+
+  /* If the CIE program moves the location, its rules depend on the pc
+     it is run for.  Leave that rare case to execute_cfa_program.  */
+  if (fs->pc != start)
+    return;
+
+  fs->initial = fs->regs;
+
+  const gdb_byte *insn_ptr = fde->instructions;
+  while (true)
+    {
+      CORE_ADDR row_start = fs->pc;
+
+      /* This runs the instructions for ROW_START, stopping after the
+	 first one that moves the location past it.  */
+      insn_ptr = execute_cfa_program (fde, insn_ptr, fde->end, gdbarch,
+				      row_start, fs, text_offset, true);
+
+      table->rows.emplace_back ();
+      dwarf2_cfa_row &row = table->rows.back ();
+      row.start = row_start - text_offset;
+      row.regs = fs->regs;
+      row.regs.prev = nullptr;
+
+      if (insn_ptr >= fde->end)
+	break;
+    }
+
+  /* The remembered states only live as long as the FDE program.  */
+  delete fs->regs.prev;
+  fs->regs.prev = NULL;
+}
+
+/* Return the row of TABLE that applies at PC, which is relative to the
+   text section offset of the objfile.  TABLE must not be empty.  */
+
+static const dwarf2_cfa_row &
+find_cfa_row (const struct dwarf2_cfa_table &table, CORE_ADDR pc)
+{
+  auto it = std::upper_bound (table.rows.begin (), table.rows.end (), pc,
+			      [] (CORE_ADDR addr, const dwarf2_cfa_row &row)
+			      {
+				return addr < row.start;
+			      });
+  if (it != table.rows.begin ())
+    --it;
+  return *it;
+}
+
 #if GDB_SELF_TEST
 
 namespace selftests {
@@ -679,6 +782,75 @@ execute_cfa_program_test (struct gdbarch *gdbarch)
   SELF_CHECK (fs.regs.prev == NULL);
 }
 
+/* Unit test to function compile_cfa_program.  Check that the row found
+   for each pc matches the result of running the program up to it.  */
+
+static void
+compile_cfa_program_test (struct gdbarch *gdbarch)
+{
+  struct dwarf2_fde fde;
+  struct dwarf2_cie cie;
+
+  memset (&fde, 0, sizeof fde);
+  memset (&cie, 0, sizeof cie);
+
+  cie.data_alignment_factor = -4;
+  cie.code_alignment_factor = 2;
+  fde.cie = &cie;
+
+  gdb_byte insns[] =
+    {
+      DW_CFA_def_cfa, 1, 4,		/* DW_CFA_def_cfa: r1 ofs 4 */
+      DW_CFA_advance_loc | 1,		/* DW_CFA_advance_loc: 2 */
+      DW_CFA_def_cfa_offset, 8,		/* DW_CFA_def_cfa_offset: 8 */
+      DW_CFA_remember_state,
+      DW_CFA_advance_loc | 1,		/* DW_CFA_advance_loc: 2 */
+      DW_CFA_offset | 0x2, 1,		/* DW_CFA_offset: r2 at cfa-4 */
+      DW_CFA_advance_loc | 0,		/* DW_CFA_advance_loc: 0 */
+      DW_CFA_def_cfa_offset, 16,	/* DW_CFA_def_cfa_offset: 16 */
+      DW_CFA_advance_loc | 2,		/* DW_CFA_advance_loc: 4 */
+      DW_CFA_restore_state,
+    };
+
+  fde.instructions = insns;
+  fde.end = insns + sizeof (insns);
+  cie.initial_instructions = fde.end;
+  cie.end = fde.end;
+
+  const CORE_ADDR text_offset = 0x100;
+  dwarf2_cfa_table table;
+  dwarf2_frame_state compile_fs (text_offset, fde.cie);
+  compile_cfa_program (&fde, gdbarch, &compile_fs, text_offset, &table);
+
+  SELF_CHECK (table.rows.size () == 4);
+  SELF_CHECK (table.rows[0].start == 0);
+  SELF_CHECK (compile_fs.regs.prev == NULL);
+
+  for (CORE_ADDR pc = 0; pc < 12; pc++)
+    {
+      dwarf2_frame_state fs (text_offset, fde.cie);
+      execute_cfa_program (&fde, insns, fde.end, gdbarch, pc + text_offset,
+			   &fs, text_offset);
+
+      const dwarf2_cfa_row &row = find_cfa_row (table, pc);
+      SELF_CHECK (row.regs.cfa_how == fs.regs.cfa_how);
+      SELF_CHECK (row.regs.cfa_reg == fs.regs.cfa_reg);
+      SELF_CHECK (row.regs.cfa_offset == fs.regs.cfa_offset);
+      SELF_CHECK (row.regs.prev == NULL);
+
+      for (size_t i = 0; i < fs.regs.reg.size (); i++)
+	{
+	  enum dwarf2_frame_reg_rule how = (i < row.regs.reg.size ()
+					    ? row.regs.reg[i].how
+					    : DWARF2_FRAME_REG_UNSPECIFIED);
+	  SELF_CHECK (how == fs.regs.reg[i].how);
+	  if (how == DWARF2_FRAME_REG_SAVED_OFFSET)
+	    SELF_CHECK (row.regs.reg[i].loc.offset
+			== fs.regs.reg[i].loc.offset);
+	}
+    }
+}
+
 } // namespace selftests
 #endif /* GDB_SELF_TEST */
 
@@ -940,6 +1112,41 @@ dwarf2_fetch_cfa_info (struct gdbarch *gdbarch, CORE_ADDR pc,
 }
 
 
+/* Return the compiled programs of FDE for GDBARCH, compiling them on
+   first use.  START is the start of the FDE in the objfile whose text
+   section is at TEXT_OFFSET.  */
+
+static const struct dwarf2_cfa_table *
+get_cfa_table (struct dwarf2_fde *fde, struct gdbarch *gdbarch,
+	       CORE_ADDR start, CORE_ADDR text_offset)
+{
+  std::unique_ptr<dwarf2_cfa_table> &slot
+    = fde->cie->unit->cfa_tables[fde];
+
+  if (slot == nullptr || slot->gdbarch != gdbarch)
+    {
+      std::unique_ptr<dwarf2_cfa_table> table (new dwarf2_cfa_table);
+      dwarf2_frame_state fs (start, fde->cie);
+
+      dwarf2_frame_find_quirks (&fs, fde);
+      try
+	{
+	  compile_cfa_program (fde, gdbarch, &fs, text_offset, table.get ());
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  /* Leave the FDE to execute_cfa_program, which only runs the
+	     instructions up to the pc being unwound and so may still
+	     succeed.  Keep the empty table so this isn't retried.  */
+	  table->rows.clear ();
+	  table->gdbarch = gdbarch;
+	}
+      slot = std::move (table);
+    }
+
+  return slot.get ();
+}
+
 struct dwarf2_frame_cache
 {
   /* DWARF Call Frame Address.  */
@@ -1021,14 +1228,10 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
   /* Check for "quirks" - known bugs in producers.  */
   dwarf2_frame_find_quirks (&fs, fde);
 
-  /* First decode all the insns in the CIE.  */
-  execute_cfa_program (fde, fde->cie->initial_instructions,
-		       fde->cie->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       cache->per_objfile->objfile->text_section_offset ());
-
-  /* Save the initialized register set.  */
-  fs.initial = fs.regs;
+  CORE_ADDR text_offset = cache->per_objfile->objfile->text_section_offset ();
+  const dwarf2_cfa_table *table = get_cfa_table (fde, gdbarch, pc1,
+						 text_offset);
+  CORE_ADDR pc = get_frame_address_in_block (this_frame);
 
   /* Fetching the entry pc for THIS_FRAME won't necessarily result
      in an address that's within the range of FDE locations.  This
@@ -1036,30 +1239,59 @@ dwarf2_frame_cache (struct frame_info *this_frame, void **this_cache)
      ranges.  */
   LONGEST entry_cfa_sp_offset;
   int entry_cfa_sp_offset_p = 0;
-  if (get_frame_func_if_available (this_frame, &entry_pc)
-      && fde->initial_location <= entry_pc
-      && entry_pc < fde->initial_location + fde->address_range)
+  bool entry_pc_p = (get_frame_func_if_available (this_frame, &entry_pc)
+		     && fde->initial_location <= entry_pc
+		     && (entry_pc
+			 < fde->initial_location + fde->address_range));
+  auto note_entry_cfa = [&] (const dwarf2_frame_state_reg_info &regs)
     {
-      /* Decode the insns in the FDE up to the entry PC.  */
-      instr = execute_cfa_program
-	(fde, fde->instructions, fde->end, gdbarch, entry_pc, &fs,
-	 cache->per_objfile->objfile->text_section_offset ());
-
-      if (fs.regs.cfa_how == CFA_REG_OFFSET
-	  && (dwarf_reg_to_regnum (gdbarch, fs.regs.cfa_reg)
+      if (regs.cfa_how == CFA_REG_OFFSET
+	  && (dwarf_reg_to_regnum (gdbarch, regs.cfa_reg)
 	      == gdbarch_sp_regnum (gdbarch)))
 	{
-	  entry_cfa_sp_offset = fs.regs.cfa_offset;
+	  entry_cfa_sp_offset = regs.cfa_offset;
 	  entry_cfa_sp_offset_p = 1;
 	}
+    };
+
+  if (!table->rows.empty ())
+    {
+      /* Running the FDE program up to the entry pc and then on to PC
+	 gives the rules for whichever of the two is later.  */
+      if (entry_pc_p)
+	{
+	  note_entry_cfa (find_cfa_row (*table,
+					entry_pc - text_offset).regs);
+	  pc = std::max (pc, entry_pc);
+	}
+
+      const dwarf2_cfa_row &row = find_cfa_row (*table, pc - text_offset);
+      fs.regs = row.regs;
+      fs.pc = row.start + text_offset;
     }
   else
-    instr = fde->instructions;
+    {
+      /* First decode all the insns in the CIE.  */
+      execute_cfa_program (fde, fde->cie->initial_instructions,
+			   fde->cie->end, gdbarch, pc, &fs, text_offset);
 
-  /* Then decode the insns in the FDE up to our target PC.  */
-  execute_cfa_program (fde, instr, fde->end, gdbarch,
-		       get_frame_address_in_block (this_frame), &fs,
-		       cache->per_objfile->objfile->text_section_offset ());
+      /* Save the initialized register set.  */
+      fs.initial = fs.regs;
+
+      if (entry_pc_p)
+	{
+	  /* Decode the insns in the FDE up to the entry PC.  */
+	  instr = execute_cfa_program (fde, fde->instructions, fde->end,
+				       gdbarch, entry_pc, &fs, text_offset);
+	  note_entry_cfa (fs.regs);
+	}
+      else
+	instr = fde->instructions;
+
+      /* Then decode the insns in the FDE up to our target PC.  */
+      execute_cfa_program (fde, instr, fde->end, gdbarch, pc, &fs,
+			   text_offset);
+    }
 
   try
     {
@@ -2320,5 +2552,7 @@ architecture that doesn't support them will have no effect."),
 #if GDB_SELF_TEST
   selftests::register_test_foreach_arch ("execute_cfa_program",
 					 selftests::execute_cfa_program_test);
+  selftests::register_test_foreach_arch ("compile_cfa_program",
+					 selftests::compile_cfa_program_test);
 #endif
 }
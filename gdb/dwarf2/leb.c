@@ -26,58 +26,56 @@
 
 #include "defs.h"
 #include "dwarf2/leb.h"
+#include "gdbsupport/selftest.h"
+
+/* See leb.h.  */
 
 ULONGEST
-read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
-			  unsigned int *bytes_read_ptr)
+read_unsigned_leb128_x (const gdb_byte *buf, unsigned int *bytes_read_ptr,
+			gdb_byte byte)
 {
-  ULONGEST result;
-  unsigned int num_read;
-  int shift;
-  unsigned char byte;
-
-  result = 0;
-  shift = 0;
-  num_read = 0;
-  while (1)
+  ULONGEST result = byte & 127;
+  unsigned int num_read = 1;
+  unsigned int shift = 7;
+
+  /* Most multi-byte values seen in practice (DIE offsets, block
+     lengths, line program operands) fit in two bytes, so decode the
+     second byte before entering the general loop.  */
+  byte = *buf++;
+  num_read++;
+  result |= (ULONGEST) (byte & 127) << shift;
+  while ((byte & 128) != 0)
     {
-      byte = bfd_get_8 (abfd, buf);
-      buf++;
-      num_read++;
-      result |= ((ULONGEST) (byte & 127) << shift);
-      if ((byte & 128) == 0)
-	{
-	  break;
-	}
       shift += 7;
+      byte = *buf++;
+      num_read++;
+      if (shift < 8 * sizeof (result))
+	result |= (ULONGEST) (byte & 127) << shift;
     }
   *bytes_read_ptr = num_read;
   return result;
 }
 
+/* See leb.h.  */
+
 LONGEST
-read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
-		    unsigned int *bytes_read_ptr)
+read_signed_leb128_x (const gdb_byte *buf, unsigned int *bytes_read_ptr,
+		      gdb_byte byte)
 {
-  ULONGEST result;
-  int shift, num_read;
-  unsigned char byte;
-
-  result = 0;
-  shift = 0;
-  num_read = 0;
-  while (1)
+  ULONGEST result = byte & 127;
+  unsigned int num_read = 1;
+  unsigned int shift = 7;
+
+  do
     {
-      byte = bfd_get_8 (abfd, buf);
-      buf++;
+      byte = *buf++;
       num_read++;
-      result |= ((ULONGEST) (byte & 127) << shift);
+      if (shift < 8 * sizeof (result))
+	result |= (ULONGEST) (byte & 127) << shift;
       shift += 7;
-      if ((byte & 128) == 0)
-	{
-	  break;
-	}
     }
+  while ((byte & 128) != 0);
+
   if ((shift < 8 * sizeof (result)) && (byte & 0x40))
     result |= -(((ULONGEST) 1) << shift);
   *bytes_read_ptr = num_read;
@@ -134,3 +132,103 @@ read_offset (bfd *abfd, const gdb_byte *buf, unsigned int offset_size)
 
   return retval;
 }
+
+#if GDB_SELF_TEST
+
+namespace selftests {
+namespace leb {
+
+/* Encode VALUE as a signed or unsigned LEB128 into BUF, returning the
+   number of bytes written.  */
+
+static unsigned int
+encode_leb128 (gdb_byte *buf, ULONGEST value, bool is_signed)
+{
+  unsigned int len = 0;
+
+  while (true)
+    {
+      gdb_byte byte = value & 0x7f;
+      bool done;
+
+      if (is_signed)
+	{
+	  LONGEST svalue = (LONGEST) value >> 7;
+	  done = ((svalue == 0 && (byte & 0x40) == 0)
+		  || (svalue == -1 && (byte & 0x40) != 0));
+	  value = svalue;
+	}
+      else
+	{
+	  value >>= 7;
+	  done = value == 0;
+	}
+
+      if (!done)
+	byte |= 0x80;
+      buf[len++] = byte;
+      if (done)
+	return len;
+    }
+}
+
+/* Check that the inline single-byte paths and the out-of-line
+   multi-byte paths of the LEB128 readers agree with a straightforward
+   encoder, around every length boundary.  */
+
+static void
+leb128_tests ()
+{
+  gdb_byte buf[16];
+  unsigned int len, bytes_read;
+
+  for (int shift = 0; shift < 64; ++shift)
+    for (int delta = -1; delta <= 1; ++delta)
+      {
+	ULONGEST uvalue = ((ULONGEST) 1 << shift) + delta;
+
+	len = encode_leb128 (buf, uvalue, false);
+	SELF_CHECK (read_unsigned_leb128 (nullptr, buf, &bytes_read)
+		    == uvalue);
+	SELF_CHECK (bytes_read == len);
+
+	LONGEST svalue = uvalue;
+	len = encode_leb128 (buf, svalue, true);
+	SELF_CHECK (read_signed_leb128 (nullptr, buf, &bytes_read)
+		    == svalue);
+	SELF_CHECK (bytes_read == len);
+
+	LONGEST nvalue = -uvalue;
+	len = encode_leb128 (buf, nvalue, true);
+	SELF_CHECK (read_signed_leb128 (nullptr, buf, &bytes_read)
+		    == nvalue);
+	SELF_CHECK (bytes_read == len);
+      }
+
+  /* Redundant padding bytes are valid and must be consumed.  */
+  static const gdb_byte padded[] = { 0x81, 0x80, 0x80, 0x00 };
+  SELF_CHECK (read_unsigned_leb128 (nullptr, padded, &bytes_read) == 1);
+  SELF_CHECK (bytes_read == 4);
+  SELF_CHECK (read_signed_leb128 (nullptr, padded, &bytes_read) == 1);
+  SELF_CHECK (bytes_read == 4);
+
+  static const gdb_byte minus_one[] = { 0x7f };
+  SELF_CHECK (read_signed_leb128 (nullptr, minus_one, &bytes_read) == -1);
+  SELF_CHECK (bytes_read == 1);
+  SELF_CHECK (read_unsigned_leb128 (nullptr, minus_one, &bytes_read)
+	      == 0x7f);
+}
+
+} /* namespace leb */
+} /* namespace selftests */
+
+#endif /* GDB_SELF_TEST */
+
+void _initialize_dwarf2_leb ();
+void
+_initialize_dwarf2_leb ()
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("leb128", selftests::leb::leb128_tests);
+#endif
+}
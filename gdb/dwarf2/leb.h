@@ -85,9 +85,56 @@ read_8_bytes (bfd *abfd, const gdb_byte *buf)
   return bfd_get_64 (abfd, buf);
 }
 
-extern LONGEST read_signed_leb128 (bfd *, const gdb_byte *, unsigned int *);
+/* Read a multi-byte unsigned LEB128 value from BUF.  BYTE is the
+   first byte of the value, which must have its continuation bit
+   set; BUF points just past it.  */
 
-extern ULONGEST read_unsigned_leb128 (bfd *, const gdb_byte *, unsigned int *);
+extern ULONGEST read_unsigned_leb128_x (const gdb_byte *buf,
+					unsigned int *bytes_read_ptr,
+					gdb_byte byte);
+
+/* Likewise, for a multi-byte signed LEB128 value.  */
+
+extern LONGEST read_signed_leb128_x (const gdb_byte *buf,
+				     unsigned int *bytes_read_ptr,
+				     gdb_byte byte);
+
+/* Read an unsigned LEB128 value from BUF, storing the number of bytes
+   consumed in *BYTES_READ_PTR.  The overwhelmingly common case of a
+   single-byte value is handled inline; longer values are decoded by
+   read_unsigned_leb128_x.  */
+
+static inline ULONGEST
+read_unsigned_leb128 (bfd *abfd, const gdb_byte *buf,
+		      unsigned int *bytes_read_ptr)
+{
+  gdb_byte byte = *buf++;
+
+  if ((byte & 0x80) != 0)
+    return read_unsigned_leb128_x (buf, bytes_read_ptr, byte);
+
+  *bytes_read_ptr = 1;
+  return byte;
+}
+
+/* Read a signed LEB128 value from BUF, storing the number of bytes
+   consumed in *BYTES_READ_PTR.  As with read_unsigned_leb128, only
+   multi-byte values leave the inline path.  */
+
+static inline LONGEST
+read_signed_leb128 (bfd *abfd, const gdb_byte *buf,
+		    unsigned int *bytes_read_ptr)
+{
+  gdb_byte byte = *buf++;
+
+  if ((byte & 0x80) != 0)
+    return read_signed_leb128_x (buf, bytes_read_ptr, byte);
+
+  *bytes_read_ptr = 1;
+  if ((byte & 0x40) != 0)
+    return (LONGEST) byte - 0x80;
+  return byte;
+}
 
 /* Read the initial length from a section.  The (draft) DWARF 3
    specification allows the initial length to take up either 4 bytes
@@ -82,11 +82,21 @@
 #include <fcntl.h>
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 #include "gdbsupport/selftest.h"
 #include "rust-lang.h"
 #include "gdbsupport/pathstuff.h"
 #include "count-one-bits.h"
 #include "debuginfod-support.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/scoped_fd.h"
+#if CXX_STD_THREAD
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "gdbsupport/block-signals.h"
+#include "gdbsupport/thread-pool.h"
+#endif
 
 /* When == 1, print basic high level tracing messages.
    When > 1, be more verbose.
@@ -1669,6 +1679,9 @@ static struct dwo_unit *lookup_dwo_unit_in_dwp
 
 static struct dwp_file *get_dwp_file (dwarf2_per_objfile *per_objfile);
 
+static void prefetch_dwo_files (dwarf2_per_objfile *per_objfile,
+				bool scan_units);
+
 static struct dwo_unit *lookup_dwo_comp_unit
   (dwarf2_cu *cu, const char *dwo_name, const char *comp_dir,
    ULONGEST signature);
@@ -6039,6 +6052,7 @@ dwarf2_initialize_objfile (struct objfile *objfile, dw_index_kind *index_kind)
     {
       *index_kind = dw_index_kind::DEBUG_NAMES;
       per_objfile->resize_symtabs ();
+      prefetch_dwo_files (per_objfile, false);
       return true;
     }
 
@@ -6048,6 +6062,7 @@ dwarf2_initialize_objfile (struct objfile *objfile, dw_index_kind *index_kind)
     {
       *index_kind = dw_index_kind::GDB_INDEX;
       per_objfile->resize_symtabs ();
+      prefetch_dwo_files (per_objfile, false);
       return true;
     }
 
@@ -6059,6 +6074,7 @@ dwarf2_initialize_objfile (struct objfile *objfile, dw_index_kind *index_kind)
       global_index_cache.hit ();
       *index_kind = dw_index_kind::GDB_INDEX;
       per_objfile->resize_symtabs ();
+      prefetch_dwo_files (per_objfile, false);
       return true;
     }
 
@@ -8025,6 +8041,10 @@ dwarf2_build_psymtabs_hard (dwarf2_per_objfile *per_objfile)
 
   create_all_comp_units (per_objfile);
 
+  /* Start reading the DWO files in the background, rather than one by
+     one as each skeleton unit is processed below.  */
+  prefetch_dwo_files (per_objfile, true);
+
   /* Create a temporary address map on a temporary obstack.  We later
      copy this to the final obstack.  */
   auto_obstack temp_obstack;
@@ -8824,6 +8844,31 @@ skip_one_die (const struct die_reader_specs *reader, const gdb_byte *info_ptr,
   const gdb_byte *buffer_end = reader->buffer_end;
   unsigned int form, i;
 
+  /* Fast paths using the layout precomputed by abbrev_table::read.
+     An invalid DW_AT_sibling, or a DIE running past the end of the
+     section, is left to the general code below, so that it is
+     complained about.  */
+  if (abbrev->sibling_offset != (unsigned short) -1)
+    {
+      if (abbrev->sibling_offset + 4 <= buffer_end - info_ptr)
+	{
+	  const gdb_byte *sibling_ptr
+	    = (buffer + to_underlying (cu->header.sect_off)
+	       + read_4_bytes (abfd, info_ptr + abbrev->sibling_offset));
+
+	  if (sibling_ptr >= info_ptr && sibling_ptr <= buffer_end)
+	    return sibling_ptr;
+	}
+    }
+  else if (abbrev->size_if_constant != 0
+	   && abbrev->size_if_constant <= buffer_end - info_ptr)
+    {
+      info_ptr += abbrev->size_if_constant;
+      if (abbrev->has_children)
+	return skip_children (reader, info_ptr);
+      return info_ptr;
+    }
+
   for (i = 0; i < abbrev->num_attrs; i++)
     {
       /* The only abbrev we care about is DW_AT_sibling.  */
@@ -12675,14 +12720,12 @@ open_dwp_file (dwarf2_per_objfile *per_objfile, const char *file_name)
    By convention the name of the DWP file is ${objfile}.dwp.
    The result is NULL if it can't be found.  */
 
-static std::unique_ptr<struct dwp_file>
-open_and_init_dwp_file (dwarf2_per_objfile *per_objfile)
-{
-  struct objfile *objfile = per_objfile->objfile;
-
-  /* Try to find first .dwp for the binary file before any symbolic links
-     resolving.  */
+/* Return the name of the DWP file to try first for OBJFILE, before
+   any symbolic links are resolved.  */
 
+static std::string
+dwp_file_name (struct objfile *objfile)
+{
   /* If the objfile is a debug file, find the name of the real binary
      file and get the name of dwp file from there.  */
   std::string dwp_name;
@@ -12697,6 +12740,17 @@ open_and_init_dwp_file (dwarf2_per_objfile *per_objfile)
     dwp_name = objfile->original_name;
 
   dwp_name += ".dwp";
+  return dwp_name;
+}
+
+static std::unique_ptr<struct dwp_file>
+open_and_init_dwp_file (dwarf2_per_objfile *per_objfile)
+{
+  struct objfile *objfile = per_objfile->objfile;
+
+  /* Try to find first .dwp for the binary file before any symbolic links
+     resolving.  */
+  std::string dwp_name = dwp_file_name (objfile);
 
   gdb_bfd_ref_ptr dbfd (open_dwp_file (per_objfile, dwp_name.c_str ()));
   if (dbfd == NULL
@@ -12785,6 +12839,197 @@ get_dwp_file (dwarf2_per_objfile *per_objfile)
   return per_objfile->per_bfd->dwp_file.get ();
 }
 
+#if CXX_STD_THREAD && defined (HAVE_POSIX_FADVISE)
+
+/* A thread that asks the operating system to read DWO and DWP files
+   into its cache before gdb opens them.  It is kept apart from
+   gdb::thread_pool, whose workers run CPU-bound tasks, so that a slow
+   disk never holds one of them up.  Like the thread pool, it is never
+   destroyed, and its thread is detached so that it can't delay exit.  */
+
+class dwo_readahead_thread
+{
+public:
+
+  /* Queue FILE_NAME, starting the thread on the first call.  */
+  void post (const std::string &file_name)
+  {
+    std::lock_guard<std::mutex> guard (m_mutex);
+
+    if (!m_started)
+      {
+	/* Ensure that signals used by gdb are blocked in the new
+	   thread.  */
+	gdb::block_signals blocker;
+	std::thread thread (&dwo_readahead_thread::thread_function, this);
+	thread.detach ();
+	m_started = true;
+      }
+
+    m_files.push (file_name);
+    m_files_cv.notify_one ();
+  }
+
+  static dwo_readahead_thread *instance;
+
+private:
+
+  void thread_function ();
+
+  std::mutex m_mutex;
+  std::condition_variable m_files_cv;
+  std::queue<std::string> m_files;
+  bool m_started = false;
+};
+
+dwo_readahead_thread *dwo_readahead_thread::instance
+  = new dwo_readahead_thread ();
+
+/* Start the operating system reading each queued file in the
+   background.  Nothing is read or mapped here, and the descriptor is
+   closed straight away, so gdb still opens the file itself, and only if
+   it needs it.  This must not touch BFD or any other gdb state.  */
+
+void
+dwo_readahead_thread::thread_function ()
+{
+  while (true)
+    {
+      std::string file_name;
+
+      {
+	std::unique_lock<std::mutex> guard (m_mutex);
+	while (m_files.empty ())
+	  m_files_cv.wait (guard);
+	file_name = std::move (m_files.front ());
+	m_files.pop ();
+      }
+
+      scoped_fd fd (gdb_open_cloexec (file_name.c_str (),
+				      O_RDONLY | O_BINARY, 0));
+      if (fd.get () >= 0)
+	posix_fadvise (fd.get (), 0, 0, POSIX_FADV_WILLNEED);
+    }
+}
+
+/* Queue FILE_NAME to be read ahead, unless it was already.  */
+
+static void
+post_dwo_prefetch (std::unordered_set<std::string> &posted,
+		   const std::string &file_name)
+{
+  if (!posted.insert (file_name).second)
+    return;
+
+  if (dwarf_read_debug)
+    fprintf_unfiltered (gdb_stdlog, "Prefetching DWO/DWP file %s\n",
+			file_name.c_str ());
+
+  dwo_readahead_thread::instance->post (file_name);
+}
+
+#endif /* CXX_STD_THREAD && HAVE_POSIX_FADVISE */
+
+/* Ask for the DWP file, or else (if SCAN_UNITS) the DWO files
+   referenced by the skeleton units, of PER_OBJFILE to be read ahead by
+   dwo_readahead_thread.  The files are still opened on demand by
+   try_open_dwop_file, which never waits for the read-ahead, but they are
+   then more likely to be in the operating system's cache.  SCAN_UNITS is
+   false when an index was read: the units are then only read on demand,
+   and reading their skeleton DIEs up front would undo that.  This does
+   nothing if "maint set worker-threads 0" is in effect.  */
+
+static void
+prefetch_dwo_files (dwarf2_per_objfile *per_objfile, bool scan_units)
+{
+#if CXX_STD_THREAD && defined (HAVE_POSIX_FADVISE)
+  if (gdb::thread_pool::g_thread_pool->thread_count () == 0)
+    return;
+
+  dwarf2_per_bfd *per_bfd = per_objfile->per_bfd;
+  struct objfile *objfile = per_objfile->objfile;
+
+  /* The files are the same for every objfile sharing PER_BFD.  */
+  if (per_bfd->dwo_files_prefetched)
+    return;
+  per_bfd->dwo_files_prefetched = true;
+
+  std::unordered_set<std::string> posted;
+
+  /* A DWP file takes precedence over DWO files, see lookup_dwo_cutu.
+     Only the usual locations are handled here; a DWP found through
+     debug-file-directory is simply read on demand.  */
+  std::string dwp_name = dwp_file_name (objfile);
+  if (access (dwp_name.c_str (), R_OK) != 0)
+    {
+      dwp_name = objfile_name (objfile);
+      dwp_name += ".dwp";
+    }
+  if (access (dwp_name.c_str (), R_OK) == 0)
+    {
+      post_dwo_prefetch (posted, dwp_name);
+      return;
+    }
+
+  if (!scan_units)
+    return;
+
+  /* Give up early on objfiles that were not built with -gsplit-dwarf,
+     so that they pay for reading only a few top-level DIEs.  */
+  const int max_units_without_dwo = 16;
+  int n_units = 0;
+  bool found_dwo = false;
+
+  try
+    {
+      for (dwarf2_per_cu_data *per_cu : per_bfd->all_comp_units)
+	{
+	  if (!found_dwo && n_units >= max_units_without_dwo)
+	    break;
+
+	  if (per_cu->is_debug_types || per_cu->is_dwz
+	      || per_objfile->get_cu (per_cu) != nullptr)
+	    continue;
+
+	  ++n_units;
+
+	  /* Only read the skeleton's top-level DIE.  This constructor
+	     does not follow DW_AT_dwo_name, so the DWO itself is not
+	     opened; the reader (and its dwarf2_cu) is discarded again at
+	     the end of the iteration.  */
+	  cutu_reader reader (per_cu, per_objfile,
+			      /* parent_cu */ nullptr, /* dwo_file */ nullptr);
+	  if (reader.dummy_p)
+	    continue;
+
+	  const char *dwo_name = dwarf2_dwo_name (reader.comp_unit_die,
+						  reader.cu);
+	  if (dwo_name == nullptr)
+	    continue;
+	  found_dwo = true;
+
+	  /* This is the first name open_dwo_file tries.  */
+	  if (IS_ABSOLUTE_PATH (dwo_name))
+	    post_dwo_prefetch (posted, dwo_name);
+	  else
+	    {
+	      const char *comp_dir
+		= dwarf2_string_attr (reader.comp_unit_die, DW_AT_comp_dir,
+				      reader.cu);
+	      if (comp_dir != nullptr)
+		post_dwo_prefetch (posted, (std::string (comp_dir)
+					    + SLASH_STRING + dwo_name));
+	    }
+	}
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* Any problem with the skeleton units will be reported when they
+	 are read for real.  */
+    }
+#endif /* CXX_STD_THREAD && HAVE_POSIX_FADVISE */
+}
+
 /* Subroutine of lookup_dwo_comp_unit, lookup_dwo_type_unit.
    Look up the CU/TU with signature SIGNATURE, either in DWO file DWO_NAME
    or in the DWP file for the objfile, referenced by THIS_UNIT.
@@ -197,6 +197,10 @@ struct dwarf2_per_bfd
   /* The DWP file if there is one, or NULL.  */
   std::unique_ptr<struct dwp_file> dwp_file;
 
+  /* True if the DWO and DWP files have been queued for reading ahead.
+     See prefetch_dwo_files.  */
+  bool dwo_files_prefetched = false;
+
   /* The shared '.dwz' file, if one exists.  This is used when the
      original data was compressed using 'dwz -m'.  */
   std::unique_ptr<struct dwz_file> dwz_file;
@@ -57,6 +57,8 @@
 #include "prologue-value.h"
 #include "arch/riscv.h"
 #include "riscv-ravenscar-thread.h"
+#include "progspace.h"
+#include <map>
 
 /* The stack must be 16-byte aligned.  */
 #define SP_ALIGNMENT 16
@@ -97,6 +99,40 @@ struct riscv_unwind_cache
   CORE_ADDR frame_base;
 };
 
+/* The part of a riscv_unwind_cache that riscv_scan_prologue computes.
+   It only depends on the code of the function, not on the state of the
+   inferior, so unlike the frame cache it can be kept when the inferior
+   is resumed.  */
+
+struct riscv_prologue_scan
+{
+  /* The pc limit the scan was done with, and the address at which it
+     stopped.  */
+  CORE_ADDR limit;
+  CORE_ADDR stop;
+
+  /* See riscv_unwind_cache.  */
+  int frame_base_reg;
+  int frame_base_offset;
+
+  /* The registers saved on the stack, and their offset from the frame
+     base.  */
+  std::vector<std::pair<int, CORE_ADDR>> saved_regs;
+};
+
+/* Per-program-space data for the RiscV unwinder.  */
+
+struct riscv_pspace_data
+{
+  /* Prologue scans, indexed by the start address of the function.  */
+  std::map<CORE_ADDR, riscv_prologue_scan> prologue_scans;
+};
+
+/* Key to access the RiscV per-program-space data.  */
+
+static const struct program_space_key<riscv_pspace_data>
+  riscv_pspace_data_key;
+
 /* RISC-V specific register group for CSRs.  */
 
 static reggroup *csr_reggroup = NULL;
@@ -1691,6 +1727,114 @@ riscv_scan_prologue (struct gdbarch *gdbarch,
   return end_prologue_addr;
 }
 
+/* Like riscv_scan_prologue, filling in CACHE, but reuse the result of an
+   earlier scan of the same code if there is one.  Rescanning the same
+   functions after every stop is a large part of the cost of unwinding
+   deep stacks.
+
+   Only one scan is kept per function.  A scan up to LIMIT that stopped
+   at STOP < LIMIT ended on an instruction that is not part of the
+   prologue, or at the end of the prologue according to the line table,
+   so any scan with a limit beyond STOP gives the same result.  */
+
+static void
+riscv_scan_prologue_cached (struct gdbarch *gdbarch,
+			    CORE_ADDR start_pc, CORE_ADDR end_pc,
+			    struct riscv_unwind_cache *cache)
+{
+  riscv_pspace_data *data = riscv_pspace_data_key.get (current_program_space);
+  if (data == nullptr)
+    data = riscv_pspace_data_key.emplace (current_program_space);
+
+  auto iter = data->prologue_scans.find (start_pc);
+  if (iter != data->prologue_scans.end ()
+      && (end_pc == iter->second.limit
+	  || (iter->second.stop < iter->second.limit
+	      && end_pc > iter->second.stop)))
+    {
+      const riscv_prologue_scan &scan = iter->second;
+
+      if (riscv_debug_unwinder)
+	fprintf_unfiltered (gdb_stdlog,
+			    "Reusing prologue scan for function starting "
+			    "at %s (limit %s)\n",
+			    core_addr_to_string (start_pc),
+			    core_addr_to_string (end_pc));
+
+      cache->frame_base_reg = scan.frame_base_reg;
+      cache->frame_base_offset = scan.frame_base_offset;
+      for (const auto &saved : scan.saved_regs)
+	trad_frame_set_addr (cache->regs, saved.first, saved.second);
+      return;
+    }
+
+  CORE_ADDR stop = riscv_scan_prologue (gdbarch, start_pc, end_pc, cache);
+
+  /* Keep the scan that covers the most pcs: a stop inside the prologue
+     should not evict the scan of the whole prologue.  */
+  if (iter != data->prologue_scans.end ()
+      && iter->second.stop < iter->second.limit
+      && stop >= end_pc)
+    return;
+
+  riscv_prologue_scan scan;
+  scan.limit = end_pc;
+  scan.stop = stop;
+  scan.frame_base_reg = cache->frame_base_reg;
+  scan.frame_base_offset = cache->frame_base_offset;
+  for (int i = 0; i <= RISCV_NUM_INTEGER_REGS; i++)
+    if (trad_frame_addr_p (cache->regs, i))
+      scan.saved_regs.emplace_back (i, cache->regs[i].addr);
+  data->prologue_scans[start_pc] = std::move (scan);
+}
+
+/* Discard the cached prologue scans of PSPACE.  */
+
+static void
+riscv_clear_prologue_scans (struct program_space *pspace)
+{
+  riscv_pspace_data *data = riscv_pspace_data_key.get (pspace);
+  if (data != nullptr)
+    data->prologue_scans.clear ();
+}
+
+/* Observer for the new_objfile event.  The code at any address may have
+   changed.  */
+
+static void
+riscv_new_objfile (struct objfile *objfile)
+{
+  riscv_clear_prologue_scans (objfile != nullptr
+			      ? objfile->pspace : current_program_space);
+}
+
+/* Observer for the free_objfile event.  */
+
+static void
+riscv_free_objfile (struct objfile *objfile)
+{
+  riscv_clear_prologue_scans (objfile->pspace);
+}
+
+/* Observer for the memory_changed event.  The user may have patched the
+   code of a function.  */
+
+static void
+riscv_memory_changed (struct inferior *inf, CORE_ADDR addr, ssize_t len,
+		      const bfd_byte *data)
+{
+  riscv_clear_prologue_scans (inf->pspace);
+}
+
+/* Observer for the inferior_created event.  The new inferior's code
+   need not match what was scanned before.  */
+
+static void
+riscv_inferior_created (struct target_ops *target, int from_tty)
+{
+  riscv_clear_prologue_scans (current_program_space);
+}
+
 /* Implement the riscv_skip_prologue gdbarch method.  */
 
 static CORE_ADDR
@@ -2938,7 +3082,7 @@ riscv_frame_cache (struct frame_info *this_frame, void **this_cache)
   /* Scan the prologue, filling in the cache.  */
   start_addr = get_frame_func (this_frame);
   pc = get_frame_pc (this_frame);
-  riscv_scan_prologue (gdbarch, start_addr, pc, cache);
+  riscv_scan_prologue_cached (gdbarch, start_addr, pc, cache);
 
   /* We can now calculate the frame base address.  */
   cache->frame_base
@@ -3702,6 +3846,11 @@ _initialize_riscv_tdep ()
 
   gdbarch_register (bfd_arch_riscv, riscv_gdbarch_init, NULL);
 
+  gdb::observers::new_objfile.attach (riscv_new_objfile);
+  gdb::observers::free_objfile.attach (riscv_free_objfile);
+  gdb::observers::memory_changed.attach (riscv_memory_changed);
+  gdb::observers::inferior_created.attach (riscv_inferior_created);
+
   /* Add root prefix command for all "set debug riscv" and "show debug
      riscv" commands.  */
   add_basic_prefix_cmd ("riscv", no_class,
@@ -25,6 +25,13 @@
 #include "gdbsupport/selftest.h"
 #include "objfiles.h"
 #include "exec.h"
+#include <algorithm>
+#if CXX_STD_THREAD
+#include <chrono>
+#include <future>
+#include <mutex>
+#include "gdbsupport/thread-pool.h"
+#endif
 
 #ifdef HAVE_SOURCE_HIGHLIGHT
 /* If Gnulib redirects 'open' and 'close' to its replacements
@@ -38,14 +45,71 @@
 #include <srchilite/langmap.h>
 #endif
 
-/* The number of source files we'll cache.  */
+/* The total size of the source text we'll cache.  The most recently
+   used file is kept even if it alone is larger than this.  */
+
+#define MAX_CACHE_SIZE (16 * 1024 * 1024)
+
+/* The input and output of highlighting one file.  This is shared with
+   the worker thread doing the highlighting, which must not touch
+   anything else.  */
+
+struct highlight_job
+{
+  /* The full name of the file.  */
+  std::string fullname;
+
+  /* The Source Highlight language name.  */
+  const char *lang_name;
 
-#define MAX_ENTRIES 5
+  /* The un-highlighted text on input.  On output, the highlighted
+     text if HIGHLIGHTED is true.  */
+  std::string contents;
+
+  /* True if highlighting succeeded.  */
+  bool highlighted = false;
+};
+
+/* See source-cache.h.  */
+
+struct source_cache::pending_highlight
+{
+  /* The job itself.  */
+  std::shared_ptr<highlight_job> job;
+
+#if CXX_STD_THREAD
+  /* Becomes ready when the worker thread is done with JOB.  */
+  std::future<void> done;
+#endif
+};
 
 /* See source-cache.h.  */
 
 source_cache g_source_cache;
 
+/* Return the offsets of the start of each line in TEXT.  */
+
+static std::vector<off_t>
+find_line_starts (const std::string &text)
+{
+  std::vector<off_t> offsets;
+  offsets.push_back (0);
+  for (size_t offset = text.find ('\n');
+       offset != std::string::npos;
+       offset = text.find ('\n', offset))
+    {
+      ++offset;
+      /* A newline at the end does not start a new line.  It would
+	 seem simpler to just strip the newline in this function, but
+	 then "list" won't print the final newline.  */
+      if (offset != text.size ())
+	offsets.push_back (offset);
+    }
+
+  offsets.shrink_to_fit ();
+  return offsets;
+}
+
 /* See source-cache.h.  */
 
 std::string
@@ -74,22 +138,7 @@ source_cache::get_plain_source_lines (struct symtab *s,
   if (mtime && mtime < st.st_mtime)
     warning (_("Source file is more recent than executable."));
 
-  std::vector<off_t> offsets;
-  offsets.push_back (0);
-  for (size_t offset = lines.find ('\n');
-       offset != std::string::npos;
-       offset = lines.find ('\n', offset))
-    {
-      ++offset;
-      /* A newline at the end does not start a new line.  It would
-	 seem simpler to just strip the newline in this function, but
-	 then "list" won't print the final newline.  */
-      if (offset != lines.size ())
-	offsets.push_back (offset);
-    }
-
-  offsets.shrink_to_fit ();
-  m_offset_cache.emplace (fullname, std::move (offsets));
+  m_offset_cache.emplace (fullname, find_line_starts (lines));
 
   return lines;
 }
@@ -147,10 +196,90 @@ get_language_name (enum language lang)
   return nullptr;
 }
 
+/* Highlight JOB's text using Source Highlight.  This may run on a
+   worker thread.  */
+
+static void
+run_highlight_job (highlight_job *job)
+{
+  /* The global source highlight object, or null if one was never
+     constructed.  This is stored here rather than in the class so
+     that we don't need to include anything or do conditional
+     compilation in source-cache.h.  Several files can be highlighted
+     at once, so it is guarded by a mutex.  */
+  static srchilite::SourceHighlight *highlighter;
+#if CXX_STD_THREAD
+  static std::mutex highlighter_mutex;
+  std::lock_guard<std::mutex> guard (highlighter_mutex);
+#endif
+
+  try
+    {
+      if (highlighter == nullptr)
+	{
+	  highlighter = new srchilite::SourceHighlight ("esc.outlang");
+	  highlighter->setStyleFile ("esc.style");
+	}
+
+      std::istringstream input (job->contents);
+      std::ostringstream output;
+      highlighter->highlight (input, output, job->lang_name, job->fullname);
+      job->contents = output.str ();
+      job->highlighted = true;
+    }
+  catch (...)
+    {
+      /* Source Highlight will throw an exception if highlighting
+	 fails.  One possible reason it can fail is if the language is
+	 unknown -- which matters to gdb because Rust support wasn't
+	 added until after 3.1.8.  The caller falls back to
+	 un-highlighted text.  */
+    }
+}
+
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 
 /* See source-cache.h.  */
 
+void
+source_cache::set_contents (source_text *text, std::string &&contents)
+{
+  m_source_map_size -= text->contents.size ();
+  text->contents = std::move (contents);
+  text->line_starts = find_line_starts (text->contents);
+  m_source_map_size += text->contents.size ();
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::finish_highlight (source_text *text)
+{
+  if (text->pending == nullptr)
+    return;
+
+#if CXX_STD_THREAD
+  if (text->pending->done.wait_for (std::chrono::seconds (0))
+      != std::future_status::ready)
+    return;
+#endif
+
+  std::shared_ptr<highlight_job> job = std::move (text->pending->job);
+  text->pending.reset ();
+
+  if (job->highlighted)
+    set_contents (text, std::move (job->contents));
+  else
+    {
+      gdb::optional<std::string> ext_contents
+	= ext_lang_colorize (text->fullname, text->contents);
+      if (ext_contents.has_value ())
+	set_contents (text, std::move (*ext_contents));
+    }
+}
+
+/* See source-cache.h.  */
+
 bool
 source_cache::ensure (struct symtab *s)
 {
@@ -166,12 +295,14 @@ source_cache::ensure (struct symtab *s)
 	     without also clearing the contents cache.  */
 	  gdb_assert (m_offset_cache.find (fullname)
 		      != m_offset_cache.end ());
-	  /* Not strictly LRU, but at least ensure that the most
-	     recently used entry is always the last candidate for
-	     deletion.  Note that this property is relied upon by at
-	     least one caller.  */
+	  /* Ensure that the most recently used entry is always the
+	     last candidate for deletion.  Note that this property is
+	     relied upon by at least one caller.  */
 	  if (i != size - 1)
-	    std::swap (m_source_map[i], m_source_map[size - 1]);
+	    std::rotate (m_source_map.begin () + i,
+			 m_source_map.begin () + i + 1,
+			 m_source_map.end ());
+	  finish_highlight (&m_source_map.back ());
 	  return true;
 	}
     }
@@ -187,59 +318,55 @@ source_cache::ensure (struct symtab *s)
       return false;
     }
 
+  m_source_map.emplace_back ();
+  source_text *text = &m_source_map.back ();
+  text->fullname = std::move (fullname);
+  set_contents (text, std::move (contents));
+
   if (source_styling && gdb_stdout->can_emit_style_escape ())
     {
 #ifdef HAVE_SOURCE_HIGHLIGHT
-      bool already_styled = false;
       const char *lang_name = get_language_name (SYMTAB_LANGUAGE (s));
       if (lang_name != nullptr)
 	{
-	  /* The global source highlight object, or null if one was
-	     never constructed.  This is stored here rather than in
-	     the class so that we don't need to include anything or do
-	     conditional compilation in source-cache.h.  */
-	  static srchilite::SourceHighlight *highlighter;
-
-	  try
-	    {
-	      if (highlighter == nullptr)
-		{
-		  highlighter = new srchilite::SourceHighlight ("esc.outlang");
-		  highlighter->setStyleFile ("esc.style");
-		}
-
-	      std::istringstream input (contents);
-	      std::ostringstream output;
-	      highlighter->highlight (input, output, lang_name, fullname);
-	      contents = output.str ();
-	      already_styled = true;
-	    }
-	  catch (...)
-	    {
-	      /* Source Highlight will throw an exception if
-		 highlighting fails.  One possible reason it can fail
-		 is if the language is unknown -- which matters to gdb
-		 because Rust support wasn't added until after 3.1.8.
-		 Ignore exceptions here and fall back to
-		 un-highlighted text. */
-	    }
+	  /* Highlighting a large file can take a long time, so it is
+	     done on a worker thread.  Until it is finished, the
+	     un-highlighted text is used.  */
+	  std::shared_ptr<highlight_job> job (new highlight_job);
+	  job->fullname = text->fullname;
+	  job->lang_name = lang_name;
+	  job->contents = text->contents;
+
+	  text->pending.reset (new pending_highlight);
+	  text->pending->job = job;
+#if CXX_STD_THREAD
+	  text->pending->done
+	    = gdb::thread_pool::g_thread_pool->post_task ([=] ()
+	      {
+		run_highlight_job (job.get ());
+	      });
+#else
+	  run_highlight_job (job.get ());
+#endif
 	}
-
-      if (!already_styled)
+      else
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 	{
 	  gdb::optional<std::string> ext_contents;
-	  ext_contents = ext_lang_colorize (fullname, contents);
+	  ext_contents = ext_lang_colorize (text->fullname, text->contents);
 	  if (ext_contents.has_value ())
-	    contents = std::move (*ext_contents);
+	    set_contents (text, std::move (*ext_contents));
 	}
     }
 
-  source_text result = { std::move (fullname), std::move (contents) };
-  m_source_map.push_back (std::move (result));
+  /* Without worker threads, the highlighting has already been done.  */
+  finish_highlight (text);
 
-  if (m_source_map.size () > MAX_ENTRIES)
-    m_source_map.erase (m_source_map.begin ());
+  while (m_source_map_size > MAX_CACHE_SIZE && m_source_map.size () > 1)
+    {
+      m_source_map_size -= m_source_map.front ().contents.size ();
+      m_source_map.erase (m_source_map.begin ());
+    }
 
   return true;
 }
@@ -267,44 +394,29 @@ source_cache::get_line_charpos (struct symtab *s,
 }
 
 /* A helper function that extracts the desired source lines from TEXT,
-   putting them into LINES_OUT.  The arguments are as for
-   get_source_lines.  Returns true on success, false if the line
-   numbers are invalid.  */
+   putting them into LINES_OUT.  LINE_STARTS holds the offset of each
+   line in TEXT, as computed by find_line_starts.  The other arguments
+   are as for get_source_lines.  Returns true on success, false if the
+   line numbers are invalid.  */
 
 static bool
-extract_lines (const std::string &text, int first_line, int last_line,
-	       std::string *lines_out)
+extract_lines (const std::string &text, const std::vector<off_t> &line_starts,
+	       int first_line, int last_line, std::string *lines_out)
 {
-  int lineno = 1;
-  std::string::size_type pos = 0;
-  std::string::size_type first_pos = std::string::npos;
-
-  while (pos != std::string::npos && lineno <= last_line)
-    {
-      std::string::size_type new_pos = text.find ('\n', pos);
-
-      if (lineno == first_line)
-	first_pos = pos;
+  if (first_line < 1 || first_line > last_line
+      || first_line > line_starts.size ())
+    return false;
 
-      pos = new_pos;
-      if (lineno == last_line || pos == std::string::npos)
-	{
-	  /* A newline at the end does not start a new line.  */
-	  if (first_pos == std::string::npos
-	      || first_pos == text.size ())
-	    return false;
-	  if (pos == std::string::npos)
-	    pos = text.size ();
-	  else
-	    ++pos;
-	  *lines_out = text.substr (first_pos, pos - first_pos);
-	  return true;
-	}
-      ++lineno;
-      ++pos;
-    }
+  std::string::size_type first_pos = line_starts[first_line - 1];
+  /* A newline at the end does not start a new line.  */
+  if (first_pos == text.size ())
+    return false;
 
-  return false;
+  std::string::size_type pos = (last_line < line_starts.size ()
+				? line_starts[last_line]
+				: text.size ());
+  *lines_out = text.substr (first_pos, pos - first_pos);
+  return true;
 }
 
 /* See source-cache.h.  */
@@ -319,7 +431,8 @@ source_cache::get_source_lines (struct symtab *s, int first_line,
   if (!ensure (s))
     return false;
 
-  return extract_lines (m_source_map.back ().contents,
+  const source_text &text = m_source_map.back ();
+  return extract_lines (text.contents, text.line_starts,
 			first_line, last_line, lines);
 }
 
@@ -329,15 +442,29 @@ namespace selftests
 static void extract_lines_test ()
 {
   std::string input_text = "abc\ndef\nghi\njkl\n";
+  std::vector<off_t> line_starts = find_line_starts (input_text);
   std::string result;
 
-  SELF_CHECK (extract_lines (input_text, 1, 1, &result)
+  SELF_CHECK (line_starts.size () == 4);
+  SELF_CHECK (extract_lines (input_text, line_starts, 1, 1, &result)
 	      && result == "abc\n");
-  SELF_CHECK (!extract_lines (input_text, 2, 1, &result));
-  SELF_CHECK (extract_lines (input_text, 1, 2, &result)
+  SELF_CHECK (!extract_lines (input_text, line_starts, 2, 1, &result));
+  SELF_CHECK (extract_lines (input_text, line_starts, 1, 2, &result)
 	      && result == "abc\ndef\n");
-  SELF_CHECK (extract_lines ("abc", 1, 1, &result)
+  SELF_CHECK (extract_lines (input_text, line_starts, 4, 4, &result)
+	      && result == "jkl\n");
+  SELF_CHECK (extract_lines (input_text, line_starts, 3, 10, &result)
+	      && result == "ghi\njkl\n");
+  SELF_CHECK (!extract_lines (input_text, line_starts, 5, 5, &result));
+
+  std::string short_text = "abc";
+  SELF_CHECK (extract_lines (short_text, find_line_starts (short_text),
+			     1, 1, &result)
 	      && result == "abc");
+
+  std::string empty_text;
+  SELF_CHECK (!extract_lines (empty_text, find_line_starts (empty_text),
+			      1, 1, &result));
 }
 }
 #endif
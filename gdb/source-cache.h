@@ -19,17 +19,21 @@
 #ifndef SOURCE_CACHE_H
 #define SOURCE_CACHE_H
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
 /* This caches two things related to source files.
 
    First, it caches highlighted source text, keyed by the source
-   file's full name.  A size-limited LRU cache is used.
+   file's full name.  An LRU cache limited by the total size of the
+   text is used.
 
    Highlighting depends on the GNU Source Highlight library.  When not
    available or when highlighting fails for some reason, this cache
-   will instead store the un-highlighted source text.
+   will instead store the un-highlighted source text.  Source
+   Highlight runs on a worker thread; until it is done, the
+   un-highlighted text is returned.
 
    Second, this will cache the file offsets corresponding to the start
    of each line of a source file.  This cache is not size-limited.  */
@@ -66,10 +70,15 @@ class source_cache
   {
     m_source_map.clear ();
     m_offset_cache.clear ();
+    m_source_map_size = 0;
   }
 
 private:
 
+  /* Highlighting of a file that is in progress on a worker thread.
+     This is defined in source-cache.c.  */
+  struct pending_highlight;
+
   /* One element in the cache.  */
   struct source_text
   {
@@ -77,6 +86,12 @@ class source_cache
     std::string fullname;
     /* The contents of the file.  */
     std::string contents;
+    /* The offset in CONTENTS of the start of each line.  These differ
+       from the file offsets once CONTENTS is highlighted.  */
+    std::vector<off_t> line_starts;
+    /* If CONTENTS is still un-highlighted and highlighting is under
+       way, the pending result; otherwise NULL.  */
+    std::shared_ptr<pending_highlight> pending;
   };
 
   /* A helper function for get_source_lines reads a source file.
@@ -89,9 +104,20 @@ class source_cache
      into both caches.  Returns false on error.  */
   bool ensure (struct symtab *s);
 
-  /* The contents of the source text cache.  */
+  /* If highlighting of TEXT has finished, install the result.  */
+  void finish_highlight (source_text *text);
+
+  /* Set TEXT's contents to CONTENTS, updating the size of the
+     cache.  */
+  void set_contents (source_text *text, std::string &&contents);
+
+  /* The contents of the source text cache.  The most recently used
+     entry is last.  */
   std::vector<source_text> m_source_map;
 
+  /* The total size of the text in M_SOURCE_MAP.  */
+  size_t m_source_map_size = 0;
+
   /* The file offset cache.  The key is the full name of the source
      file.  */
   std::unordered_map<std::string, std::vector<off_t>> m_offset_cache;
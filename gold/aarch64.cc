@@ -436,6 +436,13 @@ class Output_data_got_aarch64 : public Output_data_got<size, big_endian>
       symbol_table_(symtab), layout_(layout)
   { }
 
+  // Create a GOT of a fixed size, for an incremental update.
+  Output_data_got_aarch64(Symbol_table* symtab, Layout* layout,
+			  off_t data_size)
+    : Output_data_got<size, big_endian>(data_size),
+      symbol_table_(symtab), layout_(layout)
+  { }
+
   // Add a static entry for the GOT entry at OFFSET.  GSYM is a global
   // symbol and R_TYPE is the code of a dynamic relocation that needs to be
   // applied in a static link.
@@ -3066,6 +3073,60 @@ class Target_aarch64 : public Sized_target<size, big_endian>
   unsigned int
   plt_entry_size() const;
 
+  // Return the index of the PLT entry for GSYM.
+  unsigned int
+  plt_entry_index(const Symbol* gsym) const;
+
+  // Return the number of entries in the GOT.
+  unsigned int
+  got_entry_count() const
+  {
+    if (this->got_ == NULL)
+      return 0;
+    return this->got_->data_size() / (size / 8);
+  }
+
+  // Create the GOT section for an incremental update.
+  Output_data_got_base*
+  init_got_plt_for_update(Symbol_table* symtab,
+			  Layout* layout,
+			  unsigned int got_count,
+			  unsigned int plt_count);
+
+  // Reserve a GOT entry for a local symbol, and regenerate any
+  // necessary dynamic relocations.
+  void
+  reserve_local_got_entry(unsigned int got_index,
+			  Sized_relobj<size, big_endian>* obj,
+			  unsigned int r_sym,
+			  unsigned int got_type);
+
+  // Reserve a GOT entry for a global symbol, and regenerate any
+  // necessary dynamic relocations.
+  void
+  reserve_global_got_entry(unsigned int got_index, Symbol* gsym,
+			   unsigned int got_type);
+
+  // Register an existing PLT entry for a global symbol.
+  void
+  register_global_plt_entry(Symbol_table*, Layout*, unsigned int plt_index,
+			    Symbol* gsym);
+
+  // Force a COPY relocation for a given symbol.
+  void
+  emit_copy_reloc(Symbol_table*, Symbol*, Output_section*, off_t);
+
+  // Apply an incremental relocation.
+  void
+  apply_relocation(const Relocate_info<size, big_endian>* relinfo,
+		   typename elfcpp::Elf_types<size>::Elf_Addr r_offset,
+		   unsigned int r_type,
+		   typename elfcpp::Elf_types<size>::Elf_Swxword r_addend,
+		   const Symbol* gsym,
+		   unsigned char* view,
+		   typename elfcpp::Elf_types<size>::Elf_Addr address,
+		   section_size_type view_size);
+
   // Create a stub table.
   The_stub_table*
   new_stub_table(The_aarch64_input_section*);
@@ -3167,6 +3228,16 @@ class Target_aarch64 : public Sized_target<size, big_endian>
       layout, got, got_plt, got_irelative);
   }
 
+  virtual Output_data_plt_aarch64<size, big_endian>*
+  do_make_data_plt(Layout* layout,
+		   Output_data_got_aarch64<size, big_endian>* got,
+		   Output_data_space* got_plt,
+		   Output_data_space* got_irelative,
+		   unsigned int plt_count)
+  {
+    return new Output_data_plt_aarch64_standard<size, big_endian>(
+      layout, got, got_plt, got_irelative, plt_count);
+  }
 
   // do_make_elf_object to override the same function in the base class.
   Object*
@@ -3182,11 +3253,26 @@ class Target_aarch64 : public Sized_target<size, big_endian>
     return this->do_make_data_plt(layout, got, got_plt, got_irelative);
   }
 
+  Output_data_plt_aarch64<size, big_endian>*
+  make_data_plt(Layout* layout,
+		Output_data_got_aarch64<size, big_endian>* got,
+		Output_data_space* got_plt,
+		Output_data_space* got_irelative,
+		unsigned int plt_count)
+  {
+    return this->do_make_data_plt(layout, got, got_plt, got_irelative,
+				  plt_count);
+  }
+
   // We only need to generate stubs, and hence perform relaxation if we are
-  // not doing relocatable linking.
+  // not doing relocatable linking.  Stubs are not supported in an
+  // incremental link, since an update can not move the input sections.
   virtual bool
   do_may_relax() const
-  { return !parameters->options().relocatable(); }
+  {
+    return (!parameters->options().relocatable()
+	    && !parameters->incremental());
+  }
 
   // Relaxation hook.  This is where we do stub generation.
   virtual bool
@@ -4214,9 +4300,36 @@ class Output_data_plt_aarch64 : public Output_section_data
 			  Output_data_space* got_irelative)
     : Output_section_data(addralign), tlsdesc_rel_(NULL), irelative_rel_(NULL),
       got_(got), got_plt_(got_plt), got_irelative_(got_irelative),
-      count_(0), irelative_count_(0), tlsdesc_got_offset_(-1U)
+      count_(0), irelative_count_(0), tlsdesc_got_offset_(-1U), free_list_()
   { this->init(layout); }
 
+  // Create a PLT of a fixed size, for an incremental update.
+  // FIRST_PLT_ENTRY_SIZE and PLT_ENTRY_SIZE must be the values
+  // returned by do_first_plt_entry_offset and do_get_plt_entry_size,
+  // which we can not call from the constructor.
+  Output_data_plt_aarch64(Layout* layout,
+			  uint64_t addralign,
+			  unsigned int first_plt_entry_size,
+			  unsigned int plt_entry_size,
+			  Output_data_got_aarch64<size, big_endian>* got,
+			  Output_data_space* got_plt,
+			  Output_data_space* got_irelative,
+			  unsigned int plt_count)
+    : Output_section_data(first_plt_entry_size + plt_count * plt_entry_size,
+			  addralign, false),
+      tlsdesc_rel_(NULL), irelative_rel_(NULL),
+      got_(got), got_plt_(got_plt), got_irelative_(got_irelative),
+      count_(plt_count), irelative_count_(0), tlsdesc_got_offset_(-1U),
+      free_list_()
+  {
+    this->init(layout);
+
+    // Initialize the free list and reserve the first entry.
+    this->free_list_.init(first_plt_entry_size + plt_count * plt_entry_size,
+			  false);
+    this->free_list_.remove(0, first_plt_entry_size);
+  }
+
   // Initialize the PLT section.
   void
   init(Layout* layout);
@@ -4284,6 +4397,19 @@ class Output_data_plt_aarch64 : public Output_section_data
   entry_count() const
   { return this->count_ + this->irelative_count_; }
 
+  // Return the index of the PLT entry for GSYM.  The IRELATIVE
+  // entries follow the regular entries, and their PLT offsets count
+  // from the first IRELATIVE entry.
+  unsigned int
+  entry_index(const Symbol* gsym) const
+  {
+    if (gsym->type() == elfcpp::STT_GNU_IFUNC
+	&& gsym->can_use_relative_reloc(false))
+      return this->count_ + gsym->plt_offset() / this->get_plt_entry_size();
+    return ((gsym->plt_offset() - this->first_plt_entry_offset())
+	    / this->get_plt_entry_size());
+  }
+
   // Return the offset of the first non-reserved PLT entry.
   unsigned int
   first_plt_entry_offset() const
@@ -4299,6 +4425,16 @@ class Output_data_plt_aarch64 : public Output_section_data
   get_plt_tlsdesc_entry_size() const
   { return this->do_get_plt_tlsdesc_entry_size(); }
 
+  // Reserve a slot in the PLT for an existing symbol in an incremental update.
+  void
+  reserve_slot(unsigned int plt_index)
+  {
+    unsigned int plt_offset = (this->first_plt_entry_offset()
+			       + plt_index * this->get_plt_entry_size());
+    this->free_list_.remove(plt_offset,
+			    plt_offset + this->get_plt_entry_size());
+  }
+
   // Return the PLT address to use for a global symbol.
   uint64_t
   address_for_global(const Symbol*);
@@ -4417,6 +4553,10 @@ class Output_data_plt_aarch64 : public Output_section_data
   // Communicated to the loader via DT_TLSDESC_GOT. The magic value -1
   // indicates an offset is not allocated.
   unsigned int tlsdesc_got_offset_;
+
+  // List of available regions within the section, for incremental
+  // update links.
+  Free_list free_list_;
 };
 
 // Initialize the PLT section.
@@ -4466,17 +4606,46 @@ Output_data_plt_aarch64<size, big_endian>::add_entry(Symbol_table* symtab,
       got = this->got_plt_;
     }
 
-  gsym->set_plt_offset((*pcount) * this->get_plt_entry_size()
-		       + plt_reserved);
+  section_offset_type got_offset;
+  if (!this->is_data_size_valid())
+    {
+      gsym->set_plt_offset((*pcount) * this->get_plt_entry_size()
+			   + plt_reserved);
 
-  ++*pcount;
+      ++*pcount;
 
-  section_offset_type got_offset = got->current_data_size();
+      got_offset = got->current_data_size();
 
-  // Every PLT entry needs a GOT entry which points back to the PLT
-  // entry (this will be changed by the dynamic linker, normally
-  // lazily when the function is called).
-  got->set_current_data_size(got_offset + size / 8);
+      // Every PLT entry needs a GOT entry which points back to the PLT
+      // entry (this will be changed by the dynamic linker, normally
+      // lazily when the function is called).
+      got->set_current_data_size(got_offset + size / 8);
+    }
+  else
+    {
+      // The IRELATIVE entries follow the regular entries, so there is
+      // no room for new ones in an incremental update.
+      if (pcount == &this->irelative_count_)
+	gold_fallback(_("IFUNC symbol %s needs a new PLT entry;"
+			" relink with --incremental-full"),
+		      gsym->name());
+
+      // For incremental updates, find an available slot.
+      off_t plt_offset = this->free_list_.allocate(this->get_plt_entry_size(),
+						   this->get_plt_entry_size(),
+						   0);
+      if (plt_offset == -1)
+	gold_fallback(_("out of patch space (PLT);"
+			" relink with --incremental-full"));
+      gsym->set_plt_offset(plt_offset);
+
+      // The GOT and PLT entries have a 1-1 correspondence, so the GOT
+      // offset can be calculated from the PLT index, adjusting for the
+      // reserved entries at the beginning of the .got.plt section.
+      unsigned int plt_index = ((plt_offset - plt_reserved)
+				/ this->get_plt_entry_size());
+      got_offset = (plt_index + AARCH64_GOTPLT_RESERVE_COUNT) * (size / 8);
+    }
 
   // Every PLT entry needs a reloc.
   this->add_relocation(symtab, layout, gsym, got_offset);
@@ -4497,6 +4666,10 @@ Output_data_plt_aarch64<size, big_endian>::add_local_ifunc_entry(
     Sized_relobj_file<size, big_endian>* relobj,
     unsigned int local_sym_index)
 {
+  if (this->is_data_size_valid())
+    gold_fallback(_("local IFUNC symbol needs a new PLT entry;"
+		    " relink with --incremental-full"));
+
   unsigned int plt_offset = this->irelative_count_ * this->get_plt_entry_size();
   ++this->irelative_count_;
 
@@ -4660,6 +4833,21 @@ class Output_data_plt_aarch64_standard :
 						got_irelative)
   { }
 
+  Output_data_plt_aarch64_standard(
+      Layout* layout,
+      Output_data_got_aarch64<size, big_endian>* got,
+      Output_data_space* got_plt,
+      Output_data_space* got_irelative,
+      unsigned int plt_count)
+    : Output_data_plt_aarch64<size, big_endian>(layout,
+						size == 32 ? 4 : 8,
+						first_plt_entry_size,
+						plt_entry_size,
+						got, got_plt,
+						got_irelative,
+						plt_count)
+  { }
+
  protected:
   // Return the offset of the first non-reserved PLT entry.
   virtual unsigned int
@@ -5018,8 +5206,9 @@ Output_data_plt_aarch64<size, big_endian>::do_write(Output_file* of)
   unsigned char* const oview = of->get_output_view(offset, oview_size);
 
   const off_t got_file_offset = this->got_plt_->offset();
-  gold_assert(got_file_offset + this->got_plt_->data_size()
-	      == this->got_irelative_->offset());
+  gold_assert(parameters->incremental_update()
+	      || (got_file_offset + this->got_plt_->data_size()
+		  == this->got_irelative_->offset()));
 
   const section_size_type got_size =
       convert_to_section_size_type(this->got_plt_->data_size()
@@ -5509,7 +5698,8 @@ maybe_apply_stub(unsigned int r_type,
 		 const Sized_relobj_file<size, big_endian>* object,
 		 section_size_type current_group_size)
 {
-  if (parameters->options().relocatable())
+  // We do not generate stubs for a relocatable or an incremental link.
+  if (parameters->options().relocatable() || parameters->incremental())
     return false;
 
   typename elfcpp::Elf_types<size>::Elf_Swxword addend = rela.get_r_addend();
@@ -5767,6 +5957,8 @@ template<int size, bool big_endian>
 unsigned int
 Target_aarch64<size, big_endian>::first_plt_entry_offset() const
 {
+  if (this->plt_ == NULL)
+    return 0;
   return this->plt_->first_plt_entry_offset();
 }
 
@@ -5776,9 +5968,238 @@ template<int size, bool big_endian>
 unsigned int
 Target_aarch64<size, big_endian>::plt_entry_size() const
 {
+  if (this->plt_ == NULL)
+    return 0;
   return this->plt_->get_plt_entry_size();
 }
 
+// Return the index of the PLT entry for GSYM.
+
+template<int size, bool big_endian>
+unsigned int
+Target_aarch64<size, big_endian>::plt_entry_index(const Symbol* gsym) const
+{
+  gold_assert(this->plt_ != NULL);
+  return this->plt_->entry_index(gsym);
+}
+
+// Create the GOT and PLT sections for an incremental update.
+
+template<int size, bool big_endian>
+Output_data_got_base*
+Target_aarch64<size, big_endian>::init_got_plt_for_update(
+    Symbol_table* symtab,
+    Layout* layout,
+    unsigned int got_count,
+    unsigned int plt_count)
+{
+  gold_assert(this->got_ == NULL);
+
+  // The first word of the GOT, which holds the address of .dynamic,
+  // is reserved in the base file, so it is not handed out again.
+  this->got_ = new Output_data_got_aarch64<size, big_endian>(
+      symtab, layout, got_count * (size / 8));
+  layout->add_output_section_data(".got", elfcpp::SHT_PROGBITS,
+				  (elfcpp::SHF_ALLOC
+				   | elfcpp::SHF_WRITE),
+				  this->got_, ORDER_RELRO_LAST,
+				  true);
+
+  // Define _GLOBAL_OFFSET_TABLE_ at the start of the GOT.
+  this->global_offset_table_ =
+    symtab->define_in_output_data("_GLOBAL_OFFSET_TABLE_", NULL,
+				  Symbol_table::PREDEFINED,
+				  this->got_,
+				  0, 0, elfcpp::STT_OBJECT,
+				  elfcpp::STB_LOCAL,
+				  elfcpp::STV_HIDDEN, 0,
+				  false, false);
+
+  // Add the three reserved entries.
+  this->got_plt_ = new Output_data_space((plt_count
+					  + AARCH64_GOTPLT_RESERVE_COUNT)
+					 * (size / 8),
+					 size / 8, "** GOT PLT");
+  layout->add_output_section_data(".got.plt", elfcpp::SHT_PROGBITS,
+				  (elfcpp::SHF_ALLOC
+				   | elfcpp::SHF_WRITE),
+				  this->got_plt_, ORDER_NON_RELRO_FIRST,
+				  false);
+
+  // If there are any IRELATIVE relocations, they get GOT entries in
+  // .got.plt after the jump slot entries.
+  this->got_irelative_ = new Output_data_space(0, size / 8,
+					       "** GOT IRELATIVE PLT");
+  layout->add_output_section_data(".got.plt", elfcpp::SHT_PROGBITS,
+				  (elfcpp::SHF_ALLOC
+				   | elfcpp::SHF_WRITE),
+				  this->got_irelative_,
+				  ORDER_NON_RELRO_FIRST, false);
+
+  // If there are any TLSDESC relocations, they get GOT entries in
+  // .got.plt after the jump slot and IRELATIVE entries.
+  this->got_tlsdesc_ = new Output_data_got<size, big_endian>(0);
+  layout->add_output_section_data(".got.plt", elfcpp::SHT_PROGBITS,
+				  (elfcpp::SHF_ALLOC
+				   | elfcpp::SHF_WRITE),
+				  this->got_tlsdesc_,
+				  ORDER_NON_RELRO_FIRST, false);
+
+  // Create the PLT section.
+  this->plt_ = this->make_data_plt(layout, this->got_, this->got_plt_,
+				   this->got_irelative_, plt_count);
+  layout->add_output_section_data(".plt", elfcpp::SHT_PROGBITS,
+				  elfcpp::SHF_ALLOC | elfcpp::SHF_EXECINSTR,
+				  this->plt_, ORDER_PLT, false);
+
+  // Make the sh_info field of .rela.plt point to .plt.
+  Output_section* rela_plt_os = this->plt_->rela_plt()->output_section();
+  rela_plt_os->set_info_section(this->plt_->output_section());
+
+  // Create the rela_dyn section.
+  this->rela_dyn_section(layout);
+
+  return this->got_;
+}
+
+// Reserve a GOT entry for a local symbol, and regenerate any
+// necessary dynamic relocations.
+
+template<int size, bool big_endian>
+void
+Target_aarch64<size, big_endian>::reserve_local_got_entry(
+    unsigned int got_index,
+    Sized_relobj<size, big_endian>* obj,
+    unsigned int r_sym,
+    unsigned int got_type)
+{
+  unsigned int got_offset = got_index * (size / 8);
+  Reloc_section* rela_dyn = this->rela_dyn_section(NULL);
+
+  this->got_->reserve_local(got_index, obj, r_sym, got_type);
+  switch (got_type)
+    {
+    case GOT_TYPE_STANDARD:
+      if (parameters->options().output_is_position_independent())
+	rela_dyn->add_local_relative(obj, r_sym, elfcpp::R_AARCH64_RELATIVE,
+				     this->got_, got_offset, 0, false);
+      break;
+    case GOT_TYPE_TLS_OFFSET:
+      rela_dyn->add_local(obj, r_sym, elfcpp::R_AARCH64_TLS_TPREL64,
+			  this->got_, got_offset, 0);
+      break;
+    case GOT_TYPE_TLS_PAIR:
+      this->got_->reserve_slot(got_index + 1);
+      rela_dyn->add_local(obj, r_sym, elfcpp::R_AARCH64_TLS_DTPMOD64,
+			  this->got_, got_offset, 0);
+      break;
+    case GOT_TYPE_TLS_DESC:
+      gold_fallback(_("TLS descriptors are not supported in an incremental"
+		      " update; relink with --incremental-full"));
+      break;
+    default:
+      gold_unreachable();
+    }
+}
+
+// Reserve a GOT entry for a global symbol, and regenerate any
+// necessary dynamic relocations.
+
+template<int size, bool big_endian>
+void
+Target_aarch64<size, big_endian>::reserve_global_got_entry(
+    unsigned int got_index,
+    Symbol* gsym,
+    unsigned int got_type)
+{
+  unsigned int got_offset = got_index * (size / 8);
+  Reloc_section* rela_dyn = this->rela_dyn_section(NULL);
+
+  this->got_->reserve_global(got_index, gsym, got_type);
+  switch (got_type)
+    {
+    case GOT_TYPE_STANDARD:
+      if (!gsym->final_value_is_known())
+	{
+	  if (gsym->is_from_dynobj()
+	      || gsym->is_undefined()
+	      || gsym->is_preemptible()
+	      || (gsym->visibility() == elfcpp::STV_PROTECTED
+		  && parameters->options().shared())
+	      || (gsym->type() == elfcpp::STT_GNU_IFUNC
+		  && parameters->options().output_is_position_independent()))
+	    rela_dyn->add_global(gsym, elfcpp::R_AARCH64_GLOB_DAT,
+				 this->got_, got_offset, 0);
+	  else
+	    rela_dyn->add_global_relative(gsym, elfcpp::R_AARCH64_RELATIVE,
+					  this->got_, got_offset, 0, false);
+	}
+      break;
+    case GOT_TYPE_TLS_OFFSET:
+      rela_dyn->add_global(gsym, elfcpp::R_AARCH64_TLS_TPREL64,
+			   this->got_, got_offset, 0);
+      break;
+    case GOT_TYPE_TLS_PAIR:
+      this->got_->reserve_slot(got_index + 1);
+      rela_dyn->add_global(gsym, elfcpp::R_AARCH64_TLS_DTPMOD64,
+			   this->got_, got_offset, 0);
+      rela_dyn->add_global(gsym, elfcpp::R_AARCH64_TLS_DTPREL64,
+			   this->got_, got_offset + size / 8, 0);
+      break;
+    case GOT_TYPE_TLS_DESC:
+      gold_fallback(_("TLS descriptors are not supported in an incremental"
+		      " update; relink with --incremental-full"));
+      break;
+    default:
+      gold_unreachable();
+    }
+}
+
+// Register an existing PLT entry for a global symbol.
+
+template<int size, bool big_endian>
+void
+Target_aarch64<size, big_endian>::register_global_plt_entry(
+    Symbol_table* symtab,
+    Layout* layout,
+    unsigned int plt_index,
+    Symbol* gsym)
+{
+  gold_assert(this->plt_ != NULL);
+  gold_assert(!gsym->has_plt_offset());
+
+  // The IRELATIVE entries follow the regular entries and use a
+  // separate GOT section, which is not rebuilt from the base file.
+  if (gsym->type() == elfcpp::STT_GNU_IFUNC
+      && gsym->can_use_relative_reloc(false))
+    gold_fallback(_("IFUNC symbol %s has a PLT entry in the base file;"
+		    " relink with --incremental-full"),
+		  gsym->name());
+
+  this->plt_->reserve_slot(plt_index);
+
+  gsym->set_plt_offset(this->first_plt_entry_offset()
+		       + plt_index * this->plt_entry_size());
+
+  unsigned int got_offset = ((plt_index + AARCH64_GOTPLT_RESERVE_COUNT)
+			     * (size / 8));
+  this->plt_->add_relocation(symtab, layout, gsym, got_offset);
+}
+
+// Force a COPY relocation for a given symbol.
+
+template<int size, bool big_endian>
+void
+Target_aarch64<size, big_endian>::emit_copy_reloc(
+    Symbol_table* symtab, Symbol* sym, Output_section* os, off_t offset)
+{
+  this->copy_relocs_.emit_copy_reloc(symtab,
+				     symtab->get_sized_symbol<size>(sym),
+				     os,
+				     offset,
+				     this->rela_dyn_section(NULL));
+}
+
 // Define the _TLS_MODULE_BASE_ symbol in the TLS segment.
 
 template<int size, bool big_endian>
@@ -5817,6 +6238,12 @@ Target_aarch64<size, big_endian>::reserve_tlsdesc_entries(
 
   if (!this->plt_->has_tlsdesc_entry())
     {
+      // The reserved TLSDESC entry follows the regular PLT entries,
+      // so we can not add it to an existing PLT.
+      if (parameters->incremental_update())
+	gold_fallback(_("TLS descriptors are not supported in an incremental"
+			" update; relink with --incremental-full"));
+
       // Allocate the TLSDESC_GOT entry.
       Output_data_got_aarch64<size, big_endian>* got =
 	  this->got_section(symtab, layout);
@@ -8185,6 +8612,34 @@ Target_aarch64<size, big_endian>::relocate_section(
     reloc_symbol_changes);
 }
 
+// Apply an incremental relocation.  Incremental relocations always refer
+// to global symbols.
+
+template<int size, bool big_endian>
+void
+Target_aarch64<size, big_endian>::apply_relocation(
+    const Relocate_info<size, big_endian>* relinfo,
+    typename elfcpp::Elf_types<size>::Elf_Addr r_offset,
+    unsigned int r_type,
+    typename elfcpp::Elf_types<size>::Elf_Swxword r_addend,
+    const Symbol* gsym,
+    unsigned char* view,
+    typename elfcpp::Elf_types<size>::Elf_Addr address,
+    section_size_type view_size)
+{
+  gold::apply_relocation<size, big_endian, Target_aarch64<size, big_endian>,
+			 typename Target_aarch64<size, big_endian>::Relocate>(
+    relinfo,
+    this,
+    r_offset,
+    r_type,
+    r_addend,
+    gsym,
+    view,
+    address,
+    view_size);
+}
+
 // Scan the relocs during a relocatable link.
 
 template<int size, bool big_endian>
@@ -65,9 +65,12 @@ Library_base::should_include_member(Symbol_table* symtab, Layout* layout,
   char* tmpbuf = *tmpbufp;
   const char* ver = strchr(sym_name, '@');
   bool def = false;
-  if (ver != NULL)
+  size_t symlen;
+  if (ver == NULL)
+    symlen = strlen(sym_name);
+  else
     {
-      size_t symlen = ver - sym_name;
+      symlen = ver - sym_name;
       if (symlen + 1 > *tmpbuflen)
         {
           tmpbuf = static_cast<char*>(xrealloc(tmpbuf, symlen + 1));
@@ -86,13 +89,28 @@ Library_base::should_include_member(Symbol_table* symtab, Layout* layout,
         }
     }
 
-  Symbol* sym = symtab->lookup(sym_name, ver);
+  return Library_base::should_include_symbol(symtab, layout, sym_name, symlen,
+					     string_hash<char>(sym_name,
+							       symlen),
+					     ver, def, symp, why);
+}
+
+// Implement should_include_member once the version has been split
+// off SYM_NAME and its hash code computed.
+
+Library_base::Should_include
+Library_base::should_include_symbol(Symbol_table* symtab, Layout* layout,
+				    const char* sym_name, size_t sym_len,
+				    size_t name_hash, const char* ver,
+				    bool def, Symbol** symp, std::string* why)
+{
+  Symbol* sym = symtab->lookup(sym_name, sym_len, name_hash, ver);
   if (def
       && ver != NULL
       && (sym == NULL
           || !sym->is_undefined()
           || sym->binding() == elfcpp::STB_WEAK))
-    sym = symtab->lookup(sym_name, NULL);
+    sym = symtab->lookup(sym_name, sym_len, name_hash, NULL);
 
   *symp = sym;
 
@@ -127,7 +145,8 @@ Library_base::should_include_member(Symbol_table* symtab, Layout* layout,
       return Library_base::SHOULD_INCLUDE_YES;
     }
 
-  if (layout->script_options()->is_referenced(sym_name))
+  if (layout->script_options()->any_unreferenced()
+      && layout->script_options()->is_referenced(sym_name))
     {
       size_t alc = 100 + strlen(sym_name);
       char* buf = new char[alc];
@@ -315,10 +334,41 @@ Archive::read_armap(off_t start, section_size_type size)
   section_offset_type name_offset = 0;
   for (unsigned long i = 0; i < nsyms; ++i)
     {
-      this->armap_[i].name_offset = name_offset;
-      this->armap_[i].file_offset = convert_types<off_t, Entry_type>(
+      Armap_entry& entry(this->armap_[i]);
+      entry.name_offset = name_offset;
+      entry.file_offset = convert_types<off_t, Entry_type>(
         elfcpp::Swap<mapsize, true>::readval(pword));
-      name_offset += strlen(pnames + name_offset) + 1;
+      entry.base_name_offset = name_offset;
+      entry.version_offset = -1;
+      entry.is_default_version = false;
+      if (static_cast<section_size_type>(name_offset) <= names_size)
+	{
+	  const char* name = this->armap_names_.data() + name_offset;
+	  size_t len = strlen(name);
+	  name_offset += len + 1;
+
+	  // An '@' in the name separates the symbol name from the
+	  // version name; see should_include_member.
+	  const char* ver = strchr(name, '@');
+	  if (ver != NULL)
+	    {
+	      len = ver - name;
+	      ++ver;
+	      if (*ver == '@')
+		{
+		  ++ver;
+		  entry.is_default_version = true;
+		}
+	      entry.version_offset = ver - this->armap_names_.data();
+	    }
+	  entry.name_length = len;
+	  entry.name_hash = string_hash<char>(name, len);
+	}
+      else
+	{
+	  entry.name_length = 0;
+	  entry.name_hash = 0;
+	}
       ++pword;
       if (this->armap_[i].file_offset != last_seen_offset)
         {
@@ -331,6 +381,20 @@ Archive::read_armap(off_t start, section_size_type size)
     gold_error(_("%s: bad archive symbol table names"),
 	       this->name().c_str());
 
+  // Append a null terminated copy of each versioned name without its
+  // version, so that add_symbols can look it up directly.
+  for (unsigned long i = 0; i < nsyms; ++i)
+    {
+      Armap_entry& entry(this->armap_[i]);
+      if (entry.version_offset >= 0)
+	{
+	  entry.base_name_offset = this->armap_names_.size();
+	  this->armap_names_.append(this->armap_names_, entry.name_offset,
+				    entry.name_length);
+	  this->armap_names_.push_back('\0');
+	}
+    }
+
   // This array keeps track of which symbols are for archive elements
   // which we have already included in the link.
   this->armap_checked_.resize(nsyms);
@@ -797,11 +861,6 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
   // offset we saw that was present in the seen_offsets_ set.
   off_t last_seen_offset = -1;
 
-  // Track which symbols in the symbol table we've already found to be
-  // defined.
-
-  char* tmpbuf = NULL;
-  size_t tmpbuflen = 0;
   bool added_new_object;
   do
     {
@@ -823,14 +882,20 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 	      continue;
 	    }
 
-	  const char* sym_name = (this->armap_names_.data()
-				  + this->armap_[i].name_offset);
+	  const Armap_entry& entry(this->armap_[i]);
+	  const char* names = this->armap_names_.data();
+	  const char* ver = (entry.version_offset < 0
+			     ? NULL
+			     : names + entry.version_offset);
 
           Symbol* sym;
           std::string why;
           Archive::Should_include t =
-	    Archive::should_include_member(symtab, layout, sym_name, &sym,
-					   &why, &tmpbuf, &tmpbuflen);
+	    Archive::should_include_symbol(symtab, layout,
+					   names + entry.base_name_offset,
+					   entry.name_length, entry.name_hash,
+					   ver, entry.is_default_version,
+					   &sym, &why);
 
 	  if (t == Archive::SHOULD_INCLUDE_NO
               || t == Archive::SHOULD_INCLUDE_YES)
@@ -846,20 +911,13 @@ Archive::add_symbols(Symbol_table* symtab, Layout* layout,
 	  if (!this->include_member(symtab, layout, input_objects,
 				    last_seen_offset, mapfile, sym,
 				    why.c_str()))
-	    {
-	      if (tmpbuf != NULL)
-		free(tmpbuf);
-	      return false;
-	    }
+	    return false;
 
 	  added_new_object = true;
 	}
     }
   while (added_new_object);
 
-  if (tmpbuf != NULL)
-    free(tmpbuf);
-
   input_objects->archive_stop(this);
 
   return true;
@@ -873,30 +931,30 @@ Archive::defines_symbol(Symbol* sym) const
 {
   const char* symname = sym->name();
   size_t symname_len = strlen(symname);
+  size_t symname_hash = string_hash<char>(symname, symname_len);
+  const char* names = this->armap_names_.data();
   size_t armap_size = this->armap_.size();
   for (size_t i = 0; i < armap_size; ++i)
     {
       if (this->armap_checked_[i])
 	continue;
-      const char* archive_symname = (this->armap_names_.data()
-				     + this->armap_[i].name_offset);
-      if (strncmp(archive_symname, symname, symname_len) != 0)
+      const Armap_entry& entry(this->armap_[i]);
+      if (entry.name_hash != symname_hash
+	  || entry.name_length != symname_len
+	  || memcmp(names + entry.base_name_offset, symname,
+		    symname_len) != 0)
 	continue;
-      char c = archive_symname[symname_len];
-      if (c == '\0' && sym->version() == NULL)
-	return true;
-      if (c == '@')
+      if (entry.version_offset < 0)
 	{
-	  const char* ver = archive_symname + symname_len + 1;
-	  if (*ver == '@')
-	    {
-	      if (sym->version() == NULL)
-		return true;
-	      ++ver;
-	    }
-	  if (sym->version() != NULL && strcmp(sym->version(), ver) == 0)
+	  if (sym->version() == NULL)
 	    return true;
+	  continue;
 	}
+      if (entry.is_default_version && sym->version() == NULL)
+	return true;
+      if (sym->version() != NULL
+	  && strcmp(sym->version(), names + entry.version_offset) == 0)
+	return true;
     }
   return false;
 }
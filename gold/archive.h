@@ -100,6 +100,16 @@ class Library_base
                         Symbol** symp, std::string* why, char** tmpbufp,
                         size_t* tmpbuflen);
 
+  // Like should_include_member, but the version has already been
+  // split off.  SYM_NAME is null terminated, SYM_LEN is its length,
+  // and NAME_HASH is string_hash<char>(SYM_NAME, SYM_LEN).  VER is
+  // the version or NULL, and DEF is true if this is the default
+  // version.
+  static Should_include
+  should_include_symbol(Symbol_table* symtab, Layout*, const char* sym_name,
+			size_t sym_len, size_t name_hash, const char* ver,
+			bool def, Symbol** symp, std::string* why);
+
   // Store a pointer to the incremental link info for the library.
   void
   set_incremental_info(Incremental_archive_entry* info)
@@ -367,6 +377,20 @@ class Archive : public Library_base
     off_t name_offset;
     // The file offset to the object in the archive.
     off_t file_offset;
+    // The offset in armap_names_ of the symbol name without any
+    // version, null terminated.  This is the same as name_offset if
+    // the name has no version.
+    off_t base_name_offset;
+    // The offset in armap_names_ of the version, or -1 if none.
+    off_t version_offset;
+    // The length of the symbol name without the version.
+    size_t name_length;
+    // The hash code of the symbol name without the version.  We
+    // compute this once when reading the armap, since add_symbols
+    // may look at each entry many times.
+    size_t name_hash;
+    // Whether the version is the default version.
+    bool is_default_version;
   };
 
   // A simple hash code for off_t values.
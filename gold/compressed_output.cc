@@ -24,11 +24,23 @@
 #include <zlib.h>
 #include "parameters.h"
 #include "options.h"
+#include "workqueue.h"
 #include "compressed_output.h"
 
 namespace gold
 {
 
+// The zlib compression level to use.
+
+static int
+zlib_compress_level()
+{
+  if (parameters->options().optimize() >= 1)
+    return 9;
+  else
+    return 1;
+}
+
 // Compress UNCOMPRESSED_DATA of size UNCOMPRESSED_SIZE.  Returns true
 // if it successfully compressed, false if it failed for any reason
 // (including not having zlib support in the library).  If it returns
@@ -48,11 +60,7 @@ zlib_compress(int header_size,
   *compressed_size = uncompressed_size + uncompressed_size / 1000 + 128;
   *compressed_data = new unsigned char[*compressed_size + header_size];
 
-  int compress_level;
-  if (parameters->options().optimize() >= 1)
-    compress_level = 9;
-  else
-    compress_level = 1;
+  int compress_level = zlib_compress_level();
 
   int rc = compress2(reinterpret_cast<Bytef*>(*compressed_data) + header_size,
                      compressed_size,
@@ -211,6 +219,222 @@ decompress_input_section(const unsigned char* compressed_data,
 
 // Class Output_compressed_section.
 
+// When compressing in parallel, the size of each chunk of the section
+// contents.  This is fixed so that the output does not depend on the
+// number of threads.
+
+static const unsigned long compress_chunk_size = 1024 * 1024;
+
+// The size of the deflate window.  Each chunk after the first uses
+// the preceding data as a preset dictionary, so that splitting the
+// section costs little in compression ratio.
+
+static const unsigned long compress_window_size = 32 * 1024;
+
+// A task to compress one chunk of a compressed section.
+
+class Compress_chunk_task : public Task
+{
+ public:
+  Compress_chunk_task(Output_compressed_section* os, unsigned int chunk,
+		      Task_token* blocker)
+    : os_(os), chunk_(chunk), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->os_->compress_chunk(this->chunk_); }
+
+  std::string
+  get_name() const
+  { return "Compress_chunk_task " + std::string(this->os_->name()); }
+
+ private:
+  Output_compressed_section* os_;
+  unsigned int chunk_;
+  Task_token* blocker_;
+};
+
+Output_compressed_section::~Output_compressed_section()
+{
+  this->free_chunks();
+  delete[] this->data_;
+}
+
+// Decide whether to compress the section in parallel, and if so set
+// up the list of chunks.  This is called after all the input sections
+// have been written to the postprocessing buffer.
+
+unsigned int
+Output_compressed_section::prepare_chunks()
+{
+  gold_assert(this->chunks_.empty());
+
+  if (strcmp(this->options_->compress_debug_sections(), "none") == 0
+      || !this->has_postprocessing_buffer())
+    return 0;
+
+  off_t uncompressed_size = this->postprocessing_buffer_size();
+  if (uncompressed_size <= static_cast<off_t>(compress_chunk_size))
+    return 0;
+
+  // Copy in the contents of anything other than a regular input
+  // section, as set_final_data_size does.  Doing it twice is harmless.
+  this->write_to_postprocessing_buffer();
+
+  unsigned int count = ((uncompressed_size - 1) / compress_chunk_size) + 1;
+  this->chunks_.resize(count);
+  return count;
+}
+
+// Queue the tasks to compress the chunks.
+
+void
+Output_compressed_section::queue_chunk_tasks(Workqueue* workqueue,
+					     Task_token* blocker)
+{
+  for (unsigned int i = 0; i < this->chunks_.size(); ++i)
+    workqueue->queue(new Compress_chunk_task(this, i, blocker));
+}
+
+// Compress chunk number I as raw deflate data.  Every chunk but the
+// last ends with a full flush, so that the chunks can simply be
+// concatenated; the last chunk finishes the deflate stream.
+
+void
+Output_compressed_section::compress_chunk(unsigned int i)
+{
+  Compressed_chunk* chunk = &this->chunks_[i];
+  const unsigned char* buffer = this->postprocessing_buffer();
+  unsigned long uncompressed_size = this->postprocessing_buffer_size();
+  unsigned long start = i * compress_chunk_size;
+  unsigned long len = std::min(compress_chunk_size,
+			       uncompressed_size - start);
+  bool is_last = i + 1 == this->chunks_.size();
+
+  chunk->adler = adler32(adler32(0L, Z_NULL, 0),
+			 reinterpret_cast<const Bytef*>(buffer + start),
+			 len);
+
+  z_stream strm;
+  memset(&strm, 0, sizeof strm);
+  if (deflateInit2(&strm, zlib_compress_level(), Z_DEFLATED, -15, 8,
+		   Z_DEFAULT_STRATEGY) != Z_OK)
+    return;
+
+  if (start > 0)
+    {
+      unsigned long dict_len = std::min(start, compress_window_size);
+      if (deflateSetDictionary(&strm,
+			       reinterpret_cast<const Bytef*>(buffer + start
+							      - dict_len),
+			       dict_len) != Z_OK)
+	{
+	  deflateEnd(&strm);
+	  return;
+	}
+    }
+
+  // Leave room for the empty stored block written by the flush.
+  unsigned long out_size = deflateBound(&strm, len) + 16;
+  unsigned char* out = new unsigned char[out_size];
+  strm.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(buffer
+								    + start));
+  strm.avail_in = len;
+  strm.next_out = reinterpret_cast<Bytef*>(out);
+  strm.avail_out = out_size;
+
+  int rc = deflate(&strm, is_last ? Z_FINISH : Z_FULL_FLUSH);
+  bool ok = (is_last
+	     ? rc == Z_STREAM_END
+	     : rc == Z_OK && strm.avail_in == 0 && strm.avail_out != 0);
+  deflateEnd(&strm);
+  if (!ok)
+    {
+      delete[] out;
+      return;
+    }
+
+  chunk->data = out;
+  chunk->size = out_size - strm.avail_out;
+}
+
+// Combine the compressed chunks into a single zlib stream, preceded
+// by HEADER_SIZE bytes for the section compression header.  Set
+// data_ and *COMPRESSED_SIZE.  Return false if any chunk failed to
+// compress.
+
+bool
+Output_compressed_section::combine_chunks(int header_size,
+					  unsigned long uncompressed_size,
+					  unsigned long* compressed_size)
+{
+  unsigned long size = header_size + 2 + 4;
+  for (std::vector<Compressed_chunk>::const_iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    {
+      if (p->data == NULL)
+	return false;
+      size += p->size;
+    }
+
+  unsigned char* data = new unsigned char[size];
+  unsigned char* pov = data + header_size;
+
+  // The zlib header: deflate with a 32K window and no preset
+  // dictionary.  The second byte records the compression level, and
+  // makes the header a multiple of 31.
+  pov[0] = 0x78;
+  pov[1] = zlib_compress_level() >= 9 ? 0xda : 0x01;
+  pov += 2;
+
+  unsigned long adler = adler32(0L, Z_NULL, 0);
+  unsigned long offset = 0;
+  for (std::vector<Compressed_chunk>::const_iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    {
+      memcpy(pov, p->data, p->size);
+      pov += p->size;
+      unsigned long len = std::min(compress_chunk_size,
+				   uncompressed_size - offset);
+      adler = adler32_combine(adler, p->adler, len);
+      offset += len;
+    }
+  gold_assert(offset == uncompressed_size);
+
+  elfcpp::Swap_unaligned<32, true>::writeval(pov, adler);
+  pov += 4;
+  gold_assert(static_cast<unsigned long>(pov - data) == size);
+
+  this->data_ = data;
+  *compressed_size = size;
+  return true;
+}
+
+// Free the compressed chunks.
+
+void
+Output_compressed_section::free_chunks()
+{
+  for (std::vector<Compressed_chunk>::iterator p = this->chunks_.begin();
+       p != this->chunks_.end();
+       ++p)
+    delete[] p->data;
+  this->chunks_.clear();
+}
+
 // Set the final data size of a compressed section.  This is where
 // we actually compress the section data.
 
@@ -248,7 +472,11 @@ Output_compressed_section::set_final_data_size()
     }
   else
     compress = none;
-  if (compress != none)
+  if (compress != none && !this->chunks_.empty())
+    success = this->combine_chunks(compression_header_size,
+				   uncompressed_size, &compressed_size);
+  this->free_chunks();
+  if (compress != none && !success)
     success = zlib_compress(compression_header_size, uncompressed_data,
 			    uncompressed_size, &this->data_,
 			    &compressed_size);
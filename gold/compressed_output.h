@@ -29,6 +29,7 @@
 #define GOLD_COMPRESSED_OUTPUT_H
 
 #include <string>
+#include <vector>
 
 #include "output.h"
 
@@ -36,6 +37,8 @@ namespace gold
 {
 
 class General_options;
+class Task_token;
+class Workqueue;
 
 // Read the compression header of a compressed debug section and return
 // the uncompressed size.
@@ -60,9 +63,28 @@ class Output_compressed_section : public Output_section
 			    const char* name, elfcpp::Elf_Word flags,
 			    elfcpp::Elf_Xword type)
     : Output_section(name, flags, type),
-      options_(options)
+      options_(options), data_(NULL), chunks_()
   { this->set_requires_postprocessing(); }
 
+  ~Output_compressed_section();
+
+  // Split the section contents into chunks which can be compressed
+  // independently, and return the number of chunks.  This returns 0
+  // if the section should be compressed in one piece by
+  // set_final_data_size.
+  unsigned int
+  prepare_chunks();
+
+  // Queue a task to compress each chunk.  Each task unblocks BLOCKER
+  // when it completes.
+  void
+  queue_chunk_tasks(Workqueue*, Task_token* blocker);
+
+  // Compress chunk number I.  This is called by the tasks queued by
+  // queue_chunk_tasks.
+  void
+  compress_chunk(unsigned int i);
+
  protected:
   // Set the final data size.
   void
@@ -73,10 +95,37 @@ class Output_compressed_section : public Output_section
   do_write(Output_file*);
 
  private:
+  // A chunk of the section contents, compressed as raw deflate data.
+  struct Compressed_chunk
+  {
+    Compressed_chunk()
+      : data(NULL), size(0), adler(0)
+    { }
+
+    // The compressed data, or NULL if compression failed.
+    unsigned char* data;
+    // The size of the compressed data.
+    unsigned long size;
+    // The Adler-32 checksum of the uncompressed chunk.
+    unsigned long adler;
+  };
+
+  // Combine the compressed chunks into a single zlib stream.
+  bool
+  combine_chunks(int header_size, unsigned long uncompressed_size,
+		 unsigned long* compressed_size);
+
+  // Free the compressed chunks.
+  void
+  free_chunks();
+
   // The options--this includes the compression type.
   const General_options* options_;
   // The compressed data.
   unsigned char* data_;
+  // The independently compressed chunks, if we are compressing in
+  // parallel.
+  std::vector<Compressed_chunk> chunks_;
   // The new section name if we do compress.
   std::string new_section_name_;
 };
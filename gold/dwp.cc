@@ -28,8 +28,11 @@
 #include <cstdlib>
 #include <cstring>
 #include <cerrno>
+#include <sys/stat.h>
 
 #include <vector>
+#include <map>
+#include <set>
 #include <algorithm>
 
 #include "getopt.h"
@@ -45,6 +48,7 @@
 #include "compressed_output.h"
 #include "stringpool.h"
 #include "dwarf_reader.h"
+#include "workqueue.h"
 
 static void
 usage(FILE* fd, int) ATTRIBUTE_NORETURN;
@@ -70,6 +74,9 @@ struct Dwo_file_entry
 };
 typedef std::vector<Dwo_file_entry> File_list;
 
+// A set of DWO IDs.
+typedef std::set<uint64_t> Dwo_id_set;
+
 // Type to hold the offset and length of an input section
 // within an output section.
 
@@ -107,21 +114,65 @@ struct Unit_set
 class Dwo_file
 {
  public:
-  Dwo_file(const char* name)
-    : name_(name), obj_(NULL), input_file_(NULL), is_compressed_(),
-      sect_offsets_(), str_offset_map_()
-  { }
+  Dwo_file(const char* name, bool is_update_base = false)
+    : name_(name), is_update_base_(is_update_base), keep_dwo_ids_(NULL),
+      obj_(NULL),
+      input_file_(NULL), machine_(0), size_(0), big_endian_(false),
+      osabi_(0), abiversion_(0), is_compressed_(), sect_offsets_(),
+      debug_types_(), debug_str_(0), debug_cu_index_(0), debug_tu_index_(0),
+      str_contents_(NULL), str_is_new_(false), str_offset_map_(),
+      str_hashes_(), contribution_map_()
+  {
+    for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
+      this->debug_shndx_[i] = 0;
+  }
 
   ~Dwo_file();
 
+  // Return the file name.
+  const char*
+  name() const
+  { return this->name_; }
+
+  // For an update base, set the DWO IDs of the CUs to keep.  Other
+  // CUs are dropped.  By default, we keep all the CUs.
+  void
+  set_keep_dwo_ids(const Dwo_id_set* dwo_ids)
+  { this->keep_dwo_ids_ = dwo_ids; }
+
   // Read the input executable file and extract the list of .dwo files
   // that it references.
   void
   read_executable(File_list* files);
 
-  // Read the input file and send its contents to OUTPUT_FILE.
+  // Open the input file.
+  void
+  open();
+
+  // Read the section table and the contents of the sections that we
+  // will copy to the output file, and hash the strings in the string
+  // table.  This does not touch the output file, so it may be run
+  // for several input files at once.
   void
-  read(Dwp_output_file* output_file);
+  read_sections();
+
+  // Record the target info in OUTPUT_FILE, and merge the input string
+  // table into the output string table.  This must be called for each
+  // input file in order, after read_sections.
+  void
+  add_strings(Dwp_output_file* output_file);
+
+  // Remap the string offsets in the .debug_str_offsets.dwo section for
+  // the output string table.  This must be called after add_strings,
+  // but may be run for several input files at once.
+  void
+  remap_str_offsets();
+
+  // Add the CU and TU sets and their sections to OUTPUT_FILE.  This
+  // must be called for each input file in order, after
+  // remap_str_offsets.
+  void
+  add_units(Dwp_output_file* output_file);
 
   // Verify a .dwp file given a list of .dwo files referenced by the
   // corresponding executable file.  Returns true if no problems
@@ -129,6 +180,11 @@ class Dwo_file
   bool
   verify(const File_list& files);
 
+  // Read the DWO IDs of the CUs in a .dwp file, and add them to
+  // DWO_IDS.
+  void
+  read_dwo_ids(Dwo_id_set* dwo_ids);
+
  private:
   // Types for mapping input string offsets to output string offsets.
   typedef std::pair<section_offset_type, section_offset_type>
@@ -144,16 +200,35 @@ class Dwo_file
     { return i1.first < i2.first; }
   };
 
+  // The contents of an input section that we will copy to the output
+  // file.  The memory is owned by the Dwo_file until it is passed to
+  // the output file.
+  struct Section_data
+  {
+    unsigned char* contents;
+    section_size_type len;
+
+    Section_data()
+      : contents(NULL), len(0)
+    { }
+  };
+
+  // Map a DW_SECT and the offset and size of a contribution within
+  // the input section onto the offset of the copied contribution
+  // within the output section.
+  typedef std::pair<section_offset_type, section_size_type>
+      Contribution_bounds;
+  typedef std::map<std::pair<unsigned int, Contribution_bounds>,
+		   section_offset_type> Contribution_map;
+
   // Create a Sized_relobj_dwo of the given size and endianness,
-  // and record the target info.  P is a pointer to the ELF header
-  // in memory.
+  // and save the target info.
   Relobj*
-  make_object(Dwp_output_file* output_file);
+  make_object();
 
   template <int size, bool big_endian>
   Relobj*
-  sized_make_object(const unsigned char* p, Input_file* input_file,
-		    Dwp_output_file* output_file);
+  sized_make_object(const unsigned char* p, Input_file* input_file);
 
   // Return the number of sections in the input object file.
   unsigned int
@@ -188,6 +263,10 @@ class Dwo_file
   sized_read_unit_index(unsigned int, unsigned int *, Dwp_output_file*,
 			bool is_tu_index);
 
+  // Find the .debug_cu_index section of a .dwp file.
+  unsigned int
+  find_cu_index();
+
   // Verify the .debug_cu_index section of a .dwp file, comparing it
   // against the list of .dwo files referenced by the corresponding
   // executable file.
@@ -198,22 +277,28 @@ class Dwo_file
   bool
   sized_verify_dwo_list(unsigned int, const File_list& files);
 
-  // Merge the input string table section into the output file.
+  template <bool big_endian>
+  void
+  sized_read_dwo_ids(unsigned int, Dwo_id_set* dwo_ids);
+
+  // Read the string table section, and hash the strings.
   void
-  add_strings(Dwp_output_file*, unsigned int);
+  hash_strings();
 
   // Copy a section from the input file to the output file.
   Section_bounds
   copy_section(Dwp_output_file* output_file, unsigned int shndx,
 	       elfcpp::DW_SECT section_id);
 
-  // Remap the string offsets in the .debug_str_offsets.dwo section.
-  const unsigned char*
-  remap_str_offsets(const unsigned char* contents, section_size_type len);
+  // Copy a single contribution to a section from a .dwp input file
+  // to the output file.
+  section_offset_type
+  copy_contribution(Dwp_output_file* output_file, unsigned int dw_sect,
+		    section_offset_type offset, section_size_type len);
 
   template <bool big_endian>
-  const unsigned char*
-  sized_remap_str_offsets(const unsigned char* contents, section_size_type len);
+  void
+  sized_remap_str_offsets(unsigned char* contents, section_size_type len);
 
   // Remap a single string offsets from an offset in the input string table
   // to an offset in the output string table.
@@ -228,16 +313,49 @@ class Dwo_file
 
   // The filename.
   const char* name_;
+  // TRUE if this is an existing .dwp file being updated with --update.
+  // CUs which have already been added from other input files replace
+  // the CUs in this file.
+  bool is_update_base_;
+  // For an update base, the DWO IDs of the CUs to keep, or NULL to
+  // keep all the CUs which have not been replaced.
+  const Dwo_id_set* keep_dwo_ids_;
   // The ELF file, represented as a gold Relobj instance.
   Relobj* obj_;
   // The Input_file object.
   Input_file* input_file_;
+  // ELF header parameters.
+  int machine_;
+  int size_;
+  bool big_endian_;
+  int osabi_;
+  int abiversion_;
   // Flags indicating which sections are compressed.
   std::vector<bool> is_compressed_;
   // Map input section index onto output section offset and size.
   std::vector<Section_bounds> sect_offsets_;
+  // The debug sections, indexed by DW_SECT.
+  unsigned int debug_shndx_[elfcpp::DW_SECT_MAX + 1];
+  // The .debug_types.dwo sections.
+  std::vector<unsigned int> debug_types_;
+  // The .debug_str.dwo section.
+  unsigned int debug_str_;
+  // The .debug_cu_index and .debug_tu_index sections of a .dwp file.
+  unsigned int debug_cu_index_;
+  unsigned int debug_tu_index_;
+  // The contents of the sections to copy, indexed by DW_SECT.
+  Section_data section_data_[elfcpp::DW_SECT_MAX + 1];
+  // The contents of the .debug_str.dwo section, and whether we
+  // need to free them.
+  const char* str_contents_;
+  bool str_is_new_;
   // Map input string offsets to output string offsets.
   Str_offset_map str_offset_map_;
+  // The hash codes of the input strings, in the same order as
+  // str_offset_map_.
+  std::vector<size_t> str_hashes_;
+  // For an update base, the contributions copied so far.
+  Contribution_map contribution_map_;
 };
 
 // An ELF input file.
@@ -463,9 +581,10 @@ class Dwp_output_file
   record_target_info(const char* name, int machine, int size, bool big_endian,
 		     int osabi, int abiversion);
 
-  // Add a string to the debug strings section.
+  // Add a string to the debug strings section.  HASH_CODE is the
+  // Stringpool hash code for the string.
   section_offset_type
-  add_string(const char* str, size_t len);
+  add_string(const char* str, size_t len, size_t hash_code);
 
   // Add a section to the output file, and return the new section offset.
   section_offset_type
@@ -476,6 +595,10 @@ class Dwp_output_file
   void
   add_cu_set(Unit_set* cu_set);
 
+  // Lookup a DWO ID and return TRUE if we have already seen it.
+  bool
+  lookup_cu(uint64_t dwo_id);
+
   // Lookup a type signature and return TRUE if we have already seen it.
   bool
   lookup_tu(uint64_t type_sig);
@@ -744,6 +867,99 @@ class Unit_reader : public Dwarf_info_reader
   Section_bounds* sections_;
 };
 
+// The list of input files to add to the output file.  We process the
+// input files in batches, so that we do not keep too many files open
+// at once.  The files in a batch are read, and their string tables
+// hashed, in parallel.  Their strings are then added to the output
+// string table in order, which determines the output string offsets,
+// and their .debug_str_offsets.dwo sections are remapped in parallel.
+// Finally the units are added to the output file in order.  Since
+// everything which affects the layout of the output file is done in
+// input order, the output does not depend on the number of threads.
+
+class Dwp_input_list
+{
+ public:
+  Dwp_input_list(Dwp_output_file* output_file, size_t batch_size,
+		 bool verbose)
+    : output_file_(output_file), batch_size_(batch_size), verbose_(verbose),
+      inputs_(), next_(0), batch_begin_(0), batch_end_(0)
+  { gold_assert(batch_size > 0); }
+
+  ~Dwp_input_list();
+
+  // Add an input file.  This takes ownership of DWO_FILE.
+  void
+  add_file(Dwo_file* dwo_file)
+  { this->inputs_.push_back(dwo_file); }
+
+  // Return the number of input files.
+  size_t
+  size() const
+  { return this->inputs_.size(); }
+
+  // Queue the tasks to process the next batch of input files.
+  void
+  queue_next_batch(Workqueue*);
+
+ private:
+  // Run add_strings once a batch has been read.
+  class Add_strings_runner : public Task_function_runner
+  {
+   public:
+    Add_strings_runner(Dwp_input_list* input_list)
+      : input_list_(input_list)
+    { }
+
+    void
+    run(Workqueue* workqueue, const Task*)
+    { this->input_list_->add_strings(workqueue); }
+
+   private:
+    Dwp_input_list* input_list_;
+  };
+
+  // Run add_units once the string offsets of a batch have been
+  // remapped.
+  class Add_units_runner : public Task_function_runner
+  {
+   public:
+    Add_units_runner(Dwp_input_list* input_list)
+      : input_list_(input_list)
+    { }
+
+    void
+    run(Workqueue* workqueue, const Task*)
+    { this->input_list_->add_units(workqueue); }
+
+   private:
+    Dwp_input_list* input_list_;
+  };
+
+  // Add the strings of the current batch to the output file.
+  void
+  add_strings(Workqueue*);
+
+  // Add the units of the current batch to the output file.
+  void
+  add_units(Workqueue*);
+
+  // The output file.
+  Dwp_output_file* output_file_;
+  // The maximum number of files in a batch.
+  size_t batch_size_;
+  // Whether to print the name of each file as we read it.
+  bool verbose_;
+  // The input files.  Entries are set to NULL once a file has been
+  // added to the output file.
+  std::vector<Dwo_file*> inputs_;
+  // The index of the first file of the next batch.
+  size_t next_;
+  // The range of the current batch.
+  size_t batch_begin_;
+  size_t batch_end_;
+};
+
 // Return the name of a DWARF .dwo section.
 
 static const char*
@@ -828,6 +1044,11 @@ Sized_relobj_dwo<size, big_endian>::do_section_contents(
 
 Dwo_file::~Dwo_file()
 {
+  for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
+    if (this->section_data_[i].contents != NULL)
+      delete[] this->section_data_[i].contents;
+  if (this->str_is_new_)
+    delete[] this->str_contents_;
   if (this->obj_ != NULL)
     delete this->obj_;
   if (this->input_file_ != NULL)
@@ -840,7 +1061,7 @@ Dwo_file::~Dwo_file()
 void
 Dwo_file::read_executable(File_list* files)
 {
-  this->obj_ = this->make_object(NULL);
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -880,26 +1101,33 @@ Dwo_file::read_executable(File_list* files)
     }
 }
 
-// Read the input file and send its contents to OUTPUT_FILE.
+// Open the input file.  We open the input files one at a time, in
+// order, before handing them to the tasks that read them.
 
 void
-Dwo_file::read(Dwp_output_file* output_file)
+Dwo_file::open()
 {
-  this->obj_ = this->make_object(output_file);
+  gold_assert(this->input_file_ == NULL);
+  Input_file* input_file = new Input_file(this->name_);
+  this->input_file_ = input_file;
+  Dirsearch dirpath;
+  int index;
+  if (!input_file->open(dirpath, NULL, &index))
+    gold_fatal(_("%s: can't open"), this->name_);
+}
+
+// Read the section table and the contents of the sections that we
+// will copy to the output file.
+
+void
+Dwo_file::read_sections()
+{
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
   this->sect_offsets_.resize(shnum);
 
-  typedef std::vector<unsigned int> Types_list;
-  Types_list debug_types;
-  unsigned int debug_shndx[elfcpp::DW_SECT_MAX + 1];
-  for (unsigned int i = 0; i <= elfcpp::DW_SECT_MAX; i++)
-    debug_shndx[i] = 0;
-  unsigned int debug_str = 0;
-  unsigned int debug_cu_index = 0;
-  unsigned int debug_tu_index = 0;
-
   // Scan the section table and collect debug sections.
   // (Section index 0 is a dummy section; skip it.)
   for (unsigned int i = 1; i < shnum; i++)
@@ -918,48 +1146,110 @@ Dwo_file::read(Dwp_output_file* output_file)
       else
 	continue;
       if (strcmp(suffix, "info.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_INFO] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_INFO] = i;
       else if (strcmp(suffix, "types.dwo") == 0)
-	debug_types.push_back(i);
+	this->debug_types_.push_back(i);
       else if (strcmp(suffix, "abbrev.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_ABBREV] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_ABBREV] = i;
       else if (strcmp(suffix, "line.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_LINE] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_LINE] = i;
       else if (strcmp(suffix, "loc.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_LOC] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_LOC] = i;
       else if (strcmp(suffix, "str.dwo") == 0)
-	debug_str = i;
+	this->debug_str_ = i;
       else if (strcmp(suffix, "str_offsets.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_STR_OFFSETS] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_STR_OFFSETS] = i;
       else if (strcmp(suffix, "macinfo.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_MACINFO] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_MACINFO] = i;
       else if (strcmp(suffix, "macro.dwo") == 0)
-	debug_shndx[elfcpp::DW_SECT_MACRO] = i;
+	this->debug_shndx_[elfcpp::DW_SECT_MACRO] = i;
       else if (strcmp(suffix, "cu_index") == 0)
-	debug_cu_index = i;
+	this->debug_cu_index_ = i;
       else if (strcmp(suffix, "tu_index") == 0)
-	debug_tu_index = i;
+	this->debug_tu_index_ = i;
+    }
+
+  // Read the sections that are copied to the output file as a whole.
+  // The output file takes ownership of the memory, so if the contents
+  // are part of the mapped input file, we duplicate them so that they
+  // will persist after we close the input file.
+  for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
+    {
+      unsigned int shndx = this->debug_shndx_[i];
+      if (shndx == 0)
+	continue;
+      section_size_type len;
+      bool is_new;
+      const unsigned char* contents =
+	  this->section_contents(shndx, &len, &is_new);
+      Section_data* data = &this->section_data_[i];
+      if (is_new)
+	data->contents = const_cast<unsigned char*>(contents);
+      else
+	{
+	  data->contents = new unsigned char[len];
+	  memcpy(data->contents, contents, len);
+	}
+      data->len = len;
     }
 
-  // Merge the input string table into the output string table.
-  this->add_strings(output_file, debug_str);
+  this->hash_strings();
+}
+
+// Record the target info in OUTPUT_FILE, and merge the input string
+// table into the output string table, recording the new offsets.
+
+void
+Dwo_file::add_strings(Dwp_output_file* output_file)
+{
+  output_file->record_target_info(this->name_, this->machine_, this->size_,
+				  this->big_endian_, this->osabi_,
+				  this->abiversion_);
+
+  const char* p = this->str_contents_;
+  size_t count = this->str_hashes_.size();
+  gold_assert(this->str_offset_map_.size() == count + 1);
+  for (size_t i = 0; i < count; ++i)
+    {
+      section_offset_type offset = this->str_offset_map_[i].first;
+      size_t len = this->str_offset_map_[i + 1].first - offset - 1;
+      this->str_offset_map_[i].second =
+	  output_file->add_string(p + offset, len, this->str_hashes_[i]);
+    }
+
+  // We do not need the input strings any more.
+  std::vector<size_t>().swap(this->str_hashes_);
+  if (this->str_is_new_)
+    delete[] this->str_contents_;
+  this->str_contents_ = NULL;
+  this->str_is_new_ = false;
+}
+
+// Add the CU and TU sets and their sections to OUTPUT_FILE.
+
+void
+Dwo_file::add_units(Dwp_output_file* output_file)
+{
+  unsigned int* debug_shndx = this->debug_shndx_;
 
   // If we found any .dwp index sections, read those and add the section
   // sets to the output file.
-  if (debug_cu_index > 0 || debug_tu_index > 0)
+  if (this->debug_cu_index_ > 0 || this->debug_tu_index_ > 0)
     {
-      if (debug_cu_index > 0)
-	this->read_unit_index(debug_cu_index, debug_shndx, output_file, false);
-      if (debug_tu_index > 0)
+      if (this->debug_cu_index_ > 0)
+	this->read_unit_index(this->debug_cu_index_, debug_shndx, output_file,
+			      false);
+      if (this->debug_tu_index_ > 0)
         {
-	  if (debug_types.size() > 1)
+	  if (this->debug_types_.size() > 1)
 	    gold_fatal(_("%s: .dwp file must have no more than one "
 			 ".debug_types.dwo section"), this->name_);
-          if (debug_types.size() == 1)
-            debug_shndx[elfcpp::DW_SECT_TYPES] = debug_types[0];
+          if (this->debug_types_.size() == 1)
+            debug_shndx[elfcpp::DW_SECT_TYPES] = this->debug_types_[0];
           else
             debug_shndx[elfcpp::DW_SECT_TYPES] = 0;
-	  this->read_unit_index(debug_tu_index, debug_shndx, output_file, true);
+	  this->read_unit_index(this->debug_tu_index_, debug_shndx,
+				output_file, true);
 	}
       return;
     }
@@ -969,8 +1259,9 @@ Dwo_file::read(Dwp_output_file* output_file)
     this->add_unit_set(output_file, debug_shndx, false);
 
   debug_shndx[elfcpp::DW_SECT_INFO] = 0;
-  for (Types_list::const_iterator tp = debug_types.begin();
-       tp != debug_types.end();
+  for (std::vector<unsigned int>::const_iterator tp =
+	 this->debug_types_.begin();
+       tp != this->debug_types_.end();
        ++tp)
     {
       debug_shndx[elfcpp::DW_SECT_TYPES] = *tp;
@@ -985,7 +1276,27 @@ Dwo_file::read(Dwp_output_file* output_file)
 bool
 Dwo_file::verify(const File_list& files)
 {
-  this->obj_ = this->make_object(NULL);
+  return this->verify_dwo_list(this->find_cu_index(), files);
+}
+
+// Read the DWO IDs of the CUs in a .dwp file, and add them to DWO_IDS.
+
+void
+Dwo_file::read_dwo_ids(Dwo_id_set* dwo_ids)
+{
+  unsigned int shndx = this->find_cu_index();
+  if (this->obj_->is_big_endian())
+    this->sized_read_dwo_ids<true>(shndx, dwo_ids);
+  else
+    this->sized_read_dwo_ids<false>(shndx, dwo_ids);
+}
+
+// Find the .debug_cu_index section of a .dwp file.
+
+unsigned int
+Dwo_file::find_cu_index()
+{
+  this->obj_ = this->make_object();
 
   unsigned int shnum = this->shnum();
   this->is_compressed_.resize(shnum);
@@ -1017,23 +1328,20 @@ Dwo_file::verify(const File_list& files)
   if (debug_cu_index == 0)
     gold_fatal(_("%s: no .debug_cu_index section found"), this->name_);
 
-  return this->verify_dwo_list(debug_cu_index, files);
+  return debug_cu_index;
 }
 
 // Create a Sized_relobj_dwo of the given size and endianness,
-// and record the target info.
+// and save the target info.
 
 Relobj*
-Dwo_file::make_object(Dwp_output_file* output_file)
+Dwo_file::make_object()
 {
-  // Open the input file.
-  Input_file* input_file = new Input_file(this->name_);
-  this->input_file_ = input_file;
-  Dirsearch dirpath;
-  int index;
-  if (!input_file->open(dirpath, NULL, &index))
-    gold_fatal(_("%s: can't open"), this->name_);
-  
+  // Open the input file, if that has not been done already.
+  if (this->input_file_ == NULL)
+    this->open();
+  Input_file* input_file = this->input_file_;
+
   // Check that it's an ELF file.
   off_t filesize = input_file->file().filesize();
   int hdrsize = elfcpp::Elf_recognizer::max_header_size;
@@ -1045,8 +1353,8 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     gold_fatal(_("%s: not an ELF object file"), this->name_);
   
   // Get the size, endianness, machine, etc. info from the header,
-  // make an appropriately-sized Relobj, and pass the target info
-  // to the output object.
+  // make an appropriately-sized Relobj, and save the target info
+  // for the output object.
   int size;
   bool big_endian;
   std::string error;
@@ -1058,15 +1366,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_32_BIG
-	return this->sized_make_object<32, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<32, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_32_LITTLE
-	return this->sized_make_object<32, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<32, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1075,15 +1381,13 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     {
       if (big_endian)
 #ifdef HAVE_TARGET_64_BIG
-	return this->sized_make_object<64, true>(elf_header, input_file,
-						 output_file);
+	return this->sized_make_object<64, true>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
       else
 #ifdef HAVE_TARGET_64_LITTLE
-	return this->sized_make_object<64, false>(elf_header, input_file,
-						  output_file);
+	return this->sized_make_object<64, false>(elf_header, input_file);
 #else
 	gold_unreachable();
 #endif
@@ -1092,23 +1396,22 @@ Dwo_file::make_object(Dwp_output_file* output_file)
     gold_unreachable();
 }
 
-// Function template to create a Sized_relobj_dwo and record the target info.
+// Function template to create a Sized_relobj_dwo and save the target info.
 // P is a pointer to the ELF header in memory.
 
 template <int size, bool big_endian>
 Relobj*
-Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file,
-			    Dwp_output_file* output_file)
+Dwo_file::sized_make_object(const unsigned char* p, Input_file* input_file)
 {
   elfcpp::Ehdr<size, big_endian> ehdr(p);
   Sized_relobj_dwo<size, big_endian>* obj =
       new Sized_relobj_dwo<size, big_endian>(this->name_, input_file, ehdr);
   obj->setup();
-  if (output_file != NULL)
-    output_file->record_target_info(
-	this->name_, ehdr.get_e_machine(), size, big_endian,
-	ehdr.get_e_ident()[elfcpp::EI_OSABI],
-	ehdr.get_e_ident()[elfcpp::EI_ABIVERSION]);
+  this->machine_ = ehdr.get_e_machine();
+  this->size_ = size;
+  this->big_endian_ = big_endian;
+  this->osabi_ = ehdr.get_e_ident()[elfcpp::EI_OSABI];
+  this->abiversion_ = ehdr.get_e_ident()[elfcpp::EI_ABIVERSION];
   return obj;
 }
 
@@ -1183,12 +1486,18 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 	       this->section_name(shndx).c_str());
 
   // Copy the related sections and track the section offsets and sizes.
+  // When updating an existing .dwp file, we instead copy only the
+  // contributions of the sets that we keep, below, so that the sets
+  // replaced by the new input files do not leave their data behind.
   Section_bounds sections[elfcpp::DW_SECT_MAX + 1];
-  for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
+  if (!this->is_update_base_)
     {
-      if (debug_shndx[i] > 0)
-	sections[i] = this->copy_section(output_file, debug_shndx[i],
-					 static_cast<elfcpp::DW_SECT>(i));
+      for (int i = elfcpp::DW_SECT_ABBREV; i <= elfcpp::DW_SECT_MAX; ++i)
+	{
+	  if (debug_shndx[i] > 0)
+	    sections[i] = this->copy_section(output_file, debug_shndx[i],
+					     static_cast<elfcpp::DW_SECT>(i));
+	}
     }
 
   // Get the contents of the .debug_info.dwo or .debug_types.dwo section.
@@ -1204,7 +1513,21 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
           elfcpp::Swap_unaligned<64, big_endian>::readval(phash);
       unsigned int index =
 	  elfcpp::Swap_unaligned<32, big_endian>::readval(pindex);
-      if (index != 0 && (!is_tu_index || !output_file->lookup_tu(signature)))
+      // A CU from an existing .dwp file being updated is replaced by
+      // a CU with the same DWO ID from the new input files, and is
+      // dropped if the executable no longer refers to it.
+      bool keep;
+      if (index == 0)
+	keep = false;
+      else if (is_tu_index)
+	keep = !output_file->lookup_tu(signature);
+      else if (!this->is_update_base_)
+	keep = true;
+      else
+	keep = (!output_file->lookup_cu(signature)
+		&& (this->keep_dwo_ids_ == NULL
+		    || this->keep_dwo_ids_->count(signature) > 0));
+      if (keep)
 	{
 	  Unit_set* unit_set = new Unit_set();
 	  unit_set->signature = signature;
@@ -1216,16 +1539,23 @@ Dwo_file::sized_read_unit_index(unsigned int shndx,
 
 	  // Adjust the offset of each contribution within the input section
 	  // by the offset of the input section within the output section.
-	  for (unsigned int j = 0; j <= ncols; j++)
+	  for (unsigned int j = 0; j < ncols; j++)
 	    {
 	      unsigned int dw_sect =
-		  elfcpp::Swap_unaligned<64, big_endian>::readval(pch);
+		  elfcpp::Swap_unaligned<32, big_endian>::readval(pch);
 	      unsigned int offset =
-		  elfcpp::Swap_unaligned<64, big_endian>::readval(porow);
+		  elfcpp::Swap_unaligned<32, big_endian>::readval(porow);
 	      unsigned int size =
-		  elfcpp::Swap_unaligned<64, big_endian>::readval(psrow);
-	      unit_set->sections[dw_sect].offset = (sections[dw_sect].offset
-						    + offset);
+		  elfcpp::Swap_unaligned<32, big_endian>::readval(psrow);
+	      if (dw_sect == 0 || dw_sect > elfcpp::DW_SECT_MAX)
+		gold_fatal(_("%s: section %s is corrupt"), this->name_,
+			   this->section_name(shndx).c_str());
+	      if (this->is_update_base_ && dw_sect != info_sect)
+		unit_set->sections[dw_sect].offset =
+		    this->copy_contribution(output_file, dw_sect, offset, size);
+	      else
+		unit_set->sections[dw_sect].offset = (sections[dw_sect].offset
+						      + offset);
 	      unit_set->sections[dw_sect].size = size;
 	      pch += sizeof(uint32_t);
 	      porow += sizeof(uint32_t);
@@ -1360,52 +1690,105 @@ Dwo_file::sized_verify_dwo_list(unsigned int shndx, const File_list& files)
   return nmissing == 0;
 }
 
-// Merge the input string table section into the output file.
+template <bool big_endian>
+void
+Dwo_file::sized_read_dwo_ids(unsigned int shndx, Dwo_id_set* dwo_ids)
+{
+  gold_assert(shndx > 0);
+
+  section_size_type index_len;
+  bool index_is_new;
+  const unsigned char* contents =
+      this->section_contents(shndx, &index_len, &index_is_new);
+
+  unsigned int version =
+      elfcpp::Swap_unaligned<32, big_endian>::readval(contents);
+  if (version != 2)
+    gold_fatal(_("%s: section %s has unsupported version number %d"),
+	       this->name_, this->section_name(shndx).c_str(), version);
+
+  unsigned int nslots =
+      elfcpp::Swap_unaligned<32, big_endian>::readval(contents
+						      + 3 * sizeof(uint32_t));
+
+  const unsigned char* phash = contents + 4 * sizeof(uint32_t);
+  const unsigned char* pindex = phash + nslots * sizeof(uint64_t);
+  const unsigned char* pend = pindex + nslots * sizeof(uint32_t);
+
+  if (pend > contents + index_len)
+    gold_fatal(_("%s: section %s is corrupt"), this->name_,
+	       this->section_name(shndx).c_str());
+
+  for (unsigned int i = 0; i < nslots; ++i)
+    {
+      uint64_t signature =
+	  elfcpp::Swap_unaligned<64, big_endian>::readval(phash);
+      unsigned int index =
+	  elfcpp::Swap_unaligned<32, big_endian>::readval(pindex);
+      if (index != 0)
+	dwo_ids->insert(signature);
+      phash += sizeof(uint64_t);
+      pindex += sizeof(uint32_t);
+    }
+
+  if (index_is_new)
+    delete[] contents;
+}
+
+// Read the input string table section, and compute the hash code of
+// each string, so that merging the strings into the output string
+// table does not need to.  We record the input offsets of the strings
+// in the string offset map, and fill in the output offsets in
+// add_strings.
 
 void
-Dwo_file::add_strings(Dwp_output_file* output_file, unsigned int debug_str)
+Dwo_file::hash_strings()
 {
+  if (this->debug_str_ == 0)
+    {
+      this->str_offset_map_.push_back(std::make_pair(0, 0));
+      return;
+    }
+
   section_size_type len;
   bool is_new;
-  const unsigned char* pdata = this->section_contents(debug_str, &len, &is_new);
+  const unsigned char* pdata = this->section_contents(this->debug_str_,
+						      &len, &is_new);
   const char* p = reinterpret_cast<const char*>(pdata);
   const char* pend = p + len;
+  this->str_contents_ = p;
+  this->str_is_new_ = is_new;
 
   // Check that the last string is null terminated.
-  if (pend[-1] != '\0')
+  if (len > 0 && pend[-1] != '\0')
     gold_fatal(_("%s: last entry in string section '%s' "
 		 "is not null terminated"),
 	       this->name_,
-	       this->section_name(debug_str).c_str());
+	       this->section_name(this->debug_str_).c_str());
 
   // Count the number of strings in the section, and size the map.
   size_t count = 0;
   for (const char* pt = p; pt < pend; pt += strlen(pt) + 1)
     ++count;
   this->str_offset_map_.reserve(count + 1);
+  this->str_hashes_.reserve(count);
 
-  // Add the strings to the output string table, and record the new offsets
-  // in the map.
   section_offset_type i = 0;
-  section_offset_type new_offset;
   while (p < pend)
     {
       size_t len = strlen(p);
-      new_offset = output_file->add_string(p, len);
-      this->str_offset_map_.push_back(std::make_pair(i, new_offset));
+      this->str_offset_map_.push_back(std::make_pair(i, 0));
+      this->str_hashes_.push_back(Stringpool::string_hash(p, len));
       p += len + 1;
       i += len + 1;
     }
-  new_offset = 0;
-  this->str_offset_map_.push_back(std::make_pair(i, new_offset));
-  if (is_new)
-    delete[] pdata;
+  this->str_offset_map_.push_back(std::make_pair(i, 0));
 }
 
 // Copy a section from the input file to the output file.
 // Return the offset and length of this input section's contribution
-// in the output section.  If copying .debug_str_offsets.dwo, remap
-// the string offsets for the output string table.
+// in the output section.  The contents were read by read_sections,
+// and for .debug_str_offsets.dwo, remapped by remap_str_offsets.
 
 Section_bounds
 Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
@@ -1416,73 +1799,96 @@ Dwo_file::copy_section(Dwp_output_file* output_file, unsigned int shndx,
   if (this->sect_offsets_[shndx].size > 0)
     return this->sect_offsets_[shndx];
 
-  // Get the section contents. Upon return, if IS_NEW is true, the memory
-  // has been allocated via new; if false, the memory is part of the mapped
-  // input file, and we will need to duplicate it so that it will persist
-  // after we close the input file.
-  section_size_type len;
-  bool is_new;
-  const unsigned char* contents = this->section_contents(shndx, &len, &is_new);
-
-  if (section_id == elfcpp::DW_SECT_STR_OFFSETS)
-    {
-      const unsigned char* remapped = this->remap_str_offsets(contents, len);
-      if (is_new)
-	delete[] contents;
-      contents = remapped;
-    }
-  else if (!is_new)
-    {
-      unsigned char* copy = new unsigned char[len];
-      memcpy(copy, contents, len);
-      contents = copy;
-    }
+  gold_assert(this->debug_shndx_[section_id] == shndx);
+  Section_data* data = &this->section_data_[section_id];
 
   // Add the contents of the input section to the output section.
   // The output file takes ownership of the memory pointed to by CONTENTS.
-  section_offset_type off = output_file->add_contribution(section_id, contents,
-							  len, 1);
+  section_offset_type off = output_file->add_contribution(section_id,
+							  data->contents,
+							  data->len, 1);
+  data->contents = NULL;
 
   // Store the output section bounds.
-  Section_bounds bounds(off, len);
+  Section_bounds bounds(off, data->len);
   this->sect_offsets_[shndx] = bounds;
 
   return bounds;
 }
 
-// Remap the 
-const unsigned char*
-Dwo_file::remap_str_offsets(const unsigned char* contents,
+// Copy the contribution at OFFSET of length LEN in the section for
+// DW_SECT from a .dwp file being updated to the output file.  Return
+// the offset of the contribution in the output section.  A
+// contribution may be shared by a CU set and TU sets, so we copy each
+// contribution only once.
+
+section_offset_type
+Dwo_file::copy_contribution(Dwp_output_file* output_file,
+			    unsigned int dw_sect,
+			    section_offset_type offset,
 			    section_size_type len)
 {
-  if ((len & 3) != 0)
+  std::pair<Contribution_map::iterator, bool> ins =
+      this->contribution_map_.insert(
+	  std::make_pair(std::make_pair(dw_sect,
+					Contribution_bounds(offset, len)),
+			 0));
+  if (!ins.second)
+    return ins.first->second;
+
+  const Section_data* data = &this->section_data_[dw_sect];
+  if (data->contents == NULL
+      || offset < 0
+      || static_cast<section_size_type>(offset) > data->len
+      || len > data->len - offset)
+    gold_fatal(_("%s: contribution to section %s is out of range"),
+	       this->name_,
+	       get_dwarf_section_name(static_cast<elfcpp::DW_SECT>(dw_sect)));
+
+  // The output file takes ownership of the copy.
+  unsigned char* copy = new unsigned char[len];
+  memcpy(copy, data->contents + offset, len);
+  section_offset_type off =
+      output_file->add_contribution(static_cast<elfcpp::DW_SECT>(dw_sect),
+				    copy, len, 1);
+  ins.first->second = off;
+  return off;
+}
+
+// Remap the string offsets in the .debug_str_offsets.dwo section,
+// in place.
+
+void
+Dwo_file::remap_str_offsets()
+{
+  Section_data* data = &this->section_data_[elfcpp::DW_SECT_STR_OFFSETS];
+  if (data->contents == NULL)
+    return;
+
+  if ((data->len & 3) != 0)
     gold_fatal(_("%s: .debug_str_offsets.dwo section size not a multiple of 4"),
 	       this->name_);
 
   if (this->obj_->is_big_endian())
-    return this->sized_remap_str_offsets<true>(contents, len);
+    this->sized_remap_str_offsets<true>(data->contents, data->len);
   else
-    return this->sized_remap_str_offsets<false>(contents, len);
+    this->sized_remap_str_offsets<false>(data->contents, data->len);
 }
 
 template <bool big_endian>
-const unsigned char*
-Dwo_file::sized_remap_str_offsets(const unsigned char* contents,
+void
+Dwo_file::sized_remap_str_offsets(unsigned char* contents,
 				  section_size_type len)
 {
-  unsigned char* remapped = new unsigned char[len];
-  const unsigned char* p = contents;
-  unsigned char* q = remapped;
+  unsigned char* p = contents;
   while (len > 0)
     {
       unsigned int val = elfcpp::Swap_unaligned<32, big_endian>::readval(p);
       val = this->remap_str_offset(val);
-      elfcpp::Swap_unaligned<32, big_endian>::writeval(q, val);
+      elfcpp::Swap_unaligned<32, big_endian>::writeval(p, val);
       len -= 4;
       p += 4;
-      q += 4;
     }
-  return remapped;
 }
 
 unsigned int
@@ -1582,10 +1988,10 @@ Dwp_output_file::record_target_info(const char*, int machine,
 // Add a string to the debug strings section.
 
 section_offset_type
-Dwp_output_file::add_string(const char* str, size_t len)
+Dwp_output_file::add_string(const char* str, size_t len, size_t hash_code)
 {
   Stringpool::Key key;
-  this->stringpool_.add_with_length(str, len, true, &key);
+  this->stringpool_.add_with_hash(str, len, hash_code, &key);
   this->have_strings_ = true;
   // We aren't supposed to call get_offset() until after
   // calling set_string_offsets(), but the offsets will
@@ -1702,6 +2108,15 @@ Dwp_output_file::add_cu_set(Unit_set* cu_set)
 		 this->name_, (unsigned long long)dwo_id);
 }
 
+// Lookup a DWO ID and return TRUE if we have already seen it.
+
+bool
+Dwp_output_file::lookup_cu(uint64_t dwo_id)
+{
+  unsigned int slot;
+  return this->cu_index_.find_or_add(dwo_id, &slot);
+}
+
 // Lookup a type signature and return TRUE if we have already seen it.
 bool
 Dwp_output_file::lookup_tu(uint64_t type_sig)
@@ -2284,6 +2699,144 @@ Unit_reader::visit_type_unit(off_t, off_t tu_length, off_t,
   this->output_file_->add_tu_set(unit_set);
 }
 
+// A task to read the sections of an input file.
+
+class Dwo_read_task : public Task
+{
+ public:
+  Dwo_read_task(Dwo_file* dwo_file, Task_token* blocker)
+    : dwo_file_(dwo_file), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->dwo_file_->read_sections(); }
+
+  std::string
+  get_name() const
+  { return std::string("Dwo_read_task ") + this->dwo_file_->name(); }
+
+ private:
+  Dwo_file* dwo_file_;
+  Task_token* blocker_;
+};
+
+// A task to remap the string offsets of an input file.
+
+class Dwo_remap_task : public Task
+{
+ public:
+  Dwo_remap_task(Dwo_file* dwo_file, Task_token* blocker)
+    : dwo_file_(dwo_file), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  { this->dwo_file_->remap_str_offsets(); }
+
+  std::string
+  get_name() const
+  { return std::string("Dwo_remap_task ") + this->dwo_file_->name(); }
+
+ private:
+  Dwo_file* dwo_file_;
+  Task_token* blocker_;
+};
+
+// Class Dwp_input_list.
+
+Dwp_input_list::~Dwp_input_list()
+{
+  for (size_t i = 0; i < this->inputs_.size(); ++i)
+    if (this->inputs_[i] != NULL)
+      delete this->inputs_[i];
+}
+
+// Queue the tasks for the next batch of input files.  This is called
+// first from main, and then after each batch has been added to the
+// output file.
+
+void
+Dwp_input_list::queue_next_batch(Workqueue* workqueue)
+{
+  if (this->next_ >= this->inputs_.size())
+    return;
+
+  this->batch_begin_ = this->next_;
+  this->batch_end_ = std::min(this->inputs_.size(),
+			      this->batch_begin_ + this->batch_size_);
+  this->next_ = this->batch_end_;
+
+  Task_token* blocker = new Task_token(true);
+  for (size_t i = this->batch_begin_; i < this->batch_end_; ++i)
+    {
+      if (this->verbose_)
+	fprintf(stderr, "%s\n", this->inputs_[i]->name());
+      this->inputs_[i]->open();
+      blocker->add_blocker();
+    }
+  for (size_t i = this->batch_begin_; i < this->batch_end_; ++i)
+    workqueue->queue(new Dwo_read_task(this->inputs_[i], blocker));
+
+  workqueue->queue(new Task_function(new Add_strings_runner(this), blocker,
+				     "Dwp_input_list add strings"));
+}
+
+// Add the strings of the current batch to the output file, in order,
+// and queue the tasks to remap the string offsets.
+
+void
+Dwp_input_list::add_strings(Workqueue* workqueue)
+{
+  for (size_t i = this->batch_begin_; i < this->batch_end_; ++i)
+    this->inputs_[i]->add_strings(this->output_file_);
+
+  Task_token* blocker = new Task_token(true);
+  for (size_t i = this->batch_begin_; i < this->batch_end_; ++i)
+    blocker->add_blocker();
+  for (size_t i = this->batch_begin_; i < this->batch_end_; ++i)
+    workqueue->queue(new Dwo_remap_task(this->inputs_[i], blocker));
+
+  workqueue->queue(new Task_function(new Add_units_runner(this), blocker,
+				     "Dwp_input_list add units"));
+}
+
+// Add the units of the current batch to the output file, in order,
+// free the input files, and go on to the next batch.
+
+void
+Dwp_input_list::add_units(Workqueue* workqueue)
+{
+  for (size_t i = this->batch_begin_; i < this->batch_end_; ++i)
+    {
+      this->inputs_[i]->add_units(this->output_file_);
+      delete this->inputs_[i];
+      this->inputs_[i] = NULL;
+    }
+
+  this->queue_next_batch(workqueue);
+}
+
 }; // End namespace gold
 
 using namespace gold;
@@ -2292,6 +2845,8 @@ using namespace gold;
 
 enum Dwp_options {
   VERIFY_ONLY = 0x101,
+  THREADS,
+  THREAD_COUNT
 };
 
 struct option dwp_options[] =
@@ -2299,12 +2854,19 @@ struct option dwp_options[] =
     { "exec", required_argument, NULL, 'e' },
     { "help", no_argument, NULL, 'h' },
     { "output", required_argument, NULL, 'o' },
+    { "threads", no_argument, NULL, THREADS },
+    { "thread-count", required_argument, NULL, THREAD_COUNT },
+    { "update", no_argument, NULL, 'u' },
     { "verbose", no_argument, NULL, 'v' },
     { "verify-only", no_argument, NULL, VERIFY_ONLY },
     { "version", no_argument, NULL, 'V' },
     { NULL, 0, NULL, 0 }
   };
 
+// The number of input files that we read at a time.
+
+static const size_t dwp_batch_size = 256;
+
 // Print usage message and exit.
 
 static void
@@ -2315,6 +2877,13 @@ usage(FILE* fd, int exit_status)
   fprintf(fd, _("  -e EXE, --exec EXE       Get list of dwo files from EXE"
 					   " (defaults output to EXE.dwp)\n"));
   fprintf(fd, _("  -o FILE, --output FILE   Set output dwp file name\n"));
+  fprintf(fd, _("  --threads                Read input files in multiple"
+					   " threads\n"));
+  fprintf(fd, _("  --thread-count COUNT     Number of threads to use with"
+					   " --threads\n"));
+  fprintf(fd, _("  -u, --update             Update an existing output file,"
+					   " replacing the\n"
+		"                           units found in the input files\n"));
   fprintf(fd, _("  -v, --verbose            Verbose output\n"));
   fprintf(fd, _("  --verify-only            Verify output file against"
 					   " exec file\n"));
@@ -2378,8 +2947,11 @@ main(int argc, char** argv)
   const char* exe_filename = NULL;
   bool verbose = false;
   bool verify_only = false;
+  bool update = false;
+  bool threads = false;
+  unsigned int thread_count = 0;
   int c;
-  while ((c = getopt_long(argc, argv, "e:ho:vV", dwp_options, NULL)) != -1)
+  while ((c = getopt_long(argc, argv, "e:ho:uvV", dwp_options, NULL)) != -1)
     {
       switch (c)
         {
@@ -2391,6 +2963,20 @@ main(int argc, char** argv)
 	  case 'o':
 	    output_filename.assign(optarg);
 	    break;
+	  case 'u':
+	    update = true;
+	    break;
+	  case THREADS:
+	    threads = true;
+	    break;
+	  case THREAD_COUNT:
+	    {
+	      char* endptr;
+	      thread_count = strtoul(optarg, &endptr, 0);
+	      if (*endptr != '\0' || thread_count == 0)
+		gold_fatal(_("invalid thread count: %s"), optarg);
+	    }
+	    break;
 	  case 'v':
 	    verbose = true;
 	    break;
@@ -2405,6 +2991,8 @@ main(int argc, char** argv)
 	}
     }
 
+  options.set_thread_options(threads, thread_count);
+
   if (output_filename.empty())
     {
       if (exe_filename == NULL)
@@ -2419,6 +3007,7 @@ main(int argc, char** argv)
       Dwo_file exe_file(exe_filename);
       exe_file.read_executable(&files);
     }
+  size_t exe_file_count = files.size();
 
   // Add any additional files listed on command line.
   for (int i = optind; i < argc; ++i)
@@ -2436,16 +3025,74 @@ main(int argc, char** argv)
       return ok ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
+  // When updating an existing output file, we read it after the new
+  // input files, so that their units take precedence.  We write the
+  // new output file under a temporary name while we read the old one,
+  // and rename it when we are done.
+  std::string dwp_filename(output_filename);
+  bool update_existing = false;
+  if (update)
+    {
+      struct stat st;
+      if (::stat(output_filename.c_str(), &st) == 0)
+	{
+	  update_existing = true;
+	  dwp_filename.append(".tmp");
+	}
+    }
+
+  // When updating an existing output file for an executable, we only
+  // need to read the .dwo files which are not already in the output
+  // file, and we drop the CUs which the executable no longer refers to.
+  Dwo_id_set exe_dwo_ids;
+  if (update_existing && exe_filename != NULL)
+    {
+      Dwo_id_set dwp_dwo_ids;
+      {
+	Dwo_file dwp_file(output_filename.c_str());
+	dwp_file.read_dwo_ids(&dwp_dwo_ids);
+      }
+      File_list changed_files;
+      for (size_t i = 0; i < files.size(); ++i)
+	{
+	  if (i < exe_file_count)
+	    {
+	      exe_dwo_ids.insert(files[i].dwo_id);
+	      if (dwp_dwo_ids.count(files[i].dwo_id) > 0)
+		continue;
+	    }
+	  changed_files.push_back(files[i]);
+	}
+      files.swap(changed_files);
+    }
+
   // Process each file, adding its contents to the output file.
-  Dwp_output_file output_file(output_filename.c_str());
+  Dwp_output_file output_file(dwp_filename.c_str());
+  Dwp_input_list input_list(&output_file, dwp_batch_size, verbose);
   for (File_list::const_iterator f = files.begin(); f != files.end(); ++f)
+    input_list.add_file(new Dwo_file(f->dwo_name.c_str()));
+  if (update_existing)
     {
-      if (verbose)
-	fprintf(stderr, "%s\n", f->dwo_name.c_str());
-      Dwo_file dwo_file(f->dwo_name.c_str());
-      dwo_file.read(&output_file);
+      Dwo_file* dwp_file = new Dwo_file(output_filename.c_str(), true);
+      if (exe_filename != NULL)
+	dwp_file->set_keep_dwo_ids(&exe_dwo_ids);
+      input_list.add_file(dwp_file);
     }
+
+  Workqueue workqueue(options);
+  int nthreads = options.thread_count_initial();
+  if (nthreads == 0)
+    nthreads = std::max<size_t>(1, std::min(input_list.size(),
+					    dwp_batch_size));
+  workqueue.set_thread_count(nthreads);
+  input_list.queue_next_batch(&workqueue);
+  workqueue.process(0);
   output_file.finalize();
 
+  if (update_existing
+      && ::rename(dwp_filename.c_str(), output_filename.c_str()) < 0)
+    gold_fatal(_("cannot rename %s to %s: %s"), dwp_filename.c_str(),
+	       output_filename.c_str(), strerror(errno));
+
   return EXIT_SUCCESS;
 }
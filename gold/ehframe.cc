@@ -583,8 +583,24 @@ Eh_frame::add_ehframe_input_section(
   const unsigned char* pcontents = object->section_contents(shndx,
 							    &contents_len,
 							    false);
+
+  // Normally the section was parsed when the object's symbols were
+  // read.  Otherwise parse it now.
+  Eh_frame_input_section* input_section =
+    object->release_eh_frame_input_section(shndx);
+  if (input_section != NULL
+      && (input_section->reloc_shndx != reloc_shndx
+	  || input_section->reloc_type != reloc_type))
+    {
+      delete input_section;
+      input_section = NULL;
+    }
+
   if (contents_len == 0)
-    return EH_EMPTY_SECTION;
+    {
+      delete input_section;
+      return EH_EMPTY_SECTION;
+    }
 
   // If this is the marker section for the end of the data, then
   // return false to force it to be handled as an ordinary input
@@ -592,26 +608,39 @@ Eh_frame::add_ehframe_input_section(
   // of unrecognized .eh_frame sections.
   if (contents_len == 4
       && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0)
-    return EH_END_MARKER_SECTION;
+    {
+      delete input_section;
+      return EH_END_MARKER_SECTION;
+    }
 
-  New_cies new_cies;
-  if (!this->do_add_ehframe_input_section(object, symbols, symbols_size,
-					  symbol_names, symbol_names_size,
-					  shndx, reloc_shndx,
-					  reloc_type, pcontents,
-					  contents_len, &new_cies))
+  if (input_section == NULL)
+    {
+      input_section = new Eh_frame_input_section();
+      input_section->shndx = shndx;
+      input_section->reloc_shndx = reloc_shndx;
+      input_section->reloc_type = reloc_type;
+      input_section->is_recognized =
+	Eh_frame::do_read_input_section(object, symbols, symbols_size,
+					symbol_names_size, reloc_shndx,
+					reloc_type, pcontents, contents_len,
+					&input_section->entries);
+    }
+
+  if (!input_section->is_recognized)
     {
+      delete input_section;
+
       if (this->eh_frame_hdr_ != NULL)
 	this->eh_frame_hdr_->found_unrecognized_eh_frame_section();
 
-      for (New_cies::iterator p = new_cies.begin();
-	   p != new_cies.end();
-	   ++p)
-	delete p->first;
-
       return EH_UNRECOGNIZED_SECTION;
     }
 
+  New_cies new_cies;
+  this->add_input_entries(object, symbols, symbols_size, symbol_names, shndx,
+			  pcontents, input_section->entries, &new_cies);
+  delete input_section;
+
   // Now that we know we are using this section, record any new CIEs
   // that we found.
   for (New_cies::const_iterator p = new_cies.begin();
@@ -627,22 +656,53 @@ Eh_frame::add_ehframe_input_section(
   return EH_OPTIMIZABLE_SECTION;
 }
 
-// The bulk of the implementation of add_ehframe_input_section.
+// Parse input section SHNDX in OBJECT into ENTRIES.  This does not
+// look at any state of the Eh_frame, or at which sections of OBJECT
+// are included in the link, so that it can be done while reading
+// symbols.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::do_add_ehframe_input_section(
+Eh_frame::read_input_section(Sized_relobj_file<size, big_endian>* object,
+			     const unsigned char* symbols,
+			     section_size_type symbols_size,
+			     section_size_type symbol_names_size,
+			     unsigned int shndx,
+			     unsigned int reloc_shndx,
+			     unsigned int reloc_type,
+			     Eh_frame_input_entries* entries)
+{
+  section_size_type contents_len;
+  const unsigned char* pcontents = object->section_contents(shndx,
+							    &contents_len,
+							    false);
+  // The empty section and the end marker section are handled by
+  // add_ehframe_input_section.
+  if (contents_len == 0
+      || (contents_len == 4
+	  && elfcpp::Swap<32, big_endian>::readval(pcontents) == 0))
+    return true;
+
+  return Eh_frame::do_read_input_section(object, symbols, symbols_size,
+					 symbol_names_size, reloc_shndx,
+					 reloc_type, pcontents, contents_len,
+					 entries);
+}
+
+// The bulk of the implementation of read_input_section.
+
+template<int size, bool big_endian>
+bool
+Eh_frame::do_read_input_section(
     Sized_relobj_file<size, big_endian>* object,
     const unsigned char* symbols,
     section_size_type symbols_size,
-    const unsigned char* symbol_names,
     section_size_type symbol_names_size,
-    unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type,
     const unsigned char* pcontents,
     section_size_type contents_len,
-    New_cies* new_cies)
+    Eh_frame_input_entries* entries)
 {
   Track_relocs<size, big_endian> relocs;
 
@@ -654,7 +714,7 @@ Eh_frame::do_add_ehframe_input_section(
     return false;
 
   // Keep track of which CIEs are at which offsets.
-  Offsets_to_cie cies;
+  Offsets_to_cie_index cies;
 
   while (p < pend)
     {
@@ -694,17 +754,16 @@ Eh_frame::do_add_ehframe_input_section(
       if (id == 0)
 	{
 	  // CIE.
-	  if (!this->read_cie(object, shndx, symbols, symbols_size,
-			      symbol_names, symbol_names_size,
-			      pcontents, p, pentend, &relocs, &cies,
-			      new_cies))
+	  if (!Eh_frame::read_cie(object, symbols, symbols_size,
+				  symbol_names_size, pcontents, p, pentend,
+				  &relocs, &cies, entries))
 	    return false;
 	}
       else
 	{
 	  // FDE.
-	  if (!this->read_fde(object, shndx, symbols, symbols_size,
-			      pcontents, id, p, pentend, &relocs, &cies))
+	  if (!Eh_frame::read_fde(symbols_size, pcontents, id, p, pentend,
+				  &relocs, &cies, entries))
 	    return false;
 	}
 
@@ -714,22 +773,21 @@ Eh_frame::do_add_ehframe_input_section(
   return true;
 }
 
-// Read a CIE.  Return false if we can't parse the information.
+// Read a CIE, and add it to ENTRIES.  Return false if we can't parse
+// the information.
 
 template<int size, bool big_endian>
 bool
 Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
 		   const unsigned char* symbols,
 		   section_size_type symbols_size,
-		   const unsigned char* symbol_names,
 		   section_size_type symbol_names_size,
 		   const unsigned char* pcontents,
 		   const unsigned char* pcie,
 		   const unsigned char* pcieend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies,
-		   New_cies* new_cies)
+		   Offsets_to_cie_index* cies,
+		   Eh_frame_input_entries* entries)
 {
   bool mergeable = true;
 
@@ -883,7 +941,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
       ++paug;
     }
 
-  const char* personality_name = "";
+  unsigned int personality_name_offset = -1U;
   if (per_offset != -1)
     {
       if (relocs->advance(per_offset) > 0)
@@ -911,8 +969,7 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
 	  unsigned int name_offset = sym.get_st_name();
 	  if (name_offset >= symbol_names_size)
 	    return false;
-	  personality_name = (reinterpret_cast<const char*>(symbol_names)
-			      + name_offset);
+	  personality_name_offset = name_offset;
 	}
 
       int r = relocs->advance(per_offset + 1);
@@ -922,78 +979,55 @@ Eh_frame::read_cie(Sized_relobj_file<size, big_endian>* object,
   if (relocs->advance(pcieend - pcontents) > 0)
     return false;
 
-  Cie cie(object, shndx, (pcie - 8) - pcontents, fde_encoding, 
-	  personality_name, pcie, pcieend - pcie);
-  Cie* cie_pointer = NULL;
-  if (mergeable)
-    {
-      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
-      if (find_cie != this->cie_offsets_.end())
-	cie_pointer = *find_cie;
-      else
-	{
-	  // See if we already saw this CIE in this object file.
-	  for (New_cies::const_iterator pc = new_cies->begin();
-	       pc != new_cies->end();
-	       ++pc)
-	    {
-	      if (*(pc->first) == cie)
-		{
-		  cie_pointer = pc->first;
-		  break;
-		}
-	    }
-	}
-    }
-
-  if (cie_pointer == NULL)
-    {
-      cie_pointer = new Cie(cie);
-      new_cies->push_back(std::make_pair(cie_pointer, mergeable));
-    }
-  else
-    {
-      // We are deleting this CIE.  Record that in our mapping from
-      // input sections to the output section.  At this point we don't
-      // know for sure that we are doing a special mapping for this
-      // input section, but that's OK--if we don't do a special
-      // mapping, nobody will ever ask for the mapping we add here.
-      object->add_merge_mapping(this, shndx, (pcie - 8) - pcontents,
-                                pcieend - (pcie - 8), -1);
-    }
-
   // Record this CIE plus the offset in the input section.
-  cies->insert(std::make_pair(pcie - pcontents, cie_pointer));
+  cies->insert(std::make_pair(pcie - pcontents, entries->size()));
+
+  Eh_frame_input_entry entry;
+  entry.offset = (pcie - 8) - pcontents;
+  entry.length = pcieend - (pcie - 8);
+  entry.cie_index = -1U;
+  entry.symbol = personality_name_offset;
+  entry.fde_encoding = fde_encoding;
+  entry.is_mergeable = mergeable;
+  entry.is_empty_range = false;
+  entries->push_back(entry);
 
   return true;
 }
 
-// Read an FDE.  Return false if we can't parse the information.
+// Read an FDE, and add it to ENTRIES.  Return false if we can't parse
+// the information.
 
 template<int size, bool big_endian>
 bool
-Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
-		   unsigned int shndx,
-		   const unsigned char* symbols,
-		   section_size_type symbols_size,
+Eh_frame::read_fde(section_size_type symbols_size,
 		   const unsigned char* pcontents,
 		   unsigned int offset,
 		   const unsigned char* pfde,
 		   const unsigned char* pfdeend,
 		   Track_relocs<size, big_endian>* relocs,
-		   Offsets_to_cie* cies)
+		   Offsets_to_cie_index* cies,
+		   Eh_frame_input_entries* entries)
 {
   // OFFSET is the distance between the 4 bytes before PFDE to the
   // start of the CIE.  The offset we recorded for the CIE is 8 bytes
   // after the start of the CIE--after the length and the zero tag.
   unsigned int cie_offset = (pfde - 4 - pcontents) - offset + 8;
-  Offsets_to_cie::const_iterator pcie = cies->find(cie_offset);
+  Offsets_to_cie_index::const_iterator pcie = cies->find(cie_offset);
   if (pcie == cies->end())
     return false;
-  Cie* cie = pcie->second;
+  unsigned int cie_index = pcie->second;
+  unsigned char fde_encoding = (*entries)[cie_index].fde_encoding;
+
+  Eh_frame_input_entry entry;
+  entry.offset = (pfde - 8) - pcontents;
+  entry.length = pfdeend - (pfde - 8);
+  entry.cie_index = cie_index;
+  entry.fde_encoding = fde_encoding;
+  entry.is_mergeable = false;
 
   int pc_size = 0;
-  switch (cie->fde_encoding() & 7)
+  switch (fde_encoding & 7)
     {
     case elfcpp::DW_EH_PE_udata2:
       pc_size = 2;
@@ -1046,8 +1080,9 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
 	{
 	  // This FDE applies to a discarded function.  We
 	  // can discard this FDE.
-	  object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-				    pfdeend - (pfde - 8), -1);
+	  entry.symbol = -1U;
+	  entry.is_empty_range = false;
+	  entries->push_back(entry);
 	  return true;
 	}
 
@@ -1065,20 +1100,9 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
   // pointer to a PC relative offset when generating a shared library.
   relocs->advance(pfdeend - pcontents);
 
-  // Find the section index for code that this FDE describes.
-  // If we have discarded the section, we can also discard the FDE.
-  unsigned int fde_shndx;
   const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
   if (symndx >= symbols_size / sym_size)
     return false;
-  elfcpp::Sym<size, big_endian> sym(symbols + symndx * sym_size);
-  bool is_ordinary;
-  fde_shndx = object->adjust_sym_shndx(symndx, sym.get_st_shndx(),
-				       &is_ordinary);
-  bool is_discarded = (is_ordinary
-		       && fde_shndx != elfcpp::SHN_UNDEF
-		       && fde_shndx < object->shnum()
-		       && !object->is_section_included(fde_shndx));
 
   // Fetch the address range field from the FDE. The offset and size
   // of the field depends on the PC encoding given in the CIE, but
@@ -1101,19 +1125,124 @@ Eh_frame::read_fde(Sized_relobj_file<size, big_endian>* object,
       gold_unreachable();
     }
 
-  if (is_discarded || address_range == 0)
+  entry.symbol = symndx;
+  entry.is_empty_range = address_range == 0;
+  entries->push_back(entry);
+
+  return true;
+}
+
+// Add the CIEs and FDEs in ENTRIES, which were read from input
+// section SHNDX in OBJECT, to the .eh_frame data.  Merge the CIEs,
+// and discard the FDEs for code which is not included in the link.
+// PCONTENTS is the contents of the input section.  Any CIEs which we
+// have not seen before are added to NEW_CIES.
+
+template<int size, bool big_endian>
+void
+Eh_frame::add_input_entries(Sized_relobj_file<size, big_endian>* object,
+			    const unsigned char* symbols,
+			    section_size_type symbols_size,
+			    const unsigned char* symbol_names,
+			    unsigned int shndx,
+			    const unsigned char* pcontents,
+			    const Eh_frame_input_entries& entries,
+			    New_cies* new_cies)
+{
+  const int sym_size = elfcpp::Elf_sizes<size>::sym_size;
+
+  // The CIE for each CIE entry.
+  std::vector<Cie*> entry_cies(entries.size());
+
+  for (size_t i = 0; i < entries.size(); ++i)
     {
-      // This FDE applies to a discarded function.  We
-      // can discard this FDE.
-      object->add_merge_mapping(this, shndx, (pfde - 8) - pcontents,
-                                pfdeend - (pfde - 8), -1);
-      return true;
-    }
+      const Eh_frame_input_entry& entry(entries[i]);
+      const unsigned char* pentry = pcontents + entry.offset + 8;
+      section_size_type entry_len = entry.length - 8;
+
+      if (entry.cie_index == -1U)
+	{
+	  const char* personality_name = "";
+	  if (entry.symbol != -1U)
+	    personality_name = (reinterpret_cast<const char*>(symbol_names)
+				+ entry.symbol);
+
+	  Cie cie(object, shndx, entry.offset, entry.fde_encoding,
+		  personality_name, pentry, entry_len);
+	  Cie* cie_pointer = NULL;
+	  if (entry.is_mergeable)
+	    {
+	      Cie_offsets::iterator find_cie = this->cie_offsets_.find(&cie);
+	      if (find_cie != this->cie_offsets_.end())
+		cie_pointer = *find_cie;
+	      else
+		{
+		  // See if we already saw this CIE in this object file.
+		  for (New_cies::const_iterator pc = new_cies->begin();
+		       pc != new_cies->end();
+		       ++pc)
+		    {
+		      if (*(pc->first) == cie)
+			{
+			  cie_pointer = pc->first;
+			  break;
+			}
+		    }
+		}
+	    }
+
+	  if (cie_pointer == NULL)
+	    {
+	      cie_pointer = new Cie(cie);
+	      new_cies->push_back(std::make_pair(cie_pointer,
+						 entry.is_mergeable));
+	    }
+	  else
+	    {
+	      // We are deleting this CIE.  Record that in our mapping
+	      // from input sections to the output section.  At this
+	      // point we don't know for sure that we are doing a
+	      // special mapping for this input section, but that's
+	      // OK--if we don't do a special mapping, nobody will ever
+	      // ask for the mapping we add here.
+	      object->add_merge_mapping(this, shndx, entry.offset,
+					entry.length, -1);
+	    }
 
-  cie->add_fde(new Fde(object, shndx, (pfde - 8) - pcontents,
-		       pfde, pfdeend - pfde));
+	  entry_cies[i] = cie_pointer;
+	  continue;
+	}
 
-  return true;
+      // Find the section index for code that this FDE describes.
+      // If we have discarded the section, we can also discard the FDE.
+      bool is_discarded = entry.symbol == -1U || entry.is_empty_range;
+      if (!is_discarded)
+	{
+	  gold_assert(entry.symbol < symbols_size / sym_size);
+	  elfcpp::Sym<size, big_endian> sym(symbols + entry.symbol * sym_size);
+	  bool is_ordinary;
+	  unsigned int fde_shndx = object->adjust_sym_shndx(entry.symbol,
+							    sym.get_st_shndx(),
+							    &is_ordinary);
+	  is_discarded = (is_ordinary
+			  && fde_shndx != elfcpp::SHN_UNDEF
+			  && fde_shndx < object->shnum()
+			  && !object->is_section_included(fde_shndx));
+	}
+
+      if (is_discarded)
+	{
+	  // This FDE applies to a discarded function.  We
+	  // can discard this FDE.
+	  object->add_merge_mapping(this, shndx, entry.offset, entry.length,
+				    -1);
+	  continue;
+	}
+
+      Cie* cie = entry_cies[entry.cie_index];
+      gold_assert(cie != NULL);
+      cie->add_fde(new Fde(object, shndx, entry.offset, pentry, entry_len));
+    }
 }
 
 // Add unwind information for a PLT.
@@ -1322,6 +1451,18 @@ Eh_frame::add_ehframe_input_section<32, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+bool
+Eh_frame::read_input_section<32, false>(
+    Sized_relobj_file<32, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Eh_frame_input_entries* entries);
 #endif
 
 #ifdef HAVE_TARGET_32_BIG
@@ -1336,6 +1477,18 @@ Eh_frame::add_ehframe_input_section<32, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+bool
+Eh_frame::read_input_section<32, true>(
+    Sized_relobj_file<32, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Eh_frame_input_entries* entries);
 #endif
 
 #ifdef HAVE_TARGET_64_LITTLE
@@ -1350,6 +1503,18 @@ Eh_frame::add_ehframe_input_section<64, false>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+bool
+Eh_frame::read_input_section<64, false>(
+    Sized_relobj_file<64, false>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Eh_frame_input_entries* entries);
 #endif
 
 #ifdef HAVE_TARGET_64_BIG
@@ -1364,6 +1529,18 @@ Eh_frame::add_ehframe_input_section<64, true>(
     unsigned int shndx,
     unsigned int reloc_shndx,
     unsigned int reloc_type);
+
+template
+bool
+Eh_frame::read_input_section<64, true>(
+    Sized_relobj_file<64, true>* object,
+    const unsigned char* symbols,
+    section_size_type symbols_size,
+    section_size_type symbol_names_size,
+    unsigned int shndx,
+    unsigned int reloc_shndx,
+    unsigned int reloc_type,
+    Eh_frame_input_entries* entries);
 #endif
 
 } // End namespace gold.
@@ -373,6 +373,50 @@ class Cie
 extern bool operator<(const Cie&, const Cie&);
 extern bool operator==(const Cie&, const Cie&);
 
+// A CIE or FDE found in an input .eh_frame section by
+// Eh_frame::read_input_section.
+
+struct Eh_frame_input_entry
+{
+  // The offset of the entry in the input section, starting at its
+  // length word.
+  section_offset_type offset;
+  // The length of the entry, including the length word.
+  section_size_type length;
+  // For an FDE, the index in the list of entries of its CIE.  For a
+  // CIE, -1U.
+  unsigned int cie_index;
+  // For a CIE, the offset in the symbol names section of the name of
+  // the personality routine, or -1U if there is none.  For an FDE,
+  // the index of the symbol for the code which it describes, or -1U
+  // if the FDE has no relocation for its PC because the code was
+  // discarded by an earlier relocatable link.
+  unsigned int symbol;
+  // For a CIE, the FDE encoding.
+  unsigned char fde_encoding;
+  // For a CIE, whether it may be merged with identical CIEs.
+  bool is_mergeable;
+  // For an FDE, whether its address range is zero.
+  bool is_empty_range;
+};
+
+typedef std::vector<Eh_frame_input_entry> Eh_frame_input_entries;
+
+// The entries of an input .eh_frame section, read before layout.
+
+struct Eh_frame_input_section
+{
+  // The section index.
+  unsigned int shndx;
+  // The reloc section and its type, as for add_ehframe_input_section.
+  unsigned int reloc_shndx;
+  unsigned int reloc_type;
+  // Whether we were able to parse the section.
+  bool is_recognized;
+  // The CIEs and FDEs, in the order in which they appear.
+  Eh_frame_input_entries entries;
+};
+
 // This class manages .eh_frame sections.  It discards duplicate
 // exception information.
 
@@ -411,6 +455,22 @@ class Eh_frame : public Output_section_data
 			    unsigned int shndx, unsigned int reloc_shndx,
 			    unsigned int reloc_type);
 
+  // Parse the input section SHNDX in OBJECT into the CIEs and FDEs
+  // which it contains, without adding them to the .eh_frame data.
+  // The arguments are as for add_ehframe_input_section.  This depends
+  // only on OBJECT, so it may be called for several objects in
+  // parallel, while reading symbols.  Returns false if the section
+  // can not be parsed.
+  template<int size, bool big_endian>
+  static bool
+  read_input_section(Sized_relobj_file<size, big_endian>* object,
+		     const unsigned char* symbols,
+		     section_size_type symbols_size,
+		     section_size_type symbol_names_size,
+		     unsigned int shndx, unsigned int reloc_shndx,
+		     unsigned int reloc_type,
+		     Eh_frame_input_entries* entries);
+
   // Add a CIE and an FDE for a PLT section, to permit unwinding
   // through a PLT.  The FDE data should start with 8 bytes of zero,
   // which will be replaced by a 4 byte PC relative reference to the
@@ -464,10 +524,6 @@ class Eh_frame : public Output_section_data
   // A list of unmergeable CIEs.
   typedef std::vector<Cie*> Unmergeable_cie_offsets;
 
-  // A mapping from offsets to CIEs.  This is used while reading an
-  // input section.
-  typedef std::map<uint64_t, Cie*> Offsets_to_cie;
-
   // A list of CIEs, and a bool indicating whether the CIE is
   // mergeable.
   typedef std::vector<std::pair<Cie*, bool> > New_cies;
@@ -476,50 +532,61 @@ class Eh_frame : public Output_section_data
   static bool
   skip_leb128(const unsigned char**, const unsigned char*);
 
-  // The implementation of add_ehframe_input_section.
+  // A mapping from offsets to the index of a CIE in a list of
+  // entries.  This is used while reading an input section.
+  typedef std::map<uint64_t, unsigned int> Offsets_to_cie_index;
+
+  // The implementation of read_input_section.
   template<int size, bool big_endian>
-  bool
-  do_add_ehframe_input_section(Sized_relobj_file<size, big_endian>* object,
-			       const unsigned char* symbols,
-			       section_size_type symbols_size,
-			       const unsigned char* symbol_names,
-			       section_size_type symbol_names_size,
-			       unsigned int shndx,
-			       unsigned int reloc_shndx,
-			       unsigned int reloc_type,
-			       const unsigned char* pcontents,
-			       section_size_type contents_len,
-			       New_cies*);
+  static bool
+  do_read_input_section(Sized_relobj_file<size, big_endian>* object,
+			const unsigned char* symbols,
+			section_size_type symbols_size,
+			section_size_type symbol_names_size,
+			unsigned int reloc_shndx,
+			unsigned int reloc_type,
+			const unsigned char* pcontents,
+			section_size_type contents_len,
+			Eh_frame_input_entries* entries);
 
   // Read a CIE.
   template<int size, bool big_endian>
-  bool
+  static bool
   read_cie(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
 	   const unsigned char* symbols,
 	   section_size_type symbols_size,
-	   const unsigned char* symbol_names,
 	   section_size_type symbol_names_size,
 	   const unsigned char* pcontents,
 	   const unsigned char* pcie,
 	   const unsigned char* pcieend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies,
-	   New_cies* new_cies);
+	   Offsets_to_cie_index* cies,
+	   Eh_frame_input_entries* entries);
 
   // Read an FDE.
   template<int size, bool big_endian>
-  bool
-  read_fde(Sized_relobj_file<size, big_endian>* object,
-	   unsigned int shndx,
-	   const unsigned char* symbols,
-	   section_size_type symbols_size,
+  static bool
+  read_fde(section_size_type symbols_size,
 	   const unsigned char* pcontents,
 	   unsigned int offset,
 	   const unsigned char* pfde,
 	   const unsigned char* pfdeend,
 	   Track_relocs<size, big_endian>* relocs,
-	   Offsets_to_cie* cies);
+	   Offsets_to_cie_index* cies,
+	   Eh_frame_input_entries* entries);
+
+  // Add the CIEs and FDEs in ENTRIES, read from input section SHNDX
+  // in OBJECT, to the .eh_frame data.
+  template<int size, bool big_endian>
+  void
+  add_input_entries(Sized_relobj_file<size, big_endian>* object,
+		    const unsigned char* symbols,
+		    section_size_type symbols_size,
+		    const unsigned char* symbol_names,
+		    unsigned int shndx,
+		    const unsigned char* pcontents,
+		    const Eh_frame_input_entries& entries,
+		    New_cies* new_cies);
 
   // Template version of write function.
   template<int size, bool big_endian>
@@ -22,46 +22,230 @@
 
 
 #include "gold.h"
+
+#include <algorithm>
+
 #include "object.h"
 #include "gc.h"
 #include "symtab.h"
+#include "workqueue.h"
 
 namespace gold
 {
 
-// Garbage collection uses a worklist style algorithm to determine the 
-// transitive closure of all referenced sections.
-void 
-Garbage_collection::do_transitive_closure()
+// Turn the references of OBJECT into a compressed sparse row table:
+// sort the targets by source section, drop duplicates, and record
+// where the targets of each section start.  Also size the mark bits.
+
+void
+Garbage_collection::build_reference_table(Object_references* refs,
+					  const Relobj* object)
+{
+  if (refs->is_table)
+    return;
+
+  unsigned int shnum = object->shnum();
+  const std::vector<unsigned int>& sources = refs->sources;
+  for (size_t i = 0; i < sources.size(); ++i)
+    if (sources[i] >= shnum)
+      shnum = sources[i] + 1;
+
+  std::vector<unsigned int>& offsets = refs->offsets;
+  offsets.assign(shnum + 1, 0);
+  for (size_t i = 0; i < sources.size(); ++i)
+    ++offsets[sources[i] + 1];
+  for (unsigned int shndx = 0; shndx < shnum; ++shndx)
+    offsets[shndx + 1] += offsets[shndx];
+
+  std::vector<Section_id> targets(refs->targets.size());
+  std::vector<unsigned int> next(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < sources.size(); ++i)
+    targets[next[sources[i]]++] = refs->targets[i];
+
+  unsigned int count = 0;
+  for (unsigned int shndx = 0; shndx < shnum; ++shndx)
+    {
+      std::vector<Section_id>::iterator begin =
+	targets.begin() + offsets[shndx];
+      std::vector<Section_id>::iterator end =
+	targets.begin() + offsets[shndx + 1];
+      std::sort(begin, end);
+      end = std::unique(begin, end);
+      offsets[shndx] = count;
+      std::copy(begin, end, targets.begin() + count);
+      count += end - begin;
+    }
+  offsets[shnum] = count;
+  targets.resize(count);
+
+  refs->targets.swap(targets);
+  std::vector<unsigned int>().swap(refs->sources);
+  refs->marks.assign((shnum + mark_word_bits - 1) / mark_word_bits, 0);
+  refs->is_table = true;
+}
+
+// Set the mark bit of section SHNDX in REFS, and return whether it
+// was clear.  Sections past the end of the object are never marked.
+// Several marking tasks may set bits in the same word at once.
+
+bool
+Garbage_collection::set_mark(Object_references* refs, unsigned int shndx)
+{
+  size_t word = shndx / mark_word_bits;
+  if (word >= refs->marks.size())
+    return false;
+  Mark_word bit = Mark_word(1) << (shndx % mark_word_bits);
+  Mark_word* pword = &refs->marks[word];
+#ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
+  return (__sync_fetch_and_or(pword, bit) & bit) == 0;
+#else
+  // Without atomic operations queue_transitive_closure uses a single
+  // marking task.
+  if ((*pword & bit) != 0)
+    return false;
+  *pword |= bit;
+  return true;
+#endif
+}
+
+// Mark the sections reachable from the work list entries FIRST up to
+// LAST, with a depth first walk.  Whichever task sets the mark bit of
+// a section walks its references, so each section is walked once no
+// matter how many tasks reach it.
+
+void
+Garbage_collection::mark_reachable(const Section_id* first,
+				   const Section_id* last)
 {
-  while (!this->worklist().empty())
+  Worklist_type stack;
+  for (const Section_id* p = first; p != last; ++p)
+    if (set_mark(this->references(p->first), p->second))
+      stack.push_back(*p);
+
+  while (!stack.empty())
     {
-      // Add elements from the work list to the referenced list
-      // one by one.
-      Section_id entry = this->worklist().back();
-      this->worklist().pop_back();
-      if (!this->referenced_list().insert(entry).second)
-        continue;
-      Garbage_collection::Section_ref::iterator find_it = 
-                this->section_reloc_map().find(entry);
-      if (find_it == this->section_reloc_map().end()) 
-          continue;
-      const Garbage_collection::Sections_reachable &v = find_it->second;
-      // Scan the vector of references for each work_list entry. 
-      for (Garbage_collection::Sections_reachable::const_iterator it_v =
-               v.begin();
-           it_v != v.end();
-           ++it_v)
-        {
-          // Do not add already processed sections to the work_list. 
-          if (this->referenced_list().find(*it_v)
-              == this->referenced_list().end())
-            {
-              this->worklist().push_back(*it_v);
-            }
-        }
+      Section_id entry = stack.back();
+      stack.pop_back();
+      const Object_references* refs = this->references(entry.first);
+      if (entry.second + 1 >= refs->offsets.size())
+	continue;
+      // Scan the references of each work_list entry.
+      unsigned int begin = refs->offsets[entry.second];
+      unsigned int end = refs->offsets[entry.second + 1];
+      for (unsigned int i = begin; i < end; ++i)
+	{
+	  const Section_id& target = refs->targets[i];
+	  if (set_mark(this->references(target.first), target.second))
+	    stack.push_back(target);
+	}
     }
-  this->worklist_ready();
+}
+
+// A task which marks the sections reachable from a range of the work
+// list.
+
+class Gc_mark_task : public Task
+{
+ public:
+  Gc_mark_task(Garbage_collection* gc, size_t first, size_t last,
+	       Task_token* blocker)
+    : gc_(gc), first_(first), last_(last), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  { return NULL; }
+
+  void
+  locks(Task_locker* tl)
+  { tl->add(this, this->blocker_); }
+
+  void
+  run(Workqueue*)
+  {
+    const Section_id* worklist = &this->gc_->worklist()[0];
+    this->gc_->mark_reachable(worklist + this->first_,
+			      worklist + this->last_);
+  }
+
+  std::string
+  get_name() const
+  { return "Gc_mark_task"; }
+
+ private:
+  Garbage_collection* gc_;
+  size_t first_;
+  size_t last_;
+  Task_token* blocker_;
+};
+
+// This runs after the marking tasks.  It releases the work list and
+// then runs the runner passed to queue_transitive_closure.
+
+class Gc_mark_runner : public Task_function_runner
+{
+ public:
+  Gc_mark_runner(Garbage_collection* gc, Task_function_runner* next)
+    : gc_(gc), next_(next)
+  { }
+
+  ~Gc_mark_runner()
+  { delete this->next_; }
+
+  void
+  run(Workqueue* workqueue, const Task* task)
+  {
+    Garbage_collection::Worklist_type().swap(this->gc_->worklist());
+    this->gc_->worklist_ready();
+    this->next_->run(workqueue, task);
+  }
+
+ private:
+  Garbage_collection* gc_;
+  Task_function_runner* next_;
+};
+
+// Garbage collection marks the transitive closure of the sections on
+// the work list.  The reference tables of all the objects are built
+// first, so that the marking tasks only read them and set mark bits.
+// The work list is grouped by object, and each object's entries start
+// one marking task.
+
+void
+Garbage_collection::queue_transitive_closure(
+    const Input_objects* input_objects,
+    Workqueue* workqueue,
+    Task_function_runner* next)
+{
+  for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
+       p != input_objects->relobj_end();
+       ++p)
+    this->build_reference_table(this->references(*p), *p);
+
+  Worklist_type& worklist = this->worklist();
+  std::sort(worklist.begin(), worklist.end());
+
+  Task_token* blocker = new Task_token(true);
+  size_t first = 0;
+  while (first < worklist.size())
+    {
+      size_t last = first + 1;
+#ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
+      while (last < worklist.size()
+	     && worklist[last].first == worklist[first].first)
+	++last;
+#else
+      last = worklist.size();
+#endif
+      blocker->add_blocker();
+      workqueue->queue(new Gc_mark_task(this, first, last, blocker));
+      first = last;
+    }
+
+  workqueue->queue(new Task_function(new Gc_mark_runner(this, next),
+				     blocker, "Task_function Gc_mark_runner"));
 }
 
 } // End namespace gold.
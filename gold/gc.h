@@ -34,6 +34,9 @@ namespace gold
 {
 
 class Object;
+class Input_objects;
+class Task_function_runner;
+class Workqueue;
 
 template<int size, bool big_endian>
 class Sized_relobj_file;
@@ -47,27 +50,56 @@ class Garbage_collection
  public:
 
   typedef Unordered_set<Section_id, Section_id_hash> Sections_reachable;
-  typedef std::map<Section_id, Sections_reachable> Section_ref;
   typedef std::vector<Section_id> Worklist_type;
   // This maps the name of the section which can be represented as a C
   // identifier (cident) to the list of sections that have that name.
   // Different object files can have cident sections with the same name.
   typedef std::map<std::string, Sections_reachable> Cident_section_map;
+  // The type of a word of mark bits.
+  typedef unsigned int Mark_word;
+
+  // The references from the sections of one object, and which of its
+  // sections are referenced.
+  struct Object_references
+  {
+    Object_references()
+      : sources(), targets(), offsets(), marks(), is_table(false)
+    { }
+
+    // Add a reference from section SRC_SHNDX of this object to section
+    // DST_SHNDX of DST_OBJECT.
+    void
+    add(unsigned int src_shndx, Relobj* dst_object, unsigned int dst_shndx)
+    {
+      this->sources.push_back(src_shndx);
+      this->targets.push_back(Section_id(dst_object, dst_shndx));
+    }
+
+    // Until the table is built, the index of the source section of
+    // each reference, in the order they were added.
+    std::vector<unsigned int> sources;
+    // The target section of each reference.  Building the table sorts
+    // these by source section and removes duplicates.
+    std::vector<Section_id> targets;
+    // Once the table is built, section SHNDX refers to TARGETS
+    // OFFSETS[SHNDX] up to OFFSETS[SHNDX + 1].
+    std::vector<unsigned int> offsets;
+    // One bit per section, set once the section is found to be
+    // referenced.  The marking tasks set them atomically.
+    std::vector<Mark_word> marks;
+    // Whether SOURCES has been turned into OFFSETS.
+    bool is_table;
+  };
+
+  typedef Unordered_map<const Relobj*, Object_references>
+    Object_references_map;
 
   Garbage_collection()
-  : is_worklist_ready_(false)
+  : is_worklist_ready_(false), references_are_local_(false)
   { }
 
   // Accessor methods for the private members.
 
-  Sections_reachable&
-  referenced_list()
-  { return referenced_list_; }
-
-  Section_ref&
-  section_reloc_map()
-  { return this->section_reloc_map_; }
-
   Worklist_type&
   worklist()
   { return this->work_list_; }
@@ -80,13 +112,51 @@ class Garbage_collection
   worklist_ready()
   { this->is_worklist_ready_ = true; }
 
+  // Add OBJECT, whose relocs are about to be processed.  This must be
+  // done for every object before any Gc_process_relocs task runs, so
+  // that the tasks never change the map of objects.
+  void
+  add_object(Relobj* object)
+  { this->objects_[object]; }
+
+  // Whether every object's Gc_process_relocs task only adds references
+  // from that object.  The tasks then run in parallel, and each one
+  // builds the reference table of its own object.
+  bool
+  references_are_local() const
+  { return this->references_are_local_; }
+
+  void
+  set_references_are_local()
+  { this->references_are_local_ = true; }
+
+  // Turn the references added from OBJECT into its reference table.
+  void
+  finish_references(Relobj* object)
+  { this->build_reference_table(this->references(object), object); }
+
+  // Mark the sections reachable from the work list, with one task per
+  // object which has sections on the work list, then run NEXT.
+  void
+  queue_transitive_closure(const Input_objects*, Workqueue*,
+			   Task_function_runner* next);
+
+  // Mark the sections reachable from the work list entries FIRST up to
+  // LAST.  This is run by the marking tasks.
   void
-  do_transitive_closure();
+  mark_reachable(const Section_id* first, const Section_id* last);
 
   bool
   is_section_garbage(Relobj* obj, unsigned int shndx)
-  { return (this->referenced_list().find(Section_id(obj, shndx))
-            == this->referenced_list().end()); }
+  {
+    Object_references_map::const_iterator p = this->objects_.find(obj);
+    if (p == this->objects_.end())
+      return true;
+    const std::vector<Mark_word>& marks = p->second.marks;
+    size_t word = shndx / mark_word_bits;
+    return (word >= marks.size()
+	    || (marks[word] & (Mark_word(1) << (shndx % mark_word_bits))) == 0);
+  }
 
   Cident_section_map*
   cident_sections()
@@ -97,24 +167,41 @@ class Garbage_collection
 		     Section_id secn)
   { this->cident_sections_[section_name].insert(secn); }
 
+  // Return the references of OBJECT, which must have been added with
+  // add_object.
+  Object_references*
+  references(const Relobj* object)
+  {
+    Object_references_map::iterator p = this->objects_.find(object);
+    gold_assert(p != this->objects_.end());
+    return &p->second;
+  }
+
   // Add a reference from the SRC_SHNDX-th section of SRC_OBJECT to
   // DST_SHNDX-th section of DST_OBJECT.
   void
   add_reference(Relobj* src_object, unsigned int src_shndx,
 		Relobj* dst_object, unsigned int dst_shndx)
-  {
-    Section_id src_id(src_object, src_shndx);
-    Section_id dst_id(dst_object, dst_shndx);
-    Sections_reachable& reachable = this->section_reloc_map_[src_id];
-    reachable.insert(dst_id);
-  }
+  { this->references(src_object)->add(src_shndx, dst_object, dst_shndx); }
 
  private:
+  // The number of mark bits in a Mark_word.
+  static const unsigned int mark_word_bits = 8 * sizeof(Mark_word);
+
+  void
+  build_reference_table(Object_references*, const Relobj*);
+
+  // Set the mark bit of section SHNDX in REFS, and return whether it
+  // was clear.
+  static bool
+  set_mark(Object_references* refs, unsigned int shndx);
 
   Worklist_type work_list_;
   bool is_worklist_ready_;
-  Section_ref section_reloc_map_;
-  Sections_reachable referenced_list_;
+  // Whether the Gc_process_relocs tasks run in parallel.
+  bool references_are_local_;
+  // The references and marks, by object.
+  Object_references_map objects_;
   Cident_section_map cident_sections_;
 };
 
@@ -199,6 +286,12 @@ gc_process_relocs(
 
   bool check_section_for_function_pointers = false;
 
+  // The references of SRC_OBJ.  Only this task adds to them.
+  Garbage_collection::Object_references* gc_refs =
+    (parameters->options().gc_sections()
+     ? symtab->gc()->references(src_obj)
+     : NULL);
+
   if (parameters->options().icf_enabled()
       && (is_section_foldable_candidate(src_section_name)
           || is_prefix_of(".eh_frame", src_section_name.c_str())))
@@ -346,9 +439,9 @@ gc_process_relocs(
           if (!is_ordinary)
             continue;
         }
-      if (parameters->options().gc_sections())
+      if (gc_refs != NULL)
         {
-	  symtab->gc()->add_reference(src_obj, src_indx, dst_obj, dst_indx);
+	  gc_refs->add(src_indx, dst_obj, dst_indx);
 	  parameters->sized_target<size, big_endian>()
 	    ->gc_add_reference(symtab, src_obj, src_indx, dst_obj, dst_indx,
 			       dst_off);
@@ -358,16 +451,13 @@ gc_process_relocs(
                 symtab->gc()->cident_sections()->find(std::string(cident_section_name));
               if (ele == symtab->gc()->cident_sections()->end())
                 continue;
-	      Section_id src_id(src_obj, src_indx);
-              Garbage_collection::Sections_reachable&
-                v(symtab->gc()->section_reloc_map()[src_id]);
               Garbage_collection::Sections_reachable& cident_secn(ele->second);
               for (Garbage_collection::Sections_reachable::iterator it_v
                      = cident_secn.begin();
                    it_v != cident_secn.end();
                    ++it_v)
                 {
-                  v.insert(*it_v);
+                  gc_refs->add(src_indx, it_v->first, it_v->second);
                 }
             }
         }
@@ -28,6 +28,7 @@
 #include "object.h"
 #include "output.h"
 #include "demangle.h"
+#include "layout.h"
 
 namespace gold
 {
@@ -183,15 +184,20 @@ class Gdb_index_info_reader : public Dwarf_info_reader
 			unsigned int shndx,
 			unsigned int reloc_shndx,
 			unsigned int reloc_type,
-			Gdb_index* gdb_index)
+			Gdb_index_object* index_object)
     : Dwarf_info_reader(is_type_unit, object, symbols, symbols_size, shndx,
 			reloc_shndx, reloc_type),
-      gdb_index_(gdb_index), cu_index_(0), cu_language_(0)
+      index_object_(index_object), cu_index_(0), cu_language_(0)
   { }
 
   ~Gdb_index_info_reader()
   { this->clear_declarations(); }
 
+  // Add to the usage statistics.
+  static void
+  add_stats(unsigned int cu_count, unsigned int cu_nopubnames_count,
+	    unsigned int tu_count, unsigned int tu_nopubnames_count);
+
   // Print usage statistics.
   static void
   print_stats();
@@ -285,8 +291,8 @@ class Gdb_index_info_reader : public Dwarf_info_reader
   void
   clear_declarations();
 
-  // The Gdb_index section.
-  Gdb_index* gdb_index_;
+  // The object whose sections we are scanning.
+  Gdb_index_object* index_object_;
   // The current CU index (negative for a TU).
   int cu_index_;
   // The language of the current CU or TU.
@@ -315,14 +321,199 @@ unsigned int Gdb_index_info_reader::dwarf_tu_count = 0;
 // Number of DWARF type units without pubnames/pubtypes.
 unsigned int Gdb_index_info_reader::dwarf_tu_nopubnames_count = 0;
 
+// The .debug_info and .debug_types sections of one input object,
+// and what we find when we scan them.  The objects are scanned in
+// parallel, and then added to the Gdb_index in input order, so that
+// the contents of the index do not depend on the order in which the
+// scans finish.
+
+class Gdb_index_object
+{
+ public:
+  Gdb_index_object(Relobj* object, const unsigned char* symbols,
+		   off_t symbols_size);
+
+  ~Gdb_index_object();
+
+  // Return the object.
+  Relobj*
+  object() const
+  { return this->object_; }
+
+  // Add an input section to scan.
+  void
+  add_section(bool is_type_unit, unsigned int shndx,
+	      unsigned int reloc_shndx, unsigned int reloc_type)
+  {
+    this->sections_.push_back(Section(is_type_unit, shndx, reloc_shndx,
+				      reloc_type));
+  }
+
+  // Scan the input sections.
+  void
+  scan();
+
+  // Return whether the input sections have been scanned.
+  bool
+  is_scanned() const
+  { return this->is_scanned_; }
+
+  // The following are called by Gdb_index_info_reader while
+  // scanning.  The CU and TU indexes are local to this object.
+
+  // Add a compilation unit.
+  int
+  add_comp_unit(off_t cu_offset, off_t cu_length)
+  {
+    this->comp_units_.push_back(Gdb_index::Comp_unit(cu_offset, cu_length));
+    return this->comp_units_.size() - 1;
+  }
+
+  // Add a type unit.
+  int
+  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
+  {
+    this->type_units_.push_back(Gdb_index::Type_unit(tu_offset, type_offset,
+						     signature));
+    return this->type_units_.size() - 1;
+  }
+
+  // Add an address range.
+  void
+  add_address_range_list(Relobj* object, unsigned int cu_index,
+			 Dwarf_range_list* ranges)
+  {
+    this->ranges_.push_back(Gdb_index::Per_cu_range_list(object, cu_index,
+							 ranges));
+  }
+
+  // Add a symbol.  FLAGS are the gdb_index version 7 flags to be
+  // stored in the high-byte of the cu_index field.
+  void
+  add_symbol(int cu_index, const char* sym_name, uint8_t flags);
+
+  // Record a CU or TU without pubnames or pubtypes, for statistics.
+  void
+  add_nopubnames_unit(bool is_type_unit)
+  {
+    if (is_type_unit)
+      ++this->tu_nopubnames_count_;
+    else
+      ++this->cu_nopubnames_count_;
+  }
+
+  // Return the offset into the pubnames table for the cu at the given
+  // offset.
+  off_t
+  find_pubname_offset(off_t cu_offset);
+
+  // Return the offset into the pubtypes table for the cu at the
+  // given offset.
+  off_t
+  find_pubtype_offset(off_t cu_offset);
+
+  // Return TRUE if we have already processed the pubnames and types
+  // set of the CUs and TUS associated with the statement list at
+  // OFFSET.
+  bool
+  pubnames_read(off_t offset) const
+  { return this->stmt_list_offset_ == offset; }
+
+  // Record that we have already read the pubnames associated with
+  // OFFSET.
+  void
+  set_pubnames_read(off_t offset)
+  { this->stmt_list_offset_ = offset; }
+
+  // Return a pointer to the given table.
+  Dwarf_pubnames_table*
+  pubnames_table()
+  { return this->pubnames_table_; }
+
+  Dwarf_pubnames_table*
+  pubtypes_table()
+  { return this->pubtypes_table_; }
+
+ private:
+  friend class Gdb_index;
+
+  // An input section to scan.
+  struct Section
+  {
+    Section(bool type_unit, unsigned int index, unsigned int rel_index,
+	    unsigned int rel_type)
+      : is_type_unit(type_unit), shndx(index), reloc_shndx(rel_index),
+	reloc_type(rel_type)
+    { }
+    bool is_type_unit;
+    unsigned int shndx;
+    unsigned int reloc_shndx;
+    unsigned int reloc_type;
+  };
+
+  // A symbol found while scanning.  NAME_OFFSET is the offset of the
+  // name in NAMES_.
+  struct Symbol
+  {
+    Symbol(int index, uint8_t f, unsigned int h, size_t offset)
+      : cu_index(index), flags(f), hash(h), name_offset(offset)
+    { }
+    int cu_index;
+    uint8_t flags;
+    unsigned int hash;
+    size_t name_offset;
+  };
+
+  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
+
+  // Scan the given pubtable and build a map of the various dies it
+  // refers to, so we can process the entries when we encounter the
+  // die.  Return the just-read table so it can be cached.
+  Dwarf_pubnames_table*
+  map_pubtable_to_dies(unsigned int attr, Gdb_index_info_reader* dwinfo);
+
+  // Wrapper for map_pubtable_to_dies.
+  void
+  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo);
+
+  // The object.
+  Relobj* object_;
+  // A copy of the symbol table of the object.
+  unsigned char* symbols_;
+  off_t symbols_size_;
+  // The input sections to scan.
+  std::vector<Section> sections_;
+  // Whether the sections have been scanned.
+  bool is_scanned_;
+  // The compilation units, type units and address ranges we found.
+  std::vector<Gdb_index::Comp_unit> comp_units_;
+  std::vector<Gdb_index::Type_unit> type_units_;
+  std::vector<Gdb_index::Per_cu_range_list> ranges_;
+  // The symbols we found, in the order we found them.
+  std::vector<Symbol> symbols_found_;
+  // The names of the symbols, each terminated by a null byte.
+  std::string names_;
+  // Maps from CU offsets to pubnames and pubtypes offsets.
+  Pubname_offset_map cu_pubname_map_;
+  Pubname_offset_map cu_pubtype_map_;
+  // The pubnames and pubtypes tables of the object.
+  Dwarf_pubnames_table* pubnames_table_;
+  Dwarf_pubnames_table* pubtypes_table_;
+  // The stmt list offset of the CUs and TUs associated with the last
+  // read pubnames and pubtypes.
+  off_t stmt_list_offset_;
+  // Statistics.
+  unsigned int cu_nopubnames_count_;
+  unsigned int tu_nopubnames_count_;
+};
+
 // Process a compilation unit and parse its child DIE.
 
 void
 Gdb_index_info_reader::visit_compilation_unit(off_t cu_offset, off_t cu_length,
 					      Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_cu_count;
-  this->cu_index_ = this->gdb_index_->add_comp_unit(cu_offset, cu_length);
+  this->cu_index_ = this->index_object_->add_comp_unit(cu_offset, cu_length);
   this->visit_top_die(root_die);
 }
 
@@ -333,9 +524,8 @@ Gdb_index_info_reader::visit_type_unit(off_t tu_offset, off_t,
 				       off_t type_offset, uint64_t signature,
 				       Dwarf_die* root_die)
 {
-  ++Gdb_index_info_reader::dwarf_tu_count;
   // Use a negative index to flag this as a TU instead of a CU.
-  this->cu_index_ = -1 - this->gdb_index_->add_type_unit(tu_offset, type_offset,
+  this->cu_index_ = -1 - this->index_object_->add_type_unit(tu_offset, type_offset,
 							 signature);
   this->visit_top_die(root_die);
 }
@@ -380,10 +570,8 @@ Gdb_index_info_reader::visit_top_die(Dwarf_die* die)
 			     this->object()->name().c_str());
 		return;
 	      }
-	    if (die->tag() == elfcpp::DW_TAG_compile_unit)
-	      ++Gdb_index_info_reader::dwarf_cu_nopubnames_count;
-	    else
-	      ++Gdb_index_info_reader::dwarf_tu_nopubnames_count;
+	    this->index_object_->add_nopubnames_unit(
+		die->tag() == elfcpp::DW_TAG_type_unit);
 	    this->visit_children(die, NULL);
 	  }
 	break;
@@ -437,7 +625,7 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	    // If the DIE is not a declaration, add it to the index.
 	    std::string full_name = this->get_qualified_name(die, context);
 	    if (!full_name.empty())
-	      this->gdb_index_->add_symbol(this->cu_index_,
+	      this->index_object_->add_symbol(this->cu_index_,
                                            full_name.c_str(), 0);
 	  }
 	break;
@@ -477,7 +665,7 @@ Gdb_index_info_reader::visit_die(Dwarf_die* die, Dwarf_die* context)
 	      if (full_name.empty())
 		full_name = this->get_qualified_name(die, context);
 	      if (!full_name.empty())
-		this->gdb_index_->add_symbol(this->cu_index_,
+		this->index_object_->add_symbol(this->cu_index_,
 					     full_name.c_str(), 0);
 	    }
 
@@ -825,7 +1013,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
     {
       Dwarf_range_list* ranges = this->read_range_list(shndx, ranges_offset);
       if (ranges != NULL)
-	this->gdb_index_->add_address_range_list(this->object(),
+	this->index_object_->add_address_range_list(this->object(),
 						 this->cu_index_, ranges);
       return;
     }
@@ -851,7 +1039,7 @@ Gdb_index_info_reader::record_cu_ranges(Dwarf_die* die)
         {
 	  Dwarf_range_list* ranges = new Dwarf_range_list();
 	  ranges->add(shndx, low_pc, high_pc);
-	  this->gdb_index_->add_address_range_list(this->object(),
+	  this->index_object_->add_address_range_list(this->object(),
 						   this->cu_index_, ranges);
         }
     }
@@ -877,7 +1065,7 @@ Gdb_index_info_reader::read_pubtable(Dwarf_pubnames_table* table, off_t offset)
       if (name == NULL)
         break;
 
-      this->gdb_index_->add_symbol(this->cu_index_, name, flag_byte);
+      this->index_object_->add_symbol(this->cu_index_, name, flag_byte);
     }
   return true;
 }
@@ -916,8 +1104,7 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
           // have read. If it does, then no need to read the pubnames.
           // If it doesn't, then the caller will have to parse the
           // dies manually to find the names.
-          return this->gdb_index_->pubnames_read(this->object(),
-                                                 stmt_list_off);
+          return this->index_object_->pubnames_read(stmt_list_off);
         }
       else
         {
@@ -928,10 +1115,10 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
 
   // We found the attribute, so we can check if the corresponding
   // pubnames have been read.
-  if (this->gdb_index_->pubnames_read(this->object(), stmt_list_off))
+  if (this->index_object_->pubnames_read(stmt_list_off))
     return true;
 
-  this->gdb_index_->set_pubnames_read(this->object(), stmt_list_off);
+  this->index_object_->set_pubnames_read(stmt_list_off);
 
   // We have an attribute, and the pubnames haven't been read, so read
   // them.
@@ -939,12 +1126,12 @@ Gdb_index_info_reader::read_pubnames_and_pubtypes(Dwarf_die* die)
   // In some of the cases, we could rely on the previous value of
   // offset here, but sorting out which cases complicates the logic
   // enough that it isn't worth it. So just look up the offset again.
-  offset = this->gdb_index_->find_pubname_offset(this->cu_offset());
-  names = this->read_pubtable(this->gdb_index_->pubnames_table(), offset);
+  offset = this->index_object_->find_pubname_offset(this->cu_offset());
+  names = this->read_pubtable(this->index_object_->pubnames_table(), offset);
 
   bool types = false;
-  offset = this->gdb_index_->find_pubtype_offset(this->cu_offset());
-  types = this->read_pubtable(this->gdb_index_->pubtypes_table(), offset);
+  offset = this->index_object_->find_pubtype_offset(this->cu_offset());
+  types = this->read_pubtable(this->index_object_->pubtypes_table(), offset);
   return names || types;
 }
 
@@ -964,6 +1151,20 @@ Gdb_index_info_reader::clear_declarations()
   this->declarations_.clear();
 }
 
+// Add to the usage statistics.
+
+void
+Gdb_index_info_reader::add_stats(unsigned int cu_count,
+				 unsigned int cu_nopubnames_count,
+				 unsigned int tu_count,
+				 unsigned int tu_nopubnames_count)
+{
+  Gdb_index_info_reader::dwarf_cu_count += cu_count;
+  Gdb_index_info_reader::dwarf_cu_nopubnames_count += cu_nopubnames_count;
+  Gdb_index_info_reader::dwarf_tu_count += tu_count;
+  Gdb_index_info_reader::dwarf_tu_nopubnames_count += tu_nopubnames_count;
+}
+
 // Print usage statistics.
 void
 Gdb_index_info_reader::print_stats()
@@ -978,53 +1179,41 @@ Gdb_index_info_reader::print_stats()
           program_name, Gdb_index_info_reader::dwarf_tu_nopubnames_count);
 }
 
-// Class Gdb_index.
-
-// Construct the .gdb_index section.
+// Class Gdb_index_object.
 
-Gdb_index::Gdb_index(Output_section* gdb_index_section)
-  : Output_section_data(4),
-    pubnames_table_(NULL),
-    pubtypes_table_(NULL),
-    gdb_index_section_(gdb_index_section),
-    comp_units_(),
-    type_units_(),
-    ranges_(),
-    cu_vector_list_(),
-    cu_vector_offsets_(NULL),
-    stringpool_(),
-    tu_offset_(0),
-    addr_offset_(0),
-    symtab_offset_(0),
-    cu_pool_offset_(0),
-    stringpool_offset_(0),
-    pubnames_object_(NULL),
-    stmt_list_offset_(-1)
+Gdb_index_object::Gdb_index_object(Relobj* object,
+				   const unsigned char* symbols,
+				   off_t symbols_size)
+  : object_(object), symbols_(NULL), symbols_size_(symbols_size),
+    sections_(), is_scanned_(false), comp_units_(), type_units_(), ranges_(),
+    symbols_found_(), names_(), cu_pubname_map_(), cu_pubtype_map_(),
+    pubnames_table_(NULL), pubtypes_table_(NULL), stmt_list_offset_(-1),
+    cu_nopubnames_count_(0), tu_nopubnames_count_(0)
 {
-  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
+  // The symbols belong to the caller, and are freed after layout, so
+  // we need a copy to scan the sections later.
+  if (symbols != NULL)
+    {
+      this->symbols_ = new unsigned char[symbols_size];
+      memcpy(this->symbols_, symbols, symbols_size);
+    }
 }
 
-Gdb_index::~Gdb_index()
+Gdb_index_object::~Gdb_index_object()
 {
-  // Free the memory used by the symbol table.
-  delete this->gdb_symtab_;
-  // Free the memory used by the CU vectors.
-  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
-    delete this->cu_vector_list_[i];
+  delete[] this->symbols_;
+  delete this->pubnames_table_;
+  delete this->pubtypes_table_;
 }
 
-
 // Scan the pubnames and pubtypes sections and build a map of the
 // various cus and tus they refer to, so we can process the entries
 // when we encounter the die for that cu or tu.
 // Return the just-read table so it can be cached.
 
 Dwarf_pubnames_table*
-Gdb_index::map_pubtable_to_dies(unsigned int attr,
-                                Gdb_index_info_reader* dwinfo,
-                                Relobj* object,
-                                const unsigned char* symbols,
-                                off_t symbols_size)
+Gdb_index_object::map_pubtable_to_dies(unsigned int attr,
+				       Gdb_index_info_reader* dwinfo)
 {
   uint64_t section_offset = 0;
   Dwarf_pubnames_table* table;
@@ -1042,7 +1231,8 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
     }
 
   map->clear();
-  if (!table->read_section(object, symbols, symbols_size))
+  if (!table->read_section(this->object_, this->symbols_,
+			   this->symbols_size_))
     return NULL;
 
   while (table->read_header(section_offset))
@@ -1057,30 +1247,20 @@ Gdb_index::map_pubtable_to_dies(unsigned int attr,
 // Wrapper for map_pubtable_to_dies
 
 void
-Gdb_index::map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                          Relobj* object,
-                                          const unsigned char* symbols,
-                                          off_t symbols_size)
+Gdb_index_object::map_pubnames_and_types_to_dies(
+    Gdb_index_info_reader* dwinfo)
 {
-  // This is a new object, so reset the relevant variables.
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = -1;
-
-  delete this->pubnames_table_;
   this->pubnames_table_
-      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo,
-                                   object, symbols, symbols_size);
-  delete this->pubtypes_table_;
+      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubnames, dwinfo);
   this->pubtypes_table_
-      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo,
-                                   object, symbols, symbols_size);
+      = this->map_pubtable_to_dies(elfcpp::DW_AT_GNU_pubtypes, dwinfo);
 }
 
 // Given a cu_offset, find the associated section of the pubnames
 // table.
 
 off_t
-Gdb_index::find_pubname_offset(off_t cu_offset)
+Gdb_index_object::find_pubname_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubname_map_.find(cu_offset);
   if (it != this->cu_pubname_map_.end())
@@ -1092,7 +1272,7 @@ Gdb_index::find_pubname_offset(off_t cu_offset)
 // table.
 
 off_t
-Gdb_index::find_pubtype_offset(off_t cu_offset)
+Gdb_index_object::find_pubtype_offset(off_t cu_offset)
 {
   Pubname_offset_map::iterator it = this->cu_pubtype_map_.find(cu_offset);
   if (it != this->cu_pubtype_map_.end())
@@ -1100,33 +1280,213 @@ Gdb_index::find_pubtype_offset(off_t cu_offset)
   return -1;
 }
 
-// Scan a .debug_info or .debug_types input section.
+// Scan the .debug_info and .debug_types input sections.
 
 void
-Gdb_index::scan_debug_info(bool is_type_unit,
-			   Relobj* object,
-			   const unsigned char* symbols,
-			   off_t symbols_size,
-			   unsigned int shndx,
-			   unsigned int reloc_shndx,
-			   unsigned int reloc_type)
+Gdb_index_object::scan()
 {
-  Gdb_index_info_reader dwinfo(is_type_unit, object,
-			       symbols, symbols_size,
-			       shndx, reloc_shndx,
-			       reloc_type, this);
-  if (object != this->pubnames_object_)
-    map_pubnames_and_types_to_dies(&dwinfo, object, symbols, symbols_size);
-  dwinfo.parse();
+  gold_assert(!this->is_scanned_);
+  for (std::vector<Section>::const_iterator p = this->sections_.begin();
+       p != this->sections_.end();
+       ++p)
+    {
+      Gdb_index_info_reader dwinfo(p->is_type_unit, this->object_,
+				   this->symbols_, this->symbols_size_,
+				   p->shndx, p->reloc_shndx,
+				   p->reloc_type, this);
+      if (p == this->sections_.begin())
+	this->map_pubnames_and_types_to_dies(&dwinfo);
+      dwinfo.parse();
+    }
+  this->is_scanned_ = true;
+
+  // We don't need these any more.
+  delete[] this->symbols_;
+  this->symbols_ = NULL;
+  delete this->pubnames_table_;
+  this->pubnames_table_ = NULL;
+  delete this->pubtypes_table_;
+  this->pubtypes_table_ = NULL;
 }
 
-// Add a symbol.
+// Add a symbol.  We compute the hash code here, since this runs in
+// parallel for different objects.
 
 void
-Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
+Gdb_index_object::add_symbol(int cu_index, const char* sym_name,
+			     uint8_t flags)
 {
   unsigned int hash = mapped_index_string_hash(
       reinterpret_cast<const unsigned char*>(sym_name));
+  this->symbols_found_.push_back(Symbol(cu_index, flags, hash,
+					this->names_.size()));
+  this->names_.append(sym_name, strlen(sym_name) + 1);
+}
+
+// A task to scan the .debug_info and .debug_types sections of one
+// object.
+
+class Gdb_index_scan_task : public Task
+{
+ public:
+  Gdb_index_scan_task(Gdb_index_object* index_object, Task_token* blocker)
+    : index_object_(index_object), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    Relobj* object = this->index_object_->object();
+    if (object->is_locked())
+      return object->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->blocker_);
+    Task_token* token = this->index_object_->object()->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->index_object_->scan();
+    this->index_object_->object()->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Gdb_index_scan_task " + this->index_object_->object()->name(); }
+
+ private:
+  Gdb_index_object* index_object_;
+  Task_token* blocker_;
+};
+
+// Class Gdb_index.
+
+// Construct the .gdb_index section.
+
+Gdb_index::Gdb_index(Output_section* gdb_index_section)
+  : Output_section_data(4),
+    gdb_index_section_(gdb_index_section),
+    objects_(),
+    comp_units_(),
+    type_units_(),
+    ranges_(),
+    cu_vector_list_(),
+    cu_vector_offsets_(NULL),
+    stringpool_(),
+    tu_offset_(0),
+    addr_offset_(0),
+    symtab_offset_(0),
+    cu_pool_offset_(0),
+    stringpool_offset_(0)
+{
+  this->gdb_symtab_ = new Gdb_hashtab<Gdb_symbol>();
+}
+
+Gdb_index::~Gdb_index()
+{
+  // Free the memory used by the symbol table.
+  delete this->gdb_symtab_;
+  // Free the memory used by the CU vectors.
+  for (unsigned int i = 0; i < this->cu_vector_list_.size(); ++i)
+    delete this->cu_vector_list_[i];
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    delete this->objects_[i];
+}
+
+// Add a .debug_info or .debug_types input section.  All the sections
+// of an object are added together, so we start a new
+// Gdb_index_object whenever the object changes.
+
+void
+Gdb_index::add_debug_info(bool is_type_unit,
+			  Relobj* object,
+			  const unsigned char* symbols,
+			  off_t symbols_size,
+			  unsigned int shndx,
+			  unsigned int reloc_shndx,
+			  unsigned int reloc_type)
+{
+  if (this->objects_.empty() || this->objects_.back()->object() != object)
+    this->objects_.push_back(new Gdb_index_object(object, symbols,
+						  symbols_size));
+  this->objects_.back()->add_section(is_type_unit, shndx, reloc_shndx,
+				     reloc_type);
+}
+
+// Queue a task to scan the input sections of each object.
+
+void
+Gdb_index::queue_scan_tasks(Workqueue* workqueue, Task_token* blocker)
+{
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    blocker->add_blocker();
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    workqueue->queue(new Gdb_index_scan_task(this->objects_[i], blocker));
+}
+
+// Add the compilation units, type units, address ranges and symbols
+// found in INDEX_OBJECT.  The CU and TU indexes are converted from
+// indexes local to the object to indexes in the whole index.
+
+void
+Gdb_index::add_object(Gdb_index_object* index_object)
+{
+  gold_assert(index_object->is_scanned());
+
+  const int cu_base = this->comp_units_.size();
+  const int tu_base = this->type_units_.size();
+  this->comp_units_.insert(this->comp_units_.end(),
+			   index_object->comp_units_.begin(),
+			   index_object->comp_units_.end());
+  this->type_units_.insert(this->type_units_.end(),
+			   index_object->type_units_.begin(),
+			   index_object->type_units_.end());
+
+  for (std::vector<Per_cu_range_list>::const_iterator p =
+	 index_object->ranges_.begin();
+       p != index_object->ranges_.end();
+       ++p)
+    {
+      // The TU indexes are negative.
+      int cu_index = static_cast<int>(p->cu_index);
+      cu_index = cu_index < 0 ? cu_index - tu_base : cu_index + cu_base;
+      this->ranges_.push_back(Per_cu_range_list(p->object, cu_index,
+						p->ranges));
+    }
+
+  const char* names = index_object->names_.data();
+  for (std::vector<Gdb_index_object::Symbol>::const_iterator p =
+	 index_object->symbols_found_.begin();
+       p != index_object->symbols_found_.end();
+       ++p)
+    {
+      int cu_index = p->cu_index < 0 ? p->cu_index - tu_base
+				     : p->cu_index + cu_base;
+      this->add_symbol(cu_index, names + p->name_offset, p->hash, p->flags);
+    }
+
+  Gdb_index_info_reader::add_stats(index_object->comp_units_.size(),
+				   index_object->cu_nopubnames_count_,
+				   index_object->type_units_.size(),
+				   index_object->tu_nopubnames_count_);
+}
+
+// Add a symbol.
+
+void
+Gdb_index::add_symbol(int cu_index, const char* sym_name, unsigned int hash,
+		      uint8_t flags)
+{
   Gdb_symbol* sym = new Gdb_symbol();
   this->stringpool_.add(sym_name, true, &sym->name_key);
   sym->hashval = hash;
@@ -1156,32 +1516,23 @@ Gdb_index::add_symbol(int cu_index, const char* sym_name, uint8_t flags)
     cu_vec->push_back(std::make_pair(cu_index, flags));
 }
 
-// Return TRUE if we have already processed the pubnames associated
-// with the statement list at the given OFFSET.
-
-bool
-Gdb_index::pubnames_read(const Relobj* object, off_t offset)
-{
-  bool ret = (this->pubnames_object_ == object
-	      && this->stmt_list_offset_ == offset);
-  return ret;
-}
-
-// Record that we have processed the pubnames associated with the
-// statement list for OBJECT at the given OFFSET.
-
-void
-Gdb_index::set_pubnames_read(const Relobj* object, off_t offset)
-{
-  this->pubnames_object_ = object;
-  this->stmt_list_offset_ = offset;
-}
-
 // Set the size of the .gdb_index section.
 
 void
 Gdb_index::set_final_data_size()
 {
+  // Add the objects in input order, scanning any which were not
+  // scanned by queue_scan_tasks.
+  for (unsigned int i = 0; i < this->objects_.size(); ++i)
+    {
+      Gdb_index_object* index_object = this->objects_[i];
+      if (!index_object->is_scanned())
+	index_object->scan();
+      this->add_object(index_object);
+      delete index_object;
+    }
+  this->objects_.clear();
+
   // Finalize the string pool.
   this->stringpool_.set_string_offsets();
 
@@ -1356,4 +1707,25 @@ Gdb_index::print_stats()
     Gdb_index_info_reader::print_stats();
 }
 
+// Class Gdb_index_scan_runner.
+
+void
+Gdb_index_scan_runner::run(Workqueue* workqueue, const Task* task)
+{
+  Task_function_runner* next = this->next_;
+  this->next_ = NULL;
+
+  Gdb_index* gdb_index = this->layout_->gdb_index_data();
+  if (gdb_index == NULL || !gdb_index->has_debug_info())
+    {
+      next->run(workqueue, task);
+      delete next;
+      return;
+    }
+
+  Task_token* blocker = new Task_token(true);
+  gdb_index->queue_scan_tasks(workqueue, blocker);
+  workqueue->queue(new Task_function(next, blocker, this->next_name_));
+}
+
 } // End namespace gold.
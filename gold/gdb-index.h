@@ -27,6 +27,7 @@
 #include "output.h"
 #include "mapfile.h"
 #include "stringpool.h"
+#include "workqueue.h"
 
 #ifndef GOLD_GDB_INDEX_H
 #define GOLD_GDB_INDEX_H
@@ -37,12 +38,14 @@ namespace gold
 class Output_section;
 class Output_file;
 class Mapfile;
+class Layout;
 template<int size, bool big_endian>
 class Sized_relobj;
 class Dwarf_range_list;
 template <typename T>
 class Gdb_hashtab;
 class Gdb_index_info_reader;
+class Gdb_index_object;
 class Dwarf_pubnames_table;
 
 // This class manages the .gdb_index section, which is a fast
@@ -56,73 +59,26 @@ class Gdb_index : public Output_section_data
 
   ~Gdb_index();
 
-  // Scan a .debug_info or .debug_types input section.
-  void scan_debug_info(bool is_type_unit,
-		       Relobj* object,
-		       const unsigned char* symbols,
-		       off_t symbols_size,
-		       unsigned int shndx,
-		       unsigned int reloc_shndx,
-		       unsigned int reloc_type);
-
-  // Add a compilation unit.
-  int
-  add_comp_unit(off_t cu_offset, off_t cu_length)
-  {
-    this->comp_units_.push_back(Comp_unit(cu_offset, cu_length));
-    return this->comp_units_.size() - 1;
-  }
-
-  // Add a type unit.
-  int
-  add_type_unit(off_t tu_offset, off_t type_offset, uint64_t signature)
-  {
-    this->type_units_.push_back(Type_unit(tu_offset, type_offset, signature));
-    return this->type_units_.size() - 1;
-  }
-
-  // Add an address range.
-  void
-  add_address_range_list(Relobj* object, unsigned int cu_index,
-			 Dwarf_range_list* ranges)
-  {
-    this->ranges_.push_back(Per_cu_range_list(object, cu_index, ranges));
-  }
-
-  // Add a symbol.  FLAGS are the gdb_index version 7 flags to be stored in
-  // the high-byte of the cu_index field.
-  void
-  add_symbol(int cu_index, const char* sym_name, uint8_t flags);
-
-  // Return the offset into the pubnames table for the cu at the given
-  // offset.
-  off_t
-  find_pubname_offset(off_t cu_offset);
-
-  // Return the offset into the pubtypes table for the cu at the
-  // given offset.
-  off_t
-  find_pubtype_offset(off_t cu_offset);
-
-  // Return TRUE if we have already processed the pubnames and types
-  // set for OBJECT of the CUs and TUS associated with the statement
-  // list at OFFSET.
+  // Add a .debug_info or .debug_types input section to be scanned.
+  // The sections are scanned by queue_scan_tasks, or if that is not
+  // called, by set_final_data_size.
+  void add_debug_info(bool is_type_unit,
+		      Relobj* object,
+		      const unsigned char* symbols,
+		      off_t symbols_size,
+		      unsigned int shndx,
+		      unsigned int reloc_shndx,
+		      unsigned int reloc_type);
+
+  // Return whether there are any input sections to scan.
   bool
-  pubnames_read(const Relobj* object, off_t offset);
+  has_debug_info() const
+  { return !this->objects_.empty(); }
 
-  // Record that we have already read the pubnames associated with
-  // OBJECT and OFFSET.
+  // Queue a task to scan the input sections of each object.  Each
+  // task releases a lock on BLOCKER when it completes.
   void
-  set_pubnames_read(const Relobj* object, off_t offset);
-
-  // Return a pointer to the given table.
-  Dwarf_pubnames_table*
-  pubnames_table()
-  { return pubnames_table_; }
-
-  Dwarf_pubnames_table*
-  pubtypes_table()
-  { return pubtypes_table_; }
+  queue_scan_tasks(Workqueue*, Task_token* blocker);
 
   // Print usage statistics.
   static void
@@ -148,22 +104,9 @@ class Gdb_index : public Output_section_data
   do_print_to_mapfile(Mapfile* mapfile) const
   { mapfile->print_output_data(this, _("** gdb_index")); }
 
-  // Create a map from dies to pubnames.
-  Dwarf_pubnames_table*
-  map_pubtable_to_dies(unsigned int attr,
-                       Gdb_index_info_reader* dwinfo,
-                       Relobj* object,
-                       const unsigned char* symbols,
-                       off_t symbols_size);
-
-  // Wrapper for map_pubtable_to_dies
-  void
-  map_pubnames_and_types_to_dies(Gdb_index_info_reader* dwinfo,
-                                 Relobj* object,
-                                 const unsigned char* symbols,
-                                 off_t symbols_size);
-
  private:
+  friend class Gdb_index_object;
+
   // An entry in the compilation unit list.
   struct Comp_unit
   {
@@ -216,23 +159,23 @@ class Gdb_index : public Output_section_data
 
   typedef std::vector<std::pair<int, uint8_t> > Cu_vector;
 
-  typedef Unordered_map<off_t, off_t> Pubname_offset_map;
-  Pubname_offset_map cu_pubname_map_;
-  Pubname_offset_map cu_pubtype_map_;
-
-  // Scan the given pubtable and build a map of the various dies it
-  // refers to, so we can process the entries when we encounter the
-  // die.
+  // Add the compilation units, type units, address ranges and
+  // symbols found in OBJECT.
   void
-  map_pubtable_to_dies(Dwarf_pubnames_table* table,
-                       Pubname_offset_map* map);
+  add_object(Gdb_index_object* object);
 
-  // Tables to store the pubnames section of the current object.
-  Dwarf_pubnames_table* pubnames_table_;
-  Dwarf_pubnames_table* pubtypes_table_;
+  // Add a symbol.  HASH is the hash code of SYM_NAME.  FLAGS are the
+  // gdb_index version 7 flags to be stored in the high-byte of the
+  // cu_index field.
+  void
+  add_symbol(int cu_index, const char* sym_name, unsigned int hash,
+	     uint8_t flags);
 
   // The .gdb_index section.
   Output_section* gdb_index_section_;
+  // The input objects whose sections we have not yet added to the
+  // index, in input order.
+  std::vector<Gdb_index_object*> objects_;
   // The list of DWARF compilation units.
   std::vector<Comp_unit> comp_units_;
   // The list of DWARF type units.
@@ -253,10 +196,29 @@ class Gdb_index : public Output_section_data
   off_t symtab_offset_;
   off_t cu_pool_offset_;
   off_t stringpool_offset_;
-  // Object, stmt list offset of the CUs and TUs associated with the
-  // last read pubnames and pubtypes sections.
-  const Relobj* pubnames_object_;
-  off_t stmt_list_offset_;
+};
+
+// This runner queues the tasks which scan the input sections for
+// the .gdb_index section, and then runs NEXT when they are done.
+
+class Gdb_index_scan_runner : public Task_function_runner
+{
+ public:
+  Gdb_index_scan_runner(const Layout* layout, Task_function_runner* next,
+			const char* next_name)
+    : layout_(layout), next_(next), next_name_(next_name)
+  { }
+
+  ~Gdb_index_scan_runner()
+  { delete this->next_; }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const Layout* layout_;
+  Task_function_runner* next_;
+  const char* next_name_;
 };
 
 } // End namespace gold.
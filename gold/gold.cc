@@ -44,6 +44,8 @@
 #include "plugin.h"
 #include "gc.h"
 #include "icf.h"
+#include "merge.h"
+#include "gdb-index.h"
 #include "incremental.h"
 #include "timer.h"
 
@@ -134,6 +136,90 @@ Middle_runner::run(Workqueue* workqueue, const Task* task)
 		     this->layout_, workqueue, this->mapfile_);
 }
 
+static void
+queue_middle_tasks_after_gc(const General_options& options,
+			    const Task* task,
+			    const Input_objects* input_objects,
+			    Symbol_table* symtab,
+			    Layout* layout,
+			    Workqueue* workqueue,
+			    Mapfile* mapfile);
+
+static void
+queue_middle_tasks_after_icf(const General_options& options,
+			     const Task* task,
+			     const Input_objects* input_objects,
+			     Symbol_table* symtab,
+			     Layout* layout,
+			     Workqueue* workqueue,
+			     Mapfile* mapfile);
+
+// This class continues the middle tasks once the sections reachable
+// for garbage collection are marked.  It is just a closure.
+
+class Middle_after_gc_runner : public Task_function_runner
+{
+ public:
+  Middle_after_gc_runner(const General_options& options,
+			 const Input_objects* input_objects,
+			 Symbol_table* symtab,
+			 Layout* layout, Mapfile* mapfile)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), mapfile_(mapfile)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  Symbol_table* symtab_;
+  Layout* layout_;
+  Mapfile* mapfile_;
+};
+
+void
+Middle_after_gc_runner::run(Workqueue* workqueue, const Task* task)
+{
+  queue_middle_tasks_after_gc(this->options_, task, this->input_objects_,
+			      this->symtab_, this->layout_, workqueue,
+			      this->mapfile_);
+}
+
+// This class continues the middle tasks once identical code folding
+// is done.  It is just a closure.
+
+class Middle_after_icf_runner : public Task_function_runner
+{
+ public:
+  Middle_after_icf_runner(const General_options& options,
+			  const Input_objects* input_objects,
+			  Symbol_table* symtab,
+			  Layout* layout, Mapfile* mapfile)
+    : options_(options), input_objects_(input_objects), symtab_(symtab),
+      layout_(layout), mapfile_(mapfile)
+  { }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const General_options& options_;
+  const Input_objects* input_objects_;
+  Symbol_table* symtab_;
+  Layout* layout_;
+  Mapfile* mapfile_;
+};
+
+void
+Middle_after_icf_runner::run(Workqueue* workqueue, const Task* task)
+{
+  queue_middle_tasks_after_icf(this->options_, task, this->input_objects_,
+			       this->symtab_, this->layout_, workqueue,
+			       this->mapfile_);
+}
+
 // This class arranges the tasks to process the relocs for garbage collection.
 
 class Gc_runner : public Task_function_runner
@@ -445,17 +531,40 @@ queue_middle_gc_tasks(const General_options& options,
 {
   // Read_relocs for all the objects must be done and processed to find
   // unused sections before any scanning of the relocs can take place.
+  // With only --gc-sections, each Gc_process_relocs task adds the
+  // references from its own object, unless the target adds references
+  // across objects, so the tasks need not run in order.  --icf records
+  // the relocs in shared tables, so then they run one at a time.
+  bool in_parallel = (options.gc_sections()
+		      && !options.icf_enabled()
+		      && input_objects->number_of_relobjs() > 0
+		      && parameters->target().gc_process_relocs_in_parallel());
+  if (in_parallel)
+    symtab->gc()->set_references_are_local();
+
   Task_token* this_blocker = NULL;
+  Task_token* parallel_blocker = in_parallel ? new Task_token(true) : NULL;
   for (Input_objects::Relobj_iterator p = input_objects->relobj_begin();
        p != input_objects->relobj_end();
        ++p)
     {
+      if (options.gc_sections())
+	symtab->gc()->add_object(*p);
+      if (in_parallel)
+	{
+	  parallel_blocker->add_blocker();
+	  workqueue->queue(new Read_relocs(symtab, layout, *p, NULL,
+					   parallel_blocker));
+	  continue;
+	}
       Task_token* next_blocker = new Task_token(true);
       next_blocker->add_blocker();
       workqueue->queue(new Read_relocs(symtab, layout, *p, this_blocker,
 				       next_blocker));
       this_blocker = next_blocker;
     }
+  if (in_parallel)
+    this_blocker = parallel_blocker;
 
   // If we are given only archives in input, we have no regular
   // objects and THIS_BLOCKER is NULL here.  Create a dummy
@@ -520,19 +629,72 @@ queue_middle_tasks(const General_options& options,
 	symtab->gc_mark_symbol(sym);
       // Symbols named with -u should not be considered garbage.
       symtab->gc_mark_undef_symbols(layout);
+    }
+
+  int thread_count = options.thread_count_middle();
+  if (thread_count == 0)
+    thread_count = std::max(2, input_objects->number_of_input_objects());
+  workqueue->set_thread_count(thread_count);
+
+  if (parameters->options().gc_sections())
+    {
       gold_assert(symtab->gc() != NULL);
-      // Do a transitive closure on all references to determine the worklist.
-      symtab->gc()->do_transitive_closure();
+      // Do a transitive closure on all references to determine the
+      // worklist.  The closure is marked by separate tasks, after
+      // which the rest of the middle tasks are queued.
+      symtab->gc()->queue_transitive_closure(input_objects, workqueue,
+					     new Middle_after_gc_runner(
+						 options, input_objects,
+						 symtab, layout, mapfile));
+      return;
     }
 
+  queue_middle_tasks_after_gc(options, task, input_objects, symtab, layout,
+			      workqueue, mapfile);
+}
+
+// Queue up the middle tasks which follow garbage collection, if any.
+
+static void
+queue_middle_tasks_after_gc(const General_options& options,
+			    const Task* task,
+			    const Input_objects* input_objects,
+			    Symbol_table* symtab,
+			    Layout* layout,
+			    Workqueue* workqueue,
+			    Mapfile* mapfile)
+{
   // If identical code folding (--icf) is chosen it makes sense to do it
   // only after garbage collection (--gc-sections) as we do not want to
-  // be folding sections that will be garbage.
+  // be folding sections that will be garbage.  The sections are
+  // checksummed by separate tasks, after which the rest of the middle
+  // tasks are queued.
   if (parameters->options().icf_enabled())
     {
-      symtab->icf()->find_identical_sections(input_objects, symtab);
+      symtab->icf()->find_identical_sections(task, input_objects, symtab,
+					     workqueue,
+					     new Middle_after_icf_runner(
+						 options, input_objects,
+						 symtab, layout, mapfile));
+      return;
     }
 
+  queue_middle_tasks_after_icf(options, task, input_objects, symtab, layout,
+			       workqueue, mapfile);
+}
+
+// Queue up the rest of the middle set of tasks, after identical code
+// folding if any.
+
+static void
+queue_middle_tasks_after_icf(const General_options& options,
+			     const Task* task,
+			     const Input_objects* input_objects,
+			     Symbol_table* symtab,
+			     Layout* layout,
+			     Workqueue* workqueue,
+			     Mapfile* mapfile)
+{
   // Call Object::layout for the second time to determine the
   // output_sections for all referenced input sections.  When
   // --gc-sections or --icf is turned on, or when certain input
@@ -597,11 +759,6 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
-  int thread_count = options.thread_count_middle();
-  if (thread_count == 0)
-    thread_count = std::max(2, input_objects->number_of_input_objects());
-  workqueue->set_thread_count(thread_count);
-
   // Now we have seen all the input files.
   const bool doing_static_link =
     (!input_objects->any_dynamic()
@@ -777,16 +934,23 @@ queue_middle_tasks(const General_options& options,
 	}
     }
 
-  // When all those tasks are complete, we can start laying out the
-  // output file.
-  workqueue->queue(new Task_function(new Layout_task_runner(options,
-							    input_objects,
-							    symtab,
-							    target,
-							    layout,
-							    mapfile),
-				     this_blocker,
-				     "Task_function Layout_task_runner"));
+  // When all those tasks are complete, we read the strings of the
+  // merged string sections, and scan the debug info for
+  // --gdb-index, and then we can start laying out the output file.
+  Task_function_runner* runner =
+    new Layout_task_runner(options, input_objects, symtab, target, layout,
+			   mapfile);
+  const char* runner_name = "Task_function Layout_task_runner";
+  if (options.gdb_index())
+    {
+      runner = new Gdb_index_scan_runner(layout, runner, runner_name);
+      runner_name = "Task_function Gdb_index_scan_runner";
+    }
+  workqueue->queue(new Task_function(
+		       new Merge_strings_runner(input_objects, layout,
+						runner, runner_name),
+		       this_blocker,
+		       "Task_function Merge_strings_runner"));
 }
 
 // Queue up the final set of tasks.  This is called at the end of
@@ -878,10 +1042,23 @@ queue_final_tasks(const General_options& options,
     {
       Task_token* new_final_blocker = new Task_token(true);
       new_final_blocker->add_blocker();
-      Task* t = new Write_after_input_sections_task(layout, of,
-						    final_blocker,
-						    new_final_blocker);
-      workqueue->queue(t);
+      if (options.threads() && !layout->compressed_sections().empty())
+	{
+	  // Compress the debug sections in parallel before writing
+	  // them out.
+	  Task_function_runner* r =
+	    new Compress_sections_task_runner(layout, of, new_final_blocker);
+	  workqueue->queue(new Task_function(r, final_blocker,
+					     ("Task_function "
+					      "Compress_sections_task_runner")));
+	}
+      else
+	{
+	  Task* t = new Write_after_input_sections_task(layout, of,
+							final_blocker,
+							new_final_blocker);
+	  workqueue->queue(t);
+	}
       final_blocker = new_final_blocker;
     }
 
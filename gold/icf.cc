@@ -152,6 +152,17 @@
 // identical and can be folded.
 //
 //
+// Threads :
+// -------
+//
+// The expensive part of the first iteration, reading each candidate
+// section and its relocations and checksumming them, is done by one
+// task per object.  The iterations themselves only recompute the
+// relocations to foldable sections and run in a single task, in the
+// same order as before, so the result does not depend on the number
+// of threads.
+//
+//
 // How to run  : --icf=[safe|all|none]
 // Optional parameters : --icf-iterations <num> --print-icf-sections
 //
@@ -167,6 +178,7 @@
 #include "demangle.h"
 #include "elfcpp.h"
 #include "int_encoding.h"
+#include "workqueue.h"
 
 #include <limits>
 
@@ -177,52 +189,26 @@ namespace gold
 // sections has unique contents.  Such unique sections or groups can be
 // declared final and need not be processed any further.
 // Parameters :
-// ID_SECTION : Vector mapping a section index to a Section_id pair.
+// CKSUMS : Checksum of each section's text and relocs to sections that
+//          cannot be folded.  Before the first iteration of icf, this is
+//          the checksum of the section's text alone.
 // IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
 //                            sections is already known to be unique.
-// SECTION_CONTENTS : Contains the section's text and relocs to sections
-//                    that cannot be folded.   SECTION_CONTENTS are NULL
-//                    implies that this function is being called for the
-//                    first time before the first iteration of icf.
 
 static void
-preprocess_for_unique_sections(const std::vector<Section_id>& id_section,
-                               std::vector<bool>* is_secn_or_group_unique,
-                               std::vector<std::string>* section_contents)
+preprocess_for_unique_sections(const std::vector<uint32_t>& cksums,
+                               std::vector<bool>* is_secn_or_group_unique)
 {
   Unordered_map<uint32_t, unsigned int> uniq_map;
   std::pair<Unordered_map<uint32_t, unsigned int>::iterator, bool>
     uniq_map_insert;
 
-  for (unsigned int i = 0; i < id_section.size(); i++)
+  for (unsigned int i = 0; i < cksums.size(); i++)
     {
       if ((*is_secn_or_group_unique)[i])
         continue;
 
-      uint32_t cksum;
-      Section_id secn = id_section[i];
-      section_size_type plen;
-      if (section_contents == NULL)
-        {
-          // Lock the object so we can read from it.  This is only called
-          // single-threaded from queue_middle_tasks, so it is OK to lock.
-          // Unfortunately we have no way to pass in a Task token.
-          const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-          Task_lock_obj<Object> tl(dummy_task, secn.first);
-          const unsigned char* contents;
-          contents = secn.first->section_contents(secn.second,
-                                                  &plen,
-                                                  false);
-          cksum = xcrc32(contents, plen, 0xffffffff);
-        }
-      else
-        {
-          const unsigned char* contents_array = reinterpret_cast
-            <const unsigned char*>((*section_contents)[i].c_str());
-          cksum = xcrc32(contents_array, (*section_contents)[i].length(),
-                         0xffffffff);
-        }
-      uniq_map_insert = uniq_map.insert(std::make_pair(cksum, i));
+      uniq_map_insert = uniq_map.insert(std::make_pair(cksums[i], i));
       if (uniq_map_insert.second)
         {
           (*is_secn_or_group_unique)[i] = true;
@@ -293,6 +279,9 @@ get_rel_addend(const unsigned char* reloc_addend_ptr,
 // NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
 //                      to ICF sections.
 // KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
+// DEFERRED           : If not NULL, only the object of SECN may be read.
+//                      If the contents depend on another object, this
+//                      is set to true and nothing is returned.
 // START_OFFSET       : Only consider the part of the section at and after
 //                      this offset.
 // END_OFFSET         : Only consider the part of the section before this
@@ -306,6 +295,7 @@ get_section_contents(bool first_iteration,
                      unsigned int* num_tracked_relocs,
                      Symbol_table* symtab,
                      const std::vector<unsigned int>& kept_section_id,
+		     bool* deferred,
 		     section_offset_type start_offset = 0,
 		     section_offset_type end_offset =
 		       std::numeric_limits<section_offset_type>::max())
@@ -473,6 +463,12 @@ get_section_contents(bool first_iteration,
               if ((secn_flags & elfcpp::SHF_MERGE) != 0
 		  && parameters->target().can_icf_inline_merge_sections())
                 {
+		  if (deferred != NULL && it_v->first != secn.first)
+		    {
+		      *deferred = true;
+		      return std::string();
+		    }
+
                   uint64_t entsize =
                     (it_v->first)->section_entsize(it_v->second);
 		  long long offset = it_a->first;
@@ -616,13 +612,21 @@ get_section_contents(bool first_iteration,
   for (Icf::Extra_identity_list::const_iterator it_ext = extra_range.first;
        it_ext != extra_range.second; ++it_ext)
     {
+      if (deferred != NULL && it_ext->second.section.first != secn.first)
+	{
+	  *deferred = true;
+	  return std::string();
+	}
+
       std::string external_fixed;
       std::string external_all =
 	get_section_contents(first_iteration, &external_fixed,
 			     it_ext->second.section, self_secn,
 			     num_tracked_relocs, symtab,
-			     kept_section_id, it_ext->second.offset,
+			     kept_section_id, deferred, it_ext->second.offset,
 			     it_ext->second.offset + it_ext->second.length);
+      if (deferred != NULL && *deferred)
+	return std::string();
       buffer.append(external_fixed);
       icf_reloc_buffer.append(external_all, external_fixed.length(),
 			      std::string::npos);
@@ -661,38 +665,36 @@ get_section_contents(bool first_iteration,
 //
 // Parameters  :
 // ITERATION_NUM           : Invocation instance of this function.
-// NUM_TRACKED_RELOCS : Vector reference to store the number of relocs
+// NUM_TRACKED_RELOCS : Vector reference to the number of relocs
 //                      to ICF sections.
 // KEPT_SECTION_ID    : Vector which maps folded sections to kept sections.
 // ID_SECTION         : Vector mapping a section to an unique integer.
 // IS_SECN_OR_GROUP_UNIQUE : To check if a section or a group of identical
 //                            sections is already known to be unique.
-// SECTION_CONTENTS   : Store the section's text and relocs to non-ICF
-//                      sections.
+// SECTION_CONTENTS   : The section's text and relocs to non-ICF
+//                      sections, as computed before the first iteration.
+// FIXED_CKSUMS       : The checksums of SECTION_CONTENTS.
 
 static bool
 match_sections(unsigned int iteration_num,
                Symbol_table* symtab,
-               std::vector<unsigned int>* num_tracked_relocs,
+               const std::vector<unsigned int>& num_tracked_relocs,
                std::vector<unsigned int>* kept_section_id,
                const std::vector<Section_id>& id_section,
 	       const std::vector<uint64_t>& section_addraligns,
                std::vector<bool>* is_secn_or_group_unique,
-               std::vector<std::string>* section_contents)
+               std::vector<std::string>* section_contents,
+               const std::vector<uint32_t>& fixed_cksums)
 {
   Unordered_multimap<uint32_t, unsigned int> section_cksum;
   std::pair<Unordered_multimap<uint32_t, unsigned int>::iterator,
             Unordered_multimap<uint32_t, unsigned int>::iterator> key_range;
   bool converged = true;
 
-  if (iteration_num == 1)
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   NULL);
-  else
-    preprocess_for_unique_sections(id_section,
-                                   is_secn_or_group_unique,
-                                   section_contents);
+  // Before the first iteration, this was done with the checksums of the
+  // text alone.
+  if (iteration_num != 1)
+    preprocess_for_unique_sections(fixed_cksums, is_secn_or_group_unique);
 
   std::vector<std::string> full_section_contents;
 
@@ -703,40 +705,25 @@ match_sections(unsigned int iteration_num,
         continue;
 
       Section_id secn = id_section[i];
-
-      // Lock the object so we can read from it.  This is only called
-      // single-threaded from queue_middle_tasks, so it is OK to lock.
-      // Unfortunately we have no way to pass in a Task token.
-      const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-      Task_lock_obj<Object> tl(dummy_task, secn.first);
-
-      std::string this_secn_contents;
       uint32_t cksum;
       std::string* this_secn_cache = &((*section_contents)[i]);
-      if (iteration_num == 1)
+      if (iteration_num != 1 && (*kept_section_id)[i] != i)
         {
-          unsigned int num_relocs = 0;
-          this_secn_contents = get_section_contents(true, this_secn_cache,
-						    secn, secn, &num_relocs,
-						    symtab, (*kept_section_id));
-          (*num_tracked_relocs)[i] = num_relocs;
-        }
-      else
-        {
-          if ((*kept_section_id)[i] != i)
-            {
-              // This section is already folded into something.
-              continue;
-            }
-          this_secn_contents = get_section_contents(false, this_secn_cache,
-						    secn, secn, NULL,
-						    symtab, (*kept_section_id));
+          // This section is already folded into something.
+          continue;
         }
+      std::string this_secn_contents =
+        get_section_contents(false, this_secn_cache, secn, secn, NULL,
+                             symtab, (*kept_section_id), NULL);
 
+      // The contents start with the cached part, whose checksum is
+      // already known.
       const unsigned char* this_secn_contents_array =
             reinterpret_cast<const unsigned char*>(this_secn_contents.c_str());
-      cksum = xcrc32(this_secn_contents_array, this_secn_contents.length(),
-                     0xffffffff);
+      size_t fixed_length = this_secn_cache->length();
+      cksum = xcrc32(this_secn_contents_array + fixed_length,
+                     this_secn_contents.length() - fixed_length,
+                     fixed_cksums[i]);
       size_t count = section_cksum.count(cksum);
 
       if (count == 0)
@@ -791,7 +778,7 @@ match_sections(unsigned int iteration_num,
         }
       // If there are no relocs to foldable sections do not process
       // this section any further.
-      if (iteration_num == 1 && (*num_tracked_relocs)[i] == 0)
+      if (iteration_num == 1 && num_tracked_relocs[i] == 0)
         (*is_secn_or_group_unique)[i] = true;
     }
 
@@ -943,19 +930,116 @@ Icf::add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
   return true;
 }
 
+// A task which runs a step of find_identical_sections for the
+// candidate sections of one object.  The object is locked while the
+// task runs.
+
+class Icf_task : public Task
+{
+ public:
+  Icf_task(Icf::Step step, Symbol_table* symtab,
+	   const Icf::Object_candidates& candidates, Task_token* blocker)
+    : step_(step), symtab_(symtab), candidates_(candidates),
+      blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->candidates_.object->is_locked())
+      return this->candidates_.object->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->blocker_);
+    Task_token* token = this->candidates_.object->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    this->symtab_->icf()->run_step(this->step_, this->symtab_,
+				   this->candidates_.first,
+				   this->candidates_.last);
+    this->candidates_.object->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Icf_task " + this->candidates_.object->name(); }
+
+ private:
+  Icf::Step step_;
+  Symbol_table* symtab_;
+  Icf::Object_candidates candidates_;
+  Task_token* blocker_;
+};
+
+// This runs after the tasks for a step of find_identical_sections.
+// After the contents have been checksummed, it finds the unique
+// sections and queues the tasks which compute the contents of the
+// others.  After that, it forms the groups of identical sections and
+// then runs the runner passed to find_identical_sections.
+
+class Icf_runner : public Task_function_runner
+{
+ public:
+  Icf_runner(Icf::Step step, Symbol_table* symtab,
+	     Task_function_runner* next)
+    : step_(step), symtab_(symtab), next_(next)
+  { }
+
+  ~Icf_runner()
+  { delete this->next_; }
+
+  void
+  run(Workqueue* workqueue, const Task* task)
+  {
+    Icf* icf = this->symtab_->icf();
+    Task_function_runner* next = this->next_;
+    this->next_ = NULL;
+    if (this->step_ == Icf::CHECKSUM_CONTENTS)
+      {
+	// Sections with unique contents need not be processed any
+	// further.
+	preprocess_for_unique_sections(icf->contents_cksum_,
+				       &icf->is_secn_or_group_unique_);
+	icf->queue_step(Icf::COMPUTE_CONTENTS, this->symtab_, workqueue,
+			next);
+      }
+    else
+      {
+	icf->match_identical_sections(task, this->symtab_);
+	next->run(workqueue, task);
+	delete next;
+      }
+  }
+
+ private:
+  Icf::Step step_;
+  Symbol_table* symtab_;
+  Task_function_runner* next_;
+};
+
 // This is the main ICF function called in gold.cc.  This does the
-// initialization and calls match_sections repeatedly (thrice by default)
-// which computes the crc checksums and detects identical functions.
+// initialization and queues the tasks which checksum the candidate
+// sections.  match_identical_sections then calls match_sections
+// repeatedly (thrice by default) to detect identical functions.
 
 void
-Icf::find_identical_sections(const Input_objects* input_objects,
-                             Symbol_table* symtab)
+Icf::find_identical_sections(const Task* task,
+                             const Input_objects* input_objects,
+                             Symbol_table* symtab, Workqueue* workqueue,
+                             Task_function_runner* next)
 {
   unsigned int section_num = 0;
-  std::vector<unsigned int> num_tracked_relocs;
-  std::vector<uint64_t> section_addraligns;
-  std::vector<bool> is_secn_or_group_unique;
-  std::vector<std::string> section_contents;
   const Target& target = parameters->target();
 
   // Decide which sections are possible candidates first.
@@ -964,12 +1048,9 @@ Icf::find_identical_sections(const Input_objects* input_objects,
        p != input_objects->relobj_end();
        ++p)
     {
-      // Lock the object so we can read from it.  This is only called
-      // single-threaded from queue_middle_tasks, so it is OK to lock.
-      // Unfortunately we have no way to pass in a Task token.
-      const Task* dummy_task = reinterpret_cast<const Task*>(-1);
-      Task_lock_obj<Object> tl(dummy_task, *p);
+      Task_lock_obj<Object> tl(task, *p);
       std::vector<unsigned int> eh_frame_ind;
+      unsigned int first_section_num = section_num;
 
       for (unsigned int i = 0; i < (*p)->shnum(); ++i)
         {
@@ -999,13 +1080,14 @@ Icf::find_identical_sections(const Input_objects* input_objects,
           this->id_section_.push_back(Section_id(*p, i));
           this->section_id_[Section_id(*p, i)] = section_num;
           this->kept_section_id_.push_back(section_num);
-          num_tracked_relocs.push_back(0);
-	  section_addraligns.push_back((*p)->section_addralign(i));
-          is_secn_or_group_unique.push_back(false);
-          section_contents.push_back("");
+	  this->section_addraligns_.push_back((*p)->section_addralign(i));
           section_num++;
         }
 
+      if (section_num > first_section_num)
+	this->object_candidates_.push_back(
+	    Object_candidates(*p, first_section_num, section_num));
+
       for (std::vector<unsigned int>::iterator it_eh_ind = eh_frame_ind.begin();
 	   it_eh_ind != eh_frame_ind.end(); ++it_eh_ind)
 	{
@@ -1032,6 +1114,116 @@ Icf::find_identical_sections(const Input_objects* input_objects,
 	}
     }
 
+  // The tasks only write to their own elements of these.
+  this->num_tracked_relocs_.resize(section_num, 0);
+  this->is_secn_or_group_unique_.resize(section_num, false);
+  this->section_contents_.resize(section_num);
+  this->contents_cksum_.resize(section_num, 0);
+  this->fixed_cksum_.resize(section_num, 0);
+  this->is_contents_deferred_.resize(section_num, 0);
+
+  this->queue_step(CHECKSUM_CONTENTS, symtab, workqueue, next);
+}
+
+// Queue an Icf_task for STEP for each object with candidate sections,
+// followed by an Icf_runner which continues with the next step.
+
+void
+Icf::queue_step(Step step, Symbol_table* symtab, Workqueue* workqueue,
+		Task_function_runner* next)
+{
+  Task_token* blocker = new Task_token(true);
+  for (std::vector<Object_candidates>::const_iterator p =
+	 this->object_candidates_.begin();
+       p != this->object_candidates_.end();
+       ++p)
+    {
+      if (step == COMPUTE_CONTENTS)
+	{
+	  // Skip objects whose sections are all unique.
+	  unsigned int i = p->first;
+	  while (i < p->last && this->is_secn_or_group_unique_[i])
+	    ++i;
+	  if (i == p->last)
+	    continue;
+	}
+
+      blocker->add_blocker();
+      workqueue->queue(new Icf_task(step, symtab, *p, blocker));
+    }
+
+  workqueue->queue(new Task_function(new Icf_runner(step, symtab, next),
+				     blocker, "Task_function Icf_runner"));
+}
+
+// Run STEP for the candidate sections FIRST to LAST - 1, which all
+// belong to one object.  That object is locked.
+
+void
+Icf::run_step(Step step, Symbol_table* symtab, unsigned int first,
+	      unsigned int last)
+{
+  for (unsigned int i = first; i < last; ++i)
+    {
+      const Section_id& secn = this->id_section_[i];
+
+      if (step == CHECKSUM_CONTENTS)
+	{
+	  section_size_type plen;
+	  const unsigned char* contents =
+	    secn.first->section_contents(secn.second, &plen, false);
+	  this->contents_cksum_[i] = xcrc32(contents, plen, 0xffffffff);
+	  continue;
+	}
+
+      if (this->is_secn_or_group_unique_[i])
+	continue;
+
+      bool deferred = false;
+      unsigned int num_relocs = 0;
+      get_section_contents(true, &this->section_contents_[i], secn, secn,
+			   &num_relocs, symtab, this->kept_section_id_,
+			   &deferred);
+      if (deferred)
+	{
+	  // match_identical_sections will do this.
+	  this->is_contents_deferred_[i] = 1;
+	  continue;
+	}
+
+      const std::string& fixed = this->section_contents_[i];
+      this->num_tracked_relocs_[i] = num_relocs;
+      this->fixed_cksum_[i] =
+	xcrc32(reinterpret_cast<const unsigned char*>(fixed.c_str()),
+	       fixed.length(), 0xffffffff);
+    }
+}
+
+// Form the groups of identical sections, once the candidate sections
+// have been processed by the tasks.
+
+void
+Icf::match_identical_sections(const Task* task, Symbol_table* symtab)
+{
+  // Compute the contents of the sections which refer to data in other
+  // objects.
+  for (unsigned int i = 0; i < this->id_section_.size(); ++i)
+    {
+      if (!this->is_contents_deferred_[i])
+	continue;
+
+      const Section_id& secn = this->id_section_[i];
+      Task_lock_obj<Object> tl(task, secn.first);
+      unsigned int num_relocs = 0;
+      get_section_contents(true, &this->section_contents_[i], secn, secn,
+			   &num_relocs, symtab, this->kept_section_id_, NULL);
+      const std::string& fixed = this->section_contents_[i];
+      this->num_tracked_relocs_[i] = num_relocs;
+      this->fixed_cksum_[i] =
+	xcrc32(reinterpret_cast<const unsigned char*>(fixed.c_str()),
+	       fixed.length(), 0xffffffff);
+    }
+
   unsigned int num_iterations = 0;
 
   // Default number of iterations to run ICF is 3.
@@ -1045,9 +1237,12 @@ Icf::find_identical_sections(const Input_objects* input_objects,
     {
       num_iterations++;
       converged = match_sections(num_iterations, symtab,
-                                 &num_tracked_relocs, &this->kept_section_id_,
-                                 this->id_section_, section_addraligns,
-                                 &is_secn_or_group_unique, &section_contents);
+                                 this->num_tracked_relocs_,
+                                 &this->kept_section_id_,
+                                 this->id_section_, this->section_addraligns_,
+                                 &this->is_secn_or_group_unique_,
+                                 &this->section_contents_,
+                                 this->fixed_cksum_);
     }
 
   if (parameters->options().print_icf_sections())
@@ -1086,6 +1281,16 @@ Icf::find_identical_sections(const Input_objects* input_objects,
 
     }
 
+  // Release the memory used while finding identical sections.
+  std::vector<Object_candidates>().swap(this->object_candidates_);
+  std::vector<unsigned int>().swap(this->num_tracked_relocs_);
+  std::vector<uint64_t>().swap(this->section_addraligns_);
+  std::vector<bool>().swap(this->is_secn_or_group_unique_);
+  std::vector<std::string>().swap(this->section_contents_);
+  std::vector<uint32_t>().swap(this->contents_cksum_);
+  std::vector<uint32_t>().swap(this->fixed_cksum_);
+  std::vector<unsigned char>().swap(this->is_contents_deferred_);
+
   this->icf_ready();
 }
 
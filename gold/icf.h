@@ -35,6 +35,9 @@ namespace gold
 class Object;
 class Input_objects;
 class Symbol_table;
+class Task;
+class Task_function_runner;
+class Workqueue;
 
 class Icf
 {
@@ -81,7 +84,9 @@ class Icf
   : id_section_(), section_id_(), kept_section_id_(),
     fptr_section_id_(),
     icf_ready_(false),
-    reloc_info_list_()
+    reloc_info_list_(), object_candidates_(), num_tracked_relocs_(),
+    section_addraligns_(), is_secn_or_group_unique_(), section_contents_(),
+    contents_cksum_(), fixed_cksum_(), is_contents_deferred_()
   { }
 
   // Returns the kept folded identical section corresponding to
@@ -90,10 +95,15 @@ class Icf
   get_folded_section(Relobj* dup_obj, unsigned int dup_shndx);
 
   // Forms groups of identical sections where the first member
-  // of each group is the kept section during folding.
+  // of each group is the kept section during folding.  The candidate
+  // sections are checksummed by tasks queued on WORKQUEUE, and NEXT
+  // is run once the groups have been formed.  TASK is the running
+  // task.
   void
-  find_identical_sections(const Input_objects* input_objects,
-                          Symbol_table* symtab);
+  find_identical_sections(const Task* task,
+                          const Input_objects* input_objects,
+                          Symbol_table* symtab, Workqueue* workqueue,
+                          Task_function_runner* next);
 
   // This is set when ICF has been run and the groups of
   // identical sections have been formed.
@@ -162,11 +172,51 @@ class Icf
   { return this->section_id_; }
 
  private:
+  friend class Icf_task;
+  friend class Icf_runner;
+
+  // The steps of find_identical_sections that run in parallel, one
+  // task per object.
+  enum Step
+  {
+    // Checksum the contents of the candidate sections.
+    CHECKSUM_CONTENTS,
+    // Compute the contents and relocations of the candidate sections
+    // which are not known to be unique.
+    COMPUTE_CONTENTS
+  };
+
+  // The candidate sections of an object, which have consecutive ids.
+  struct Object_candidates
+  {
+    Object_candidates(Relobj* object_arg, unsigned int first_arg,
+		      unsigned int last_arg)
+      : object(object_arg), first(first_arg), last(last_arg)
+    { }
+
+    Relobj* object;
+    unsigned int first;
+    unsigned int last;
+  };
 
   bool
   add_ehframe_links(Relobj* object, unsigned int ehframe_shndx,
 		    Reloc_info& ehframe_relocs);
 
+  // Queue a task for STEP for each object, and then NEXT_STEP.
+  void
+  queue_step(Step step, Symbol_table* symtab, Workqueue* workqueue,
+	     Task_function_runner* next_step);
+
+  // Run STEP for the sections with ids FIRST to LAST - 1.
+  void
+  run_step(Step step, Symbol_table* symtab, unsigned int first,
+	   unsigned int last);
+
+  // Iterate until the groups of identical sections converge.
+  void
+  match_identical_sections(const Task* task, Symbol_table* symtab);
+
   // Maps integers to sections.
   std::vector<Section_id> id_section_;
   // Does the reverse.
@@ -186,6 +236,24 @@ class Icf
   // Regions of other sections that should be considered part of
   // each section for ICF purposes.
   Extra_identity_list extra_identity_list_;
+
+  // The rest is only used while finding identical sections, and is
+  // indexed by section id.  The tasks write to distinct elements.
+  std::vector<Object_candidates> object_candidates_;
+  // The number of relocs to ICF sections.
+  std::vector<unsigned int> num_tracked_relocs_;
+  std::vector<uint64_t> section_addraligns_;
+  std::vector<bool> is_secn_or_group_unique_;
+  // The part of each section's text and relocs which does not change
+  // from iteration to iteration.
+  std::vector<std::string> section_contents_;
+  // Checksum of the raw contents of each section.
+  std::vector<uint32_t> contents_cksum_;
+  // Checksum of SECTION_CONTENTS_.
+  std::vector<uint32_t> fixed_cksum_;
+  // Nonzero for the sections which refer to data in other objects, so
+  // that their contents could not be computed in parallel.
+  std::vector<unsigned char> is_contents_deferred_;
 };
 
 // This function returns true if this section corresponds to a function that
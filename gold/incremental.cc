@@ -696,6 +696,10 @@ Sized_incremental_binary<size, big_endian>::do_process_got_plt(
   for (unsigned int i = 0; i < plt_count; ++i)
     {
       unsigned int plt_desc = got_plt_reader.get_plt_desc(i);
+      // The PLT entries for local IFUNC symbols have no descriptor.
+      if (plt_desc == 0)
+	gold_fallback(_("local IFUNC symbol has a PLT entry;"
+			" relink with --incremental-full"));
       // FIXME: This should really be a fatal error (corrupt input).
       gold_assert(plt_desc >= first_global && plt_desc < symtab_count);
       Symbol* sym = this->global_symbol(plt_desc - first_global);
@@ -1819,10 +1823,6 @@ struct Got_plt_view_info
   unsigned int got_count;
   // Number of PLT entries.
   unsigned int plt_count;
-  // Offset of the first non-reserved PLT entry (this is a target-dependent value).
-  unsigned int first_plt_entry_offset;
-  // Size of a PLT entry (this is a target-dependent value).
-  unsigned int plt_entry_size;
   // Size of a GOT entry (this is a target-dependent value).
   unsigned int got_entry_size;
   // Symbol index to write in the GOT descriptor array.  For global symbols,
@@ -1905,8 +1905,9 @@ template<int size, bool big_endian>
 class Global_symbol_visitor_got_plt
 {
  public:
-  Global_symbol_visitor_got_plt(struct Got_plt_view_info& info)
-    : info_(info)
+  Global_symbol_visitor_got_plt(struct Got_plt_view_info& info,
+				const Sized_target<size, big_endian>* target)
+    : info_(info), target_(target)
   { }
 
   void
@@ -1923,9 +1924,7 @@ class Global_symbol_visitor_got_plt
       }
     if (sym->has_plt_offset())
       {
-	unsigned int plt_index =
-	    ((sym->plt_offset() - this->info_.first_plt_entry_offset)
-	     / this->info_.plt_entry_size);
+	unsigned int plt_index = this->target_->plt_entry_index(sym);
 	gold_assert(plt_index < this->info_.plt_count);
 	unsigned char* pov = this->info_.plt_desc_p + plt_index * 4;
 	elfcpp::Swap<32, big_endian>::writeval(pov, sym->symtab_index());
@@ -1934,6 +1933,7 @@ class Global_symbol_visitor_got_plt
 
  private:
   struct Got_plt_view_info& info_;
+  const Sized_target<size, big_endian>* target_;
 };
 
 // Write the contents of the .gnu_incremental_got_plt section.
@@ -1951,8 +1951,6 @@ Output_section_incremental_inputs<size, big_endian>::write_got_plt(
   struct Got_plt_view_info view_info;
   view_info.got_count = target->got_entry_count();
   view_info.plt_count = target->plt_entry_count();
-  view_info.first_plt_entry_offset = target->first_plt_entry_offset();
-  view_info.plt_entry_size = target->plt_entry_size();
   view_info.got_entry_size = target->got_entry_size();
   view_info.got_type_p = pov + 8;
   view_info.got_desc_p = (view_info.got_type_p
@@ -1990,7 +1988,8 @@ Output_section_incremental_inputs<size, big_endian>::write_got_plt(
 
   // Write the incremental GOT and PLT descriptors for global symbols.
   typedef Global_symbol_visitor_got_plt<size, big_endian> Symbol_visitor;
-  symtab_->for_all_symbols<size, Symbol_visitor>(Symbol_visitor(view_info));
+  symtab_->for_all_symbols<size, Symbol_visitor>(Symbol_visitor(view_info,
+								 target));
 }
 
 // Class Sized_relobj_incr.  Most of these methods are not used for
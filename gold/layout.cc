@@ -451,6 +451,7 @@ Layout::Layout(int number_of_input_files, Script_options* script_options)
     build_id_note_(NULL),
     debug_abbrev_(NULL),
     debug_info_(NULL),
+    compressed_sections_(),
     group_signatures_(),
     output_file_size_(-1),
     have_added_input_section_(false),
@@ -1620,8 +1621,8 @@ Layout::remove_eh_frame_for_plt(Output_data* plt, const unsigned char* cie_data,
   this->eh_frame_data_->remove_ehframe_for_plt(plt, cie_data, cie_length);
 }
 
-// Scan a .debug_info or .debug_types section, and add summary
-// information to the .gdb_index section.
+// Add a .debug_info or .debug_types section to be scanned for
+// summary information for the .gdb_index section.
 
 template<int size, bool big_endian>
 void
@@ -1647,9 +1648,9 @@ Layout::add_to_gdb_index(bool is_type_unit,
       os->set_after_input_sections();
     }
 
-  this->gdb_index_data_->scan_debug_info(is_type_unit, object, symbols,
-					 symbols_size, shndx, reloc_shndx,
-					 reloc_type);
+  this->gdb_index_data_->add_debug_info(is_type_unit, object, symbols,
+					symbols_size, shndx, reloc_shndx,
+					reloc_type);
 }
 
 // Add POSD to an output section using NAME, TYPE, and FLAGS.  Return
@@ -1696,8 +1697,13 @@ Layout::make_output_section(const char* name, elfcpp::Elf_Word type,
   if ((flags & elfcpp::SHF_ALLOC) == 0
       && strcmp(parameters->options().compress_debug_sections(), "none") != 0
       && is_compressible_debug_section(name))
-    os = new Output_compressed_section(&parameters->options(), name, type,
-				       flags);
+    {
+      Output_compressed_section* cos =
+	new Output_compressed_section(&parameters->options(), name, type,
+				      flags);
+      this->compressed_sections_.push_back(cos);
+      os = cos;
+    }
   else if ((flags & elfcpp::SHF_ALLOC) == 0
 	   && parameters->options().strip_debug_non_line()
 	   && strcmp(".debug_abbrev", name) == 0)
@@ -6141,6 +6147,35 @@ Build_id_task_runner::run(Workqueue* workqueue, const Task*)
 				     "Task_function Close_task_runner"));
 }
 
+// Compress_sections_task_runner methods.
+
+// Queue a task for each chunk of each compressed debug section, and
+// then queue the task which writes the sections out once the chunks
+// have been compressed.
+
+void
+Compress_sections_task_runner::run(Workqueue* workqueue, const Task*)
+{
+  const Layout::Compressed_section_list& sections =
+    this->layout_->compressed_sections();
+
+  Task_token* compress_blocker = new Task_token(true);
+  for (Layout::Compressed_section_list::const_iterator p = sections.begin();
+       p != sections.end();
+       ++p)
+    compress_blocker->add_blockers((*p)->prepare_chunks());
+
+  for (Layout::Compressed_section_list::const_iterator p = sections.begin();
+       p != sections.end();
+       ++p)
+    (*p)->queue_chunk_tasks(workqueue, compress_blocker);
+
+  workqueue->queue(new Write_after_input_sections_task(this->layout_,
+						       this->of_,
+						       compress_blocker,
+						       this->final_blocker_));
+}
+
 // Close_task_runner methods.
 
 // Finish up the build ID computation, if necessary, and write a binary file,
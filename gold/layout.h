@@ -57,6 +57,7 @@ class Output_data_dynamic;
 class Output_symtab_xindex;
 class Output_reduced_debug_abbrev_section;
 class Output_reduced_debug_info_section;
+class Output_compressed_section;
 class Eh_frame;
 class Gdb_index;
 class Target;
@@ -679,8 +680,8 @@ class Layout
   remove_eh_frame_for_plt(Output_data* plt, const unsigned char* cie_data,
 			  size_t cie_length);
 
-  // Scan a .debug_info or .debug_types section, and add summary
-  // information to the .gdb_index section.
+  // Add a .debug_info or .debug_types section to be scanned for
+  // summary information for the .gdb_index section.
   template<int size, bool big_endian>
   void
   add_to_gdb_index(bool is_type_unit,
@@ -691,6 +692,11 @@ class Layout
 		   unsigned int reloc_shndx,
 		   unsigned int reloc_type);
 
+  // Return the .gdb_index section data, or NULL if there is none.
+  Gdb_index*
+  gdb_index_data() const
+  { return this->gdb_index_data_; }
+
   // Handle a GNU stack note.  This is called once per input object
   // file.  SEEN_GNU_STACK is true if the object file has a
   // .note.GNU-stack section.  GNU_STACK_FLAGS is the section flags
@@ -846,6 +852,14 @@ class Layout
   any_postprocessing_sections() const
   { return this->any_postprocessing_sections_; }
 
+  // The list of compressed debug output sections.
+  typedef std::vector<Output_compressed_section*> Compressed_section_list;
+
+  // Return the compressed debug output sections.
+  const Compressed_section_list&
+  compressed_sections() const
+  { return this->compressed_sections_; }
+
   // Return the size of the output file.
   off_t
   output_file_size() const
@@ -1452,6 +1466,8 @@ class Layout
   Output_reduced_debug_abbrev_section* debug_abbrev_;
   // The output section containing the dwarf debug info tree
   Output_reduced_debug_info_section* debug_info_;
+  // The compressed debug output sections.
+  Compressed_section_list compressed_sections_;
   // A list of group sections and their signatures.
   Group_signatures group_signatures_;
   // The size of the output file.
@@ -1692,6 +1708,30 @@ class Build_id_task_runner : public Task_function_runner
   Output_file* of_;
 };
 
+// This task function runs when --compress-debug-sections and
+// --threads are used.  It queues tasks which compress the contents of
+// the debug sections in parallel, and then queues
+// Write_after_input_sections_task, which assembles the compressed
+// sections and writes them out.
+
+class Compress_sections_task_runner : public Task_function_runner
+{
+ public:
+  Compress_sections_task_runner(Layout* layout, Output_file* of,
+				Task_token* final_blocker)
+    : layout_(layout), of_(of), final_blocker_(final_blocker)
+  { }
+
+  // Run the operation.
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  Layout* layout_;
+  Output_file* of_;
+  Task_token* final_blocker_;
+};
+
 // This task function handles closing the file.
 
 class Close_task_runner : public Task_function_runner
@@ -27,6 +27,7 @@
 
 #include "merge.h"
 #include "compressed_output.h"
+#include "layout.h"
 
 namespace gold
 {
@@ -431,13 +432,120 @@ Output_merge_data::do_print_merge_stats(const char* section_name)
 
 // Class Output_merge_string.
 
-// Add an input section to a merged string section.
+// The number of String_shards to use when running with threads.
+
+const unsigned int merge_string_shard_count = 32;
+
+template<typename Char_type>
+Output_merge_string<Char_type>::String_shard::String_shard(uint64_t addralign)
+  : lock(new Lock()), stringpool(addralign), strings()
+{
+  this->stringpool.set_no_zero_null();
+}
+
+template<typename Char_type>
+Output_merge_string<Char_type>::String_shard::~String_shard()
+{
+  delete this->lock;
+}
+
+template<typename Char_type>
+Output_merge_string<Char_type>::Output_merge_string(uint64_t addralign)
+  : Output_merge_base(sizeof(Char_type), addralign), shards_(),
+    merged_strings_lists_(), object_lists_(), optimize_(false),
+    output_size_(0), input_count_(0), input_size_(0)
+{
+  unsigned int shard_count = 1;
+  if (parameters->options_valid())
+    {
+      if (parameters->options().threads())
+	shard_count = merge_string_shard_count;
+      // This is the same test as in the Stringpool constructor.
+      if (parameters->options().optimize() >= 2
+	  && addralign <= sizeof(Char_type))
+	this->optimize_ = true;
+    }
+  this->shards_.reserve(shard_count);
+  for (unsigned int i = 0; i < shard_count; ++i)
+    this->shards_.push_back(new String_shard(addralign));
+}
+
+template<typename Char_type>
+Output_merge_string<Char_type>::~Output_merge_string()
+{
+  for (typename Merged_strings_lists::iterator p =
+	 this->merged_strings_lists_.begin();
+       p != this->merged_strings_lists_.end();
+       ++p)
+    delete *p;
+  for (typename std::vector<String_shard*>::iterator p = this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    delete *p;
+}
+
+// Add an input section to a merged string section.  We only check
+// the size here; the strings are read by do_add_input_strings.
 
 template<typename Char_type>
 bool
 Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 						     unsigned int shndx)
 {
+  section_size_type sec_len;
+  if (!object->section_is_compressed(shndx, &sec_len))
+    sec_len = convert_to_section_size_type(object->section_size(shndx));
+
+  if (sec_len % sizeof(Char_type) != 0)
+    {
+      object->error(_("mergeable string section length not multiple of "
+		      "character size"));
+      return false;
+    }
+
+  Merged_strings_list* merged_strings_list =
+      new Merged_strings_list(object, shndx);
+  this->merged_strings_lists_.push_back(merged_strings_list);
+  this->object_lists_[object].push_back(merged_strings_list);
+
+  // For script processing, we keep the input sections.
+  if (this->keeps_input_sections())
+    record_input_section(object, shndx);
+
+  return true;
+}
+
+// Read the strings of the input sections from OBJECT.  This is called
+// by a Merge_strings_task, so tasks for other objects may be running
+// at the same time.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::do_add_input_strings(Relobj* object)
+{
+  typename Object_lists::iterator p = this->object_lists_.find(object);
+  if (p == this->object_lists_.end())
+    return;
+
+  Pending_strings pending(this->shards_.size());
+  for (typename Merged_strings_lists::iterator l = p->second.begin();
+       l != p->second.end();
+       ++l)
+    this->read_input_section(*l, &pending);
+}
+
+// Read the strings of the input section for MERGED_STRINGS_LIST, and
+// add them to the String_shards.  PENDING is scratch space.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::read_input_section(
+    Merged_strings_list* merged_strings_list,
+    Pending_strings* pending)
+{
+  Relobj* object = merged_strings_list->object;
+  unsigned int shndx = merged_strings_list->shndx;
+
   section_size_type sec_len;
   bool is_new;
   uint64_t addralign = this->addralign();
@@ -450,15 +558,6 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   const Char_type* pend = p + sec_len / sizeof(Char_type);
   const Char_type* pend0 = pend;
 
-  if (sec_len % sizeof(Char_type) != 0)
-    {
-      object->error(_("mergeable string section length not multiple of "
-		      "character size"));
-      if (is_new)
-	delete[] pdata;
-      return false;
-    }
-
   if (pend[-1] != 0)
     {
       gold_warning(_("%s: last entry in mergeable string section '%s' "
@@ -470,9 +569,6 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 	--pend0;
     }
 
-  Merged_strings_list* merged_strings_list =
-      new Merged_strings_list(object, shndx);
-  this->merged_strings_lists_.push_back(merged_strings_list);
   Merged_strings& merged_strings = merged_strings_list->merged_strings;
 
   // Count the number of non-null strings in the section and size the list.
@@ -499,6 +595,7 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 				 & (addralign - 1));
   bool has_misaligned_strings = false;
 
+  const unsigned int shard_count = this->shards_.size();
   while (p < pend)
     {
       size_t len = p < pend0 ? string_length(p) : pend - p;
@@ -509,10 +606,12 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 	      != init_align_modulo))
 	  has_misaligned_strings = true;
 
-      Stringpool::Key key;
-      this->stringpool_.add_with_length(p, len, true, &key);
+      size_t hash_code = string_hash<Char_type>(p, len);
+      unsigned int shard = (hash_code ^ (hash_code >> 16)) % shard_count;
+      (*pending)[shard].push_back(Pending_string(merged_strings.size(), p,
+						 len, hash_code));
 
-      merged_strings.push_back(Merged_string(i, key));
+      merged_strings.push_back(Merged_string(i, 0));
       p += len + 1;
       i += (len + 1) * sizeof(Char_type);
     }
@@ -521,8 +620,32 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
   // compute the length of the last string.
   merged_strings.push_back(Merged_string(i, 0));
 
-  this->input_count_ += count;
-  this->input_size_ += i;
+  merged_strings_list->input_count = count;
+
+  // Add the strings to the String_shards, taking each lock once.
+  for (unsigned int shard = 0; shard < shard_count; ++shard)
+    {
+      std::vector<Pending_string>& strings((*pending)[shard]);
+      if (strings.empty())
+	continue;
+      String_shard* string_shard = this->shards_[shard];
+      Hold_lock hl(*string_shard->lock);
+      for (typename std::vector<Pending_string>::const_iterator ps =
+	     strings.begin();
+	   ps != strings.end();
+	   ++ps)
+	{
+	  Stringpool::Key key;
+	  const Char_type* str =
+	    string_shard->stringpool.add_with_hash(ps->string, ps->length,
+						   ps->hash_code, &key);
+	  if (key > string_shard->strings.size())
+	    string_shard->strings.push_back(Output_string(str, ps->length));
+	  merged_strings[ps->index].stringpool_key = this->make_key(key,
+								    shard);
+	}
+      strings.clear();
+    }
 
   if (has_misaligned_strings)
     gold_warning(_("%s: section %s contains incorrectly aligned strings;"
@@ -530,30 +653,106 @@ Output_merge_string<Char_type>::do_add_input_section(Relobj* object,
 		 object->name().c_str(),
 		 object->section_name(shndx).c_str());
 
-  // For script processing, we keep the input sections.
-  if (this->keeps_input_sections())
-    record_input_section(object, shndx);
-
   if (is_new)
     delete[] pdata;
+}
 
-  return true;
+// Comparison routine used when sorting for tail merging.  We want to
+// sort this so that when one string is a suffix of another, we always
+// see the shorter string immediately after the longer string.  This
+// is a reversed lexicographic sort on the reversed string, as in
+// Stringpool_template::set_string_offsets.
+
+template<typename Char_type>
+bool
+Output_merge_string<Char_type>::Output_string_comparison::operator()(
+    const Output_string* s1,
+    const Output_string* s2) const
+{
+  const size_t len1 = s1->length;
+  const size_t len2 = s2->length;
+  const size_t minlen = len1 < len2 ? len1 : len2;
+  const Char_type* p1 = s1->string + len1 - 1;
+  const Char_type* p2 = s2->string + len2 - 1;
+  for (size_t i = minlen; i > 0; --i, --p1, --p2)
+    {
+      if (*p1 != *p2)
+	return *p1 > *p2;
+    }
+  return len1 > len2;
+}
+
+// Assign offsets to all the strings, letting a string which is a
+// suffix of the previous one in sorted order share its storage.
+
+template<typename Char_type>
+void
+Output_merge_string<Char_type>::set_tail_merged_offsets()
+{
+  const size_t charsize = sizeof(Char_type);
+  const uint64_t addralign = this->addralign();
+
+  std::vector<Output_string*> v;
+  for (typename std::vector<String_shard*>::iterator p = this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    for (typename std::vector<Output_string>::iterator q =
+	   (*p)->strings.begin();
+	 q != (*p)->strings.end();
+	 ++q)
+      v.push_back(&*q);
+
+  std::sort(v.begin(), v.end(), Output_string_comparison());
+
+  section_offset_type offset = 0;
+  section_offset_type last_offset = -1;
+  for (typename std::vector<Output_string*>::iterator last = v.end(),
+	 curr = v.begin();
+       curr != v.end();
+       last = curr++)
+    {
+      section_offset_type this_offset;
+      if (last != v.end()
+	  && (((*curr)->length - (*last)->length) % addralign) == 0
+	  && (*curr)->length <= (*last)->length
+	  && memcmp((*curr)->string,
+		    (*last)->string + (*last)->length - (*curr)->length,
+		    (*curr)->length * charsize) == 0)
+	this_offset = (last_offset
+		       + ((*last)->length - (*curr)->length) * charsize);
+      else
+	{
+	  this_offset = align_address(offset, addralign);
+	  offset = this_offset + ((*curr)->length + 1) * charsize;
+	}
+      (*curr)->offset = this_offset;
+      last_offset = this_offset;
+    }
+
+  this->output_size_ = offset;
 }
 
 // Finalize the mappings from the input sections to the output
-// section, and return the final data size.
+// section, and return the final data size.  Unless we are tail
+// merging, the strings are laid out in the order in which they first
+// appear in the input sections.
 
 template<typename Char_type>
 section_size_type
 Output_merge_string<Char_type>::finalize_merged_data()
 {
-  this->stringpool_.set_string_offsets();
+  if (this->optimize_ && !this->merged_strings_lists_.empty())
+    this->set_tail_merged_offsets();
 
+  const uint64_t addralign = this->addralign();
   for (typename Merged_strings_lists::const_iterator l =
 	 this->merged_strings_lists_.begin();
        l != this->merged_strings_lists_.end();
        ++l)
     {
+      // All the input sections must have been read by now.
+      gold_assert(!(*l)->merged_strings.empty());
+
       section_offset_type last_input_offset = 0;
       section_offset_type last_output_offset = 0;
       Relobj *object = (*l)->object;
@@ -572,9 +771,20 @@ Output_merge_string<Char_type>::finalize_merged_data()
                                          last_output_offset);
 	  last_input_offset = p->offset;
 	  if (p->stringpool_key != 0)
-	    last_output_offset =
-	        this->stringpool_.get_offset_from_key(p->stringpool_key);
+	    {
+	      Output_string* os = this->output_string(p->stringpool_key);
+	      if (os->offset == -1)
+		{
+		  os->offset = align_address(this->output_size_, addralign);
+		  this->output_size_ = (os->offset
+					+ (os->length + 1) * sizeof(Char_type));
+		}
+	      last_output_offset = os->offset;
+	    }
 	}
+
+      this->input_count_ += (*l)->input_count;
+      this->input_size_ += last_input_offset;
       delete *l;
     }
 
@@ -582,8 +792,9 @@ Output_merge_string<Char_type>::finalize_merged_data()
   // if called twice, as may happen if Layout::set_segment_offsets
   // finds a better alignment.
   this->merged_strings_lists_.clear();
+  this->object_lists_.clear();
 
-  return this->stringpool_.get_strtab_size();
+  return this->output_size_;
 }
 
 template<typename Char_type>
@@ -600,7 +811,13 @@ template<typename Char_type>
 void
 Output_merge_string<Char_type>::do_write(Output_file* of)
 {
-  this->stringpool_.write(of, this->offset());
+  const off_t offset = this->offset();
+  const section_size_type size = this->output_size_;
+  if (size == 0)
+    return;
+  unsigned char* view = of->get_output_view(offset, size);
+  this->do_write_to_buffer(view);
+  of->write_output_view(offset, size, view);
 }
 
 // Write a merged string section to a buffer.
@@ -609,7 +826,21 @@ template<typename Char_type>
 void
 Output_merge_string<Char_type>::do_write_to_buffer(unsigned char* buffer)
 {
-  this->stringpool_.write_to_buffer(buffer, this->data_size());
+  for (typename std::vector<String_shard*>::const_iterator p =
+	 this->shards_.begin();
+       p != this->shards_.end();
+       ++p)
+    for (typename std::vector<Output_string>::const_iterator q =
+	   (*p)->strings.begin();
+	 q != (*p)->strings.end();
+	 ++q)
+      {
+	const section_size_type len = (q->length + 1) * sizeof(Char_type);
+	gold_assert(q->offset >= 0
+		    && static_cast<section_size_type>(q->offset) + len
+		       <= this->output_size_);
+	memcpy(buffer + q->offset, q->string, len);
+      }
 }
 
 // Return the name of the types of string to use with
@@ -656,7 +887,114 @@ Output_merge_string<Char_type>::do_print_merge_stats(const char* section_name)
 	  program_name, buf, this->input_size_);
   fprintf(stderr, _("%s: %s input strings: %zu\n"),
 	  program_name, buf, this->input_count_);
-  this->stringpool_.print_stats(buf);
+  if (this->shards_.size() == 1)
+    this->shards_[0]->stringpool.print_stats(buf);
+  else
+    {
+      size_t count = 0;
+      for (typename std::vector<String_shard*>::const_iterator p =
+	     this->shards_.begin();
+	   p != this->shards_.end();
+	   ++p)
+	count += (*p)->strings.size();
+      fprintf(stderr, _("%s: %s entries: %zu; stringpools: %zu\n"),
+	      program_name, buf, count, this->shards_.size());
+    }
+}
+
+// Read the strings of the merged string sections in one object.
+
+class Merge_strings_task : public Task
+{
+ public:
+  Merge_strings_task(Relobj* object,
+		     const std::vector<Output_merge_base*>& sections,
+		     Task_token* blocker)
+    : object_(object), sections_(sections), blocker_(blocker)
+  { }
+
+  // The standard Task methods.
+
+  Task_token*
+  is_runnable()
+  {
+    if (this->object_->is_locked())
+      return this->object_->token();
+    return NULL;
+  }
+
+  void
+  locks(Task_locker* tl)
+  {
+    tl->add(this, this->blocker_);
+    Task_token* token = this->object_->token();
+    if (token != NULL)
+      tl->add(this, token);
+  }
+
+  void
+  run(Workqueue*)
+  {
+    for (std::vector<Output_merge_base*>::const_iterator p =
+	   this->sections_.begin();
+	 p != this->sections_.end();
+	 ++p)
+      (*p)->add_input_strings(this->object_);
+    this->object_->release();
+  }
+
+  std::string
+  get_name() const
+  { return "Merge_strings_task " + this->object_->name(); }
+
+ private:
+  Relobj* object_;
+  std::vector<Output_merge_base*> sections_;
+  Task_token* blocker_;
+};
+
+// Class Merge_strings_runner.
+
+void
+Merge_strings_runner::run(Workqueue* workqueue, const Task* task)
+{
+  std::vector<Output_merge_base*> sections;
+  for (Layout::Section_list::const_iterator p =
+	 this->layout_->section_list().begin();
+       p != this->layout_->section_list().end();
+       ++p)
+    {
+      const Output_section::Input_section_list& input_sections =
+	(*p)->input_sections();
+      for (Output_section::Input_section_list::const_iterator q =
+	     input_sections.begin();
+	   q != input_sections.end();
+	   ++q)
+	if (q->is_merge_section() && q->output_merge_base()->is_string())
+	  sections.push_back(q->output_merge_base());
+    }
+
+  Task_function_runner* next = this->next_;
+  this->next_ = NULL;
+
+  if (sections.empty())
+    {
+      next->run(workqueue, task);
+      delete next;
+      return;
+    }
+
+  Task_token* blocker = new Task_token(true);
+  for (Input_objects::Relobj_iterator p = this->input_objects_->relobj_begin();
+       p != this->input_objects_->relobj_end();
+       ++p)
+    blocker->add_blocker();
+  for (Input_objects::Relobj_iterator p = this->input_objects_->relobj_begin();
+       p != this->input_objects_->relobj_end();
+       ++p)
+    workqueue->queue(new Merge_strings_task(*p, sections, blocker));
+
+  workqueue->queue(new Task_function(next, blocker, this->next_name_));
 }
 
 // Instantiate the templates we need.
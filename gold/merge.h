@@ -29,10 +29,14 @@
 
 #include "stringpool.h"
 #include "output.h"
+#include "workqueue.h"
 
 namespace gold
 {
 
+class Input_objects;
+class Layout;
+
 // For each object with merge sections, we store an Object_merge_map.
 // This is used to map locations in input sections to a merged output
 // section.  The output section itself is not recorded here--it can be
@@ -217,6 +221,14 @@ class Output_merge_base : public Output_section_data
     return this->first_shndx_;
   }
  
+  // Read the strings in the input sections from OBJECT.  A merged
+  // string section only records its input sections when they are
+  // added; their contents are read later by a Merge_strings_task for
+  // each object.
+  void
+  add_input_strings(Relobj* object)
+  { this->do_add_input_strings(object); }
+
   // Set of merged input sections.
   typedef Unordered_set<Section_id, Section_id_hash> Input_sections;
 
@@ -253,6 +265,11 @@ class Output_merge_base : public Output_section_data
   do_set_keeps_input_sections()
   { this->keeps_input_sections_ = true; }
 
+  // This may be overridden by the child class.
+  virtual void
+  do_add_input_strings(Relobj*)
+  { }
+
   // Record the merged input section for script processing.
   void
   record_input_section(Relobj* relobj, unsigned int shndx);
@@ -396,22 +413,30 @@ class Output_merge_data : public Output_merge_base
 // Handle SHF_MERGE sections with string data.  This is a template
 // based on the type of the characters in the string.
 
+// The strings are kept in several Stringpools, chosen by the hash
+// code of the string, so that the tasks which read the input sections
+// of different objects can add strings at the same time.  The offsets
+// of the strings are assigned afterward in the order in which the
+// input sections were added, so the output does not depend on the
+// number of Stringpools or on the order in which the tasks ran.
+
 template<typename Char_type>
 class Output_merge_string : public Output_merge_base
 {
  public:
-  Output_merge_string(uint64_t addralign)
-    : Output_merge_base(sizeof(Char_type), addralign), stringpool_(addralign),
-      merged_strings_lists_(), input_count_(0), input_size_(0)
-  {
-    this->stringpool_.set_no_zero_null();
-  }
+  Output_merge_string(uint64_t addralign);
+
+  ~Output_merge_string();
 
  protected:
   // Add an input section.
   bool
   do_add_input_section(Relobj* object, unsigned int shndx);
 
+  // Read the strings of the input sections from OBJECT.
+  void
+  do_add_input_strings(Relobj* object);
+
   // Do all the final processing after the input sections are read in.
   // Returns the final data size.
   section_size_type
@@ -438,16 +463,6 @@ class Output_merge_string : public Output_merge_base
   void
   do_print_merge_stats(const char* section_name);
 
-  // Writes the stringpool to a buffer.
-  void
-  stringpool_to_buffer(unsigned char* buffer, section_size_type buffer_size)
-  { this->stringpool_.write_to_buffer(buffer, buffer_size); }
-
-  // Clears all the data in the stringpool, to save on memory.
-  void
-  clear_stringpool()
-  { this->stringpool_.clear(); }
-
   // Whether this is a merge string section.
   virtual bool
   do_is_string()
@@ -472,7 +487,7 @@ class Output_merge_string : public Output_merge_base
   {
     // The offset in the input section.
     section_offset_type offset;
-    // The key in the Stringpool.
+    // The key of the string, as returned by make_key.
     Stringpool::Key stringpool_key;
 
     Merged_string(section_offset_type offseta, Stringpool::Key stringpool_keya)
@@ -488,27 +503,148 @@ class Output_merge_string : public Output_merge_base
     Relobj* object;
     // The input section in the input object.
     unsigned int shndx;
-    // The list of merged strings.
+    // The number of non-empty strings in the input section.
+    size_t input_count;
+    // The list of merged strings.  This is empty until the input
+    // section has been read.
     Merged_strings merged_strings;
 
     Merged_strings_list(Relobj* objecta, unsigned int shndxa)
-      : object(objecta), shndx(shndxa), merged_strings()
+      : object(objecta), shndx(shndxa), input_count(0), merged_strings()
     { }
   };
 
   typedef std::vector<Merged_strings_list*> Merged_strings_lists;
 
-  // As we see the strings, we add them to a Stringpool.
-  Stringpool_template<Char_type> stringpool_;
-  // Map from a location in an input object to an entry in the
-  // Stringpool.
+  // A string in the output section.
+  struct Output_string
+  {
+    // The canonical copy of the string.
+    const Char_type* string;
+    // The length of the string in characters.
+    size_t length;
+    // The offset in the output section, or -1 if not yet assigned.
+    section_offset_type offset;
+
+    Output_string(const Char_type* stringa, size_t lengtha)
+      : string(stringa), length(lengtha), offset(-1)
+    { }
+  };
+
+  // One of the Stringpools holding the strings.
+  struct String_shard
+  {
+    String_shard(uint64_t addralign);
+
+    ~String_shard();
+
+    // Held while adding strings.
+    Lock* lock;
+    // The unique strings.
+    Stringpool_template<Char_type> stringpool;
+    // The strings, indexed by Stringpool key minus one.
+    std::vector<Output_string> strings;
+  };
+
+  // A string read from an input section which has not yet been added
+  // to its String_shard.
+  struct Pending_string
+  {
+    // The index in Merged_strings_list::merged_strings.
+    size_t index;
+    // The string in the input section contents.
+    const Char_type* string;
+    // The length of the string in characters.
+    size_t length;
+    // The hash code of the string.
+    size_t hash_code;
+
+    Pending_string(size_t indexa, const Char_type* stringa, size_t lengtha,
+		   size_t hash_codea)
+      : index(indexa), string(stringa), length(lengtha),
+	hash_code(hash_codea)
+    { }
+  };
+
+  // The pending strings, one vector for each String_shard.
+  typedef std::vector<std::vector<Pending_string> > Pending_strings;
+
+  // Comparison routine used when sorting strings for tail merging.
+  struct Output_string_comparison
+  {
+    bool
+    operator()(const Output_string*, const Output_string*) const;
+  };
+
+  // Read the strings of one input section.
+  void
+  read_input_section(Merged_strings_list*, Pending_strings*);
+
+  // Return the key for the string with Stringpool key KEY in
+  // shards_[SHARD].
+  Stringpool::Key
+  make_key(Stringpool::Key key, unsigned int shard) const
+  { return (key - 1) * this->shards_.size() + shard + 1; }
+
+  // Return the string for a key returned by make_key.
+  Output_string*
+  output_string(Stringpool::Key key)
+  {
+    --key;
+    String_shard* shard = this->shards_[key % this->shards_.size()];
+    return &shard->strings[key / this->shards_.size()];
+  }
+
+  // Assign offsets to all the strings such that strings which are a
+  // suffix of another string share its storage.
+  void
+  set_tail_merged_offsets();
+
+  typedef Unordered_map<const Relobj*, Merged_strings_lists> Object_lists;
+
+  // The Stringpools holding the strings.
+  std::vector<String_shard*> shards_;
+  // Map from a location in an input object to a string.
   Merged_strings_lists merged_strings_lists_;
+  // The same lists, by object.
+  Object_lists object_lists_;
+  // Whether to merge strings which are a suffix of another string.
+  bool optimize_;
+  // The size of the section, once the string offsets are known.
+  section_size_type output_size_;
   // The number of entries seen in input files.
   size_t input_count_;
   // The total size of input sections.
   size_t input_size_;
 };
 
+// This runner queues a Merge_strings_task for each object to read the
+// strings of the merged string sections in LAYOUT, and queues NEXT to
+// run once they are done.
+
+class Merge_strings_runner : public Task_function_runner
+{
+ public:
+  Merge_strings_runner(const Input_objects* input_objects,
+		       const Layout* layout, Task_function_runner* next,
+		       const char* next_name)
+    : input_objects_(input_objects), layout_(layout), next_(next),
+      next_name_(next_name)
+  { }
+
+  ~Merge_strings_runner()
+  { delete this->next_; }
+
+  void
+  run(Workqueue*, const Task*);
+
+ private:
+  const Input_objects* input_objects_;
+  const Layout* layout_;
+  Task_function_runner* next_;
+  const char* next_name_;
+};
+
 } // End namespace gold.
 
 #endif // !defined(GOLD_MERGE_H)
@@ -31,6 +31,7 @@
 #include "gc.h"
 #include "target-select.h"
 #include "dwarf_reader.h"
+#include "ehframe.h"
 #include "layout.h"
 #include "output.h"
 #include "symtab.h"
@@ -476,6 +477,8 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
     local_plt_offsets_(),
     kept_comdat_sections_(),
     has_eh_frame_(false),
+    eh_frame_sections_read_(false),
+    eh_frame_input_sections_(),
     is_deferred_layout_(false),
     deferred_layout_(),
     deferred_layout_relocs_(),
@@ -487,6 +490,7 @@ Sized_relobj_file<size, big_endian>::Sized_relobj_file(
 template<int size, bool big_endian>
 Sized_relobj_file<size, big_endian>::~Sized_relobj_file()
 {
+  this->free_eh_frame_input_sections();
 }
 
 // Set up an object file based on the file header.  This sets up the
@@ -919,6 +923,167 @@ Sized_relobj_file<size, big_endian>::base_read_symbols(Read_symbols_data* sd)
   sd->symbol_names = fvstrtab;
   sd->symbol_names_size =
     convert_to_section_size_type(strtabshdr.get_sh_size());
+
+  this->hash_symbol_names(sd);
+  this->read_eh_frame_sections(sd);
+}
+
+// Split the names of the external symbols from their versions and
+// compute their hash codes, for Symbol_table::add_from_relobj.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::hash_symbol_names(Read_symbols_data* sd)
+{
+  const int sym_size = This::sym_size;
+  const size_t symcount = ((sd->symbols_size - sd->external_symbols_offset)
+			   / sym_size);
+  const unsigned char* p = sd->symbols->data() + sd->external_symbols_offset;
+  const char* sym_names =
+    reinterpret_cast<const char*>(sd->symbol_names->data());
+
+  sd->symbol_name_hashes.resize(symcount);
+  for (size_t i = 0; i < symcount; ++i, p += sym_size)
+    {
+      elfcpp::Sym<size, big_endian> sym(p);
+      Symbol_name_hash* nh = &sd->symbol_name_hashes[i];
+      unsigned int st_name = sym.get_st_name();
+      if (st_name >= sd->symbol_names_size)
+	{
+	  // add_from_relobj will report this.
+	  nh->hash_code = 0;
+	  nh->length = 0;
+	  nh->has_version = false;
+	  continue;
+	}
+      const char* name = sym_names + st_name;
+      size_t len = strlen(name);
+      const char* ver = static_cast<const char*>(memchr(name, '@', len));
+      if (ver != NULL)
+	len = ver - name;
+      nh->hash_code = string_hash<char>(name, len);
+      nh->length = len;
+      nh->has_version = ver != NULL;
+    }
+}
+
+// Parse the .eh_frame sections of this object.  This is called from
+// the Read_symbols task, which runs in parallel for different
+// objects, so that the layout, which is serialized, only has to merge
+// the CIEs and discard the FDEs for discarded sections.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::read_eh_frame_sections(
+    Read_symbols_data* sd)
+{
+  if (!this->has_eh_frame_
+      || this->eh_frame_sections_read_
+      || sd->symbols == NULL
+      || this->input_file()->just_symbols()
+      || parameters->options().relocatable()
+      || parameters->incremental())
+    return;
+  this->eh_frame_sections_read_ = true;
+
+  const unsigned int shnum = this->shnum();
+  const unsigned char* const pshdrs = sd->section_headers->data();
+  const char* const pnames =
+    reinterpret_cast<const char*>(sd->section_names->data());
+
+  // Find the .eh_frame sections.
+  std::vector<unsigned int> eh_frame_sections;
+  const unsigned char* p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      if (shdr.get_sh_name() < sd->section_names_size
+	  && this->check_eh_frame_flags(&shdr)
+	  && strcmp(pnames + shdr.get_sh_name(), ".eh_frame") == 0)
+	eh_frame_sections.push_back(i);
+    }
+  if (eh_frame_sections.empty())
+    return;
+
+  // Find the reloc sections which apply to them, the same way that
+  // do_layout does.
+  std::vector<unsigned int> reloc_shndx(shnum, 0);
+  std::vector<unsigned int> reloc_type(shnum, elfcpp::SHT_NULL);
+  p = pshdrs + This::shdr_size;
+  for (unsigned int i = 1; i < shnum; ++i, p += This::shdr_size)
+    {
+      typename This::Shdr shdr(p);
+      unsigned int sh_type = shdr.get_sh_type();
+      if (sh_type != elfcpp::SHT_REL && sh_type != elfcpp::SHT_RELA)
+	continue;
+      unsigned int target_shndx = this->adjust_shndx(shdr.get_sh_info());
+      if (target_shndx == 0 || target_shndx >= shnum)
+	continue;
+      if (reloc_shndx[target_shndx] != 0)
+	reloc_shndx[target_shndx] = -1U;
+      else
+	{
+	  reloc_shndx[target_shndx] = i;
+	  reloc_type[target_shndx] = sh_type;
+	}
+    }
+
+  for (std::vector<unsigned int>::const_iterator pe =
+	 eh_frame_sections.begin();
+       pe != eh_frame_sections.end();
+       ++pe)
+    {
+      unsigned int shndx = *pe;
+      Eh_frame_input_section* input_section = new Eh_frame_input_section();
+      input_section->shndx = shndx;
+      input_section->reloc_shndx = reloc_shndx[shndx];
+      input_section->reloc_type = reloc_type[shndx];
+      input_section->is_recognized =
+	Eh_frame::read_input_section(this, sd->symbols->data(),
+				     sd->symbols_size, sd->symbol_names_size,
+				     shndx, reloc_shndx[shndx],
+				     reloc_type[shndx],
+				     &input_section->entries);
+      this->eh_frame_input_sections_.push_back(input_section);
+    }
+}
+
+// Return the parsed contents of the .eh_frame section SHNDX, and
+// forget about it.
+
+template<int size, bool big_endian>
+Eh_frame_input_section*
+Sized_relobj_file<size, big_endian>::release_eh_frame_input_section(
+    unsigned int shndx)
+{
+  for (typename std::vector<Eh_frame_input_section*>::iterator p =
+	 this->eh_frame_input_sections_.begin();
+       p != this->eh_frame_input_sections_.end();
+       ++p)
+    {
+      if ((*p)->shndx == shndx)
+	{
+	  Eh_frame_input_section* ret = *p;
+	  this->eh_frame_input_sections_.erase(p);
+	  return ret;
+	}
+    }
+  return NULL;
+}
+
+// Free the parsed .eh_frame sections which were not laid out, such
+// as those in discarded comdat groups.
+
+template<int size, bool big_endian>
+void
+Sized_relobj_file<size, big_endian>::free_eh_frame_input_sections()
+{
+  for (typename std::vector<Eh_frame_input_section*>::iterator p =
+	 this->eh_frame_input_sections_.begin();
+       p != this->eh_frame_input_sections_.end();
+       ++p)
+    delete *p;
+  this->eh_frame_input_sections_.clear();
 }
 
 // Return the section index of symbol SYM.  Set *VALUE to its value in
@@ -1924,6 +2089,11 @@ Sized_relobj_file<size, big_endian>::do_layout(Symbol_table* symtab,
 				    reloc_type[i]);
     }
 
+  // Any .eh_frame sections parsed in advance which are still left
+  // will not be laid out.
+  if (!is_pass_one && !this->is_deferred_layout())
+    this->free_eh_frame_input_sections();
+
   // When doing a relocatable link handle the reloc sections at the
   // end.  Garbage collection  and Identical Code Folding is not
   // turned on for relocatable code.
@@ -2074,6 +2244,7 @@ Sized_relobj_file<size, big_endian>::do_layout_deferred_sections(Layout* layout)
     }
 
   this->deferred_layout_.clear();
+  this->free_eh_frame_input_sections();
 
   // Now handle the deferred relocation sections.
 
@@ -2138,10 +2309,16 @@ Sized_relobj_file<size, big_endian>::do_add_symbols(Symbol_table* symtab,
 
   const char* sym_names =
     reinterpret_cast<const char*>(sd->symbol_names->data());
+  const Symbol_name_hash* name_hashes = NULL;
+  if (!sd->symbol_name_hashes.empty())
+    {
+      gold_assert(sd->symbol_name_hashes.size() == symcount);
+      name_hashes = &sd->symbol_name_hashes[0];
+    }
   symtab->add_from_relobj(this,
 			  sd->symbols->data() + sd->external_symbols_offset,
 			  symcount, this->local_symbol_count_,
-			  sym_names, sd->symbol_names_size,
+			  sym_names, sd->symbol_names_size, name_hashes,
 			  &this->symbols_,
 			  &this->defined_count_);
 
@@ -2149,6 +2326,7 @@ Sized_relobj_file<size, big_endian>::do_add_symbols(Symbol_table* symtab,
   sd->symbols = NULL;
   delete sd->symbol_names;
   sd->symbol_names = NULL;
+  std::vector<Symbol_name_hash>().swap(sd->symbol_name_hashes);
 }
 
 // Find out if this object, that is a member of a lib group, should be included
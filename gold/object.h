@@ -50,17 +50,32 @@ class Dynobj;
 class Object_merge_map;
 class Relocatable_relocs;
 struct Symbols_data;
+struct Eh_frame_input_section;
 
 template<typename Stringpool_char>
 class Stringpool_template;
 
 // Data to pass from read_symbols() to add_symbols().
 
+// The name of an external symbol in an object file, without any
+// version suffix.
+
+struct Symbol_name_hash
+{
+  // The hash code of the name, as computed by string_hash.
+  size_t hash_code;
+  // The length of the name, up to any '@'.
+  unsigned int length;
+  // Whether the name is followed by '@' and a version.
+  bool has_version;
+};
+
 struct Read_symbols_data
 {
   Read_symbols_data()
     : section_headers(NULL), section_names(NULL), symbols(NULL),
-      symbol_names(NULL), versym(NULL), verdef(NULL), verneed(NULL)
+      symbol_names(NULL), symbol_name_hashes(), versym(NULL), verdef(NULL),
+      verneed(NULL)
   { }
 
   ~Read_symbols_data();
@@ -83,6 +98,12 @@ struct Read_symbols_data
   File_view* symbol_names;
   // Size of symbol name data in bytes.
   section_size_type symbol_names_size;
+  // The names of the external symbols, split from their versions and
+  // hashed.  Reading the symbols of different objects can run in
+  // parallel, while adding them to the symbol table is done one
+  // object at a time, so we do the work of scanning the names here.
+  // This is empty if the names were not hashed.
+  std::vector<Symbol_name_hash> symbol_name_hashes;
 
   // Version information.  This is only used on dynamic objects.
   // Version symbol data (from SHT_GNU_versym section).
@@ -2341,6 +2362,12 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   bool is_deferred_layout() const
   { return this->is_deferred_layout_; }
 
+  // Return the parsed contents of the .eh_frame section SHNDX, read
+  // along with the symbols, or NULL if it was not read.  The caller
+  // takes ownership of the result.
+  Eh_frame_input_section*
+  release_eh_frame_input_section(unsigned int shndx);
+
  protected:
   typedef typename Sized_relobj<size, big_endian>::Output_sections
       Output_sections;
@@ -2630,6 +2657,18 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   void
   find_symtab(const unsigned char* pshdrs);
 
+  // Hash the names of the external symbols read into SD.
+  void
+  hash_symbol_names(Read_symbols_data* sd);
+
+  // Parse the .eh_frame sections, using the symbols read into SD.
+  void
+  read_eh_frame_sections(Read_symbols_data* sd);
+
+  // Free the parsed .eh_frame sections which were not laid out.
+  void
+  free_eh_frame_input_sections();
+
   // Return whether SHDR has the right flags for a GNU style exception
   // frame section.
   bool
@@ -2873,6 +2912,12 @@ class Sized_relobj_file : public Sized_relobj<size, big_endian>
   Kept_comdat_section_table kept_comdat_sections_;
   // Whether this object has a GNU style .eh_frame section.
   bool has_eh_frame_;
+  // Whether read_eh_frame_sections has run, so that reading the
+  // symbols again for deferred layout does not parse them again.
+  bool eh_frame_sections_read_;
+  // The .eh_frame sections parsed by read_eh_frame_sections which
+  // have not yet been laid out.
+  std::vector<Eh_frame_input_section*> eh_frame_input_sections_;
   // True if the layout of this object was deferred, waiting for plugin
   // replacement files.
   bool is_deferred_layout_;
@@ -1078,6 +1078,50 @@ General_options::add_plugin_option(const char* arg)
   this->plugins_->add_plugin_option(arg);
 }
 
+// Set the --threads and --thread-count options.  This is used by
+// programs which use libgold without parsing a linker command line.
+
+void
+General_options::set_thread_options(bool threads, unsigned int thread_count)
+{
+  this->set_threads(threads);
+  this->set_thread_count(thread_count);
+  this->finalize_thread_options();
+}
+
+// Apply --thread-count to the per-pass thread counts, and complain
+// about thread options if we have no thread support.
+
+void
+General_options::finalize_thread_options()
+{
+  // If --thread_count is specified, it applies to
+  // --thread-count-{initial,middle,final}, though it doesn't override
+  // them.
+  if (this->thread_count() > 0 && this->thread_count_initial() == 0)
+    this->set_thread_count_initial(this->thread_count());
+  if (this->thread_count() > 0 && this->thread_count_middle() == 0)
+    this->set_thread_count_middle(this->thread_count());
+  if (this->thread_count() > 0 && this->thread_count_final() == 0)
+    this->set_thread_count_final(this->thread_count());
+
+  // Let's warn if you set the thread-count but we're going to ignore it.
+#ifndef ENABLE_THREADS
+  if (this->threads())
+    {
+      gold_warning(_("ignoring --threads: "
+		     "%s was compiled without thread support"),
+		   program_name);
+      this->set_threads(false);
+    }
+  if (this->thread_count() > 0 || this->thread_count_initial() > 0
+      || this->thread_count_middle() > 0 || this->thread_count_final() > 0)
+    gold_warning(_("ignoring --thread-count: "
+		   "%s was compiled without thread support"),
+		 program_name);
+#endif
+}
+
 // Set up variables and other state that isn't set up automatically by
 // the parse routine, and ensure options don't contradict each other
 // and are otherwise kosher.
@@ -1194,31 +1238,7 @@ General_options::finalize()
   if (this->nmagic() || this->omagic())
     this->set_static(true);
 
-  // If --thread_count is specified, it applies to
-  // --thread-count-{initial,middle,final}, though it doesn't override
-  // them.
-  if (this->thread_count() > 0 && this->thread_count_initial() == 0)
-    this->set_thread_count_initial(this->thread_count());
-  if (this->thread_count() > 0 && this->thread_count_middle() == 0)
-    this->set_thread_count_middle(this->thread_count());
-  if (this->thread_count() > 0 && this->thread_count_final() == 0)
-    this->set_thread_count_final(this->thread_count());
-
-  // Let's warn if you set the thread-count but we're going to ignore it.
-#ifndef ENABLE_THREADS
-  if (this->threads())
-    {
-      gold_warning(_("ignoring --threads: "
-		     "%s was compiled without thread support"),
-		   program_name);
-      this->set_threads(false);
-    }
-  if (this->thread_count() > 0 || this->thread_count_initial() > 0
-      || this->thread_count_middle() > 0 || this->thread_count_final() > 0)
-    gold_warning(_("ignoring --thread-count: "
-		   "%s was compiled without thread support"),
-		 program_name);
-#endif
+  this->finalize_thread_options();
 
 #ifndef ENABLE_PLUGINS
   if (this->has_plugins())
@@ -1380,6 +1400,18 @@ General_options::finalize()
 			 "incremental link"));
 	  this->set_compress_debug_sections("none");
 	}
+      if (this->fix_cortex_a53_843419())
+	{
+	  gold_warning(_("ignoring --fix-cortex-a53-843419 for an "
+			 "incremental link"));
+	  this->set_fix_cortex_a53_843419(false);
+	}
+      if (this->fix_cortex_a53_835769())
+	{
+	  gold_warning(_("ignoring --fix-cortex-a53-835769 for an "
+			 "incremental link"));
+	  this->set_fix_cortex_a53_835769(false);
+	}
     }
 
   // --rosegment-gap implies --rosegment.
@@ -1537,6 +1537,12 @@ class General_options
   // any problems.
   void finalize();
 
+  // Set the --threads and --thread-count options.  This is for
+  // programs like dwp which use libgold without parsing a linker
+  // command line.
+  void
+  set_thread_options(bool threads, unsigned int thread_count);
+
   // True if we printed the version information.
   bool
   printed_version() const
@@ -1826,6 +1832,11 @@ class General_options
   set_start_stop_visibility_enum(elfcpp::STV value)
   { this->start_stop_visibility_enum_ = value; }
 
+  // Called by finalize() and set_thread_options() to apply the
+  // thread count options.
+  void
+  finalize_thread_options();
+
   // These are called by finalize() to set up the search-path correctly.
   void
   add_to_library_path_with_sysroot(const std::string& arg)
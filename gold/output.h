@@ -3637,6 +3637,11 @@ class Output_section : public Output_data
     return this->postprocessing_buffer_;
   }
 
+  // Return whether the postprocessing buffer has been created.
+  bool
+  has_postprocessing_buffer() const
+  { return this->postprocessing_buffer_ != NULL; }
+
   // If a section requires postprocessing, create the buffer to use.
   void
   create_postprocessing_buffer();
@@ -1025,6 +1025,13 @@ class Target_powerpc : public Sized_target<size, big_endian>
 		      unsigned int dst_shndx,
 		      Address dst_off) const;
 
+  // For powerpc64, processing the relocs of one object records
+  // references in the .opd access map of another, so the objects are
+  // processed one at a time.
+  bool
+  do_gc_process_relocs_in_parallel() const
+  { return size == 32; }
+
   typedef std::vector<Stub_table<size, big_endian>*> Stub_tables;
   const Stub_tables&
   stub_tables() const
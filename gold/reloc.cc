@@ -33,6 +33,7 @@
 #include "target-reloc.h"
 #include "reloc.h"
 #include "icf.h"
+#include "gc.h"
 #include "compressed_output.h"
 #include "incremental.h"
 
@@ -111,7 +112,7 @@ Gc_process_relocs::~Gc_process_relocs()
 // These tasks process the relocations read by Read_relocs and
 // determine which sections are referenced and which are garbage.
 // This task is done only when --gc-sections is used.  This is blocked
-// by THIS_BLOCKER_.  It unblocks NEXT_BLOCKER_.
+// by THIS_BLOCKER_, if any.  It unblocks NEXT_BLOCKER_.
 
 Task_token*
 Gc_process_relocs::is_runnable()
@@ -134,6 +135,11 @@ void
 Gc_process_relocs::run(Workqueue*)
 {
   this->object_->gc_process_relocs(this->symtab_, this->layout_, this->rd_);
+  // When the tasks run in parallel, no other task adds references
+  // from this object, so its reference table can be built now.
+  if (parameters->options().gc_sections()
+      && this->symtab_->gc()->references_are_local())
+    this->symtab_->gc()->finish_references(this->object_);
   this->object_->release();
 }
 
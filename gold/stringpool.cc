@@ -274,12 +274,27 @@ Stringpool_template<Stringpool_char>::add_with_length(const Stringpool_char* s,
       return p->first.string;
     }
 
+  return this->add_with_hash(s, length, string_hash(s, length), pkey);
+}
+
+template<typename Stringpool_char>
+const Stringpool_char*
+Stringpool_template<Stringpool_char>::add_with_hash(const Stringpool_char* s,
+						    size_t length,
+						    size_t hash_code,
+						    Key* pkey)
+{
+  typedef std::pair<typename String_set_type::iterator, bool> Insert_type;
+
+  // We add 1 so that 0 is always invalid.
+  const Key k = this->key_to_offset_.size() + 1;
+
   // When we have to copy the string, we look it up twice in the hash
   // table.  The problem is that we can't insert S before we
   // canonicalize it by copying it into the canonical list. The hash
   // code will only be computed once.
 
-  Hashkey hk(s, length);
+  Hashkey hk(s, length, hash_code);
   typename String_set_type::const_iterator p = this->string_set_.find(hk);
   if (p != this->string_set_.end())
     {
@@ -309,7 +324,20 @@ const Stringpool_char*
 Stringpool_template<Stringpool_char>::find(const Stringpool_char* s,
 					   Key* pkey) const
 {
-  Hashkey hk(s);
+  size_t length = string_length(s);
+  return this->find_with_hash(s, length, string_hash(s, length), pkey);
+}
+
+// Look up string S of length LEN, whose hash code is HASH_CODE.
+
+template<typename Stringpool_char>
+const Stringpool_char*
+Stringpool_template<Stringpool_char>::find_with_hash(const Stringpool_char* s,
+						     size_t len,
+						     size_t hash_code,
+						     Key* pkey) const
+{
+  Hashkey hk(s, len, hash_code);
   typename String_set_type::const_iterator p = this->string_set_.find(hk);
   if (p == this->string_set_.end())
     return NULL;
@@ -229,12 +229,31 @@ class Stringpool_template
   const Stringpool_char*
   add_with_length(const Stringpool_char* s, size_t len, bool copy, Key* pkey);
 
+  // Compute a hash code for a string.  LENGTH is the length of the
+  // string in characters.  This is the hash code expected by
+  // add_with_hash and find_with_hash.
+  static size_t
+  string_hash(const Stringpool_char*, size_t length);
+
+  // Add string S of length LEN characters to the pool, copying it.
+  // HASH_CODE must be string_hash(S, LEN); this lets a caller which
+  // already has the hash code avoid computing it again.
+  const Stringpool_char*
+  add_with_hash(const Stringpool_char* s, size_t len, size_t hash_code,
+		Key* pkey);
+
   // If the string S is present in the pool, return the canonical
   // string pointer.  Otherwise, return NULL.  If PKEY is not NULL,
   // set *PKEY to the key.
   const Stringpool_char*
   find(const Stringpool_char* s, Key* pkey) const;
 
+  // Like find, but S is LEN characters long and need not be null
+  // terminated, and HASH_CODE must be string_hash(S, LEN).
+  const Stringpool_char*
+  find_with_hash(const Stringpool_char* s, size_t len, size_t hash_code,
+		 Key* pkey) const;
+
   // Turn the stringpool into a string table: determine the offsets of
   // all the strings.  After this is called, no more strings may be
   // added to the stringpool.
@@ -297,11 +316,6 @@ class Stringpool_template
   static bool
   string_equal(const Stringpool_char*, const Stringpool_char*);
 
-  // Compute a hash code for a string.  LENGTH is the length of the
-  // string in characters.
-  static size_t
-  string_hash(const Stringpool_char*, size_t length);
-
   // We store the actual data in a list of these buffers.
   struct Stringdata
   {
@@ -353,6 +367,10 @@ class Stringpool_template
     Hashkey(const Stringpool_char* s, size_t len)
       : string(s), length(len), hash_code(string_hash(s, len))
     { }
+
+    Hashkey(const Stringpool_char* s, size_t len, size_t hash)
+      : string(s), length(len), hash_code(hash)
+    { }
   };
 
   // Hash function.  This is trivial, since we have already computed
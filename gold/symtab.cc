@@ -700,9 +700,22 @@ Symbol_table::resolve_forwards(const Symbol* from) const
 
 Symbol*
 Symbol_table::lookup(const char* name, const char* version) const
+{
+  size_t name_len = strlen(name);
+  return this->lookup(name, name_len, string_hash<char>(name, name_len),
+		      version);
+}
+
+// Look up a symbol by name, given the length and hash code of the
+// name.  This is used when reading an archive map, where we compute
+// the hash code of each name once rather than on every pass.
+
+Symbol*
+Symbol_table::lookup(const char* name, size_t name_len, size_t name_hash,
+		     const char* version) const
 {
   Stringpool::Key name_key;
-  name = this->namepool_.find(name, &name_key);
+  name = this->namepool_.find_with_hash(name, name_len, name_hash, &name_key);
   if (name == NULL)
     return NULL;
 
@@ -1182,6 +1195,7 @@ Symbol_table::add_from_relobj(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     typename Sized_relobj_file<size, big_endian>::Symbols* sympointers,
     size_t* defined)
 {
@@ -1243,7 +1257,14 @@ Symbol_table::add_from_relobj(
       // In an object file, an '@' in the name separates the symbol
       // name from the version name.  If there are two '@' characters,
       // this is the default version.
-      const char* ver = strchr(name, '@');
+      const Symbol_name_hash* nh = (name_hashes == NULL
+				    ? NULL
+				    : &name_hashes[i]);
+      const char* ver;
+      if (nh == NULL)
+	ver = strchr(name, '@');
+      else
+	ver = nh->has_version ? name + nh->length : NULL;
       Stringpool::Key ver_key = 0;
       int namelen = 0;
       // IS_DEFAULT_VERSION: is the version default?
@@ -1276,7 +1297,7 @@ Symbol_table::add_from_relobj(
       // about a common symbol?
       else
 	{
-	  namelen = strlen(name);
+	  namelen = nh == NULL ? strlen(name) : nh->length;
 	  if (!this->version_script_.empty()
 	      && st_shndx != elfcpp::SHN_UNDEF)
 	    {
@@ -1348,7 +1369,11 @@ Symbol_table::add_from_relobj(
         }
 
       Stringpool::Key name_key;
-      name = this->namepool_.add_with_length(name, namelen, true,
+      if (nh == NULL)
+	name = this->namepool_.add_with_length(name, namelen, true,
+					       &name_key);
+      else
+	name = this->namepool_.add_with_hash(name, namelen, nh->hash_code,
 					     &name_key);
 
       Sized_symbol<size>* res;
@@ -3742,6 +3767,7 @@ Symbol_table::add_from_relobj<32, false>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<32, false>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3756,6 +3782,7 @@ Symbol_table::add_from_relobj<32, true>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<32, true>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3770,6 +3797,7 @@ Symbol_table::add_from_relobj<64, false>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<64, false>::Symbols* sympointers,
     size_t* defined);
 #endif
@@ -3784,6 +3812,7 @@ Symbol_table::add_from_relobj<64, true>(
     size_t symndx_offset,
     const char* sym_names,
     size_t sym_name_size,
+    const Symbol_name_hash* name_hashes,
     Sized_relobj_file<64, true>::Symbols* sympointers,
     size_t* defined);
 #endif
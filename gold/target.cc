@@ -239,6 +239,16 @@ Sized_target<size, big_endian>::do_adjust_elf_header(unsigned char* view,
     }
 }
 
+// Return the index of the PLT entry for GSYM.
+
+template<int size, bool big_endian>
+unsigned int
+Sized_target<size, big_endian>::plt_entry_index(const Symbol* gsym) const
+{
+  return ((gsym->plt_offset() - this->first_plt_entry_offset())
+	  / this->plt_entry_size());
+}
+
 #ifdef HAVE_TARGET_32_LITTLE
 template
 class Sized_target<32, false>;
@@ -464,6 +464,14 @@ class Target
   gc_mark_symbol(Symbol_table* symtab, Symbol* sym) const
   { this->do_gc_mark_symbol(symtab, sym); }
 
+  // Return whether the relocs of different objects may be processed
+  // for --gc-sections at the same time.  This is false for a target
+  // which adds gc references from other objects, or changes other
+  // objects, while processing the relocs of one object.
+  bool
+  gc_process_relocs_in_parallel() const
+  { return this->do_gc_process_relocs_in_parallel(); }
+
   // Return the name of the entry point symbol.
   const char*
   entry_symbol_name() const
@@ -793,6 +801,11 @@ class Target
   do_gc_mark_symbol(Symbol_table*, Symbol*) const
   { }
 
+  // This may be overridden by the child class.
+  virtual bool
+  do_gc_process_relocs_in_parallel() const
+  { return true; }
+
   // This may be overridden by the child class.
   virtual bool
   do_has_custom_set_dynsym_indexes() const
@@ -1053,6 +1066,14 @@ class Sized_target : public Target
   plt_entry_size() const
   { gold_unreachable(); }
 
+  // Return the index of the PLT entry for the global symbol GSYM.
+  // This is only used for laying out the incremental link info
+  // sections.  A target needs to override this if some of its PLT
+  // offsets do not count from the first non-reserved PLT entry.
+
+  virtual unsigned int
+  plt_entry_index(const Symbol* gsym) const;
+
   // Return the size of each GOT entry.  This is only used for
   // laying out the incremental link info sections.  A target needs
   // to implement this if its GOT size is different.
@@ -0,0 +1,44 @@
+#!/bin/sh
+
+# incremental_ifunc_aarch64.sh -- test an incremental update of a base
+# file with an IFUNC PLT entry on aarch64.
+
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# This file is part of gold.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street - Fifth Floor, Boston,
+# MA 02110-1301, USA.
+
+# The IRELATIVE PLT entry for foo1 in the base file can not be reused,
+# so the incremental update must ask for a full link.  The errors will
+# be found in incremental_ifunc_aarch64.err.
+
+check()
+{
+    if ! grep -q "$1" incremental_ifunc_aarch64.err
+    then
+	echo "Did not find expected error:"
+	echo "   $1"
+	echo ""
+	echo "Actual error output below:"
+	cat incremental_ifunc_aarch64.err
+	exit 1
+    fi
+}
+
+check "IFUNC symbol foo1 has a PLT entry in the base file; relink with --incremental-full"
+
+exit 0
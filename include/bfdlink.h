@@ -421,6 +421,10 @@ struct bfd_link_info
   /* TRUE if separate code segment should be created.  */
   unsigned int separate_code: 1;
 
+  /* TRUE if relative relocations should be packed into a DT_RELR
+     table.  */
+  unsigned int enable_dt_relr: 1;
+
   /* Nonzero if .eh_frame_hdr section and PT_GNU_EH_FRAME ELF segment
      should be created.  1 for DWARF2 tables, 2 for compact tables.  */
   unsigned int eh_frame_hdr_type: 2;
@@ -538,6 +542,11 @@ struct bfd_link_info
      means explicitly zero-sized.  */
   bfd_signed_vma stacksize;
 
+  /* The number of threads to relocate input files with.  Zero or one
+     means relocate them serially, -1 means use one thread per online
+     processor.  Only some ELF targets support this.  */
+  int thread_count;
+
   /* Enable or disable target specific optimizations.
 
      Not all targets have optimizations to enable.
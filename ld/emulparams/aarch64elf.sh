@@ -1,3 +1,4 @@
+source_sh ${srcdir}/emulparams/dt-relr.sh
 ARCH=aarch64
 MACHINE=
 NOP=0x1f2003d5
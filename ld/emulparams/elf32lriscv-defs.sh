@@ -1,4 +1,5 @@
 # This is an ELF platform.
+source_sh ${srcdir}/emulparams/dt-relr.sh
 SCRIPT_NAME=elf
 ARCH=riscv
 NO_REL_RELOCS=yes
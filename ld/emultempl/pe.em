@@ -1227,7 +1227,8 @@ write_build_id (bfd *abfd)
 
   build_id_size = compute_build_id_size (t->build_id.style);
   build_id = xmalloc (build_id_size);
-  generate_build_id (abfd, t->build_id.style, pecoff_checksum_contents, build_id, build_id_size);
+  generate_build_id (abfd, t->build_id.style, pecoff_checksum_contents,
+		     build_id, build_id_size, link_info.thread_count);
 
   bfd_vma ib = pe_data (link_info.output_bfd)->pe_opthdr.ImageBase;
 
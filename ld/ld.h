@@ -104,6 +104,11 @@ struct wildcard_spec
   struct name_list *exclude_name_list;
   sort_type sorted;
   struct flag_info *section_flag_list;
+  /* For section name specs, the length of NAME and of its literal
+     prefix and suffix, filled in by lang_add_wild.  */
+  size_t namelen;
+  size_t prefixlen;
+  size_t suffixlen;
 };
 
 struct wildcard_list
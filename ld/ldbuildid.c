@@ -20,10 +20,14 @@
 
 #include "sysdep.h"
 #include "bfd.h"
+#include "libiberty.h"
 #include "safe-ctype.h"
 #include "md5.h"
 #include "sha1.h"
 #include "ldbuildid.h"
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
 #ifdef __MINGW32__
 #include <windows.h>
 #include <rpcdce.h>
@@ -36,6 +40,7 @@ bfd_boolean
 validate_build_id_style (const char *style)
 {
   if ((streq (style, "md5")) || (streq (style, "sha1"))
+      || (streq (style, "md5-tree")) || (streq (style, "sha1-tree"))
       || (streq (style, "uuid")) || (strneq (style, "0x", 2)))
     return TRUE;
 
@@ -45,10 +50,11 @@ validate_build_id_style (const char *style)
 bfd_size_type
 compute_build_id_size (const char *style)
 {
-  if (streq (style, "md5") || streq (style, "uuid"))
+  if (streq (style, "md5") || streq (style, "md5-tree")
+      || streq (style, "uuid"))
     return 128 / 8;
 
-  if (streq (style, "sha1"))
+  if (streq (style, "sha1") || streq (style, "sha1-tree"))
     return 160 / 8;
 
   if (strneq (style, "0x", 2))
@@ -94,14 +100,209 @@ read_hex (const char xdigit)
   return 0;
 }
 
+/* The "-tree" styles split the checksummed contents into chunks of
+   TREE_CHUNK_SIZE bytes, hash each chunk, and then hash the
+   concatenated chunk digests.  The chunks are independent, so up to
+   one per thread are hashed at once.  The chunk size is fixed so that
+   the ID does not depend on the number of threads.  */
+
+#define TREE_CHUNK_SIZE (1024 * 1024)
+
+struct tree_hash
+{
+  /* md5_buffer or sha1_buffer, and the size of its digest.  */
+  void *(*hash) (const char *, size_t, void *);
+  size_t digest_size;
+
+  /* Up to NCHUNKS chunks waiting to be hashed, with FILL bytes in
+     them so far.  */
+  char *chunks;
+  unsigned int nchunks;
+  size_t fill;
+
+  /* The digests of the chunks hashed so far.  */
+  unsigned char *digests;
+  size_t ndigests;
+  size_t digests_alloc;
+};
+
+#ifdef HAVE_PTHREAD
+struct tree_hash_job
+{
+  struct tree_hash *tree;
+  unsigned int chunk;
+};
+
+static void *
+tree_hash_thread (void *arg)
+{
+  struct tree_hash_job *job = (struct tree_hash_job *) arg;
+  struct tree_hash *tree = job->tree;
+
+  tree->hash (tree->chunks + (size_t) job->chunk * TREE_CHUNK_SIZE,
+	      TREE_CHUNK_SIZE,
+	      tree->digests + ((tree->ndigests + job->chunk)
+			       * tree->digest_size));
+  return NULL;
+}
+#endif
+
+/* Hash the chunks waiting in TREE.  All but the last are full.  */
+
+static void
+tree_hash_flush (struct tree_hash *tree)
+{
+  unsigned int count, last, i;
+
+  if (tree->fill == 0)
+    return;
+
+  count = (tree->fill + TREE_CHUNK_SIZE - 1) / TREE_CHUNK_SIZE;
+  if (tree->ndigests + count > tree->digests_alloc)
+    {
+      tree->digests_alloc = tree->digests_alloc * 2 + count;
+      tree->digests = (unsigned char *)
+	xrealloc (tree->digests, tree->digests_alloc * tree->digest_size);
+    }
+
+  last = count - 1;
+  i = 0;
+#ifdef HAVE_PTHREAD
+  if (last != 0)
+    {
+      pthread_t *threads;
+      struct tree_hash_job *jobs;
+      unsigned int started;
+
+      threads = (pthread_t *) xmalloc (last * sizeof (*threads));
+      jobs = (struct tree_hash_job *) xmalloc (last * sizeof (*jobs));
+      for (started = 0; started < last; started++)
+	{
+	  jobs[started].tree = tree;
+	  jobs[started].chunk = started;
+	  if (pthread_create (&threads[started], NULL, tree_hash_thread,
+			      &jobs[started]) != 0)
+	    break;
+	}
+      /* Chunks which couldn't be given a thread are hashed below.  */
+      i = started;
+      for (; i < last; i++)
+	tree_hash_thread (&jobs[i]);
+      while (started != 0)
+	pthread_join (threads[--started], NULL);
+      free (jobs);
+      free (threads);
+    }
+#endif
+  for (; i < last; i++)
+    tree->hash (tree->chunks + (size_t) i * TREE_CHUNK_SIZE,
+		TREE_CHUNK_SIZE,
+		tree->digests + (tree->ndigests + i) * tree->digest_size);
+  tree->hash (tree->chunks + (size_t) last * TREE_CHUNK_SIZE,
+	      tree->fill - (size_t) last * TREE_CHUNK_SIZE,
+	      tree->digests + (tree->ndigests + last) * tree->digest_size);
+
+  tree->ndigests += count;
+  tree->fill = 0;
+}
+
+/* A sum_fn collecting BUFFER into the chunks of the tree_hash DATA.  */
+
+static void
+tree_hash_bytes (const void *buffer, size_t len, void *data)
+{
+  struct tree_hash *tree = (struct tree_hash *) data;
+  const char *p = (const char *) buffer;
+  size_t size = (size_t) tree->nchunks * TREE_CHUNK_SIZE;
+
+  while (len != 0)
+    {
+      size_t n = size - tree->fill;
+
+      if (n > len)
+	n = len;
+      memcpy (tree->chunks + tree->fill, p, n);
+      tree->fill += n;
+      p += n;
+      len -= n;
+      if (tree->fill == size)
+	tree_hash_flush (tree);
+    }
+}
+
+/* Return the number of threads to use for THREADS, as given by
+   --threads or --thread-count.  Each thread needs a chunk buffer, so
+   use no more than 64.  */
+
+static unsigned int
+tree_hash_threads (int threads)
+{
+  long n = 1;
+
+#ifdef HAVE_PTHREAD
+  n = threads;
+  if (n < 0)
+    {
+#if defined (HAVE_SYSCONF) && defined (_SC_NPROCESSORS_ONLN)
+      n = sysconf (_SC_NPROCESSORS_ONLN);
+#else
+      n = 1;
+#endif
+    }
+#endif
+  if (n < 1)
+    return 1;
+  return n > 64 ? 64 : n;
+}
+
+static bfd_boolean
+generate_tree_build_id (bfd *abfd,
+			void *(*hash) (const char *, size_t, void *),
+			size_t digest_size,
+			checksum_fn checksum_contents,
+			unsigned char *id_bits,
+			int threads)
+{
+  struct tree_hash tree;
+  bfd_boolean ret;
+
+  tree.hash = hash;
+  tree.digest_size = digest_size;
+  tree.nchunks = tree_hash_threads (threads);
+  tree.chunks = (char *) xmalloc ((size_t) tree.nchunks * TREE_CHUNK_SIZE);
+  tree.fill = 0;
+  tree.digests = NULL;
+  tree.ndigests = 0;
+  tree.digests_alloc = 0;
+
+  ret = (*checksum_contents) (abfd, tree_hash_bytes, &tree);
+  if (ret)
+    {
+      tree_hash_flush (&tree);
+      hash ((const char *) tree.digests, tree.ndigests * digest_size,
+	    id_bits);
+    }
+
+  free (tree.digests);
+  free (tree.chunks);
+  return ret;
+}
+
 bfd_boolean
 generate_build_id (bfd *abfd,
 		   const char *style,
 		   checksum_fn checksum_contents,
 		   unsigned char *id_bits,
-		   int size ATTRIBUTE_UNUSED)
+		   int size ATTRIBUTE_UNUSED,
+		   int threads)
 {
-  if (streq (style, "md5"))
+  if (streq (style, "md5-tree"))
+    return generate_tree_build_id (abfd, md5_buffer, 128 / 8,
+				   checksum_contents, id_bits, threads);
+  else if (streq (style, "sha1-tree"))
+    return generate_tree_build_id (abfd, sha1_buffer, 160 / 8,
+				   checksum_contents, id_bits, threads);
+  else if (streq (style, "md5"))
     {
       struct md5_ctx ctx;
 
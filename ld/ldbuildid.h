@@ -34,6 +34,7 @@ typedef bfd_boolean (*checksum_fn) (bfd *,
 				    void *);
 
 extern bfd_boolean
-generate_build_id (bfd *, const char *, checksum_fn, unsigned char *, int);
+generate_build_id (bfd *, const char *, checksum_fn, unsigned char *, int,
+		   int);
 
 #endif /* LDBUILDID_H */
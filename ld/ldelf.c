@@ -1389,7 +1389,8 @@ write_build_id (bfd *abfd)
   bfd_h_put_32 (abfd, NT_GNU_BUILD_ID, &e_note->type);
   memcpy (e_note->name, "GNU", sizeof "GNU");
 
-  generate_build_id (abfd, style, bed->s->checksum_contents, id_bits, size);
+  generate_build_id (abfd, style, bed->s->checksum_contents, id_bits, size,
+		     link_info.thread_count);
 
   position = i_shdr->sh_offset + asec->output_offset;
   size = asec->size;
@@ -1891,7 +1892,18 @@ elf_orphan_compatible (asection *in, asection *out)
 }
 
 /* Place an orphan section.  We use this to put random SHF_ALLOC
-   sections in the right segment.  */
+   sections in the right segment.
+
+   This is called once for every orphan, which for -ffunction-sections
+   style links without a covering script can mean hundreds of
+   thousands of calls, so take care not to add searches of the whole
+   statement list here.  Orphans are matched to existing output
+   sections by name through the output section statement hash table.
+   HOLD remembers where the last orphan of each class went;
+   lang_output_section_find_by_flags only runs until a class has an
+   exact match, which the first orphan placed in the class provides.
+   lang_insert_orphan keeps an index of the loaded note sections for
+   grouping orphan notes.  */
 
 lang_output_section_statement_type *
 ldelf_place_orphan (asection *s, const char *secname, int constraint)
@@ -45,6 +45,11 @@ ldelf_map_segments (bfd_boolean need_layout)
 	{
 	  bfd_size_type phdr_size;
 
+	  /* .relr.dyn depends on the addresses of the relocations it
+	     packs, so it can only be sized after layout.  */
+	  if (!_bfd_elf_size_relative_relocs (&link_info, &need_layout))
+	    einfo (_("%F%P: failed to size relative relocations: %E\n"));
+
 	  phdr_size = elf_program_header_size (link_info.output_bfd);
 	  /* If we don't have user supplied phdrs, throw away any
 	     previous linker generated program headers.  */
@@ -265,6 +265,75 @@ unique_section_p (const asection *sec,
   return FALSE;
 }
 
+/* Compute the lengths used by spec_match for SPEC.  The prefix is
+   the literal text before the first wildcard character and the
+   suffix the literal text after the last one.  An unclosed '[' is
+   literal to fnmatch, so the suffix stops there too rather than
+   overlapping the prefix.  Patterns using backslash escapes are left
+   entirely to fnmatch.  */
+
+static void
+init_spec (struct wildcard_spec *spec)
+{
+  const char *name = spec->name;
+  const char *p;
+
+  spec->namelen = 0;
+  spec->prefixlen = 0;
+  spec->suffixlen = 0;
+  if (name == NULL)
+    return;
+
+  spec->namelen = strlen (name);
+  if (strchr (name, '\\') != NULL)
+    return;
+
+  spec->prefixlen = strcspn (name, "?*[");
+  if (spec->prefixlen == spec->namelen)
+    return;
+
+  for (p = name + spec->namelen; p > name + spec->prefixlen; p--)
+    if (p[-1] == '?' || p[-1] == '*' || p[-1] == '[' || p[-1] == ']')
+      break;
+  spec->suffixlen = name + spec->namelen - p;
+}
+
+/* Return TRUE if section NAME matches SPEC.  This is equivalent to
+   name_match (SPEC->name, NAME) == 0, but compares the literal prefix
+   and suffix of the pattern first so that fnmatch is only called for
+   names that might match, and not at all for the common "prefix*" and
+   "*suffix" forms.  */
+
+static bfd_boolean
+spec_match (const struct wildcard_spec *spec, const char *name)
+{
+  size_t nl = spec->namelen;
+  size_t pl = spec->prefixlen;
+  size_t sl = spec->suffixlen;
+  size_t inputlen;
+
+  if (pl == 0 && sl == 0)
+    return name_match (spec->name, name) == 0;
+
+  if (pl != 0 && strncmp (spec->name, name, pl) != 0)
+    return FALSE;
+
+  /* A pattern without wildcards matches only itself.  */
+  if (pl == nl)
+    return name[pl] == '\0';
+
+  inputlen = pl + strlen (name + pl);
+  if (sl != 0
+      && (inputlen < pl + sl
+	  || memcmp (spec->name + nl - sl, name + inputlen - sl, sl) != 0))
+    return FALSE;
+
+  if (nl == pl + sl + 1 && spec->name[pl] == '*')
+    return TRUE;
+
+  return fnmatch (spec->name + pl, name + pl, 0) == 0;
+}
+
 /* Generic traversal routines for finding matching sections.  */
 
 /* Return true if FILE matches a pattern in EXCLUDE_LIST, otherwise return
@@ -350,7 +419,7 @@ walk_wild_section_general (lang_wild_statement_type *ptr,
 	    {
 	      const char *sname = bfd_section_name (s);
 
-	      skip = name_match (sec->spec.name, sname) != 0;
+	      skip = !spec_match (&sec->spec, sname);
 	    }
 
 	  if (!skip)
@@ -914,6 +983,304 @@ analyze_walk_wild_section_handler (lang_wild_statement_type *ptr)
       ptr->handler_data[data_counter++] = sec;
 }
 
+/* Statements applying to every input file are matched against all
+   input sections at once, through a trie of the literal prefixes of
+   their section specs.  Each input section is then looked up once,
+   rather than once per statement, and the sections matching a
+   statement are recorded on the statement for walk_wild.  */
+
+/* An input section matched by SPEC.  */
+
+struct wild_match
+{
+  asection *section;
+  lang_input_statement_type *file;
+  struct wildcard_list *spec;
+};
+
+/* A spec attached to the trie.  RULE orders the specs of all indexed
+   statements by statement and then by position in the statement.  */
+
+struct wild_rule
+{
+  struct wild_rule *next;
+  unsigned int rule;
+  lang_wild_statement_type *stmt;
+  struct wildcard_list *spec;
+};
+
+/* A trie node.  RULES are the specs whose literal prefix ends here;
+   the root holds those without a literal prefix, such as "*.text".  */
+
+struct wild_trie
+{
+  struct wild_trie *child;
+  struct wild_trie *sibling;
+  struct wild_rule *rules;
+  unsigned char c;
+};
+
+/* All wild statements, in the order they were created.  */
+static lang_wild_statement_type *first_wild_statement;
+static lang_wild_statement_type **last_wild_statement = &first_wild_statement;
+static unsigned int wild_statement_count;
+
+/* The trie, how many statements it covers, and a signature of the
+   input files whose sections were last matched against it.  */
+static struct wild_trie *wild_trie;
+static unsigned int wild_trie_statements;
+static size_t wild_files_count;
+static size_t wild_sections_count;
+static size_t wild_files_hash;
+
+/* Return TRUE if walk_wild should use the matches recorded on S.  */
+
+static bfd_boolean
+wild_statement_indexed (lang_wild_statement_type *s)
+{
+  return (s->section_list != NULL
+	  && (s->filename == NULL
+	      || archive_path (s->filename) != NULL
+	      || wildcardp (s->filename)));
+}
+
+static void
+free_wild_trie (struct wild_trie *node)
+{
+  while (node != NULL)
+    {
+      struct wild_trie *next = node->sibling;
+      struct wild_rule *r, *rnext;
+
+      for (r = node->rules; r != NULL; r = rnext)
+	{
+	  rnext = r->next;
+	  free (r);
+	}
+      free_wild_trie (node->child);
+      free (node);
+      node = next;
+    }
+}
+
+/* Add SPEC of statement STMT to the trie as rule number RULE.  */
+
+static void
+add_wild_rule (lang_wild_statement_type *stmt, struct wildcard_list *spec,
+	       unsigned int rule)
+{
+  struct wild_trie *node = wild_trie;
+  struct wild_rule *r;
+  const char *name = spec->spec.name;
+  size_t len = name != NULL ? strcspn (name, "?*[\\") : 0;
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    {
+      struct wild_trie **pp;
+      unsigned char c = name[i];
+
+      for (pp = &node->child; *pp != NULL; pp = &(*pp)->sibling)
+	if ((*pp)->c == c)
+	  break;
+      if (*pp == NULL)
+	{
+	  *pp = (struct wild_trie *) xcalloc (1, sizeof (**pp));
+	  (*pp)->c = c;
+	}
+      node = *pp;
+    }
+
+  r = (struct wild_rule *) xmalloc (sizeof (*r));
+  r->rule = rule;
+  r->stmt = stmt;
+  r->spec = spec;
+  r->next = node->rules;
+  node->rules = r;
+}
+
+/* Record SECTION of FILE on every indexed statement with a spec
+   matching it, visiting the specs in rule order.  */
+
+static void
+match_wild_section (lang_input_statement_type *file, asection *section,
+		    struct wild_rule ***found, size_t *found_alloc)
+{
+  const char *name = bfd_section_name (section);
+  const char *p = name;
+  struct wild_trie *node = wild_trie;
+  size_t count = 0;
+  size_t i;
+
+  while (1)
+    {
+      struct wild_rule *r;
+
+      for (r = node->rules; r != NULL; r = r->next)
+	if (r->spec->spec.name == NULL
+	    || spec_match (&r->spec->spec, name))
+	  {
+	    size_t j;
+
+	    if (count == *found_alloc)
+	      {
+		*found_alloc = *found_alloc * 2 + 8;
+		*found = (struct wild_rule **)
+		  xrealloc (*found, *found_alloc * sizeof (**found));
+	      }
+	    /* Keep the candidates sorted, lowest rule first.  */
+	    for (j = count; j > 0 && (*found)[j - 1]->rule > r->rule; j--)
+	      (*found)[j] = (*found)[j - 1];
+	    (*found)[j] = r;
+	    count++;
+	  }
+
+      if (*p == '\0')
+	break;
+      for (node = node->child; node != NULL; node = node->sibling)
+	if (node->c == (unsigned char) *p)
+	  break;
+      if (node == NULL)
+	break;
+      p++;
+    }
+
+  for (i = 0; i < count; i++)
+    {
+      lang_wild_statement_type *s = (*found)[i]->stmt;
+      struct wild_match *m;
+
+      if (s->match_count == s->match_alloc)
+	{
+	  s->match_alloc = s->match_alloc * 2 + 8;
+	  s->matches = (struct wild_match *)
+	    xrealloc (s->matches, s->match_alloc * sizeof (*s->matches));
+	}
+      m = &s->matches[s->match_count++];
+      m->section = section;
+      m->file = file;
+      m->spec = (*found)[i]->spec;
+    }
+}
+
+/* Bring the matches recorded on indexed wild statements up to date,
+   rebuilding the trie if statements have been added since it was
+   built and rematching if input files or sections have been added
+   since the last call.  */
+
+static void
+resolve_wild_sections (void)
+{
+  lang_wild_statement_type *s;
+  struct wild_rule **found = NULL;
+  size_t found_alloc = 0;
+  size_t nfiles = 0;
+  size_t nsections = 0;
+  size_t hash = 0;
+
+  LANG_FOR_EACH_INPUT_STATEMENT (f)
+    {
+      nfiles++;
+      nsections += f->the_bfd->section_count;
+      hash = hash * 31 + f->the_bfd->id;
+    }
+
+  if (wild_trie != NULL
+      && wild_trie_statements == wild_statement_count
+      && wild_files_count == nfiles
+      && wild_sections_count == nsections
+      && wild_files_hash == hash)
+    return;
+
+  if (wild_trie == NULL || wild_trie_statements != wild_statement_count)
+    {
+      unsigned int rule = 0;
+
+      free_wild_trie (wild_trie);
+      wild_trie = (struct wild_trie *) xcalloc (1, sizeof (*wild_trie));
+      for (s = first_wild_statement; s != NULL; s = s->next_wild)
+	if (wild_statement_indexed (s))
+	  {
+	    struct wildcard_list *sec;
+
+	    for (sec = s->section_list; sec != NULL; sec = sec->next)
+	      add_wild_rule (s, sec, rule++);
+	  }
+      wild_trie_statements = wild_statement_count;
+    }
+
+  for (s = first_wild_statement; s != NULL; s = s->next_wild)
+    s->match_count = 0;
+
+  for (f = (lang_input_statement_type *) file_chain.head;
+       f != NULL;
+       f = f->next)
+    {
+      asection *section;
+
+      if (f->flags.just_syms)
+	continue;
+      for (section = f->the_bfd->sections;
+	   section != NULL;
+	   section = section->next)
+	match_wild_section (f, section, &found, &found_alloc);
+    }
+  free (found);
+
+  wild_files_count = nfiles;
+  wild_sections_count = nsections;
+  wild_files_hash = hash;
+}
+
+/* Return TRUE if S applies to sections of FILE.  */
+
+static bfd_boolean
+wild_file_match (lang_wild_statement_type *s, lang_input_statement_type *file)
+{
+  const char *file_spec = s->filename;
+
+  if (file_spec != NULL)
+    {
+      char *p = archive_path (file_spec);
+
+      if (p != NULL
+	  ? !input_statement_is_archive_path (file_spec, p, file)
+	  : fnmatch (file_spec, file->filename, 0) != 0)
+	return FALSE;
+    }
+
+  return !walk_wild_file_in_exclude_list (s->exclude_name_list, file);
+}
+
+/* Call CALLBACK for the sections recorded on S by
+   resolve_wild_sections.  */
+
+static void
+walk_wild_indexed (lang_wild_statement_type *s,
+		   callback_t callback,
+		   void *data)
+{
+  lang_input_statement_type *last = NULL;
+  bfd_boolean skip = FALSE;
+  size_t i;
+
+  resolve_wild_sections ();
+
+  for (i = 0; i < s->match_count; i++)
+    {
+      struct wild_match *m = &s->matches[i];
+
+      if (m->file != last)
+	{
+	  last = m->file;
+	  skip = !wild_file_match (s, last);
+	}
+      if (!skip)
+	walk_wild_consider_section (s, m->file, m->section, m->spec,
+				    callback, data);
+    }
+}
+
 /* Handle a wild statement for a single file F.  */
 
 static void
@@ -956,7 +1323,9 @@ walk_wild (lang_wild_statement_type *s, callback_t callback, void *data)
   const char *file_spec = s->filename;
   char *p;
 
-  if (file_spec == NULL)
+  if (wild_statement_indexed (s))
+    walk_wild_indexed (s, callback, data);
+  else if (file_spec == NULL)
     {
       /* Perform the iteration over all files in the list.  */
       LANG_FOR_EACH_INPUT_STATEMENT (f)
@@ -1866,6 +2235,49 @@ insert_os_after (lang_output_section_statement_type *after)
   return where;
 }
 
+/* The first and last loaded ELF note output sections, used by
+   lang_insert_orphan to group orphan note sections without searching
+   the whole output section list for each orphan.  The index is only
+   kept while lang_place_orphans runs.  lang_insert_orphan updates it
+   as it places new note sections, and lang_add_section clears VALID
+   when any other output section becomes a loaded note.  */
+
+static struct
+{
+  asection *first;
+  asection *last;
+  bfd_boolean valid;
+  bfd_boolean active;
+} orphan_notes;
+
+static bfd_boolean
+orphan_note_p (const asection *sec)
+{
+  return (elf_section_type (sec) == SHT_NOTE
+	  && (sec->flags & SEC_LOAD) != 0);
+}
+
+/* Rebuild orphan_notes from the output section list, ignoring SKIP.  */
+
+static void
+orphan_notes_scan (const asection *skip)
+{
+  asection *sec;
+
+  orphan_notes.first = NULL;
+  orphan_notes.last = NULL;
+  for (sec = link_info.output_bfd->sections;
+       sec != NULL && !bfd_is_abs_section (sec);
+       sec = sec->next)
+    if (sec != skip && orphan_note_p (sec))
+      {
+	if (orphan_notes.first == NULL)
+	  orphan_notes.first = sec;
+	orphan_notes.last = sec;
+      }
+  orphan_notes.valid = orphan_notes.active;
+}
+
 lang_output_section_statement_type *
 lang_insert_orphan (asection *s,
 		    const char *secname,
@@ -1878,6 +2290,10 @@ lang_insert_orphan (asection *s,
   lang_statement_list_type add;
   lang_output_section_statement_type *os;
   lang_output_section_statement_type **os_tail;
+  asection *last_sec = link_info.output_bfd->section_last;
+  bfd_boolean notes_valid = orphan_notes.valid;
+  bfd_boolean new_sec;
+  bfd_boolean note_placed = FALSE;
 
   /* If we have found an appropriate place for the output section
      statements for this orphan, add them to our own private list,
@@ -1919,6 +2335,15 @@ lang_insert_orphan (asection *s,
   if (after != NULL)
     pop_stat_ptr ();
 
+  /* A new output section made into a loaded note by the
+     lang_add_section call above doesn't spoil orphan_notes, since it
+     is added to the index below once it has been placed.  */
+  new_sec = (os->bfd_section != NULL
+	     && os->bfd_section != last_sec
+	     && os->bfd_section == link_info.output_bfd->section_last);
+  if (new_sec)
+    orphan_notes.valid = notes_valid;
+
   if (after != NULL && os->bfd_section != NULL)
     {
       asection *snew, *as;
@@ -1959,6 +2384,14 @@ lang_insert_orphan (asection *s,
 
 	  /* Now tack it back on in the right place.  */
 	  bfd_section_list_append (link_info.output_bfd, snew);
+
+	  if (orphan_notes.valid && new_sec && orphan_note_p (snew))
+	    {
+	      if (orphan_notes.first == NULL)
+		orphan_notes.first = snew;
+	      orphan_notes.last = snew;
+	      note_placed = TRUE;
+	    }
 	}
       else if ((bfd_get_flavour (link_info.output_bfd)
 		== bfd_target_elf_flavour)
@@ -1988,25 +2421,24 @@ lang_insert_orphan (asection *s,
 	  if (elf_section_type (s) == SHT_NOTE
 	      && (s->flags & SEC_LOAD) != 0)
 	    {
-	      /* Search from the beginning for the last output note
-		 section with equal or larger alignments.  NB: Don't
-		 place orphan note section after non-note sections.  */
-
-	      first_orphan_note = NULL;
-	      for (sec = link_info.output_bfd->sections;
+	      /* Search from the first output note section for the last
+		 output note section with equal or larger alignments.
+		 NB: Don't place orphan note section after non-note
+		 sections.  */
+
+	      if (!orphan_notes.valid || !new_sec)
+		orphan_notes_scan (snew);
+	      first_orphan_note = orphan_notes.first;
+	      for (sec = first_orphan_note;
 		   (sec != NULL
 		    && !bfd_is_abs_section (sec));
 		   sec = sec->next)
-		if (sec != snew
-		    && elf_section_type (sec) == SHT_NOTE
-		    && (sec->flags & SEC_LOAD) != 0)
+		if (sec != snew && orphan_note_p (sec))
 		  {
-		    if (!first_orphan_note)
-		      first_orphan_note = sec;
 		    if (sec->alignment_power >= s->alignment_power)
 		      after_sec = sec;
 		  }
-		else if (first_orphan_note)
+		else
 		  {
 		    /* Stop if there is non-note section after the first
 		       orphan note section.  */
@@ -2030,51 +2462,60 @@ lang_insert_orphan (asection *s,
 	      /* Don't place non-note sections in the middle of orphan
 	         note sections.  */
 	      after_sec_note = TRUE;
-	      after_sec = as;
-	      for (sec = as->next;
-		   (sec != NULL
-		    && !bfd_is_abs_section (sec));
-		   sec = sec->next)
-		if (elf_section_type (sec) == SHT_NOTE
-		    && (sec->flags & SEC_LOAD) != 0)
-		  after_sec = sec;
+	      if (!orphan_notes.valid)
+		orphan_notes_scan (NULL);
+	      /* AS is a note section, so this is AS or a later one.  */
+	      after_sec = orphan_notes.last;
 	    }
 
 	  if (after_sec_note)
 	    {
 	      if (after_sec)
 		{
-		  /* Search forward to insert OS after AFTER_SEC output
-		     statement.  */
 		  lang_output_section_statement_type *stmt, *next;
 		  bfd_boolean found = FALSE;
-		  for (stmt = after; stmt != NULL; stmt = next)
+
+		  /* AFTER_SEC normally has its own output statement.  */
+		  stmt = lang_output_section_get (after_sec);
+		  if (stmt != NULL
+		      && stmt->bfd_section == after_sec
+		      && (insert_after || stmt->prev != NULL))
 		    {
-		      next = stmt->next;
-		      if (insert_after)
-			{
-			  if (stmt->bfd_section == after_sec)
-			    {
-			      place_after = TRUE;
-			      found = TRUE;
-			      after = stmt;
-			      break;
-			    }
-			}
-		      else
-			{
-			  /* If INSERT_AFTER is FALSE, place OS before
-			     AFTER_SEC output statement.  */
-			  if (next && next->bfd_section == after_sec)
-			    {
-			      place_after = TRUE;
-			      found = TRUE;
-			      after = stmt;
-			      break;
-			    }
-			}
+		      place_after = TRUE;
+		      found = TRUE;
+		      after = insert_after ? stmt : stmt->prev;
 		    }
 
+		  /* Search forward to insert OS after AFTER_SEC output
+		     statement.  */
+		  if (!found)
+		    for (stmt = after; stmt != NULL; stmt = next)
+		      {
+			next = stmt->next;
+			if (insert_after)
+			  {
+			    if (stmt->bfd_section == after_sec)
+			      {
+				place_after = TRUE;
+				found = TRUE;
+				after = stmt;
+				break;
+			      }
+			  }
+			else
+			  {
+			    /* If INSERT_AFTER is FALSE, place OS before
+			       AFTER_SEC output statement.  */
+			    if (next && next->bfd_section == after_sec)
+			      {
+				place_after = TRUE;
+				found = TRUE;
+				after = stmt;
+				break;
+			      }
+			  }
+		      }
+
 		  /* Search backward to insert OS after AFTER_SEC output
 		     statement.  */
 		  if (!found)
@@ -2134,6 +2575,22 @@ lang_insert_orphan (asection *s,
 	      bfd_section_list_insert_before (link_info.output_bfd,
 					      as, snew);
 	    }
+
+	  if (orphan_notes.valid
+	      && new_sec
+	      && orphan_note_p (s)
+	      && orphan_note_p (snew))
+	    {
+	      /* SNEW is now the only note section, or has been placed
+		 before the first one or after AFTER_SEC.  */
+	      if (!after_sec_note)
+		orphan_notes.first = orphan_notes.last = snew;
+	      else if (!insert_after)
+		orphan_notes.first = snew;
+	      else if (after_sec == orphan_notes.last)
+		orphan_notes.last = snew;
+	      note_placed = TRUE;
+	    }
 	}
       else if (as != snew && as->prev != snew)
 	{
@@ -2207,6 +2664,13 @@ lang_insert_orphan (asection *s,
 	    lang_os_list.tail = (lang_statement_union_type **) os_tail;
 	}
     }
+
+  if (orphan_notes.valid
+      && !note_placed
+      && os->bfd_section != NULL
+      && orphan_note_p (os->bfd_section))
+    orphan_notes.valid = FALSE;
+
   return os;
 }
 
@@ -2545,6 +3009,7 @@ lang_add_section (lang_statement_list_type *ptr,
   flagword flags = section->flags;
 
   bfd_boolean discard;
+  bfd_boolean was_note;
   lang_input_section_type *new_section;
   bfd *abfd = link_info.output_bfd;
 
@@ -2654,6 +3119,10 @@ lang_add_section (lang_statement_list_type *ptr,
       break;
     }
 
+  was_note = (orphan_notes.valid
+	      && output->bfd_section != NULL
+	      && orphan_note_p (output->bfd_section));
+
   if (output->bfd_section == NULL)
     init_os (output, flags);
 
@@ -2692,6 +3161,11 @@ lang_add_section (lang_statement_list_type *ptr,
 	output->bfd_section->entsize = section->entsize;
     }
 
+  if (orphan_notes.valid
+      && !was_note
+      && orphan_note_p (output->bfd_section))
+    orphan_notes.valid = FALSE;
+
   if ((flags & SEC_TIC54X_BLOCK) != 0
       && bfd_get_arch (section->owner) == bfd_arch_tic54x)
     {
@@ -7179,6 +7653,8 @@ ldlang_place_orphan (asection *s)
 static void
 lang_place_orphans (void)
 {
+  orphan_notes.active = TRUE;
+
   LANG_FOR_EACH_INPUT_STATEMENT (file)
     {
       asection *s;
@@ -7215,6 +7691,9 @@ lang_place_orphans (void)
 	    }
 	}
     }
+
+  orphan_notes.active = FALSE;
+  orphan_notes.valid = FALSE;
 }
 
 void
@@ -8152,6 +8631,7 @@ lang_add_wild (struct wildcard_spec *filespec,
     {
       next = curr->next;
       curr->next = section_list;
+      init_spec (&curr->spec);
     }
 
   if (filespec != NULL && filespec->name != NULL)
@@ -8178,6 +8658,13 @@ lang_add_wild (struct wildcard_spec *filespec,
   new_stmt->keep_sections = keep_sections;
   lang_list_init (&new_stmt->children);
   analyze_walk_wild_section_handler (new_stmt);
+  new_stmt->next_wild = NULL;
+  new_stmt->matches = NULL;
+  new_stmt->match_count = 0;
+  new_stmt->match_alloc = 0;
+  *last_wild_statement = new_stmt;
+  last_wild_statement = &new_stmt->next_wild;
+  wild_statement_count++;
 }
 
 void
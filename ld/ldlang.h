@@ -380,6 +380,16 @@ struct lang_wild_statement_struct
   struct wildcard_list *handler_data[4];
   lang_section_bst_type *tree;
   struct flag_info *section_flag_list;
+
+  /* The next wild statement, in the order they were created.  */
+  lang_wild_statement_type *next_wild;
+
+  /* For a statement applying to every file matching a wildcard,
+     the input sections matching SECTION_LIST, in the order walk_wild
+     visits them.  */
+  struct wild_match *matches;
+  size_t match_count;
+  size_t match_alloc;
 };
 
 typedef struct lang_address_statement_struct
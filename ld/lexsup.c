@@ -424,6 +424,13 @@ static const struct ld_option ld_options[] =
      OPTION_REDUCE_MEMORY_OVERHEADS},
     '\0', NULL, N_("Reduce memory overheads, possibly taking much longer"),
     TWO_DASHES },
+  { {"threads", no_argument, NULL, OPTION_THREADS},
+    '\0', NULL, N_("Relocate input files in parallel"), TWO_DASHES },
+  { {"no-threads", no_argument, NULL, OPTION_NO_THREADS},
+    '\0', NULL, N_("Relocate input files serially (default)"), TWO_DASHES },
+  { {"thread-count", required_argument, NULL, OPTION_THREAD_COUNT},
+    '\0', N_("COUNT"), N_("Relocate input files with COUNT threads"),
+    TWO_DASHES },
   { {"relax", no_argument, NULL, OPTION_RELAX},
     '\0', NULL, N_("Reduce code size by using target specific optimizations"), TWO_DASHES },
   { {"no-relax", no_argument, NULL, OPTION_NO_RELAX},
@@ -1579,6 +1586,26 @@ parse_args (unsigned argc, char **argv)
 	    config.hash_table_size = 1021;
 	  break;
 
+	case OPTION_THREADS:
+	  if (link_info.thread_count == 0)
+	    link_info.thread_count = -1;
+	  break;
+
+	case OPTION_NO_THREADS:
+	  link_info.thread_count = 0;
+	  break;
+
+	case OPTION_THREAD_COUNT:
+	  {
+	    char *end;
+	    long count = strtol (optarg, &end, 0);
+
+	    if (*end || count < 1 || count != (int) count)
+	      einfo (_("%F%P: invalid thread count `%s'\n"), optarg);
+	    link_info.thread_count = count;
+	  }
+	  break;
+
 	case OPTION_HASH_SIZE:
 	  {
 	    bfd_size_type new_size;
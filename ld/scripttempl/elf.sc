@@ -47,6 +47,7 @@
 #	BSS_PLT - .plt should be in bss segment
 #	NO_REL_RELOCS - Don't include .rel.* sections in script
 #	NO_RELA_RELOCS - Don't include .rela.* sections in script
+#	HAVE_DT_RELR - Include a .relr.dyn section in script
 #	NON_ALLOC_DYN - Place dynamic sections after data segment.
 #	TEXT_DYNAMIC - .dynamic in text segment, not data segment.
 #	EMBEDDED - whether this is for an embedded system.
@@ -476,6 +477,7 @@ cat >> ldscripts/dyntmp.$$ <<EOF
       ${IREL_IN_PLT+${RELOCATING+${CREATE_PIC-PROVIDE_HIDDEN (${USER_LABEL_PREFIX}__rela_iplt_end = .);}}}
     }
   ${OTHER_PLT_RELOC_SECTIONS}
+  ${HAVE_DT_RELR+.relr.dyn     ${RELOCATING-0} : { *(.relr.dyn) }}
 EOF
 
 emit_dyn()
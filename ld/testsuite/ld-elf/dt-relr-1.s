@@ -0,0 +1,17 @@
+	.text
+	.globl	_start
+_start:
+	nop
+
+	.data
+	.p2align 3
+	.weak	undef
+	.globl	bar
+	.hidden	bar
+bar:
+	.dc.a	_start
+	.dc.a	foo
+	.dc.a	bar
+	.dc.a	undef
+foo:
+	.dc.a	foo
@@ -0,0 +1,8 @@
+	.text
+	.globl	_start
+_start:
+	nop
+
+	# Enough data for the build ID to cover more than one chunk.
+	.data
+	.fill	0x180000, 1, 0x5a
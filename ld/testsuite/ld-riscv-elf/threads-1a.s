@@ -0,0 +1,11 @@
+	.file	"threads-1a.c"
+	.text
+	.globl	_start
+_start:
+	call	func_b
+	lla	a0, data_a
+	lla	a1, data_b
+	ret
+	.data
+data_a:
+	.dc.a	data_b
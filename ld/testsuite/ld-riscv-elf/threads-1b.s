@@ -0,0 +1,12 @@
+	.file	"threads-1b.c"
+	.text
+	.globl	func_b
+func_b:
+	lla	a0, data_b
+	ret
+	.data
+	.globl	data_b
+data_b:
+	.dc.a	data_a_copy
+data_a_copy:
+	.dc.a	func_b
@@ -0,0 +1,7 @@
+	.text
+	.globl	func_c
+func_c:
+	call	_start
+	ret
+local_c:
+	ret
@@ -0,0 +1,5 @@
+        .section ".sec[a"
+        .word 1
+
+        .section ".sec[bar"
+        .word 2
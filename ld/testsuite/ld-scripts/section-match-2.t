@@ -0,0 +1,12 @@
+SECTIONS
+{
+	/* An unclosed '[' is not a wildcard, so .secA should collect
+	   the section called ".sec[a".  */
+        .secA : { *(.sec[a) }
+
+	/* .secB should collect any sections with a ".sec[b" prefix.  */
+        .secB : { *(.sec[b*) }
+
+	/* Ignore anything else.  */
+        /DISCARD/ : { *(*) }
+}
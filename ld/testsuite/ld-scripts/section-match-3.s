@@ -0,0 +1,14 @@
+	.section ".text.b", "a"
+	.byte 0x0b
+
+	.section ".text.ab", "a"
+	.byte 0xab
+
+	.section ".text.a", "a"
+	.byte 0x0a
+
+	.section ".rodata.b", "a"
+	.byte 0x1b
+
+	.section ".data.x", "a"
+	.byte 0xd0
@@ -0,0 +1,15 @@
+SECTIONS
+{
+	/* .secA collects .text.ab and .text.a, in input order.  */
+	.secA : { *(.text.a*) }
+
+	/* .text.b matches both patterns but is placed only once,
+	   followed by .rodata.b.  .text.ab was claimed by .secA.  */
+	.secB : { *(*b .text.*) }
+
+	/* .text.b was claimed by .secB, leaving only .data.x.  */
+	.secC : { *(.data.* .text.b) }
+
+	/* Ignore anything else.  */
+	/DISCARD/ : { *(*) }
+}
@@ -39,11 +39,16 @@ struct riscv_private_data
   bfd_vma gp;
   bfd_vma print_addr;
   bfd_vma hi_addr[OP_MASK_RD + 1];
+  asection *section;
 };
 
 static const char * const *riscv_gpr_names;
 static const char * const *riscv_fpr_names;
 
+/* CSR names, for the privileged spec in use when the first
+   instruction was disassembled.  */
+static const char *riscv_csr_hash[4096];    /* Total 2^12 CSR.  */
+
 /* Other options.  */
 static int no_aliases;	/* If set disassemble as most general inst.  */
 
@@ -363,33 +368,8 @@ print_insn_args (const char *d, insn_t l, bfd_vma pc, disassemble_info *info)
 
 	case 'E':
 	  {
-	    static const char *riscv_csr_hash[4096];    /* Total 2^12 CSR.  */
-	    static bfd_boolean init_csr = FALSE;
 	    unsigned int csr = EXTRACT_OPERAND (CSR, l);
 
-	    if (!init_csr)
-	      {
-		unsigned int i;
-		for (i = 0; i < 4096; i++)
-		  riscv_csr_hash[i] = NULL;
-
-		/* Set to the newest privilege version.  */
-		if (default_priv_spec == PRIV_SPEC_CLASS_NONE)
-		  default_priv_spec = PRIV_SPEC_CLASS_DRAFT - 1;
-
-#define DECLARE_CSR(name, num, class, define_version, abort_version)	\
-		if (riscv_csr_hash[num] == NULL 			\
-		    && ((define_version == PRIV_SPEC_CLASS_NONE 	\
-			 && abort_version == PRIV_SPEC_CLASS_NONE)	\
-			|| (default_priv_spec >= define_version 	\
-			    && default_priv_spec < abort_version)))	\
-		  riscv_csr_hash[num] = #name;
-#define DECLARE_CSR_ALIAS(name, num, class, define_version, abort_version) \
-		DECLARE_CSR (name, num, class, define_version, abort_version)
-#include "opcode/riscv-opc.h"
-#undef DECLARE_CSR
-	      }
-
 	    if (riscv_csr_hash[csr] != NULL)
 	      print (info->stream, "%s", riscv_csr_hash[csr]);
 	    else
@@ -410,6 +390,99 @@ print_insn_args (const char *d, insn_t l, bfd_vma pc, disassemble_info *info)
     }
 }
 
+/* Opcodes are looked up in buckets indexed by the major opcode and
+   funct3 field of a 32-bit instruction, or by the quadrant and funct3
+   field of a compressed one.  Each bucket lists, in riscv_opcodes
+   order, the non-macro entries whose match and mask agree with those
+   bits, so the match functions only run on plausible candidates.  */
+
+#define RISCV_DIS_BUCKETS (1024 + 32)
+
+static unsigned int
+riscv_dis_bucket (insn_t word)
+{
+  if ((word & 3) != 3)
+    return 1024 + (((word >> 13) & 7) << 2) + (word & 3);
+  return (((word >> 12) & 7) << 7) + (word & OP_MASK_OP);
+}
+
+static const struct riscv_opcode **riscv_dis_opcodes;
+static unsigned int riscv_dis_start[RISCV_DIS_BUCKETS + 1];
+
+static void
+riscv_dis_init_csrs (void)
+{
+  /* Set to the newest privilege version.  */
+  if (default_priv_spec == PRIV_SPEC_CLASS_NONE)
+    default_priv_spec = PRIV_SPEC_CLASS_DRAFT - 1;
+
+#define DECLARE_CSR(name, num, class, define_version, abort_version)	\
+  if (riscv_csr_hash[num] == NULL					\
+      && ((define_version == PRIV_SPEC_CLASS_NONE			\
+	   && abort_version == PRIV_SPEC_CLASS_NONE)			\
+	  || (default_priv_spec >= define_version			\
+	      && default_priv_spec < abort_version)))			\
+    riscv_csr_hash[num] = #name;
+#define DECLARE_CSR_ALIAS(name, num, class, define_version, abort_version) \
+  DECLARE_CSR (name, num, class, define_version, abort_version)
+#include "opcode/riscv-opc.h"
+#undef DECLARE_CSR
+}
+
+static void
+riscv_dis_init_buckets (void)
+{
+  const struct riscv_opcode *riscv_hash[OP_MASK_OP + 1];
+  const struct riscv_opcode *op;
+  unsigned int b, n;
+  int pass;
+
+#define OP_HASH_IDX(i) ((i) & (riscv_insn_length (i) == 2 ? 0x3 : OP_MASK_OP))
+
+  /* A word is only ever matched against entries from the first one
+     sharing its hash index onwards.  */
+  memset (riscv_hash, 0, sizeof (riscv_hash));
+  for (op = riscv_opcodes; op->name; op++)
+    if (!riscv_hash[OP_HASH_IDX (op->match)])
+      riscv_hash[OP_HASH_IDX (op->match)] = op;
+
+  /* Count the candidates for each bucket, then fill them in.  */
+  for (pass = 0; pass < 2; pass++)
+    {
+      n = 0;
+      for (b = 0; b < RISCV_DIS_BUCKETS; b++)
+	{
+	  insn_t key, key_mask;
+
+	  if (b >= 1024)
+	    {
+	      key = (((b - 1024) >> 2) << 13) | (b & 3);
+	      key_mask = 0xe003;
+	    }
+	  else
+	    {
+	      key = ((b >> 7) << 12) | (b & OP_MASK_OP);
+	      key_mask = 0x707f;
+	    }
+
+	  riscv_dis_start[b] = n;
+	  if ((b >= 1024) != ((key & 3) != 3))
+	    continue;
+	  for (op = riscv_hash[OP_HASH_IDX (key)]; op && op->name; op++)
+	    if (op->pinfo != INSN_MACRO
+		&& ((op->match ^ key) & op->mask & key_mask) == 0)
+	      {
+		if (pass)
+		  riscv_dis_opcodes[n] = op;
+		n++;
+	      }
+	}
+      riscv_dis_start[b] = n;
+      if (!pass)
+	riscv_dis_opcodes = xmalloc ((n + 1) * sizeof (*riscv_dis_opcodes));
+    }
+}
+
 /* Print the RISC-V instruction at address MEMADDR in debugged memory,
    on using INFO.  Returns length of the instruction, in bytes.
    BIGENDIAN must be 1 if this is big-endian code, 0 if
@@ -419,21 +492,16 @@ static int
 riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
 {
   const struct riscv_opcode *op;
-  static bfd_boolean init = 0;
-  static const struct riscv_opcode *riscv_hash[OP_MASK_OP + 1];
   struct riscv_private_data *pd;
   int insnlen;
+  unsigned int b;
 
-#define OP_HASH_IDX(i) ((i) & (riscv_insn_length (i) == 2 ? 0x3 : OP_MASK_OP))
-
-  /* Build a hash table to shorten the search time.  */
-  if (! init)
+  /* Set up all the static tables on the first call, so that later
+     calls only read them.  */
+  if (riscv_dis_opcodes == NULL)
     {
-      for (op = riscv_opcodes; op->name; op++)
-	if (!riscv_hash[OP_HASH_IDX (op->match)])
-	  riscv_hash[OP_HASH_IDX (op->match)] = op;
-
-      init = 1;
+      riscv_dis_init_csrs ();
+      riscv_dis_init_buckets ();
     }
 
   if (info->private_data == NULL)
@@ -453,6 +521,20 @@ riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
   else
     pd = info->private_data;
 
+  /* Addresses built by lui and auipc are not carried into another
+     section or symbol, so that each symbol disassembles the same
+     however objdump splits up the work.  */
+  if (info->section != pd->section
+      || (info->num_symbols > 0
+	  && bfd_asymbol_value (info->symbols[0]) == memaddr))
+    {
+      int i;
+
+      pd->section = info->section;
+      for (i = 0; i < (int)ARRAY_SIZE (pd->hi_addr); i++)
+	pd->hi_addr[i] = -1;
+    }
+
   insnlen = riscv_insn_length (word);
 
   /* RISC-V instructions are always little-endian.  */
@@ -469,10 +551,11 @@ riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
   info->target = 0;
   info->target2 = 0;
 
-  op = riscv_hash[OP_HASH_IDX (word)];
-  if (op != NULL)
+  b = riscv_dis_bucket (word);
+  if (riscv_dis_start[b] != riscv_dis_start[b + 1])
     {
       unsigned xlen = 0;
+      unsigned int i;
 
       /* If XLEN is not known, get its value from the ELF class.  */
       if (info->mach == bfd_mach_riscv64)
@@ -485,8 +568,10 @@ riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
 	  xlen = ehdr->e_ident[EI_CLASS] == ELFCLASS64 ? 64 : 32;
 	}
 
-      for (; op->name; op++)
+      for (i = riscv_dis_start[b]; i < riscv_dis_start[b + 1]; i++)
 	{
+	  op = riscv_dis_opcodes[i];
+
 	  /* Does the opcode match?  */
 	  if (! (op->match_func) (op, word))
 	    continue;